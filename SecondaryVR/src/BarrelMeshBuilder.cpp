@@ -0,0 +1,482 @@
+#pragma once
+#include "BarrelMeshBuilder.h"
+#include "LensDistortion.h"
+#include "InverseDistortion.h"
+#include "HmdProfile.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <cmath>
+
+
+namespace {
+	bool isOutsideEye(const glm::vec2& tc, const uint32_t camIndex) {
+		const glm::vec2 equivNDC = glm::vec2((tc.x - 0.5f*camIndex)*4.f - 1.f, tc.y*2.f - 1.f);
+		return glm::any(glm::greaterThan(glm::abs(equivNDC), glm::vec2(1.f)));
+	}
+
+	glm::vec2 eyeNDCToUV(const glm::vec3& pos, const uint32_t camIndex) {
+		return glm::vec2((pos.x + 1.f)*0.25f + 0.5f*camIndex, (pos.y + 1.f)*0.5f);
+	}
+
+	//lensVisibleRadius in the lens space the warp works in (theta), theta is isotropic in panel pixels
+	float getLensVisibleTheta(const EyeDistortionConstants& eye) {
+		const HmdProfile& hmd = HmdProfile::get();
+		if (hmd.lensVisibleRadius <= 0.f) { return std::numeric_limits<float>::max(); }
+		return hmd.lensVisibleRadius / hmd.hScreenSize * eye.scaleIn.x;
+	}
+
+	//distance along dir from center to the edge of the [lo, hi] box, center must be inside
+	float distanceToBoxEdge(const glm::vec2& center, const glm::vec2& dir, const glm::vec2& lo, const glm::vec2& hi) {
+		float t = std::numeric_limits<float>::max();
+		for (int axis = 0; axis < 2; ++axis) {
+			if		(dir[axis] > 0.f) { t = std::min(t, (hi[axis] - center[axis]) / dir[axis]); }
+			else if (dir[axis] < 0.f) { t = std::min(t, (lo[axis] - center[axis]) / dir[axis]); }
+		}
+		return t;
+	}
+}
+
+Vertex BarrelMeshBuilder::makeVertex(const uint32_t camIndex, const glm::vec2& gridNDC) {
+	//warp the ndc positions down so that the green channel of this vertex samples its original grid location
+	return makeScreenVertex(camIndex, InverseDistortion::getEye(camIndex).inverseNDC(glm::vec3(gridNDC, 0.5f)));
+}
+
+Vertex BarrelMeshBuilder::makeScreenVertex(const uint32_t camIndex, const glm::vec3& screenNDC) {
+	const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+	Vertex v;
+	v.pos = screenNDC;
+
+	//passIn uv(that is for left or right eye determined by camIndex
+	//get source uv for each channel
+	const glm::vec2 oTexCoord = eyeNDCToUV(v.pos, camIndex);
+	glm::vec2 tcRed, tcGreen, tcBlue;
+	LensDistortion::getSourceUV(eye, oTexCoord, tcRed, tcGreen, tcBlue);
+	v.color = glm::vec3(tcRed, 1.f);
+	v.uv = tcGreen;
+	v.nor = glm::vec3(tcBlue, 1.f);
+
+	//if the green uv is outside the eye or the lens can't see it set a flag on blue channel of color
+	const float thetaRadius = glm::length((oTexCoord - eye.lensCenter) * eye.scaleIn);
+	if (isOutsideEye(tcGreen, camIndex) || thetaRadius > getLensVisibleTheta(eye)) {
+		v.color.b = 0;
+	}
+	return v;
+}
+
+float BarrelMeshBuilder::triangleError(const uint32_t camIndex, const Vertex& a, const Vertex& b, const Vertex& c,
+	const uint32_t samplesPerEdge, float* out_errorSum, uint32_t* out_numSamples)
+{
+	const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+	const glm::vec2 toPixels(HmdProfile::get().width, HmdProfile::get().height);
+	const float invN = 1.f / samplesPerEdge;
+
+	float maxError = 0.f;
+	glm::vec2 tcRed, tcGreen, tcBlue;
+	for (uint32_t i = 0; i <= samplesPerEdge; ++i) {
+		for (uint32_t j = 0; i + j <= samplesPerEdge; ++j) {
+			const uint32_t k = samplesPerEdge - i - j;
+			if (i == samplesPerEdge || j == samplesPerEdge || k == samplesPerEdge) { continue; }//corners are exact
+			const float wa = i*invN;
+			const float wb = j*invN;
+			const float wc = k*invN;
+
+			//what the rasterizer would hand the frag shader at this point
+			const glm::vec3 pos = wa*a.pos + wb*b.pos + wc*c.pos;
+			const glm::vec2 lerpRed		= wa*glm::vec2(a.color) + wb*glm::vec2(b.color) + wc*glm::vec2(c.color);
+			const glm::vec2 lerpGreen	= wa*a.uv + wb*b.uv + wc*c.uv;
+			const glm::vec2 lerpBlue	= wa*glm::vec2(a.nor) + wb*glm::vec2(b.nor) + wc*glm::vec2(c.nor);
+
+			LensDistortion::getSourceUV(eye, eyeNDCToUV(pos, camIndex), tcRed, tcGreen, tcBlue);
+			if (isOutsideEye(tcGreen, camIndex)) { continue; }//black anyway
+
+			const float error = std::max(glm::length((lerpRed - tcRed)*toPixels),
+								std::max(glm::length((lerpGreen - tcGreen)*toPixels),
+										 glm::length((lerpBlue - tcBlue)*toPixels)));
+			maxError = std::max(maxError, error);
+			if (out_errorSum) { *out_errorSum += error; }
+			if (out_numSamples) { ++(*out_numSamples); }
+		}
+	}
+	return maxError;
+}
+
+void BarrelMeshBuilder::buildUniform(const uint32_t camIndex, const uint32_t quadsPerDim,
+	std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices)
+{
+	//top left (vulk top left of screen is -1,-1 and uv 0, 0) also the front face is set to ccw
+	const float stride = 2.f / quadsPerDim;
+	out_vertices.clear();
+	out_vertices.reserve((quadsPerDim + 1)*(quadsPerDim + 1));
+	for (uint32_t y = 0; y <= quadsPerDim; ++y) {
+		for (uint32_t x = 0; x <= quadsPerDim; ++x) {
+			out_vertices.push_back(makeVertex(camIndex, glm::vec2(-1.f + x*stride, -1.f + y*stride)));
+		}
+	}
+
+	//indexing, same as Mesh::genGridMesh
+	out_indices.clear();
+	out_indices.reserve(quadsPerDim*quadsPerDim * 2 * 3);
+	for (uint32_t y = 0; y < quadsPerDim; ++y) {
+		for (uint32_t x = 0; x < quadsPerDim; ++x) {
+			const uint32_t first = y*(quadsPerDim + 1) + x;
+			out_indices.push_back(first);
+			out_indices.push_back(first + 1 + quadsPerDim + 1);
+			out_indices.push_back(first + 1);
+
+			out_indices.push_back(first + quadsPerDim + 1);
+			out_indices.push_back(first + quadsPerDim + 2);
+			out_indices.push_back(first);
+		}
+	}
+}
+
+void BarrelMeshBuilder::buildAdaptive(const uint32_t camIndex, const float maxErrorPx,
+	std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices,
+	const uint32_t baseQuadsPerDim, const uint32_t maxDepth)
+{
+	//quadtrees on an integer lattice of the finest level
+	const uint32_t rootSize = 1 << maxDepth;
+	const uint32_t N = baseQuadsPerDim * rootSize;
+	const float stride = 2.f / N;
+	out_vertices.clear();
+	out_indices.clear();
+
+	std::unordered_map<uint32_t, uint32_t> latticeToIndex;
+	auto getIndex = [&](const uint32_t x, const uint32_t y) -> uint32_t {
+		const uint32_t key = y*(N + 1) + x;
+		auto found = latticeToIndex.find(key);
+		if (found != latticeToIndex.end()) { return found->second; }
+		const uint32_t index = static_cast<uint32_t>(out_vertices.size());
+		out_vertices.push_back(makeVertex(camIndex, glm::vec2(-1.f + x*stride, -1.f + y*stride)));
+		latticeToIndex[key] = index;
+		return index;
+	};
+
+	struct Quad { uint32_t x, y, size, depth; };
+	std::vector<Quad> leaves;
+	std::vector<Quad> stack;
+	for (uint32_t y = 0; y < baseQuadsPerDim; ++y) {
+		for (uint32_t x = 0; x < baseQuadsPerDim; ++x) {
+			stack.push_back({ x*rootSize, y*rootSize, rootSize, 0 });
+		}
+	}
+	while (!stack.empty()) {
+		const Quad q = stack.back(); stack.pop_back();
+		//every corner of a split quad is a corner of one of its leaves so these are never wasted
+		const uint32_t i00 = getIndex(q.x,			q.y);
+		const uint32_t i10 = getIndex(q.x + q.size,	q.y);
+		const uint32_t i01 = getIndex(q.x,			q.y + q.size);
+		const uint32_t i11 = getIndex(q.x + q.size,	q.y + q.size);
+
+		bool split = false;
+		if (q.depth < maxDepth) {
+			const float error = std::max(
+				triangleError(camIndex, out_vertices[i00], out_vertices[i11], out_vertices[i10], 4),
+				triangleError(camIndex, out_vertices[i01], out_vertices[i11], out_vertices[i00], 4));
+			split = error > maxErrorPx;
+		}
+
+		if (split) {
+			const uint32_t h = q.size / 2;
+			stack.push_back({ q.x,		q.y,		h, q.depth + 1 });
+			stack.push_back({ q.x + h,	q.y,		h, q.depth + 1 });
+			stack.push_back({ q.x,		q.y + h,	h, q.depth + 1 });
+			stack.push_back({ q.x + h,	q.y + h,	h, q.depth + 1 });
+		} else {
+			leaves.push_back(q);
+		}
+	}
+
+	//triangulate, same winding as the uniform grid (00,11,10) (01,11,00)
+	std::vector<uint32_t> boundary;
+	auto addIfPresent = [&](const uint32_t x, const uint32_t y) {
+		auto found = latticeToIndex.find(y*(N + 1) + x);
+		if (found != latticeToIndex.end()) { boundary.push_back(found->second); }
+	};
+	out_indices.reserve(leaves.size() * 2 * 3);
+	for (const Quad& q : leaves) {
+		//walk the edge 00 -> 01 -> 11 -> 10 picking up vertices of finer neighbors
+		boundary.clear();
+		uint32_t cornerPositions[4];
+		cornerPositions[0] = static_cast<uint32_t>(boundary.size());
+		for (uint32_t t = 0; t < q.size; ++t) { addIfPresent(q.x,				q.y + t); }
+		cornerPositions[1] = static_cast<uint32_t>(boundary.size());
+		for (uint32_t t = 0; t < q.size; ++t) { addIfPresent(q.x + t,			q.y + q.size); }
+		cornerPositions[2] = static_cast<uint32_t>(boundary.size());
+		for (uint32_t t = 0; t < q.size; ++t) { addIfPresent(q.x + q.size,		q.y + q.size - t); }
+		cornerPositions[3] = static_cast<uint32_t>(boundary.size());
+		for (uint32_t t = 0; t < q.size; ++t) { addIfPresent(q.x + q.size - t,	q.y); }
+		const uint32_t n = static_cast<uint32_t>(boundary.size());
+
+		if (n == 4) {
+			const uint32_t i00 = boundary[0], i01 = boundary[1], i11 = boundary[2], i10 = boundary[3];
+			out_indices.push_back(i00); out_indices.push_back(i11); out_indices.push_back(i10);
+			out_indices.push_back(i01); out_indices.push_back(i11); out_indices.push_back(i00);
+			continue;
+		}
+
+		//finer neighbors on some edges: fan from a corner whose two edges have no extra vertices (none of the fan's
+		//triangles lie along an edge), only if every corner touches such an edge does it need a center vertex
+		uint32_t fanCorner = UINT32_MAX;
+		for (uint32_t c = 0; c < 4 && fanCorner == UINT32_MAX; ++c) {
+			const uint32_t before = (cornerPositions[c] + n - cornerPositions[(c + 3) % 4]) % n;
+			const uint32_t after = (cornerPositions[(c + 1) % 4] + n - cornerPositions[c]) % n;
+			if (before == 1 && after == 1) {
+				fanCorner = cornerPositions[c];
+			}
+		}
+
+		if (fanCorner != UINT32_MAX) {
+			for (uint32_t k = 1; k + 1 < n; ++k) {
+				out_indices.push_back(boundary[fanCorner]);
+				out_indices.push_back(boundary[(fanCorner + k) % n]);
+				out_indices.push_back(boundary[(fanCorner + k + 1) % n]);
+			}
+		} else {
+			const uint32_t center = static_cast<uint32_t>(out_vertices.size());
+			out_vertices.push_back(makeVertex(camIndex, glm::vec2(-1.f + (q.x + 0.5f*q.size)*stride,
+																  -1.f + (q.y + 0.5f*q.size)*stride)));
+			for (uint32_t i = 0; i < n; ++i) {
+				out_indices.push_back(center);
+				out_indices.push_back(boundary[i]);
+				out_indices.push_back(boundary[(i + 1) % n]);
+			}
+		}
+	}
+}
+
+uint32_t BarrelMeshBuilder::getUniformQuadsPerDim(const uint32_t camIndex, const float maxErrorPx, const uint32_t maxQuadsPerDim) {
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	float maxError, meanError;
+	for (uint32_t q = 4; q < maxQuadsPerDim; q += 2) {
+		buildUniform(camIndex, q, vertices, indices);
+		clipToLens(vertices, indices);
+		measureError(camIndex, vertices, indices, maxError, meanError);
+		if (maxError <= maxErrorPx) {
+			return q;
+		}
+	}
+	return maxQuadsPerDim;
+}
+
+void BarrelMeshBuilder::buildForError(const uint32_t camIndex, const float maxErrorPx,
+	std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices)
+{
+	buildAdaptive(camIndex, maxErrorPx, out_vertices, out_indices);
+	clipToLens(out_vertices, out_indices);
+	//the split test only samples the quad's 2 triangles, not the transition fans, and maxDepth can stop it short,
+	//so the adaptive mesh only counts if the triangles it emitted measure within maxErrorPx like the uniform grid's do
+	float maxError, meanError;
+	measureError(camIndex, out_vertices, out_indices, maxError, meanError);
+	const bool adaptiveMeetsError = maxError <= maxErrorPx;
+
+	std::vector<Vertex> uniformVertices;
+	std::vector<unsigned int> uniformIndices;
+	buildUniform(camIndex, getUniformQuadsPerDim(camIndex, maxErrorPx), uniformVertices, uniformIndices);
+	clipToLens(uniformVertices, uniformIndices);
+	if (!adaptiveMeetsError || uniformVertices.size() <= out_vertices.size()) {
+		out_vertices.swap(uniformVertices);
+		out_indices.swap(uniformIndices);
+	}
+}
+
+void BarrelMeshBuilder::buildLensRings(const uint32_t camIndex, const uint32_t rings, const uint32_t segments,
+	std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices)
+{
+	const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+	const InverseDistortion& inverse = InverseDistortion::getEye(camIndex);
+	const glm::vec2 eyeLo(0.5f*camIndex, 0.f);
+	const glm::vec2 eyeHi(0.5f*camIndex + 0.5f, 1.f);
+	const float lensVisibleTheta = getLensVisibleTheta(eye);
+
+	//the warp only scales theta so a ray from the lens center in theta is a ray in both screen and source uv,
+	//(theta/scaleIn on screen, theta*scale in the source). a ray is sampled in theta out to the closest of:
+	//the edge of the eye on screen, the edge of the eye in the source image, the visible lens circle
+	auto getMaxTheta = [&](const glm::vec2& dir) {
+		const float screenEdge = distanceToBoxEdge(eye.lensCenter, dir / eye.scaleIn, eyeLo, eyeHi);
+		const float sourceEdge = inverse.inverseRadius(distanceToBoxEdge(eye.lensCenter, dir * eye.scale, eyeLo, eyeHi));
+		return std::min(lensVisibleTheta, std::min(screenEdge, sourceEdge));
+	};
+
+	//rays evenly spaced along the outline of the visible region (in the source image, where the error is measured)
+	//plus the ones through the eye corners (screen and source) so the corners aren't cut
+	std::vector<float> angles;
+	const float twoPi = 6.28318530718f;
+	const uint32_t outlineSamples = 16 * segments;
+	std::vector<float> outlineLength(outlineSamples + 1, 0.f);
+	glm::vec2 prev;
+	for (uint32_t k = 0; k <= outlineSamples; ++k) {
+		const glm::vec2 dir(std::cos(twoPi * k / outlineSamples), std::sin(twoPi * k / outlineSamples));
+		const float r = getMaxTheta(dir);
+		const glm::vec2 p = dir * (r * glm::dot(eye.hmdWarpParam, glm::vec4(1.f, r*r, r*r*r*r, r*r*r*r*r*r)));
+		if (k > 0) { outlineLength[k] = outlineLength[k - 1] + glm::length(p - prev); }
+		prev = p;
+	}
+	for (uint32_t i = 0, k = 0; i < segments; ++i) {
+		const float target = outlineLength.back() * i / segments;
+		while (outlineLength[k + 1] < target) { ++k; }
+		const float t = (target - outlineLength[k]) / std::max(outlineLength[k + 1] - outlineLength[k], 1e-12f);
+		angles.push_back(twoPi * (k + t) / outlineSamples);
+	}
+	for (int corner = 0; corner < 4; ++corner) {
+		const glm::vec2 uv(corner & 1 ? eyeHi.x : eyeLo.x, corner & 2 ? eyeHi.y : eyeLo.y);
+		const glm::vec2 screenDir = (uv - eye.lensCenter) * eye.scaleIn;
+		const glm::vec2 sourceDir = (uv - eye.lensCenter) / eye.scale;
+		angles.push_back(std::atan2(screenDir.y, screenDir.x));
+		angles.push_back(std::atan2(sourceDir.y, sourceDir.x));
+	}
+	for (float& a : angles) { if (a < 0.f) { a += twoPi; } }
+	std::sort(angles.begin(), angles.end());
+	const float minAngleStep = 0.1f * twoPi / segments;
+	angles.erase(std::unique(angles.begin(), angles.end(),
+		[&](const float a, const float b) { return b - a < minAngleStep; }), angles.end());
+	if (angles.size() > 1 && angles.front() + twoPi - angles.back() < minAngleStep) { angles.pop_back(); }
+	const uint32_t numRays = static_cast<uint32_t>(angles.size());
+
+	//center then ring by ring, rings are evenly spaced along each ray in the source image (distorted radius)
+	//so they bunch up towards the edge where the warp bends the most
+	out_vertices.clear();
+	out_vertices.reserve(1 + rings*numRays);
+	out_vertices.push_back(makeScreenVertex(camIndex, glm::vec3((eye.lensCenter.x - 0.5f*camIndex)*4.f - 1.f, eye.lensCenter.y*2.f - 1.f, 0.5f)));
+	std::vector<float> maxRho(numRays);
+	for (uint32_t j = 0; j < numRays; ++j) {
+		const float r = getMaxTheta(glm::vec2(std::cos(angles[j]), std::sin(angles[j])));
+		maxRho[j] = r * glm::dot(eye.hmdWarpParam, glm::vec4(1.f, r*r, r*r*r*r, r*r*r*r*r*r));
+	}
+	for (uint32_t i = 1; i <= rings; ++i) {
+		for (uint32_t j = 0; j < numRays; ++j) {
+			const glm::vec2 theta = glm::vec2(std::cos(angles[j]), std::sin(angles[j])) * inverse.inverseRadius(maxRho[j] * i / rings);
+			const glm::vec2 uv = eye.lensCenter + theta / eye.scaleIn;
+			out_vertices.push_back(makeScreenVertex(camIndex, glm::vec3((uv.x - 0.5f*camIndex)*4.f - 1.f, uv.y*2.f - 1.f, 0.5f)));
+		}
+	}
+
+	//same facing as the grid (clockwise in ndc with y down on screen, front face is ccw)
+	auto ringIndex = [&](const uint32_t ring, const uint32_t ray) { return 1 + (ring - 1)*numRays + (ray % numRays); };
+	out_indices.clear();
+	out_indices.reserve(numRays * 3 + (rings - 1)*numRays * 6);
+	for (uint32_t j = 0; j < numRays; ++j) {
+		out_indices.push_back(0);
+		out_indices.push_back(ringIndex(1, j + 1));
+		out_indices.push_back(ringIndex(1, j));
+	}
+	for (uint32_t i = 1; i < rings; ++i) {
+		for (uint32_t j = 0; j < numRays; ++j) {
+			const uint32_t a0 = ringIndex(i, j),		a1 = ringIndex(i, j + 1);
+			const uint32_t b0 = ringIndex(i + 1, j),	b1 = ringIndex(i + 1, j + 1);
+			out_indices.push_back(a0); out_indices.push_back(b1); out_indices.push_back(b0);
+			out_indices.push_back(a0); out_indices.push_back(a1); out_indices.push_back(b1);
+		}
+	}
+}
+
+void BarrelMeshBuilder::clipToLens(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+	const uint32_t unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap(vertices.size(), unused);
+	std::vector<Vertex> keptVertices;
+	std::vector<unsigned int> keptIndices;
+	keptVertices.reserve(vertices.size());
+	keptIndices.reserve(indices.size());
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		if (vertices[indices[i]].color.b == 0.f && vertices[indices[i + 1]].color.b == 0.f && vertices[indices[i + 2]].color.b == 0.f) {
+			continue;
+		}
+		for (size_t k = i; k < i + 3; ++k) {
+			if (remap[indices[k]] == unused) {
+				remap[indices[k]] = static_cast<uint32_t>(keptVertices.size());
+				keptVertices.push_back(vertices[indices[k]]);
+			}
+			keptIndices.push_back(remap[indices[k]]);
+		}
+	}
+	vertices.swap(keptVertices);
+	indices.swap(keptIndices);
+}
+
+void BarrelMeshBuilder::measureError(const uint32_t camIndex, const std::vector<Vertex>& vertices,
+	const std::vector<unsigned int>& indices, float& out_maxErrorPx, float& out_meanErrorPx)
+{
+	float errorSum = 0.f;
+	uint32_t numSamples = 0;
+	out_maxErrorPx = 0.f;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		out_maxErrorPx = std::max(out_maxErrorPx, triangleError(camIndex,
+			vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], 8, &errorSum, &numSamples));
+	}
+	out_meanErrorPx = numSamples > 0 ? errorSum / numSamples : 0.f;
+}
+
+void BarrelMeshBuilder::report() {
+	//the eyes mirror each other, left is enough
+	const uint32_t camIndex = 0;
+	const glm::vec2 eyePixels(HmdProfile::get().width / 2, HmdProfile::get().height);
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	float maxError, meanError;
+
+	std::cout << "\n\nBarrelMeshBuilder report (hmd " << HmdProfile::get().width << "x" << HmdProfile::get().height
+		<< ", error in hmd pixels, camIndex 0, " << eyePixels.x*eyePixels.y << " px per eye)";
+	std::cout << "\n\tmesh\t\t\tverts\ttris\tmax err\tmean err\tpx rasterized\tbuild ms";
+
+	auto printRow = [&](const std::string& name, const double buildMs) {
+		measureError(camIndex, vertices, indices, maxError, meanError);
+		//screen area covered is the fragment count of the present pass (eye ndc is 2x2)
+		float area = 0.f;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			const glm::vec3 e0 = vertices[indices[i + 1]].pos - vertices[indices[i]].pos;
+			const glm::vec3 e1 = vertices[indices[i + 2]].pos - vertices[indices[i]].pos;
+			area += 0.5f * std::abs(e0.x*e1.y - e0.y*e1.x);
+		}
+		std::cout << "\n\t" << name << "\t" << vertices.size() << "\t" << indices.size() / 3 << "\t" << maxError
+			<< "\t" << meanError << "\t\t" << static_cast<uint32_t>(area * 0.25f * eyePixels.x*eyePixels.y) << "\t\t" << buildMs;
+	};
+	auto elapsedMs = [](const std::chrono::high_resolution_clock::time_point& start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	};
+
+	const uint32_t uniformQuads[] = { 10, 20, 40, 80 };
+	for (const uint32_t q : uniformQuads) {
+		auto start = std::chrono::high_resolution_clock::now();
+		buildUniform(camIndex, q, vertices, indices);
+		const double ms = elapsedMs(start);
+		printRow("uniform " + std::to_string(q) + "x" + std::to_string(q) + "\t", ms);
+		start = std::chrono::high_resolution_clock::now();
+		clipToLens(vertices, indices);
+		printRow("  lens clipped\t", ms + elapsedMs(start));
+	}
+
+	const float tolerances[] = { 4.f, 2.f, 1.f, 0.5f, 0.25f };
+	for (const float tol : tolerances) {
+		auto start = std::chrono::high_resolution_clock::now();
+		buildAdaptive(camIndex, tol, vertices, indices);
+		const double ms = elapsedMs(start);
+		std::stringstream name; name << "adaptive tol " << tol << "px";
+		printRow(name.str(), ms);
+		start = std::chrono::high_resolution_clock::now();
+		clipToLens(vertices, indices);
+		printRow("  lens clipped\t", ms + elapsedMs(start));
+	}
+
+	for (const float tol : tolerances) {
+		auto start = std::chrono::high_resolution_clock::now();
+		buildForError(camIndex, tol, vertices, indices);
+		std::stringstream name; name << "for error " << tol << "px";
+		printRow(name.str(), elapsedMs(start));
+	}
+
+	const uint32_t ringCounts[][2] = { { 8, 32 }, { 12, 48 }, { 16, 64 }, { 24, 96 }, { 32, 128 } };
+	for (const auto& rs : ringCounts) {
+		auto start = std::chrono::high_resolution_clock::now();
+		buildLensRings(camIndex, rs[0], rs[1], vertices, indices);
+		printRow("rings " + std::to_string(rs[0]) + "x" + std::to_string(rs[1]) + "\t", elapsedMs(start));
+	}
+	std::cout << std::endl;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Vertex.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+//Builds the per eye NDCBARRELMESH_PRECALC geometry.
+//Grid points live in the eye's source ndc, positions are warped with InverseDistortion
+//and each vertex carries its red/green/blue source uv (color.xy, uv, nor.xy)
+//color.b = 0 flags a vertex that can't be seen: green uv outside the eye or past the profile's lensVisibleRadius
+class BarrelMeshBuilder {
+public:
+	//quadsPerDim x quadsPerDim uniform grid
+	static void buildUniform(const uint32_t camIndex, const uint32_t quadsPerDim,
+		std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices);
+
+	//baseQuadsPerDim^2 quadtrees, a quad is split until linearly interpolating the 3 source uv's across it
+	//is within maxErrorPx (hmd pixels) of the analytic getSourceUV. where neighbors differ in depth the
+	//coarser quad is fanned from a corner (or its center) through all the edge vertices so there are no t-junctions
+	static void buildAdaptive(const uint32_t camIndex, const float maxErrorPx,
+		std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices,
+		const uint32_t baseQuadsPerDim = 8, const uint32_t maxDepth = 5);
+
+	//coarsest lens clipped uniform grid whose measured max error is within maxErrorPx, maxQuadsPerDim if none is
+	static uint32_t getUniformQuadsPerDim(const uint32_t camIndex, const float maxErrorPx, const uint32_t maxQuadsPerDim = 128);
+
+	//the lens clipped adaptive mesh or the lens clipped getUniformQuadsPerDim grid, whichever has fewer vertices.
+	//the adaptive mesh is only kept if measureError puts it within maxErrorPx.
+	//the warp's error is smooth enough over most of the eye that the quadtree's transitions can cost more than they save
+	static void buildForError(const uint32_t camIndex, const float maxErrorPx,
+		std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices);
+
+	//rings x segments polar mesh about the lens center, each ray ends where it first leaves the eye,
+	//the source image or the visible lens circle so nothing outside the visible region is rasterized
+	static void buildLensRings(const uint32_t camIndex, const uint32_t rings, const uint32_t segments,
+		std::vector<Vertex>& out_vertices, std::vector<unsigned int>& out_indices);
+
+	//drops triangles whose 3 vertices are all flagged (color.b == 0) and any vertices left unused
+	static void clipToLens(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	//densely samples every triangle, compares interpolated vs analytic source uv's (visible region only)
+	static void measureError(const uint32_t camIndex, const std::vector<Vertex>& vertices,
+		const std::vector<unsigned int>& indices, float& out_maxErrorPx, float& out_meanErrorPx);
+
+	//prints vertex count vs max/mean uv error for a range of tolerances (adaptive and buildForError) and the uniform grids
+	static void report();
+
+private:
+	//gridNDC is where the green channel should sample, screenNDC is where the vertex goes
+	static Vertex makeVertex(const uint32_t camIndex, const glm::vec2& gridNDC);
+	static Vertex makeScreenVertex(const uint32_t camIndex, const glm::vec3& screenNDC);
+	static float triangleError(const uint32_t camIndex, const Vertex& a, const Vertex& b, const Vertex& c,
+		const uint32_t samplesPerEdge, float* out_errorSum = nullptr, uint32_t* out_numSamples = nullptr);
+};
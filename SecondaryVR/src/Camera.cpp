@@ -94,8 +94,10 @@ void Camera::updateQualitySettings(const bool increase) {
 
 void Camera::updateDimensions(const VkExtent2D& swapChainExtent) {
 	const float scale = vrmode ? 0.5f : 1.f;
-	width = hmdWidth * scale * (vrmode ? vrScalings[qualityIndex] : 1.f);
-	height = hmdHeight * (vrmode ? vrScalings[qualityIndex] : 1.f);
+	//the distorted image is already at panel scale, only the lower quality levels shrink it
+	const float vrScaling = usesDistortedForward() ? glm::min(vrScalings[qualityIndex], 1.f) : vrScalings[qualityIndex];
+	width = HmdProfile::get().width * scale * (vrmode ? vrScaling : 1.f);
+	height = HmdProfile::get().height * (vrmode ? vrScaling : 1.f);
 
 	//ensure that dims are even to avoid stencil issues
 	width  = ((width  & 1) == 1) && !vrmode ? width  - 1 : width;
@@ -140,4 +142,32 @@ void Camera::timeWarpFinishInit(const uint32_t imageIndex) {
 	timewarpInitFlag = false;
 	timeWarpInvVP[0] = glm::inverse(proj * view[0]);
 	timeWarpInvVP[1] = glm::inverse(proj * view[1]);
-}
\ No newline at end of file
+}
+
+bool Camera::usesStencilLoading() const {
+	return vrmode && useStencil && !hiddenAreaMeshMask && !usesDistortedForward();
+}
+
+bool Camera::usesHiddenAreaMesh() const {
+	return vrmode && useStencil && hiddenAreaMeshMask && !usesDistortedForward();
+}
+
+bool Camera::usesDistortedForward() const {
+	return vrmode && distortedForward && !timewarp;
+}
+
+uint32_t Camera::getStencilTestBit() const {
+	//the stencil-less passes clear the stencil to 1, HiddenAreaMesh draws the current phase's mask over that
+	return (temporalCheckerStencil && usesStencilLoading()) ? 1u << stencilPhase : 1u;
+}
+
+void Camera::finishTemporalFrame(const uint32_t imageIndex) {
+	stencilPhase ^= 1;
+	lastForwardImageIndex = imageIndex;
+	lastViewProj[0] = proj * view[0];
+	lastViewProj[1] = proj * view[1];
+}
+
+void Camera::resetTemporalHistory() {
+	lastForwardImageIndex = UINT32_MAX;
+}
@@ -5,6 +5,7 @@
 #endif // !GLFW_INCLUDE_VULKAN
 
 #include "GlobalSettings.h"
+#include "HmdProfile.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <array>
@@ -34,6 +35,10 @@ public:
 	std::vector<float> vrScalings;
 
 	bool useStencil = true;
+	//forward + SubpassHoleFill in one render pass, the pp chain samples its packed output (startSubpassHoleFill)
+	bool subpassHoleFill = startSubpassHoleFill && !temporalCheckerStencil;
+	//forward pipelines warp straight into lens space, no vr stencil or barrel stage (startDistortedForward, DistortedForward)
+	bool distortedForward = startDistortedForward && !temporalCheckerStencil;
 
 	//Time Warp State
 	bool timewarpCleanUp = false;
@@ -43,6 +48,10 @@ public:
 	glm::vec3 rightCamPosTimeWarp;
 	std::array<glm::mat4, 2> timeWarpInvVP;
 
+	//Temporal Checker Stencil State (temporalCheckerStencil)
+	uint32_t stencilPhase = 0;//flips every forward rendered frame, see getStencilTestBit
+	uint32_t lastForwardImageIndex = UINT32_MAX;//swap image the last frame was forward rendered to, UINT32_MAX if there's no usable one
+	std::array<glm::mat4, 2> lastViewProj;//and the view projections it was rendered with
 
 
 
@@ -51,8 +60,8 @@ public:
 	//float width = 1280;
 	//float height = 800;
 	//DK1 virtual 1.4x(barrel will shrink to down)
-	uint32_t width = hmdWidth;
-	uint32_t height = hmdHeight;
+	uint32_t width = HmdProfile::get().width;
+	uint32_t height = HmdProfile::get().height;
 	VkExtent2D renderTargetExtent = {width, height};
 	//HALF modern
 	//float width = 1080;
@@ -85,6 +94,22 @@ public:
 	void updateTimeWarpState();
 	void timeWarpFinishInit(const uint32_t imageIndex);
 
+	//vr stencil masking
+	//forward pass loads the vr stencil from the depth image (renderPassStencilLoading)
+	bool usesStencilLoading() const;
+	//forward pass clears the stencil and HiddenAreaMesh masks it (hiddenAreaMeshMask)
+	bool usesHiddenAreaMesh() const;
+	//forward pipelines draw the distorted image (distortedForward), time warp needs an undistorted one to reproject
+	bool usesDistortedForward() const;
+
+	//temporal checker stencil
+	//stencil bit the forward pass tests (compare mask and reference), 1 unless the vr stencil is alternating
+	uint32_t getStencilTestBit() const;
+	//after a frame is forward rendered: next phase, remember what the hole fill's history will be
+	void finishTemporalFrame(const uint32_t imageIndex);
+	//nothing to reproject from next frame (swap chain recreated, time warp frames)
+	void resetTemporalHistory();
+
 	void updateDimensions(const VkExtent2D& swapChainExtent);
 	void updatePerspectiveProjection();
 };
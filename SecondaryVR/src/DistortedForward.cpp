@@ -0,0 +1,126 @@
+#pragma once
+#include "DistortedForward.h"
+#include "VulkanContextInfo.h"
+#include "InverseDistortion.h"
+#include "GlobalSettings.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+
+DistortedForwardSpecializationData DistortedForward::getSpecializationData(const VulkanContextInfo& contextInfo) {
+	DistortedForwardSpecializationData data;
+	data.hmd = HmdProfile::get().getSpecializationData();
+	data.eyeExtent[0] = static_cast<float>(contextInfo.camera.width);
+	data.eyeExtent[1] = static_cast<float>(contextInfo.camera.height);
+	data.tessEdgePixels = distortedForwardTessEdgePixels;
+	return data;
+}
+
+std::vector<VkSpecializationMapEntry> DistortedForward::getSpecializationMapEntries() {
+	static_assert(sizeof(DistortedForwardSpecializationData) == DistortedForwardSpecializationData::NUM_CONSTANTS * sizeof(float),
+		"DistortedForwardSpecializationData must be tightly packed floats");
+	std::vector<VkSpecializationMapEntry> entries(DistortedForwardSpecializationData::NUM_CONSTANTS);
+	for (uint32_t i = 0; i < DistortedForwardSpecializationData::NUM_CONSTANTS; ++i) {
+		entries[i].constantID = i;
+		entries[i].offset = i * sizeof(float);
+		entries[i].size = sizeof(float);
+	}
+	return entries;
+}
+
+float DistortedForward::getInitialRadius(const glm::vec4& hmdWarpParam, const float rho) {
+	const float kAtOne = hmdWarpParam.x + hmdWarpParam.y + hmdWarpParam.z + hmdWarpParam.w;
+	return std::min(rho, std::pow(rho / kAtOne, 1.f / 3.f));
+}
+
+glm::vec2 DistortedForward::warpNDC(const EyeDistortionConstants& eye, const glm::vec2& ndc, const uint32_t camIndex,
+	const uint32_t newtonSteps)
+{
+	//same steps as warpNDC in forwardDistorted.tese/.vert
+	const glm::vec2 uv((ndc.x + 1.f)*0.25f + 0.5f*camIndex, (ndc.y + 1.f)*0.5f);
+	const glm::vec2 theta1 = (uv - eye.lensCenter) / eye.scale;
+	const float rho = glm::length(theta1);
+	if (rho < 1e-6f) {
+		return ndc;
+	}
+
+	const glm::vec4& k = eye.hmdWarpParam;
+	float r = getInitialRadius(k, rho);
+	for (uint32_t i = 0; i < newtonSteps; ++i) {
+		const float rSq = r*r;
+		const float err = r*(k.x + rSq*(k.y + rSq*(k.z + rSq*k.w))) - rho;
+		const float deriv = k.x + rSq*(3.f*k.y + rSq*(5.f*k.z + rSq*7.f*k.w));
+		r -= err / deriv;
+	}
+
+	const glm::vec2 warped = eye.lensCenter + theta1 * (r / rho) / eye.scaleIn;
+	return glm::vec2((warped.x - 0.5f*camIndex)*4.f - 1.f, warped.y*2.f - 1.f);
+}
+
+void DistortedForward::report(const VulkanContextInfo& contextInfo) {
+	const uint32_t hmdWidth = HmdProfile::get().width;
+	const uint32_t hmdHeight = HmdProfile::get().height;
+	const glm::vec2 toPixels(hmdWidth, hmdHeight);
+	//eye ndc -> panel pixels
+	const glm::vec2 ndcToPixels(0.25f * hmdWidth, 0.5f * hmdHeight);
+	const uint32_t gridSize = 128;
+
+	std::cout << "\n\nDistortedForward report (tessellation shaders: " << (contextInfo.tessellationShader ? "yes" : "no, per vertex warp") << ")";
+
+	//error is how far the barrel stage's forward warp of the warped point lands from it, like InverseDistortion::benchmark
+	std::cout << "\n\tnewton steps\tmax warp error px (left, right)";
+	for (uint32_t steps = 1; steps <= 5; ++steps) {
+		std::cout << "\n\t" << steps << (steps == WARP_NEWTON_STEPS ? " (shaders)" : "\t");
+		for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+			const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+			float maxError = 0.f;
+			glm::vec2 tcRed, tcGreen, tcBlue;
+			for (uint32_t y = 0; y < gridSize; ++y) {
+				for (uint32_t x = 0; x < gridSize; ++x) {
+					const glm::vec2 ndc((x + 0.5f) / gridSize * 2.f - 1.f, (y + 0.5f) / gridSize * 2.f - 1.f);
+					const glm::vec2 target((ndc.x + 1.f)*0.25f + 0.5f*camIndex, (ndc.y + 1.f)*0.5f);
+					const glm::vec2 warped = warpNDC(eye, ndc, camIndex, steps);
+					LensDistortion::getSourceUV(eye, glm::vec2((warped.x + 1.f)*0.25f + 0.5f*camIndex, (warped.y + 1.f)*0.5f),
+						tcRed, tcGreen, tcBlue);
+					maxError = std::max(maxError, glm::length((tcGreen - target)*toPixels));
+				}
+			}
+			std::cout << "\t" << maxError;
+		}
+	}
+
+	//a straight edge is rasterized straight between its warped ends, the lens would have bent it through the warped midpoint.
+	//tessellated edges are pieces of about distortedForwardTessEdgePixels, so that row is the tessellated error
+	const EyeDistortionConstants& left = LensDistortion::getEyeConstants(0);
+	const glm::vec2 directions[4] = { glm::vec2(1.f, 0.f), glm::vec2(0.f, 1.f), glm::normalize(glm::vec2(1.f, 1.f)), glm::normalize(glm::vec2(1.f, -1.f)) };
+	std::cout << "\n\tedge px (pre warp)\tmax straight edge error px (tessellated edges are pieces of " << distortedForwardTessEdgePixels << " px)";
+	for (float edgePixels = 4.f; edgePixels <= 128.f; edgePixels *= 2.f) {
+		float maxError = 0.f;
+		for (uint32_t y = 0; y < gridSize; ++y) {
+			for (uint32_t x = 0; x < gridSize; ++x) {
+				const glm::vec2 mid((x + 0.5f) / gridSize * 2.f - 1.f, (y + 0.5f) / gridSize * 2.f - 1.f);
+				for (const glm::vec2& direction : directions) {
+					const glm::vec2 halfEdge = 0.5f * edgePixels * direction / ndcToPixels;
+					const glm::vec2 chordMid = 0.5f * (warpNDC(left, mid - halfEdge, 0) + warpNDC(left, mid + halfEdge, 0));
+					maxError = std::max(maxError, glm::length((warpNDC(left, mid, 0) - chordMid) * ndcToPixels));
+				}
+			}
+		}
+		std::cout << "\n\t" << edgePixels << "\t\t\t" << maxError;
+	}
+
+	//what the forward pass writes and the pp chain reads back per frame, panel sized vs vrScalings' oversized target
+	const Camera& camera = contextInfo.camera;
+	std::cout << "\n\tlevel\tundistorted target px\tpp passes\tdistorted target px\tpp passes";
+	for (int i = 0; i < camera.numQualitySettings; ++i) {
+		const float scaling = camera.vrScalings[i];
+		const uint64_t undistorted = static_cast<uint64_t>(hmdWidth * scaling) * static_cast<uint64_t>(hmdHeight * scaling);
+		const float distortedScaling = std::min(scaling, 1.f);
+		const uint64_t distorted = static_cast<uint64_t>(hmdWidth * distortedScaling) * static_cast<uint64_t>(hmdHeight * distortedScaling);
+		std::cout << "\n\t" << i << "\t" << undistorted << "\t\t\t" << allShaders_PostProcessPipelines.size() << "\t\t"
+			<< distorted << "\t\t\t" << distortedShaders_PostProcessPipelines.size();
+	}
+	std::cout << std::endl;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include "HmdProfile.h"
+#include "LensDistortion.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+class VulkanContextInfo;
+
+//the forward pipelines' specialization constants in direct to distorted mode, HmdSpecializationData then the tessellation ones
+//the member order IS the constant_id (see forwardDistorted.tesc/.tese/.vert)
+struct DistortedForwardSpecializationData {
+	HmdSpecializationData hmd;	//0-14
+	float eyeExtent[2];			//15-16 forward target pixels per eye
+	float tessEdgePixels;		//17    distortedForwardTessEdgePixels
+
+	static const uint32_t NUM_CONSTANTS = HmdSpecializationData::NUM_CONSTANTS + 3;
+};
+
+//Direct to distorted forward rendering (Camera::distortedForward): the forward pipelines move every vertex to where the
+//barrel stage would have shown it, so the forward pass draws the lens space image (green channel) and the pp chain is one
+//present stage (distortedShaders_PostProcessPipelines) instead of the vr stencil, hole fill and barrel resample.
+//with tessellation shaders forward.vert's triangles are split by projected edge length (forwardDistorted.tesc) and
+//forwardDistorted.tese warps the new vertices, without them forwardDistorted.vert warps the mesh's own vertices.
+//this is the cpu side of the shaders' warp, to check it against InverseDistortion
+class DistortedForward {
+public:
+	static const uint32_t WARP_NEWTON_STEPS = 3;//forwardDistorted.tese/.vert
+	static const uint32_t MAX_TESS_LEVEL = 64;//forwardDistorted.tesc, the smallest maxTessellationGenerationLevel allowed
+
+	static DistortedForwardSpecializationData getSpecializationData(const VulkanContextInfo& contextInfo);
+	static std::vector<VkSpecializationMapEntry> getSpecializationMapEntries();
+
+	//eye ndc the barrel stage samples -> eye ndc of the pixel that samples it (InverseDistortion::inverseNDC) with a fixed
+	//number of newton steps and no table, what the shaders run per vertex
+	static glm::vec2 warpNDC(const EyeDistortionConstants& eye, const glm::vec2& ndc, const uint32_t camIndex,
+		const uint32_t newtonSteps = WARP_NEWTON_STEPS);
+	//newton start for r*k(r^2) = rho: rho itself near the center, the cube root of rho/k(1) once that's smaller
+	//(past r = 1 the higher terms take over and starting from rho needs far more steps)
+	static float getInitialRadius(const glm::vec4& hmdWarpParam, const float rho);
+
+	//shader warp error vs InverseDistortion per newton step count, how far an untessellated straight edge of a given
+	//length in eye pixels is from its warped curve, and the offscreen forward target per quality level vs the pp barrel chain
+	static void report(const VulkanContextInfo& contextInfo);
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include "DistortionLUT.h"
+#include "LensDistortion.h"
+#include "HmdProfile.h"
+
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+
+void DistortionLUT::bake(const VkExtent2D& eyeExtent, std::vector<glm::vec4>& out_texels) {
+	//left eye, pixel centers of the present viewport mapped to absolute screen uv (0-.5 in x)
+	const uint32_t camIndex = 0;
+	const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+	const uint32_t width = eyeExtent.width;
+	const uint32_t height = eyeExtent.height;
+	out_texels.resize(width*height);
+
+	std::vector<float> rowU(width);
+	std::vector<float> rowV(width);
+	for (uint32_t x = 0; x < width; ++x) {
+		rowU[x] = (x + 0.5f) / width * 0.5f + 0.5f*camIndex;
+	}
+
+	SourceUVBatch rowSourceUVs;
+	rowSourceUVs.resize(width);
+	for (uint32_t y = 0; y < height; ++y) {
+		std::fill(rowV.begin(), rowV.end(), (y + 0.5f) / height);
+		LensDistortion::getSourceUVBatch(eye, rowU.data(), rowV.data(), width, rowSourceUVs);
+
+		for (uint32_t x = 0; x < width; ++x) {
+			//chromatic scales are (c0 + c1 rSq) and (c2 + c3 rSq) of the green channel's lens space offset
+			const glm::vec2 theta = (glm::vec2(rowU[x], rowV[x]) - eye.lensCenter) * eye.scaleIn;
+			const float rSq = glm::dot(theta, theta);
+			glm::vec4& texel = out_texels[y*width + x];
+			texel.x = rowSourceUVs.greenU[x] - rowU[x];
+			texel.y = rowSourceUVs.greenV[x] - rowV[x];
+			texel.z = eye.chromAbParam.x + eye.chromAbParam.y*rSq - 1.f;
+			texel.w = eye.chromAbParam.z + eye.chromAbParam.w*rSq - 1.f;
+		}
+	}
+}
+
+void DistortionLUT::bakeHalf(const VkExtent2D& eyeExtent, std::vector<uint64_t>& out_halfTexels) {
+	std::vector<glm::vec4> texels;
+	bake(eyeExtent, texels);
+
+	out_halfTexels.resize(texels.size());
+	for (size_t i = 0; i < texels.size(); ++i) {
+		out_halfTexels[i] = glm::packHalf4x16(texels[i]);
+	}
+}
+
+VulkanImage DistortionLUT::createImage(const VulkanContextInfo& contextInfo, const VkExtent2D& eyeExtent) {
+	//baked for the panel's eye resolution, upload straight from the mapping
+	const HmdBakeEntry* baked = contextInfo.bakeBundle.find(HmdBakeType::DISTORTION_LUT, 0);
+	if (baked && baked->width == eyeExtent.width && baked->height == eyeExtent.height) {
+		return VulkanImage(eyeExtent, format, contextInfo.bakeBundle.getData(*baked), baked->size, contextInfo);
+	}
+
+	std::vector<uint64_t> halfTexels;
+	bakeHalf(eyeExtent, halfTexels);
+	return VulkanImage(eyeExtent, format, halfTexels.data(), halfTexels.size() * sizeof(uint64_t), contextInfo);
+}
+
+void DistortionLUT::report() {
+	const uint32_t hmdWidth = HmdProfile::get().width;
+	const uint32_t hmdHeight = HmdProfile::get().height;
+	const VkExtent2D eyeExtent = { hmdWidth / 2, hmdHeight };
+	const glm::vec2 toPixels(hmdWidth, hmdHeight);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<glm::vec4> texels;
+	bake(eyeExtent, texels);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	std::cout << "\n\nDistortionLUT report (" << eyeExtent.width << "x" << eyeExtent.height << " per eye, RGBA16F, "
+		<< texels.size() * 8 / 1024 << " KB)";
+	std::cout << "\n\tbake: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+
+	for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+		const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+		float maxError = 0.f;
+		double errorSum = 0.0;
+		uint32_t count = 0;
+		glm::vec2 tcRed, tcGreen, tcBlue;
+		for (uint32_t y = 0; y < eyeExtent.height; ++y) {
+			for (uint32_t x = 0; x < eyeExtent.width; ++x) {
+				const glm::vec2 oTexCoord((x + 0.5f) / eyeExtent.width * 0.5f + 0.5f*camIndex, (y + 0.5f) / eyeExtent.height);
+				LensDistortion::getSourceUV(eye, oTexCoord, tcRed, tcGreen, tcBlue);
+				if (glm::any(glm::greaterThan(glm::abs(glm::vec2((tcGreen.x - 0.5f*camIndex)*4.f - 1.f, tcGreen.y*2.f - 1.f)), glm::vec2(1.f)))) {
+					continue;//black anyway
+				}
+
+				//same as the shader: right eye fetches the mirrored texel and flips x
+				const uint32_t lutX = (camIndex == 1) ? eyeExtent.width - 1 - x : x;
+				const glm::vec4 texel = glm::unpackHalf4x16(glm::packHalf4x16(texels[y*eyeExtent.width + lutX]));
+				const glm::vec2 mirror((camIndex == 1) ? -1.f : 1.f, 1.f);
+				const glm::vec2 lutGreen = oTexCoord + mirror*glm::vec2(texel.x, texel.y);
+				const glm::vec2 lutRed = eye.lensCenter + (lutGreen - eye.lensCenter)*(1.f + texel.z);
+				const glm::vec2 lutBlue = eye.lensCenter + (lutGreen - eye.lensCenter)*(1.f + texel.w);
+
+				const float error = std::max(glm::length((lutRed - tcRed)*toPixels),
+									std::max(glm::length((lutGreen - tcGreen)*toPixels),
+											 glm::length((lutBlue - tcBlue)*toPixels)));
+				maxError = std::max(maxError, error);
+				errorSum += error;
+				++count;
+			}
+		}
+		std::cout << "\n\tcamIndex " << camIndex << ": max error " << maxError << " px, mean error "
+			<< (count > 0 ? errorSum / count : 0.0) << " px";
+	}
+	std::cout << std::endl;
+}
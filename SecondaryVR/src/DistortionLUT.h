@@ -0,0 +1,32 @@
+#pragma once
+#include "VulkanImage.h"
+#include "VulkanContextInfo.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+//Baked barrel/aberration lookup for the present pass (ppBarrelAbLUT.frag).
+//One texel per present pixel of the LEFT eye (the right eye is its mirror image), RGBA16F:
+//	xy: tcGreen - oTexCoord (absolute screen uv)
+//	z:  red chromatic scale - 1, tcRed  = LensCenter + (tcGreen - LensCenter) * (1 + z)
+//	w:  blue chromatic scale - 1, tcBlue = LensCenter + (tcGreen - LensCenter) * (1 + w)
+//so the frag shader does one fetch and three samples instead of the warp polynomial.
+//offsets and scale - 1 are kept small so half floats hold them well (see report())
+class DistortionLUT {
+public:
+	static const VkFormat format = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+	//eyeExtent is the present resolution of one eye, out_texels is eyeExtent.width*eyeExtent.height vec4's
+	static void bake(const VkExtent2D& eyeExtent, std::vector<glm::vec4>& out_texels);
+
+	//bake packed to half4's (glm::packHalf4x16), the texel data the image is made from
+	static void bakeHalf(const VkExtent2D& eyeExtent, std::vector<uint64_t>& out_halfTexels);
+
+	//bakes and uploads, one image shared by both eyes. call again when the swapchain changes size
+	//uses the HmdBakeBundle's texels if it has them for this extent
+	static VulkanImage createImage(const VulkanContextInfo& contextInfo, const VkExtent2D& eyeExtent);
+
+	//reconstructs source uv's from the half float texels the way the shader does and compares
+	//to getSourceUV for both eyes, prints max/mean error in hmd pixels and bake time
+	static void report();
+};
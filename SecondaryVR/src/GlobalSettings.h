@@ -11,11 +11,61 @@
 #include <string>
 
 
-//const float hmdWidth = 1080;
-//const float hmdHeight = 600;
-
-const uint32_t hmdWidth = 1280;
-const uint32_t hmdHeight = 800;
+//headset panel, lens and stencil values (see HmdProfile), falls back to the dk1 preset if the file isn't there
+//res/hmd/hd2160x1200.hmd for a modern 2160x1200 headset
+const std::string hmdProfilePath = "res/hmd/dk1.hmd";
+//<profile name>.hmdbake goes here, stencils/meshes/luts baked for the profile (see HmdBakeBundle), rebaked when stale
+const std::string hmdBakeBundleDir = "res/hmd/";
+//write the radial density/fixed foveated stencil with a draw on the gpu (StencilGenerator) instead of uploading the cpu/baked mask
+const bool generateStencilOnGPU = false;
+//vr forward pass stencil masks (PreMadeStencil)
+enum class StencilType {
+	RadialDensityMask = 0, FixedFoveated, 
+	PreCalcBarrelSamplingMask
+};
+const uint32_t NUM_STENCIL_TYPES = 3;
+//the one the vr depth image starts with, B cycles through them at runtime
+const StencilType startVrStencilType = StencilType::RadialDensityMask;
+//fixed foveated stencil rings, innermost first (at most PreMadeStencil::MAX_RINGS): eye ndc radius the ring reaches out to
+//and its density shift, the ring shades 1 in 2^shift quads (0 all, 1 half, 2 quarter, 3 eighth, see PreMadeStencil::quadShaded).
+//nothing past the lens edge is shaded so the last ring can just reach past it. quality level i uses
+//fixedFoveatedLevels[min(i, size - 1)], so stepping the adaptive quality steps the rings along with the resolution scale
+const std::vector< std::vector< std::pair<float, uint32_t> > > fixedFoveatedLevels =
+{
+	{{0.55f, 0}, {0.8f, 1}, {2.f, 2}},
+	{{0.45f, 0}, {0.7f, 1}, {2.f, 2}},
+	{{0.4f, 0}, {0.6f, 1}, {0.85f, 2}, {2.f, 3}},
+	{{0.3f, 0}, {0.5f, 1}, {0.7f, 2}, {2.f, 3}},
+};
+//checker rings (density shift 1) of the vr stencil shade the other half of their quads every other frame: stencil bit 0 is the
+//even frames' mask, bit 1 the odd frames' (PreMadeStencil::alternateMask). the hole fill stage becomes ppStencilHoleFillTemporal.frag,
+//it fills a checker hole from its previous output reprojected with last frame's view projection and only falls back to the
+//spatial fill on disocclusion. the quarter and eighth density rings stay put and are still filled spatially
+const bool temporalCheckerStencil = false;
+//mask the vr forward pass with HiddenAreaMesh instead of a stencil image: the forward pass clears the stencil and starts by drawing
+//rectangles over the quads the stencil masks out (checker runs discard every other quad), writing 0 where the pipelines test for 1.
+//every quality level's (and temporal phase's) rectangles are in one vertex buffer made with the stencils, so the depth image
+//is a plain attachment with no upload and changing quality or phase only picks another draw range
+const bool hiddenAreaMeshMask = false;
+//forward rendering and the per pixel part of the hole fill as 2 subpasses of the forward render pass (SubpassHoleFill): the second
+//reads the forward color as an input attachment and writes the rendered pixels to a target the pp chain samples instead of
+//the forward image, so the forward color stays in tile memory on tile based gpus (transient, lazily allocated where the driver can).
+//the holes need their neighbours so they're still filled by the pp chain, a raster hole fill first stage does it in place
+//(holesOnlyFragShaders_PostProcessPipelines): only the holes are written. H toggles it at runtime, startSubpassHoleFill picks
+//the one it starts with. not with temporalCheckerStencil, its hole fill reprojects the forward image of the last frame
+const bool startSubpassHoleFill = false;
+//SubpassHoleFill's output as B10G11R11_UFLOAT_PACK32 (4 bytes a pixel) instead of the forward color's R16G16B16A16_SFLOAT (8),
+//where the device renders to and samples it. halves what the subpass stores and the pp chain reads back, but there's no alpha
+//(reads as 1), no negatives and 6/6/5 mantissa bits instead of 10, so dark gradients can band before the barrel resample
+const bool subpassHoleFillPackedOutput = false;
+//forward render straight into lens space (DistortedForward): the forward pipelines move every vertex where the barrel stage would
+//have shown it, tessellated by projected edge length where the device has tessellation shaders (per vertex otherwise), so there's
+//no vr stencil, hole fill or barrel resample and the forward target is panel sized instead of vrScalings' oversized one.
+//the pp chain is distortedShaders_PostProcessPipelines. L toggles it in vr mode (not while time warping, that reprojects an
+//undistorted frame), startDistortedForward picks the one it starts with. not with temporalCheckerStencil, there's no stencil
+const bool startDistortedForward = false;
+//a patch edge is split into pieces about this many eye pixels long before the warp bends them (forwardDistorted.tesc)
+const float distortedForwardTessEdgePixels = 16.f;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////// THESE ARE THE SHADERS A MESH CAN RUN BASED ON ITS MATERIAL FLAGS (DIFFUSE NORMAL HEIGHT SPEC)///////////
@@ -66,6 +116,60 @@ const std::vector< std::pair<std::vector<std::string>, uint32_t> > allShaders_Fo
 	HAS_SPEC | HAS_HEIGHT | HAS_NOR | HAS_DIFFUSE},
 };
 
+//DistortedForward's forward stages: with tessellation shaders these go between forward.vert and the frag,
+//without them the per vertex warp replaces forward.vert
+const std::vector<std::string> distortedTessShaders_ForwardPipelines =
+{
+	"src/shaders/forwardDistorted.tesc.spv",
+	"src/shaders/forwardDistorted.tese.spv",
+};
+const std::string distortedVertexShader_ForwardPipelines = "src/shaders/forwardDistorted.vert.spv";
+
+//pp vertex shaders that read PostProcessPreCalcVertex's (precalc r g b source uv's) and draw the precalc barrel meshes,
+//every other pp vertex shader only reads the PostProcessVertex position (see Vertex.h)
+const std::vector<std::string> preCalcVertexShaders_PostProcessPipelines =
+{
+	"src/shaders/ppBarrelAbMeshPreCalc.vert.spv",
+};
+
+//pp vertex shaders that draw the ndc barrel grid mesh, the rest of the buffer backed ones draw the ndc triangle
+const std::vector<std::string> gridVertexShaders_PostProcessPipelines =
+{
+	"src/shaders/ppBarrelAbMesh.vert.spv",
+	"src/shaders/ppBarrelAbMesh2.vert.spv",
+	"src/shaders/ppTimeWarp.vert.spv",
+};
+
+//pp vertex shaders that make their geometry from gl_VertexIndex and the push constants,
+//no vertex buffer is bound and no pp mesh is built for them. the flag is what gets drawn per eye
+const uint32_t PP_GEOMETRY_MESH		= 0;//vertex (and index) buffer of one of the pp meshes
+const uint32_t PP_GEOMETRY_TRIANGLE	= 1;//3 vertices, fullscreen triangle (ppPassthrough.vert)
+const uint32_t PP_GEOMETRY_GRID		= 2;//gridQuadsPerDim^2 quads, 6 vertices each (ndc barrel grid)
+const uint32_t PP_GEOMETRY_POINTS	= 3;//a point per eye pixel of the render target (ndc pixel points)
+const std::vector< std::pair<std::string, uint32_t> > proceduralVertexShaders_PostProcessPipelines =
+{
+	{"src/shaders/ppFullscreenTriangle.vert.spv", PP_GEOMETRY_TRIANGLE},
+	{"src/shaders/ppTimeWarpGrid.vert.spv", PP_GEOMETRY_GRID},
+	{"src/shaders/ppTimeWarpPoints.vert.spv", PP_GEOMETRY_POINTS},
+	{"src/shaders/ppTimeWarpBarrelAb.vert.spv", PP_GEOMETRY_TRIANGLE},
+};
+
+//pp fragment shaders whose second image input is the vr stencil's HoleFillClassification, any other stage with 2 gets the DistortionLUT
+const std::vector<std::string> classificationFragShaders_PostProcessPipelines =
+{
+	"src/shaders/ppStencilHoleFillClassified.frag.spv",
+};
+
+//pp fragment shaders that fill the holes in place as the first stage with camera.subpassHoleFill (PipelineType::HOLES_ONLY):
+//the forward render pass already stored the rendered pixels in SubpassHoleFill's output, so the stage loads it and its stencil
+//test only lets the holes through instead of writing every pixel again to a target of its own
+const std::vector<std::string> holesOnlyFragShaders_PostProcessPipelines =
+{
+	"src/shaders/ppStencilHoleFill.frag.spv",
+	"src/shaders/ppStencilHoleFillPrefetch.frag.spv",
+	"src/shaders/ppStencilHoleFillClassified.frag.spv",
+};
+
 ///////////////////////////////////////////////////////////////////////
 ///////// THESE ARE THE PP STAGES THEY SHOULD PROCEED IN ORDER ////////
 ///////// EACH WILL PROCESS THE PREVIOUS STAGES OUTPUT ////////////////
@@ -75,57 +179,145 @@ const std::vector< std::pair<std::vector<std::string>, uint32_t> > allShaders_Fo
 
 //name of shaders and number of input sampler images
 //TODO: PostProcessPipeline should have a struct that has all needed config parameters to set up the instance
-//SHADER PATHS,  num image inputs(should be vector of source stages), typeFlags (0 is normal ,1 is timewarp)
+//SHADER PATHS,  num image inputs(binding 0 is the stage before, PostProcessGraph wires them), typeFlags (0 is normal ,1 is timewarp, 2 is temporal hole fill, 3 is compute)
 const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > allShaders_PostProcessPipelines =
 {
 	////PASSTHROUGH
-	//{{"src/shaders/ppPassthrough.vert.spv",
+	//{{"src/shaders/ppFullscreenTriangle.vert.spv",
 	//"src/shaders/ppPassthrough.frag.spv"},
 	//1, 0}, //1 is num input sampler images to this pp stage
 
-	////STENCIL HOLE FILL
-	{{"src/shaders/ppPassthrough.vert.spv",
-	"src/shaders/ppStencilHoleFill.frag.spv"},
-	1, 0}, 
+	////STENCIL HOLE FILL (ppPassthrough.vert is the same triangle from the ndcTriangle mesh)
+	//temporal (typeFlags 2) reads this frame's and the previous frame's images, the depth and a ubo, has to be the first stage
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	temporalCheckerStencil ? "src/shaders/ppStencilHoleFillTemporal.frag.spv" : "src/shaders/ppStencilHoleFill.frag.spv"},
+	1, temporalCheckerStencil ? 2u : 0u}, 
 
-	//////BARREL/ABERRATION ALL IN FRAG 
-	{{"src/shaders/ppPassthrough.vert.spv",
+	////STENCIL HOLE FILL PREFETCH, the checkerboard ring's taps come from one 4x4 fetch per pixel
+	//{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	//"src/shaders/ppStencilHoleFillPrefetch.frag.spv"},
+	//1, 0},
+
+	////STENCIL HOLE FILL CLASSIFIED (HoleFillClassification, 2nd image input), one fetch picks the taps instead of the ring math
+	//{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	//"src/shaders/ppStencilHoleFillClassified.frag.spv"},
+	//2, 0},
+
+	//////BARREL/ABERRATION, the last stage is distortionTechniques_PostProcessPipelines' pick at runtime
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
 	"src/shaders/ppBarrelAbFragCommonUse.frag.spv"},
 	1, 0},
+};
 
-	//BARREL/ABERRATION PRECALC MESH
-	//{{"src/shaders/ppBarrelAbMeshPreCalc.vert.spv",
-	//"src/shaders/ppBarrelAbMeshPreCalc.frag.spv"},
-	//1, 0},
+//the barrel/aberration stages a chain is built for, each replaces the last stage of allShaders_PostProcessPipelines. all of them
+//are built and recorded with the swapchain, so N picks the next one without rebuilding anything. J runs the A/B timing: the
+//techniques take turns of distortionABFramesPerTechnique frames, distortionABRounds times round, then the gpu ms of each
+//chain is printed (PostProcessTimer) and the cheapest one is kept. startDistortionTechnique is the one it starts with,
+//startDistortionABTest runs the A/B timing on startup. the fused, compute and distorted forward chains have their own
+const std::vector< std::pair<std::string, std::tuple<std::vector<std::string>, uint32_t, uint32_t>> > distortionTechniques_PostProcessPipelines =
+{
+	//ALL IN FRAG
+	{"frag math",
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	"src/shaders/ppBarrelAbFragCommonUse.frag.spv"},
+	1, 0}},
+
+	//BAKED LUT (DistortionLUT, 2nd image input), one fetch instead of the warp math
+	{"baked lut",
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	"src/shaders/ppBarrelAbLUT.frag.spv"},
+	2, 0}},
+
+	//PRECALC MESH
+	{"precalc mesh",
+	{{"src/shaders/ppBarrelAbMeshPreCalc.vert.spv",
+	"src/shaders/ppBarrelAbMeshPreCalc.frag.spv"},
+	1, 0}},
+
+	//not the shader mesh (ppBarrelAbMesh2.vert, ppBarrelAbMesh.frag): it still has the dk1 lens and a 1280x800 screen baked in
+	//instead of the HmdProfile constants, so it'd be timed against the others while drawing the wrong image
+};
+const uint32_t startDistortionTechnique = 0;
+const bool startDistortionABTest = false;
+const uint32_t distortionABFramesPerTechnique = 30;
+const uint32_t distortionABRounds = 10;
+
+//the stencil hole fill and barrel/aberration stages above as one stage that fills the holes at the 3 chromatic source uv's,
+//no hole filled intermediate image and one pp submit less. F swaps between the two at runtime (recreates the pipelines),
+//startFusedPostProcess picks the one it starts with. not with temporalCheckerStencil, its hole fill needs its own history
+const bool startFusedPostProcess = false;
+const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > fusedShaders_PostProcessPipelines =
+{
+	////STENCIL HOLE FILL + BARREL/ABERRATION ALL IN FRAG
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	"src/shaders/ppStencilHoleFillBarrelAb.frag.spv"},
+	1, 0},
+};
 
-	//BARREL/ABERRATION SHADER MESH (NO PRECALC, DONE IN SHADERS)
-	//{{"src/shaders/ppBarrelAbMesh2.vert.spv",
-	//"src/shaders/ppBarrelAbMesh.frag.spv"},
-	//1, 0},
+//the pp chain of direct to distorted forward rendering (startDistortedForward), the forward image is already in lens space.
+//quality tiers: ppLateralChromAb scales red and blue about the lens center for the chromatic aberration,
+//without distortedForwardChromAb it's left out and ppPassthrough only copies to the swapchain
+const bool distortedForwardChromAb = true;
+const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > distortedShaders_PostProcessPipelines =
+{
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
+	distortedForwardChromAb ? "src/shaders/ppLateralChromAb.frag.spv" : "src/shaders/ppPassthrough.frag.spv"},
+	1, 0},
 };
 
-//SHADER PATHS,  num image inputs(should be vector of source stages), typeFlags (0 is normal ,1 is timewarp)
+//the stencil hole fill and barrel/aberration stages above as compute (typeFlags 3, just the .comp): an invocation per 2x2 quad,
+//the hole fill stages a tile with its tap reach in shared memory and tests the quad's ring once. the barrel/aberration one
+//writes the swapchain images as storage images (VulkanContextInfo::swapChainStorage), its taps follow the lens so no tile.
+//K swaps to these and back at runtime (recreates the pipelines) to compare against the raster stages, startComputePostProcess
+//picks the one it starts with. not with temporalCheckerStencil, like the fused stage
+const bool startComputePostProcess = false;
+const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > computeShaders_PostProcessPipelines =
+{
+	////STENCIL HOLE FILL, shared memory tiles
+	{{"src/shaders/ppStencilHoleFill.comp.spv"},
+	1, 3},
+
+	////BARREL/ABERRATION
+	{{"src/shaders/ppBarrelAb.comp.spv"},
+	1, 3},
+};
+
+
+//SHADER PATHS,  num image inputs(binding 0 is the stage before, PostProcessGraph wires them), typeFlags (0 is normal ,1 is timewarp)
 const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > allShaders_TimeWarpPipelines =
 {
-	////passthrough
-	{{"src/shaders/ppTimeWarp.vert.spv",
+	////TimeWarp, procedural grid
+	{{"src/shaders/ppTimeWarpGrid.vert.spv",
 	"src/shaders/ppTimeWarp.frag.spv"},
 	2, 1}, //1 is num input sampler images to this pp stage
 
-	////TimeWarp
+	////TimeWarp, ndc barrel grid mesh or a procedural point per pixel
 	//{{"src/shaders/ppTimeWarp.vert.spv",
 	//"src/shaders/ppTimeWarp.frag.spv"},
 	//2, 1}, //1 is num input sampler images to this pp stage
+	//{{"src/shaders/ppTimeWarpPoints.vert.spv",
+	//"src/shaders/ppTimeWarp.frag.spv"},
+	//2, 1},
 
 	////Barrel/Aberration all in FRAG 
-	{{"src/shaders/ppPassthrough.vert.spv",
+	{{"src/shaders/ppFullscreenTriangle.vert.spv",
 	"src/shaders/ppBarrelAbFragCommonUse.frag.spv"},
 	1, 0},
-	//{{"src/shaders/ppPassthrough.vert.spv",
+	//{{"src/shaders/ppFullscreenTriangle.vert.spv",
 	//"src/shaders/ppPassthrough.frag.spv"},
 	//1, 0},
+};
 
-	//combined?
+//the time warp and barrel/aberration stages above as one present stage: every swapchain pixel takes its 3 chromatic uv's back
+//through the head rotation since the warped frame, no warped intermediate image and one submit between the warp and present.
+//G swaps between the two while not warping (T makes the pipelines), startFusedTimeWarp picks the one it starts with
+const bool startFusedTimeWarp = false;
+const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > fusedShaders_TimeWarpPipelines =
+{
+	////TimeWarp + Barrel/Aberration all in FRAG
+	{{"src/shaders/ppTimeWarpBarrelAb.vert.spv",
+	"src/shaders/ppTimeWarpBarrelAb.frag.spv"},
+	2, 1},
 };
 
 
@@ -0,0 +1,339 @@
+#pragma once
+#include "HiddenAreaMesh.h"
+#include "VulkanContextInfo.h"
+#include "VulkanBuffer.h"
+#include "Vertex.h"
+#include "QuadMask.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+
+HiddenAreaMesh::HiddenAreaMesh() {
+}
+
+HiddenAreaMesh::~HiddenAreaMesh() {
+}
+
+void HiddenAreaMesh::createMeshes(const VulkanContextInfo& contextInfo) {
+	destroyMeshes(contextInfo);
+
+	std::vector<HiddenAreaVertex> vertices;
+	draws.resize(contextInfo.radialDensityMasks.size() * 2);
+	for (size_t i = 0; i < contextInfo.radialDensityMasks.size(); ++i) {
+		const PreMadeStencil& stencil = contextInfo.radialDensityMasks[i];
+		draws[i*2] = build(stencil.mask, vertices);
+		draws[i*2 + 1] = temporalCheckerStencil ? build(stencil.alternateMask, vertices) : draws[i*2];
+	}
+
+	VulkanBuffer::createDeviceLocalBuffer(contextInfo, vertices.data(), sizeof(HiddenAreaVertex) * vertices.size(),
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferMemory);
+}
+
+HiddenAreaDraws HiddenAreaMesh::build(const QuadMask& mask, std::vector<HiddenAreaVertex>& out_vertices) {
+	//a rectangle stays open while the next row has a run with the same span and fill, quad units, y1 exclusive
+	struct OpenRect {
+		uint32_t x0, x1, y0;
+		uint16_t fill;
+	};
+	std::array<std::vector<HiddenAreaVertex>, 3> groups;
+	auto emitRect = [&groups](const OpenRect& rect, const uint32_t y1) {
+		//QuadMask fill of the masked out quads: set, or one checker phase (keepParity 0 for even, 1 for odd)
+		const uint32_t group = (QuadMask::FILL_SET == rect.fill) ? 0 : rect.fill;
+		const uint16_t x0 = static_cast<uint16_t>(2*rect.x0), x1 = static_cast<uint16_t>(2*rect.x1);
+		const uint16_t y0 = static_cast<uint16_t>(2*rect.y0), y1p = static_cast<uint16_t>(2*y1);
+		const std::array<glm::u16vec2, 6> corners = { glm::u16vec2(x0, y0), glm::u16vec2(x1, y0), glm::u16vec2(x1, y1p),
+			glm::u16vec2(x0, y0), glm::u16vec2(x1, y1p), glm::u16vec2(x0, y1p) };
+		for (const glm::u16vec2& corner : corners) {
+			HiddenAreaVertex vertex;
+			vertex.pos = corner;
+			groups[group].push_back(vertex);
+		}
+	};
+
+	std::vector<OpenRect> open;
+	std::vector<OpenRect> next;
+	for (uint32_t qy = 0; qy <= mask.quadsY; ++qy) {
+		//open is sorted by x0 and the runs come left to right, so matching the previous row is one pass
+		size_t o = 0;
+		next.clear();
+		if (qy < mask.quadsY) {
+			uint32_t qx = 0;
+			for (uint32_t r = mask.rowStarts[qy]; r < mask.rowStarts[qy + 1]; ++r) {
+				const uint16_t fill = (mask.runs[r] >> QuadMask::FILL_SHIFT) ^ QuadMask::FILL_SET;
+				const uint32_t length = mask.runs[r] & QuadMask::MAX_RUN_LENGTH;
+				if (QuadMask::FILL_CLEAR != fill) {
+					while (o < open.size() && open[o].x0 < qx) {
+						emitRect(open[o++], qy);
+					}
+					if (o < open.size() && open[o].x0 == qx && open[o].x1 == qx + length && open[o].fill == fill) {
+						next.push_back(open[o++]);
+					} else {
+						next.push_back({ qx, qx + length, qy, fill });
+					}
+				}
+				qx += length;
+			}
+		}
+		while (o < open.size()) {
+			emitRect(open[o++], qy);
+		}
+		std::swap(open, next);
+	}
+
+	HiddenAreaDraws maskDraws;
+	maskDraws.firstVertex = static_cast<uint32_t>(out_vertices.size());
+	for (uint32_t g = 0; g < 3; ++g) {
+		maskDraws.vertexCounts[g] = static_cast<uint32_t>(groups[g].size());
+		out_vertices.insert(out_vertices.end(), groups[g].begin(), groups[g].end());
+	}
+	return maskDraws;
+}
+
+void HiddenAreaMesh::record(const VkCommandBuffer& commandBuffer, const VulkanContextInfo& contextInfo) const {
+	const Camera& camera = contextInfo.camera;
+	const PreMadeStencil& stencil = contextInfo.radialDensityMasks[camera.qualityIndex];
+	const HiddenAreaDraws& maskDraws = draws[camera.qualityIndex*2 + (temporalCheckerStencil ? camera.stencilPhase : 0)];
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+	//both eyes at once, the forward pipelines set their own viewport per eye
+	VkViewport viewport = {};
+	viewport.width = static_cast<float>(camera.renderTargetExtent.width);
+	viewport.height = static_cast<float>(camera.renderTargetExtent.height);
+	viewport.minDepth = 0.f;
+	viewport.maxDepth = 1.f;
+	VkRect2D scissor = {};
+	scissor.extent = camera.renderTargetExtent;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	const VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+
+	HiddenAreaPushConstant pushConstant = {};
+	pushConstant.invExtent = glm::vec2(1.f / stencil.width, 1.f / stencil.height);
+	uint32_t firstVertex = maskDraws.firstVertex;
+	for (uint32_t g = 0; g < 3; ++g) {
+		if (maskDraws.vertexCounts[g] == 0) {
+			continue;
+		}
+		pushConstant.keepParity = static_cast<int32_t>(g) - 1;
+		vkCmdPushConstants(commandBuffer, pipelineLayout, HiddenAreaPushConstant::stages, 0, sizeof(HiddenAreaPushConstant), &pushConstant);
+		vkCmdDraw(commandBuffer, maskDraws.vertexCounts[g], 1, firstVertex, 0);
+		firstVertex += maskDraws.vertexCounts[g];
+	}
+}
+
+void HiddenAreaMesh::createPipeline(const VulkanContextInfo& contextInfo, const VkRenderPass& renderPass) {
+	const std::vector<std::string> shaderpaths = { "src/shaders/hiddenAreaMesh.vert.spv",
+		"src/shaders/hiddenAreaMesh.frag.spv" };
+	VkShaderModule shaderModules[2];
+	for (int i = 0; i < 2; ++i) {
+		const std::vector<char> code = readFile(shaderpaths[i]);
+		VkShaderModuleCreateInfo createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = code.size();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+		if (vkCreateShaderModule(contextInfo.device, &createInfo, nullptr, &shaderModules[i]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create shader module!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = shaderModules[0];
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = shaderModules[1];
+	shaderStages[1].pName = "main";
+
+	const VkVertexInputBindingDescription bindingDescription = HiddenAreaVertex::getBindingDescription();
+	const std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions = HiddenAreaVertex::getAttributeDescriptions();
+	VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInputInfo.vertexBindingDescriptionCount = 1;
+	vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+	//dynamic, set in record
+	VkPipelineViewportStateCreateInfo viewportState = {};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer = {};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling = {};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	//the pass cleared the stencil to 1 (Camera::getStencilTestBit), every fragment that survives the discard writes 0
+	VkStencilOpState stencilOp = {};
+	stencilOp.failOp = VK_STENCIL_OP_KEEP;
+	stencilOp.passOp = VK_STENCIL_OP_REPLACE;
+	stencilOp.depthFailOp = VK_STENCIL_OP_KEEP;
+	stencilOp.compareOp = VK_COMPARE_OP_ALWAYS;
+	stencilOp.compareMask = 0xFF;
+	stencilOp.writeMask = 0xFF;
+	stencilOp.reference = 0;
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = VK_FALSE;
+	depthStencil.depthWriteEnable = VK_FALSE;
+	depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+	depthStencil.depthBoundsTestEnable = VK_FALSE;
+	depthStencil.stencilTestEnable = VK_TRUE;
+	depthStencil.front = stencilOp;
+	depthStencil.back = stencilOp;
+
+	//the forward pass has a color attachment, leave it alone
+	VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+	colorBlendAttachment.colorWriteMask = 0;
+	colorBlendAttachment.blendEnable = VK_FALSE;
+
+	VkPipelineColorBlendStateCreateInfo colorBlending = {};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+
+	const std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	VkPipelineDynamicStateCreateInfo dynamicInfo = {};
+	dynamicInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	dynamicInfo.pDynamicStates = dynamicStates.data();
+
+	VkPushConstantRange pushConstantRange = {};
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(HiddenAreaPushConstant);
+	pushConstantRange.stageFlags = HiddenAreaPushConstant::stages;
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 0;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+	if (vkCreatePipelineLayout(contextInfo.device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create pipeline layout!";
+		throw std::runtime_error(ss.str());
+	}
+
+	VkGraphicsPipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicInfo;
+	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.renderPass = renderPass;
+	pipelineInfo.subpass = 0;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	if (vkCreateGraphicsPipelines(contextInfo.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create graphics pipeline!";
+		throw std::runtime_error(ss.str());
+	}
+
+	vkDestroyShaderModule(contextInfo.device, shaderModules[0], nullptr);
+	vkDestroyShaderModule(contextInfo.device, shaderModules[1], nullptr);
+}
+
+void HiddenAreaMesh::report(const VulkanContextInfo& contextInfo) {
+	std::cout << "\n\nHiddenAreaMesh report (" << PreMadeStencil::getTypeName(contextInfo.vrStencilType) << ")";
+	std::cout << "\n\tlevel\textent\t\tbuild ms\trects\ttriangles\tmesh bytes\tstencil upload bytes\tmismatched pixels";
+	for (size_t i = 0; i < contextInfo.radialDensityMasks.size(); ++i) {
+		const PreMadeStencil& stencil = contextInfo.radialDensityMasks[i];
+
+		auto start = std::chrono::high_resolution_clock::now();
+		std::vector<HiddenAreaVertex> vertices;
+		const HiddenAreaDraws maskDraws = build(stencil.mask, vertices);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		//rasterize at pixel centers like the gpu would (the corners are whole pixels), with hiddenAreaMesh.frag's discard
+		const uint32_t width = 2*stencil.mask.quadsX;
+		const uint32_t height = 2*stencil.mask.quadsY;
+		std::vector<uint8_t> hidden(width*height, 0);
+		uint32_t v = maskDraws.firstVertex;
+		for (uint32_t g = 0; g < 3; ++g) {
+			for (const uint32_t groupEnd = v + maskDraws.vertexCounts[g]; v < groupEnd; v += 6) {
+				const glm::u16vec2 lo = vertices[v].pos;
+				const glm::u16vec2 hi = vertices[v + 2].pos;
+				for (uint32_t y = lo.y; y < hi.y; ++y) {
+					for (uint32_t x = lo.x; x < hi.x; ++x) {
+						const int32_t parity = ((x >> 1) ^ (y >> 1)) & 1;
+						hidden[y*width + x] += (g == 0 || parity == static_cast<int32_t>(g) - 1) ? 1 : 0;
+					}
+				}
+			}
+		}
+
+		//every pixel is either shaded by the mask or covered exactly once
+		std::vector<uint8_t> maskPixels(width*height);
+		stencil.mask.expand(maskPixels.data(), 1);
+		uint32_t mismatches = 0;
+		for (uint32_t p = 0; p < width*height; ++p) {
+			mismatches += (hidden[p] + maskPixels[p] == 1) ? 0 : 1;
+		}
+
+		const uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+		std::cout << "\n\t" << i << "\t" << stencil.width << "x" << stencil.height << "\t"
+			<< std::chrono::duration<double, std::milli>(end - start).count() << "\t\t"
+			<< numVertices / 6 << "\t" << numVertices / 3 << "\t\t" << numVertices * sizeof(HiddenAreaVertex) << "\t\t"
+			<< stencil.width * stencil.height << "\t\t\t" << mismatches;
+	}
+	std::cout << std::endl;
+}
+
+void HiddenAreaMesh::destroyPipeline(const VulkanContextInfo& contextInfo) {
+	if (pipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(contextInfo.device, pipeline, nullptr);
+		vkDestroyPipelineLayout(contextInfo.device, pipelineLayout, nullptr);
+	}
+	pipeline = VK_NULL_HANDLE;
+	pipelineLayout = VK_NULL_HANDLE;
+}
+
+void HiddenAreaMesh::destroyMeshes(const VulkanContextInfo& contextInfo) {
+	if (vertexBuffer != VK_NULL_HANDLE) {
+		//a frame in flight may still be drawing the old rectangles
+		vkDeviceWaitIdle(contextInfo.device);
+		vkDestroyBuffer(contextInfo.device, vertexBuffer, nullptr);
+		vkFreeMemory(contextInfo.device, vertexBufferMemory, nullptr);
+	}
+	vertexBuffer = VK_NULL_HANDLE;
+	vertexBufferMemory = VK_NULL_HANDLE;
+	draws.clear();
+}
+
+void HiddenAreaMesh::destroy(const VulkanContextInfo& contextInfo) {
+	destroyPipeline(contextInfo);
+	destroyMeshes(contextInfo);
+}
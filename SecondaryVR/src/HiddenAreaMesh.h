@@ -0,0 +1,69 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+class VulkanContextInfo;
+class QuadMask;
+struct HiddenAreaVertex;
+
+//same layout as hiddenAreaMesh.vert and hiddenAreaMesh.frag
+struct HiddenAreaPushConstant {
+	glm::vec2 invExtent;//1 / the mask's width and height in pixels
+	int32_t keepParity;//-1 all of the rectangle, else only the quads where ((qx ^ qy) & 1) is this
+	static const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+};
+
+//one mask's rectangles in the vertex buffer, grouped by keepParity (-1, 0, 1)
+struct HiddenAreaDraws {
+	uint32_t firstVertex = 0;
+	std::array<uint32_t, 3> vertexCounts = {};
+};
+
+//Masks the vr forward pass without a stencil image (hiddenAreaMeshMask, see GlobalSettings.h).
+//Every quality level's QuadMask becomes rectangles over its masked out quads: each row's unset runs, stacked with the
+//identical runs of the rows below. checker runs are a rectangle too and hiddenAreaMesh.frag discards every other quad.
+//record() is the first draw of the forward pass, it writes stencil 0 under the rectangles where the pass cleared it to 1,
+//so the forward pipelines' stencil test drops the same fragments the uploaded mask would. no depth writes, the holes keep
+//the cleared depth like they do with renderPassStencilLoading. the rectangles of every level (and with temporalCheckerStencil
+//both phases) share one vertex buffer made with the stencils, switching quality or phase is just another draw range
+class HiddenAreaMesh {
+public:
+	VkBuffer vertexBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
+	std::vector<HiddenAreaDraws> draws;//[quality level*2 + phase], phase 1 is only filled with temporalCheckerStencil
+
+	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+	VkPipeline pipeline = VK_NULL_HANDLE;
+
+public:
+	HiddenAreaMesh();
+	~HiddenAreaMesh();
+
+	//rectangles of every contextInfo.radialDensityMasks level in a new vertex buffer, replaces the old one (see initStencils)
+	void createMeshes(const VulkanContextInfo& contextInfo);
+	//appends mask's rectangles to out_vertices, 2 triangles each, pixel corners of a 2*quadsX by 2*quadsY target
+	static HiddenAreaDraws build(const QuadMask& mask, std::vector<HiddenAreaVertex>& out_vertices);
+
+	//for the forward render pass that clears the stencil (VulkanRenderPass::renderPass)
+	void createPipeline(const VulkanContextInfo& contextInfo, const VkRenderPass& renderPass);
+	//inside the forward render pass before any forward pipeline, the mask of camera.qualityIndex and camera.stencilPhase
+	void record(const VkCommandBuffer& commandBuffer, const VulkanContextInfo& contextInfo) const;
+
+	//rectangles, triangles and bytes per quality level next to the stencil image upload they replace, and the pixels
+	//the rectangles (rasterized on the cpu, with the checker discard) get wrong against the expanded mask
+	static void report(const VulkanContextInfo& contextInfo);
+
+	//cleanup
+	void destroyPipeline(const VulkanContextInfo& contextInfo);
+	void destroy(const VulkanContextInfo& contextInfo);
+
+private:
+	void destroyMeshes(const VulkanContextInfo& contextInfo);
+};
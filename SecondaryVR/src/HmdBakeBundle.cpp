@@ -0,0 +1,288 @@
+#pragma once
+#include "HmdBakeBundle.h"
+#include "VulkanContextInfo.h"
+#include "HmdProfile.h"
+#include "GlobalSettings.h"
+#include "PreMadeStencil.h"
+#include "DistortionLUT.h"
+#include "Mesh.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <future>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	const char BAKE_MAGIC[4] = { 'S', 'V', 'R', 'B' };
+	const uint64_t BAKE_ALIGNMENT = 16;
+
+	//FNV-1a
+	uint64_t hashBytes(uint64_t hash, const void* bytes, const size_t size) {
+		const uint8_t* b = static_cast<const uint8_t*>(bytes);
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= b[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+	template<typename T>
+	uint64_t hashValue(const uint64_t hash, const T& value) {
+		return hashBytes(hash, &value, sizeof(T));
+	}
+
+	uint64_t alignUp(const uint64_t offset) {
+		return (offset + BAKE_ALIGNMENT - 1) & ~(BAKE_ALIGNMENT - 1);
+	}
+}
+
+HmdBakeBundle::HmdBakeBundle() {
+}
+
+HmdBakeBundle::~HmdBakeBundle() {
+}
+
+uint64_t HmdBakeBundle::calcKey(const VulkanContextInfo& contextInfo) {
+	const HmdProfile& hmd = HmdProfile::get();
+	const Mesh meshSettings;
+
+	uint64_t hash = 14695981039346656037ull;
+	hash = hashValue(hash, static_cast<uint32_t>(VERSION));
+	hash = hashValue(hash, hmd.width);
+	hash = hashValue(hash, hmd.height);
+	hash = hashValue(hash, hmd.hScreenSize);
+	hash = hashValue(hash, hmd.lensSeparation);
+	hash = hashValue(hash, hmd.lensVisibleRadius);
+	hash = hashValue(hash, hmd.hmdWarpParam);
+	hash = hashValue(hash, hmd.chromAbParam);
+	hash = hashValue(hash, hmd.middleRegionRadius);
+	hash = hashValue(hash, hmd.ndcCenterOffset);
+	hash = hashBytes(hash, contextInfo.camera.vrScalings.data(), contextInfo.camera.vrScalings.size() * sizeof(float));
+	for (const auto& level : fixedFoveatedLevels) {
+		hash = hashBytes(hash, level.data(), level.size() * sizeof(level[0]));
+	}
+	hash = hashValue(hash, meshSettings.quadsPerDim);
+	hash = hashValue(hash, meshSettings.maxErrorPx);
+	hash = hashValue(hash, meshSettings.lensRings);
+	hash = hashValue(hash, meshSettings.lensSegments);
+	hash = hashValue(hash, static_cast<uint32_t>(sizeof(PostProcessPreCalcVertex)));
+	hash = hashValue(hash, static_cast<uint32_t>(DistortionLUT::format));
+	return hash;
+}
+
+void HmdBakeBundle::open(const VulkanContextInfo& contextInfo) {
+	path = hmdBakeBundleDir + HmdProfile::get().name + ".hmdbake";
+	key = calcKey(contextInfo);
+
+	if (map() && isValid(key)) {
+		std::cout << "\nMapped hmd bake bundle " << path << " (" << mappedSize / 1024 << " KB)";
+		return;
+	}
+	unmap();//windows won't let us rewrite a mapped file
+
+	auto start = std::chrono::high_resolution_clock::now();
+	bake(contextInfo, key, blob);
+	auto end = std::chrono::high_resolution_clock::now();
+	std::cout << "\nBaked hmd bake bundle " << path << " (" << blob.size() / 1024 << " KB) in "
+		<< std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(blob.data(), blob.size());
+	file.close();
+	if (file.good() && map() && isValid(key)) {
+		std::vector<char>().swap(blob);
+	} else {
+		unmap();
+		std::cout << "\nCouldn't write " << path << ", using the bake from memory this run";
+	}
+}
+
+const char* HmdBakeBundle::getBase() const {
+	return mapped ? mapped : blob.data();
+}
+
+uint64_t HmdBakeBundle::getSize() const {
+	return mapped ? mappedSize : blob.size();
+}
+
+bool HmdBakeBundle::isValid(const uint64_t expectedKey) const {
+	const char* base = getBase();
+	const uint64_t size = getSize();
+	if (size < sizeof(HmdBakeHeader)) { return false; }
+
+	const HmdBakeHeader* header = reinterpret_cast<const HmdBakeHeader*>(base);
+	if (memcmp(header->magic, BAKE_MAGIC, sizeof(BAKE_MAGIC)) != 0 || header->version != VERSION || header->key != expectedKey) {
+		return false;
+	}
+	if (sizeof(HmdBakeHeader) + uint64_t(header->numEntries) * sizeof(HmdBakeEntry) > size) { return false; }
+
+	const HmdBakeEntry* entries = reinterpret_cast<const HmdBakeEntry*>(base + sizeof(HmdBakeHeader));
+	for (uint32_t i = 0; i < header->numEntries; ++i) {
+		if (entries[i].offset > size || entries[i].size > size - entries[i].offset) { return false; }
+	}
+	return true;
+}
+
+const HmdBakeEntry* HmdBakeBundle::find(const HmdBakeType type, const uint32_t index) const {
+	if (getSize() < sizeof(HmdBakeHeader)) { return nullptr; }
+	const char* base = getBase();
+	const HmdBakeHeader* header = reinterpret_cast<const HmdBakeHeader*>(base);
+	const HmdBakeEntry* entries = reinterpret_cast<const HmdBakeEntry*>(base + sizeof(HmdBakeHeader));
+	for (uint32_t i = 0; i < header->numEntries; ++i) {
+		if (entries[i].type == static_cast<uint32_t>(type) && entries[i].index == index) {
+			return &entries[i];
+		}
+	}
+	return nullptr;
+}
+
+const void* HmdBakeBundle::getData(const HmdBakeEntry& entry) const {
+	return getBase() + entry.offset;
+}
+
+void HmdBakeBundle::bake(const VulkanContextInfo& contextInfo, const uint64_t key, std::vector<char>& out_blob) {
+	std::vector<HmdBakeEntry> entries;
+	std::vector<std::vector<char>> datas;
+	auto addEntry = [&](const HmdBakeType type, const uint32_t index, const uint32_t width, const uint32_t height,
+		const void* data, const size_t size) {
+		HmdBakeEntry entry = {};
+		entry.type = static_cast<uint32_t>(type);
+		entry.index = index;
+		entry.width = width;
+		entry.height = height;
+		entry.size = size;
+		entries.push_back(entry);
+		datas.emplace_back(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+	};
+
+	//every bake is its own task, right eye mesh is mirrored from the left
+	const uint32_t numQualitySettings = static_cast<uint32_t>(contextInfo.camera.numQualitySettings);
+	std::vector<std::future<PreMadeStencil>> stencils;
+	for (uint32_t type = 0; type < NUM_STENCIL_TYPES; ++type) {
+		for (uint32_t i = 0; i < numQualitySettings; ++i) {
+			stencils.push_back(std::async(std::launch::async, [&contextInfo, type, i] {
+				PreMadeStencil stencil(contextInfo, i, static_cast<StencilType>(type));
+				stencil.generateMask(contextInfo);
+				return stencil;
+			}));
+		}
+	}
+
+	Mesh meshes[2];
+	std::future<void> meshBake = std::async(std::launch::async, [&meshes] {
+		meshes[0].buildNDCBarrelMeshPreCalc(0);
+		meshes[1].mirrorToRightEye(meshes[0]);
+	});
+
+	//distortion lut at the panel's eye resolution, other present sizes bake their own at swapchain creation
+	const VkExtent2D eyeExtent = { HmdProfile::get().width / 2, HmdProfile::get().height };
+	std::vector<uint64_t> halfTexels;
+	std::future<void> lutBake = std::async(std::launch::async, [&eyeExtent, &halfTexels] {
+		DistortionLUT::bakeHalf(eyeExtent, halfTexels);
+	});
+
+	//every type's stencil at every quality level, VulkanContextInfo::createDepthImage picks the current one
+	for (uint32_t i = 0; i < stencils.size(); ++i) {
+		const PreMadeStencil stencil = stencils[i].get();
+		std::vector<char> maskBytes;
+		stencil.mask.serialize(maskBytes);
+		addEntry(HmdBakeType::STENCIL, i, stencil.width, stencil.height, maskBytes.data(), maskBytes.size());
+		stencil.alternateMask.serialize(maskBytes);
+		addEntry(HmdBakeType::STENCIL_ALTERNATE, i, stencil.width, stencil.height, maskBytes.data(), maskBytes.size());
+	}
+
+	//precalc barrel meshes (see Mesh::createNDCBarrelMeshPreCalc)
+	meshBake.get();
+	for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+		const Mesh& mesh = meshes[camIndex];
+		addEntry(HmdBakeType::MESH_VERTICES, camIndex, static_cast<uint32_t>(mesh.mPPPreCalcVertices.size()),
+			sizeof(PostProcessPreCalcVertex), mesh.mPPPreCalcVertices.data(),
+			mesh.mPPPreCalcVertices.size() * sizeof(PostProcessPreCalcVertex));
+		addEntry(HmdBakeType::MESH_INDICES, camIndex, static_cast<uint32_t>(mesh.mIndices.size()), sizeof(uint32_t),
+			mesh.mIndices.data(), mesh.mIndices.size() * sizeof(uint32_t));
+	}
+
+	lutBake.get();
+	addEntry(HmdBakeType::DISTORTION_LUT, 0, eyeExtent.width, eyeExtent.height, halfTexels.data(), halfTexels.size() * sizeof(uint64_t));
+
+	//lay out
+	uint64_t offset = alignUp(sizeof(HmdBakeHeader) + entries.size() * sizeof(HmdBakeEntry));
+	for (HmdBakeEntry& entry : entries) {
+		entry.offset = offset;
+		offset = alignUp(offset + entry.size);
+	}
+
+	HmdBakeHeader header = {};
+	memcpy(header.magic, BAKE_MAGIC, sizeof(BAKE_MAGIC));
+	header.version = VERSION;
+	header.key = key;
+	header.numEntries = static_cast<uint32_t>(entries.size());
+
+	out_blob.assign(offset, 0);
+	memcpy(out_blob.data(), &header, sizeof(header));
+	memcpy(out_blob.data() + sizeof(header), entries.data(), entries.size() * sizeof(HmdBakeEntry));
+	for (size_t i = 0; i < entries.size(); ++i) {
+		memcpy(out_blob.data() + entries[i].offset, datas[i].data(), datas[i].size());
+	}
+}
+
+bool HmdBakeBundle::map() {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) { return false; }
+	fileHandle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { return false; }
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) { return false; }
+	mappingHandle = mapping;
+
+	mapped = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	mappedSize = mapped ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) { return false; }
+	fileHandle = reinterpret_cast<void*>(static_cast<intptr_t>(fd) + 1);//+1 so fd 0 isn't nullptr
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) { return false; }
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	mapped = (view == MAP_FAILED) ? nullptr : static_cast<const char*>(view);
+	mappedSize = mapped ? static_cast<uint64_t>(st.st_size) : 0;
+#endif
+	return mapped != nullptr;
+}
+
+void HmdBakeBundle::unmap() {
+#ifdef _WIN32
+	if (mapped)			{ UnmapViewOfFile(mapped); }
+	if (mappingHandle)	{ CloseHandle(static_cast<HANDLE>(mappingHandle)); }
+	if (fileHandle)		{ CloseHandle(static_cast<HANDLE>(fileHandle)); }
+#else
+	if (mapped)			{ munmap(const_cast<char*>(mapped), static_cast<size_t>(mappedSize)); }
+	if (fileHandle)		{ ::close(static_cast<int>(reinterpret_cast<intptr_t>(fileHandle) - 1)); }
+#endif
+	mapped = nullptr;
+	mappedSize = 0;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+}
+
+void HmdBakeBundle::close() {
+	unmap();
+	std::vector<char>().swap(blob);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class VulkanContextInfo;
+
+//One binary file per hmd profile holding everything that is a pure function of the lens:
+//every quality level's radial density stencil, both eyes' precalc barrel meshes and the distortion lut.
+//It is memory mapped and the uploads copy straight out of the mapping (no stb decode, no per-pixel conversion),
+//the stencils are kept in their compact QuadMask form and expanded on upload.
+//The header carries a hash of every input to the bakes (HmdProfile, quality scalings, mesh settings),
+//if it doesn't match the running config the file is rebaked and rewritten on startup.
+//bump VERSION when a baker's output changes for the same inputs
+enum class HmdBakeType : uint32_t {
+	STENCIL = 0,		//index: StencilType * numQualitySettings + quality index, width x height pixels, serialized QuadMask
+	MESH_VERTICES,		//index: camIndex, width PostProcessPreCalcVertex's of height bytes each
+	MESH_INDICES,		//index: camIndex, width uint32_t's
+	DISTORTION_LUT,		//index: 0, width x height packed half4 texels (see DistortionLUT)
+	STENCIL_ALTERNATE,	//index and layout as STENCIL, the stencil's alternateMask (temporalCheckerStencil)
+};
+
+struct HmdBakeHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint32_t numEntries;
+	uint32_t pad;
+};
+
+struct HmdBakeEntry {
+	uint32_t type;
+	uint32_t index;
+	uint32_t width;
+	uint32_t height;
+	uint64_t offset;//from the start of the file, 16 byte aligned
+	uint64_t size;//bytes
+};
+
+class HmdBakeBundle {
+public:
+	static const uint32_t VERSION = 8;
+
+	std::string path;
+	uint64_t key = 0;
+
+	//file layout: HmdBakeHeader, numEntries HmdBakeEntry's, data
+	const char* mapped = nullptr;
+	uint64_t mappedSize = 0;
+	void* fileHandle = nullptr;//win32 file and mapping handles, posix keeps the fd in fileHandle
+	void* mappingHandle = nullptr;
+	std::vector<char> blob;//used instead of the mapping if the bundle couldn't be written to disk
+
+public:
+	HmdBakeBundle();
+	~HmdBakeBundle();
+
+	//maps res/hmd/<profile name>.hmdbake, bakes and rewrites it first if it is missing or its key is stale.
+	//needs the camera's quality scalings so call after contextInfo.camera is set
+	void open(const VulkanContextInfo& contextInfo);
+
+	//nullptr if the bundle doesn't have it
+	const HmdBakeEntry* find(const HmdBakeType type, const uint32_t index) const;
+	const void* getData(const HmdBakeEntry& entry) const;
+
+	//hash of everything the bakes depend on
+	static uint64_t calcKey(const VulkanContextInfo& contextInfo);
+
+	//cleanup
+	void close();
+
+private:
+	const char* getBase() const;
+	uint64_t getSize() const;
+	bool isValid(const uint64_t expectedKey) const;
+	bool map();
+	void unmap();
+	static void bake(const VulkanContextInfo& contextInfo, const uint64_t key, std::vector<char>& out_blob);
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include "HmdProfile.h"
+#include "GlobalSettings.h"
+#include "LensDistortion.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstddef>
+
+
+HmdProfile::HmdProfile() {
+}
+
+HmdProfile::~HmdProfile() {
+}
+
+//Oculus Rift DK1, values that were scattered throughout the Oculus world demo
+HmdProfile HmdProfile::DK1() {
+	HmdProfile p;
+	p.name = "dk1";
+	p.width = 1280;
+	p.height = 800;
+	p.hScreenSize = 0.14976f;
+	p.lensSeparation = 0.0635f;
+	p.lensVisibleRadius = 0.0468f;//half the panel height, only the corners are cut
+	p.hmdWarpParam = glm::vec4(1.0f, 0.22f, 0.24f, 0.0f); // For the 7-inch device
+	p.chromAbParam = glm::vec4(0.996f, -0.004f, 1.014f, 0.f);
+	p.middleRegionRadius = 0.52f;//roughly 0.52
+	p.ndcCenterOffset = 0.1425f;//0.15 ndc centeer UV center offset 0.0375
+	return p;
+}
+
+//2x 1080x1200 panels (Vive/Rift CV1 class), lens centers sit nearly on the panel centers
+//warp values are approximate, override them in a profile file for a specific headset
+HmdProfile HmdProfile::HD2160x1200() {
+	HmdProfile p;
+	p.name = "hd2160x1200";
+	p.width = 2160;
+	p.height = 1200;
+	p.hScreenSize = 0.1224f;
+	p.lensSeparation = 0.0635f;
+	p.lensVisibleRadius = 0.034f;//half the panel height
+	p.hmdWarpParam = glm::vec4(1.0f, 0.25f, 0.32f, 0.0f);
+	p.chromAbParam = glm::vec4(0.994f, -0.004f, 1.012f, 0.f);
+	p.middleRegionRadius = 0.52f;
+	p.ndcCenterOffset = -0.0376f;//4*(hScreenSize*0.25 - lensSeparation*0.5)/hScreenSize
+	return p;
+}
+
+HmdProfile HmdProfile::loadFromFile(const std::string& path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to open hmd profile " << path << "!";
+		throw std::runtime_error(ss.str());
+	}
+
+	HmdProfile p = DK1();
+	std::string line;
+	uint32_t lineNum = 0;
+	while (std::getline(file, line)) {
+		++lineNum;
+		const size_t comment = line.find('#');
+		if (comment != std::string::npos) { line = line.substr(0, comment); }
+
+		std::istringstream iss(line);
+		std::string key;
+		if (!(iss >> key)) { continue; }
+
+		bool ok = true;
+		if (key == "preset") {
+			std::string preset; ok = static_cast<bool>(iss >> preset);
+			if		(preset == "dk1")			{ p = DK1(); }
+			else if (preset == "hd2160x1200")	{ p = HD2160x1200(); }
+			else								{ ok = false; }
+		}
+		else if (key == "name")					{ ok = static_cast<bool>(iss >> p.name); }
+		else if (key == "resolution")			{ ok = static_cast<bool>(iss >> p.width >> p.height); }
+		else if (key == "hScreenSize")			{ ok = static_cast<bool>(iss >> p.hScreenSize); }
+		else if (key == "lensSeparation")		{ ok = static_cast<bool>(iss >> p.lensSeparation); }
+		else if (key == "lensVisibleRadius")	{ ok = static_cast<bool>(iss >> p.lensVisibleRadius); }
+		else if (key == "hmdWarpParam")			{ ok = static_cast<bool>(iss >> p.hmdWarpParam.x >> p.hmdWarpParam.y >> p.hmdWarpParam.z >> p.hmdWarpParam.w); }
+		else if (key == "chromAbParam")			{ ok = static_cast<bool>(iss >> p.chromAbParam.x >> p.chromAbParam.y >> p.chromAbParam.z >> p.chromAbParam.w); }
+		else if (key == "middleRegionRadius")	{ ok = static_cast<bool>(iss >> p.middleRegionRadius); }
+		else if (key == "ndcCenterOffset")		{ ok = static_cast<bool>(iss >> p.ndcCenterOffset); }
+		else									{ ok = false; }
+
+		if (!ok) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": bad line " << lineNum << " in hmd profile " << path << "!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	//stencil and render targets need even dims
+	if (p.width == 0 || p.height == 0 || (p.width & 1) == 1 || (p.height & 1) == 1) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": hmd profile " << path << " resolution must be even and non zero!";
+		throw std::runtime_error(ss.str());
+	}
+	return p;
+}
+
+const HmdProfile& HmdProfile::get() {
+	static const HmdProfile profile = [] {
+		std::ifstream exists(hmdProfilePath);
+		if (!exists.is_open()) {
+			std::cout << "\nNo hmd profile at " << hmdProfilePath << ", using dk1 preset";
+			return DK1();
+		}
+		HmdProfile p = loadFromFile(hmdProfilePath);
+		std::cout << "\nLoaded hmd profile " << p.name << " (" << p.width << "x" << p.height << ") from " << hmdProfilePath;
+		return p;
+	}();
+	return profile;
+}
+
+HmdSpecializationData HmdProfile::getSpecializationData() const {
+	//left eye, the shaders mirror the lens center shift for the right
+	const EyeDistortionConstants eye = LensDistortion::calcEyeConstants(*this, 0);
+
+	HmdSpecializationData data;
+	data.warpK[0] = hmdWarpParam.x;		data.warpK[1] = hmdWarpParam.y;
+	data.warpK[2] = hmdWarpParam.z;		data.warpK[3] = hmdWarpParam.w;
+	data.chromAb[0] = chromAbParam.x;	data.chromAb[1] = chromAbParam.y;
+	data.chromAb[2] = chromAbParam.z;	data.chromAb[3] = chromAbParam.w;
+	data.lensCenterShift = eye.lensCenter.x - 0.25f;
+	data.scale[0] = eye.scale.x;		data.scale[1] = eye.scale.y;
+	data.scaleIn[0] = eye.scaleIn.x;	data.scaleIn[1] = eye.scaleIn.y;
+	data.middleRegionRadius = middleRegionRadius;
+	data.ndcCenterOffset = ndcCenterOffset;
+	return data;
+}
+
+std::vector<VkSpecializationMapEntry> HmdProfile::getSpecializationMapEntries() {
+	static_assert(sizeof(HmdSpecializationData) == HmdSpecializationData::NUM_CONSTANTS * sizeof(float),
+		"HmdSpecializationData must be tightly packed floats");
+	std::vector<VkSpecializationMapEntry> entries(HmdSpecializationData::NUM_CONSTANTS);
+	for (uint32_t i = 0; i < HmdSpecializationData::NUM_CONSTANTS; ++i) {
+		entries[i].constantID = i;
+		entries[i].offset = i * sizeof(float);
+		entries[i].size = sizeof(float);
+	}
+	return entries;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//flat list of floats handed to the post process shaders as specialization constants
+//the member order IS the constant_id (see shaders, constant_id = index into this struct)
+struct HmdSpecializationData {
+	float warpK[4];				//0-3   HmdWarpParam
+	float chromAb[4];			//4-7   ChromAbParam
+	float lensCenterShift;		//8     uv shift of the left lens center from the left eye's center (right is negated)
+	float scale[2];				//9-10  Scale
+	float scaleIn[2];			//11-12 ScaleIn
+	float middleRegionRadius;	//13    stencil: inside this eye ndc radius is full res
+	float ndcCenterOffset;		//14    stencil: eye ndc x offset of the lens center (right is negated)
+
+	static const uint32_t NUM_CONSTANTS = 15;
+};
+
+//everything about the headset the cpu and shaders need: panel, lens and stencil tuning
+class HmdProfile {
+public:
+	HmdProfile();
+	~HmdProfile();
+
+	//presets
+	static HmdProfile DK1();
+	static HmdProfile HD2160x1200();
+
+	//text file, one "key value(s)" per line, # comments. "preset <name>" first to start from a preset
+	static HmdProfile loadFromFile(const std::string& path);
+
+	//the active profile, loaded from hmdProfilePath (GlobalSettings.h) on first use
+	static const HmdProfile& get();
+
+	HmdSpecializationData getSpecializationData() const;
+	static std::vector<VkSpecializationMapEntry> getSpecializationMapEntries();
+
+public:
+	std::string name;
+	uint32_t width;				//full panel resolution, both eyes
+	uint32_t height;
+	float hScreenSize;			//meters
+	float lensSeparation;		//meters
+	float lensVisibleRadius;	//meters from the lens center on the panel that can be seen through the lens, 0 is unlimited
+	glm::vec4 hmdWarpParam;
+	glm::vec4 chromAbParam;
+
+	//stencil mask tuning (eye ndc)
+	float middleRegionRadius;
+	float ndcCenterOffset;
+};
@@ -0,0 +1,203 @@
+#pragma once
+#include "HoleFillClassification.h"
+#include "PreMadeStencil.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+
+//ppStencilHoleFillClassified.frag's tap tables, per pixel id
+static const int32_t checkerHoleTaps[4][4][2] = {
+	{ { 0, -1}, {-1,  0}, { 2,  0}, { 0,  2} },
+	{ { 0, -1}, { 1,  0}, {-2,  0}, { 0,  2} },
+	{ { 0,  1}, {-1,  0}, { 2,  0}, { 0, -2} },
+	{ { 0,  1}, { 1,  0}, {-2,  0}, { 0, -2} } };
+static const int32_t renderedCheckerTaps[4][4][2] = {//self isn't listed, it's rendered
+	{ {-1, -1}, { 2, -1}, {-1,  2}, { 2,  2} },
+	{ { 1, -1}, {-2, -1}, { 1,  2}, {-2,  2} },
+	{ {-1,  1}, { 2,  1}, {-1, -2}, { 2, -2} },
+	{ { 1,  1}, {-2,  1}, { 1, -2}, {-2, -2} } };
+
+int32_t HoleFillClassification::getQuadDensityShift(const PreMadeStencil& stencil, const uint32_t camIndex,
+	const int32_t qx, const int32_t qy)
+{
+	//PreMadeStencil::createRingStencilMask's test: the quad's lower right pixel, the first ring it's inside of
+	const float invWidth = 1.f / stencil.width;
+	const float invHeight = 1.f / stencil.height;
+	const float u = (2*qx + 1)*invWidth;
+	const float v = (2*qy + 1)*invHeight;
+	const float ndcScaleY = stencil.height / (stencil.width*0.5f);
+	const float dx = (u - 0.5f*camIndex)*4.f - 1.f - stencil.ndcCenter[camIndex].x;
+	const float dy = (v*2.f - 1.f)*ndcScaleY - stencil.ndcCenter[camIndex].y;
+	const float radius = std::sqrt(dx*dx + dy*dy);
+
+	for (const StencilRing& ring : stencil.rings) {
+		if (radius <= ring.outerRadius) {
+			return static_cast<int32_t>(ring.densityShift);
+		}
+	}
+	return -1;
+}
+
+uint8_t HoleFillClassification::getQuadClass(const PreMadeStencil& stencil, const uint32_t camIndex,
+	const uint32_t qx, const uint32_t qy)
+{
+	const int32_t densityShift = getQuadDensityShift(stencil, camIndex, static_cast<int32_t>(qx), static_cast<int32_t>(qy));
+	if (densityShift < 0) {
+		return CLASS_OUTSIDE;
+	}
+	const bool shaded = PreMadeStencil::quadShaded(static_cast<uint32_t>(densityShift), qx, qy);
+	if (densityShift == 1) {
+		return shaded ? CLASS_RENDERED_CHECKER : CLASS_CHECKER_HOLE;
+	} else if (shaded) {
+		return CLASS_RENDERED;
+	}
+	return densityShift == 2 ? CLASS_QUARTER_HOLE : CLASS_EIGHTH_HOLE;
+}
+
+bool HoleFillClassification::tapRendered(const PreMadeStencil& stencil, const std::vector<int8_t>* quadShifts,
+	const uint32_t camIndex, const int32_t x, const int32_t y)
+{
+	//floor, taps can land left of or above the render target
+	const int32_t qx = (x < 0 ? x - 1 : x) / 2;
+	const int32_t qy = (y < 0 ? y - 1 : y) / 2;
+	const int32_t quadsX = stencil.width / 2;
+	const int32_t quadsY = stencil.height / 2;
+	const int32_t densityShift = (qx >= 0 && qy >= 0 && qx < quadsX && qy < quadsY) ?
+		quadShifts[camIndex][qy*quadsX + qx] : getQuadDensityShift(stencil, camIndex, qx, qy);
+	//past the last ring it reads black like the output there. the quad tests only use the low bits, negative quads wrap fine
+	return densityShift < 0 ||
+		PreMadeStencil::quadShaded(static_cast<uint32_t>(densityShift), static_cast<uint32_t>(qx), static_cast<uint32_t>(qy));
+}
+
+uint8_t HoleFillClassification::resolveBoundary(const PreMadeStencil& stencil, const std::vector<int8_t>* quadShifts,
+	const uint32_t camIndex, const uint8_t pixelClass, const int32_t x, const int32_t y)
+{
+	const uint32_t pixelID = (x & 1) | ((y & 1) << 1);
+	if (pixelClass == CLASS_RENDERED_CHECKER) {
+		for (uint32_t i = 0; i < 4; ++i) {
+			if (!tapRendered(stencil, quadShifts, camIndex, x + renderedCheckerTaps[pixelID][i][0], y + renderedCheckerTaps[pixelID][i][1])) {
+				return CLASS_RENDERED;
+			}
+		}
+		return pixelClass;
+	}
+	if (pixelClass == CLASS_CHECKER_HOLE) {
+		bool tapsRendered = true;
+		for (uint32_t i = 0; i < 4 && tapsRendered; ++i) {
+			tapsRendered = tapRendered(stencil, quadShifts, camIndex, x + checkerHoleTaps[pixelID][i][0], y + checkerHoleTaps[pixelID][i][1]);
+		}
+		if (tapsRendered) {
+			return pixelClass;
+		}
+	}
+	if (pixelClass == CLASS_CHECKER_HOLE || pixelClass == CLASS_QUARTER_HOLE) {
+		//ppStencilHoleFillClassified.frag's quarter lattice fill corners, lattice point i is pixel 4i+1
+		const int32_t baseX = static_cast<int32_t>(std::floor((x + 0.5f - 1.f) * 0.25f));
+		const int32_t baseY = static_cast<int32_t>(std::floor((y + 0.5f - 1.f) * 0.25f));
+		for (uint32_t i = 0; i < 4; ++i) {
+			const int32_t cornerX = (baseX + (i & 1))*4 + 1;
+			const int32_t cornerY = (baseY + (i >> 1))*4 + 1;
+			if (!tapRendered(stencil, quadShifts, camIndex, cornerX, cornerY)) {
+				return CLASS_EIGHTH_HOLE;//the eighth lattice's quads are shaded in every ring
+			}
+		}
+		return CLASS_QUARTER_HOLE;
+	}
+	return pixelClass;
+}
+
+void HoleFillClassification::bake(const PreMadeStencil& stencil, std::vector<uint8_t>& out_texels) {
+	const uint32_t width = stencil.width;
+	const uint32_t height = stencil.height;
+	const uint32_t eyeWidth = width / 2;
+	const uint32_t quadsX = width / 2;
+	const uint32_t quadsY = height / 2;
+	out_texels.resize(width*height);
+
+	//every quad's ring against both eyes, a pixel's taps can cross the eye seam and are still tested against its own eye
+	std::vector<int8_t> quadShifts[2];
+	for (uint32_t camIndex = 0; camIndex < 2; ++camIndex) {
+		quadShifts[camIndex].resize(quadsX*quadsY);
+		for (uint32_t qy = 0; qy < quadsY; ++qy) {
+			for (uint32_t qx = 0; qx < quadsX; ++qx) {
+				quadShifts[camIndex][qy*quadsX + qx] = static_cast<int8_t>(getQuadDensityShift(stencil, camIndex, static_cast<int32_t>(qx), static_cast<int32_t>(qy)));
+			}
+		}
+	}
+
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		uint8_t* upperRow = &out_texels[(2*qy)*width];
+		uint8_t* lowerRow = upperRow + width;
+		for (uint32_t qx = 0; qx < quadsX; ++qx) {
+			//a quad can straddle the eyes if the eye width is odd, each pixel goes with the eye it's drawn in
+			const uint32_t leftCam = (2*qx >= eyeWidth) ? 1 : 0;
+			const uint32_t rightCam = (2*qx + 1 >= eyeWidth) ? 1 : 0;
+			const uint8_t leftClass = getQuadClass(stencil, leftCam, qx, qy);
+			const uint8_t rightClass = (leftCam == rightCam) ? leftClass : getQuadClass(stencil, rightCam, qx, qy);
+			const int32_t x = 2*qx;
+			const int32_t y = 2*qy;
+			upperRow[2*qx]		= resolveBoundary(stencil, quadShifts, leftCam,  leftClass,  x,     y)     | (0 << PIXEL_ID_SHIFT);
+			upperRow[2*qx + 1]	= resolveBoundary(stencil, quadShifts, rightCam, rightClass, x + 1, y)     | (1 << PIXEL_ID_SHIFT);
+			lowerRow[2*qx]		= resolveBoundary(stencil, quadShifts, leftCam,  leftClass,  x,     y + 1) | (2 << PIXEL_ID_SHIFT);
+			lowerRow[2*qx + 1]	= resolveBoundary(stencil, quadShifts, rightCam, rightClass, x + 1, y + 1) | (3 << PIXEL_ID_SHIFT);
+		}
+	}
+}
+
+VulkanImage HoleFillClassification::createImage(const VulkanContextInfo& contextInfo) {
+	const PreMadeStencil& stencil = contextInfo.radialDensityMasks[contextInfo.camera.qualityIndex];
+	std::vector<uint8_t> texels;
+	bake(stencil, texels);
+	const VkExtent2D extent = { stencil.width, stencil.height };
+	return VulkanImage(extent, format, texels.data(), texels.size(), contextInfo);
+}
+
+void HoleFillClassification::report(const VulkanContextInfo& contextInfo) {
+	std::cout << "\n\nHoleFillClassification report (" << PreMadeStencil::getTypeName(contextInfo.vrStencilType) << ", R8_UINT)";
+	std::cout << "\n\tlevel\textent\t\tbake ms\t\toutside\trendered\tchecker\tchecker holes\tlattice holes\teye overlap\tmask mismatches";
+	for (size_t i = 0; i < contextInfo.radialDensityMasks.size(); ++i) {
+		const PreMadeStencil& stencil = contextInfo.radialDensityMasks[i];
+
+		auto start = std::chrono::high_resolution_clock::now();
+		std::vector<uint8_t> texels;
+		bake(stencil, texels);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		//rendered classes should be exactly the mask's set pixels, except where the mask xors away a quad both eyes' rings
+		//shade (eye overlap, ppStencilHoleFill treats those as rendered too). the barrel sampling mask has no rings to compare
+		std::vector<uint8_t> maskPixels(stencil.width * stencil.height);
+		stencil.mask.expand(maskPixels.data(), 1);
+		std::array<uint32_t, 6> classCounts = {};
+		uint32_t overlaps = 0;
+		uint32_t mismatches = 0;
+		for (uint32_t y = 0; y < stencil.height; ++y) {
+			for (uint32_t x = 0; x < stencil.width; ++x) {
+				const uint32_t pixelClass = texels[y*stencil.width + x] & CLASS_MASK;
+				++classCounts[pixelClass];
+				const bool rendered = pixelClass == CLASS_RENDERED || pixelClass == CLASS_RENDERED_CHECKER;
+				if (rendered == (maskPixels[y*stencil.width + x] != 0)) {
+					continue;
+				}
+				const uint32_t otherCam = (x >= stencil.width / 2) ? 0 : 1;
+				const uint8_t otherClass = getQuadClass(stencil, otherCam, x / 2, y / 2);
+				const bool otherRendered = otherClass == CLASS_RENDERED || otherClass == CLASS_RENDERED_CHECKER;
+				overlaps += (rendered && otherRendered) ? 1 : 0;
+				mismatches += (rendered && otherRendered) ? 0 : 1;
+			}
+		}
+
+		std::cout << "\n\t" << i << "\t" << stencil.width << "x" << stencil.height << "\t"
+			<< std::chrono::duration<double, std::milli>(end - start).count() << "\t\t"
+			<< classCounts[CLASS_OUTSIDE] << "\t" << classCounts[CLASS_RENDERED] << "\t\t" << classCounts[CLASS_RENDERED_CHECKER] << "\t"
+			<< classCounts[CLASS_CHECKER_HOLE] << "\t\t" << classCounts[CLASS_QUARTER_HOLE] + classCounts[CLASS_EIGHTH_HOLE] << "\t\t";
+		if (StencilType::PreCalcBarrelSamplingMask == stencil.type) {
+			std::cout << "-\t\t-";
+		} else {
+			std::cout << overlaps << "\t\t" << mismatches;
+		}
+	}
+	std::cout << std::endl;
+}
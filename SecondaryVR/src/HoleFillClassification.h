@@ -0,0 +1,51 @@
+#pragma once
+#include "VulkanImage.h"
+#include "VulkanContextInfo.h"
+#include <vector>
+#include <cstdint>
+
+class PreMadeStencil;
+
+//Baked hole fill class of every vr render target pixel for ppStencilHoleFillClassified.frag, R8_UINT, one texel per pixel
+//of the stencil's extent. Made from the same rings and quad test as PreMadeStencil::createRingStencilMask whenever the quality
+//level or stencil type changes, so the shader does one texelFetch and a fixed tap pattern instead of the lens radius,
+//ring and checker parity tests.
+//A hole's class is the fill it gets, not only its ring: near a sparser ring some of its own ring's taps land on quads that
+//ring never shades, so it's baked as the sparser ring's lattice hole (those quads are shaded in both, the patterns are nested),
+//and a rendered checker pixel whose diagonal taps reach one is fetched as is (ppStencilHoleFill.frag's fillHole)
+//	bits 0-2: CLASS_*
+//	bits 3-4: the pixel's place in its 2x2 quad, numbered like reading a book (0 upper left, 3 lower right)
+class HoleFillClassification {
+public:
+	static const VkFormat format = VK_FORMAT_R8_UINT;
+
+	static const uint8_t CLASS_OUTSIDE			= 0;//past the last ring, black
+	static const uint8_t CLASS_RENDERED			= 1;//full density ring or a shaded quad of a quarter/eighth ring, fetched as is
+	static const uint8_t CLASS_RENDERED_CHECKER	= 2;//shaded quad of a checker ring, reshaded with its diagonal neighbours
+	static const uint8_t CLASS_CHECKER_HOLE		= 3;
+	static const uint8_t CLASS_QUARTER_HOLE		= 4;
+	static const uint8_t CLASS_EIGHTH_HOLE		= 5;
+	static const uint32_t CLASS_MASK = 0x7;
+	static const uint32_t PIXEL_ID_SHIFT = 3;
+
+	//out_texels is stencil.width*stencil.height, each half of it classified against its own eye's lens center
+	static void bake(const PreMadeStencil& stencil, std::vector<uint8_t>& out_texels);
+
+	//bakes and uploads for the stencil in the depth image (radialDensityMasks[camera.qualityIndex])
+	static VulkanImage createImage(const VulkanContextInfo& contextInfo);
+
+	//bake time, size and pixels per class at every quality level, and the rendered/hole pixels that disagree with the stencil mask
+	static void report(const VulkanContextInfo& contextInfo);
+
+private:
+	//first ring the quad's lower right pixel is inside of, -1 past the last one. quads off the render target are fine
+	static int32_t getQuadDensityShift(const PreMadeStencil& stencil, const uint32_t camIndex, const int32_t qx, const int32_t qy);
+	static uint8_t getQuadClass(const PreMadeStencil& stencil, const uint32_t camIndex, const uint32_t qx, const uint32_t qy);
+
+	//quadShifts[camIndex] is getQuadDensityShift of every quad against that eye, the taps of a pixel use its own eye's
+	static bool tapRendered(const PreMadeStencil& stencil, const std::vector<int8_t>* quadShifts, const uint32_t camIndex,
+		const int32_t x, const int32_t y);
+	//the class of the fill whose taps were all rendered, the same steps out as ppStencilHoleFill.frag's fillHole
+	static uint8_t resolveBoundary(const PreMadeStencil& stencil, const std::vector<int8_t>* quadShifts, const uint32_t camIndex,
+		const uint8_t pixelClass, const int32_t x, const int32_t y);
+};
@@ -0,0 +1,217 @@
+#pragma once
+#include "InverseDistortion.h"
+#include "GlobalSettings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <cmath>
+
+
+InverseDistortion::InverseDistortion() {
+}
+
+InverseDistortion::~InverseDistortion() {
+}
+
+InverseDistortion::InverseDistortion(const EyeDistortionConstants& eye, const uint32_t camIndex, const uint32_t lutSize)
+	: eye(eye), camIndex(camIndex)
+{
+	//largest distorted radius we expect to be asked about is a corner of this eye's half of the screen
+	const float x = 0.5f*camIndex;
+	const glm::vec2 corners[4] = { glm::vec2(x, 0.f), glm::vec2(x + 0.5f, 0.f),
+								   glm::vec2(x, 1.f), glm::vec2(x + 0.5f, 1.f) };
+	maxRho = 0.f;
+	for (const glm::vec2& c : corners) {
+		maxRho = std::max(maxRho, glm::length((c - eye.lensCenter) / eye.scale));
+	}
+
+	const float rhoStep = maxRho / (lutSize - 1);
+	invRhoStep = 1.f / rhoStep;
+
+	//bisection is slow but always converges, only done once here
+	radialLUT.resize(lutSize);
+	radialLUT[0] = 0.f;
+	for (uint32_t i = 1; i < lutSize; ++i) {
+		const float rho = i*rhoStep;
+		float lo = radialLUT[i - 1];
+		float hi = findUpperBracket(rho, lo);
+		for (int iter = 0; iter < 64 && (hi - lo) > 1e-7f; ++iter) {
+			const float mid = 0.5f*(lo + hi);
+			if (warp(mid) < rho) { lo = mid; } else { hi = mid; }
+		}
+		radialLUT[i] = 0.5f*(lo + hi);
+	}
+}
+
+const InverseDistortion& InverseDistortion::getEye(const uint32_t camIndex) {
+	static const InverseDistortion eyes[2] = {
+		InverseDistortion(LensDistortion::getEyeConstants(0), 0),
+		InverseDistortion(LensDistortion::getEyeConstants(1), 1) };
+	return eyes[camIndex];
+}
+
+float InverseDistortion::warp(const float r) const {
+	const float rSq = r*r;
+	return r * (eye.hmdWarpParam.x + rSq*(eye.hmdWarpParam.y + rSq*(eye.hmdWarpParam.z + rSq*eye.hmdWarpParam.w)));
+}
+
+float InverseDistortion::warpDerivative(const float r) const {
+	const float rSq = r*r;
+	return eye.hmdWarpParam.x + rSq*(3.f*eye.hmdWarpParam.y + rSq*(5.f*eye.hmdWarpParam.z + rSq*7.f*eye.hmdWarpParam.w));
+}
+
+//grow the bracket until it contains the root (only needed past the end of the table)
+float InverseDistortion::findUpperBracket(const float rho, const float lo) const {
+	float hi = std::max(lo * 2.f, lo + 0.5f);
+	for (int i = 0; i < 32 && warp(hi) < rho; ++i) {
+		hi *= 2.f;
+	}
+	return hi;
+}
+
+float InverseDistortion::solveRadius(const float rho, float lo, float hi, float r) const {
+	for (uint32_t iter = 0; iter < MAX_ITERATIONS; ++iter) {
+		const float err = warp(r) - rho;
+		if (std::abs(err) < 1e-7f) { break; }
+		if (err < 0.f) { lo = r; } else { hi = r; }
+
+		//newton step, fall back to bisection if it leaves the bracket
+		const float deriv = warpDerivative(r);
+		float next = (deriv > 0.f) ? r - err / deriv : lo - 1.f;
+		if (next <= lo || next >= hi) {
+			next = 0.5f*(lo + hi);
+		}
+		r = next;
+	}
+	return r;
+}
+
+float InverseDistortion::inverseRadius(const float rho) const {
+	if (rho <= 0.f) { return 0.f; }
+
+	const float t = rho*invRhoStep;
+	const uint32_t i = static_cast<uint32_t>(t);
+	if (i + 1 < radialLUT.size()) {
+		//table entries bracket the root since the warp is monotonic
+		const float lo = radialLUT[i];
+		const float hi = radialLUT[i + 1];
+		return solveRadius(rho, lo, hi, lo + (hi - lo)*(t - i));
+	} else {
+		const float lo = radialLUT.back();
+		const float hi = findUpperBracket(rho, lo);
+		return solveRadius(rho, lo, hi, 0.5f*(lo + hi));
+	}
+}
+
+glm::vec2 InverseDistortion::inverseUV(const glm::vec2& tcGreen) const {
+	//undo tcGreen = LensCenter + Scale * theta1
+	const glm::vec2 theta1 = (tcGreen - eye.lensCenter) / eye.scale;
+	const float rho = glm::length(theta1);
+	if (rho < 1e-12f) { return eye.lensCenter; }
+
+	//undo theta1 = theta * k(|theta|^2), direction is unchanged
+	const glm::vec2 theta = theta1 * (inverseRadius(rho) / rho);
+
+	//undo theta = (oTexCoord - LensCenter) * ScaleIn
+	return eye.lensCenter + theta / eye.scaleIn;
+}
+
+glm::vec3 InverseDistortion::inverseNDC(const glm::vec3& ndc) const {
+	const glm::vec2 uv((ndc.x + 1.f)*0.25f + 0.5f*camIndex, (ndc.y + 1.f)*0.5f);
+	const glm::vec2 inv = inverseUV(uv);
+	return glm::vec3((inv.x - 0.5f*camIndex)*4.f - 1.f, inv.y*2.f - 1.f, ndc.z);
+}
+
+
+//////////////////////////////////////////////////////////////////
+///// OLD SECANT METHOD, ONLY KEPT AROUND TO COMPARE AGAINST /////
+//////////////////////////////////////////////////////////////////
+namespace {
+	glm::vec2 convertRadToUV(const glm::vec2 normalized_ndc, const float radius, const uint32_t camIndex) {
+		const int vrMode = 1;
+		glm::vec2 ndc = radius * normalized_ndc;
+		glm::vec2 uv = (ndc + 1.f)*0.5f;
+		uv.x = (uv.x * (1.f - 0.5f*vrMode)) + 0.5f*camIndex;
+		return uv;
+	}
+
+	float convertUVToRad(const glm::vec2 uv, const uint32_t camIndex) {
+		const glm::vec2 equivNDC = glm::vec2((uv.x - 0.5*camIndex)*4.f - 1.f, uv.y*2.f - 1.f);
+		return length(equivNDC);
+	}
+
+	//the loop is capped here (it wasn't in Mesh.cpp) so the sweep can't hang, out_converged reports if it got there
+	glm::vec3 secantDistortInverse(glm::vec3 ndc, const uint32_t camIndex, bool& out_converged) {
+		const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+		glm::vec2 tcRed, tcGreen, tcBlue;
+		glm::vec2 normalized_ndc = glm::normalize(glm::vec2(ndc.x, ndc.y));
+		float radius = glm::length(glm::vec2(ndc.x, ndc.y));
+
+		float r0 = 0.f;
+		float r1 = 1.f;
+		LensDistortion::getSourceUV(eye, convertRadToUV(normalized_ndc, r0, camIndex), tcRed, tcGreen, tcBlue);
+		float dr0 = radius - convertUVToRad(tcGreen, camIndex);
+		int iter = 0;
+		while (std::abs(r1 - r0) > 0.001 && iter++ < 1000) {
+			LensDistortion::getSourceUV(eye, convertRadToUV(normalized_ndc, r1, camIndex), tcRed, tcGreen, tcBlue);
+			float dr1 = radius - convertUVToRad(tcGreen, camIndex);
+			float r2 = r1 - dr1 * ((r1 - r0) / (dr1 - dr0));
+			r0 = r1;
+			r1 = r2;
+			dr0 = dr1;
+		}
+		out_converged = std::abs(r1 - r0) <= 0.001 && std::isfinite(r1);
+		return glm::vec3(normalized_ndc * r1, ndc.z);
+	}
+}
+
+void InverseDistortion::benchmark() {
+	//every hmd pixel center of an eye as the target ndc, error is how far (in hmd pixels)
+	//the forward warp of the inverted point lands from the target
+	const uint32_t hmdWidth = HmdProfile::get().width;
+	const uint32_t hmdHeight = HmdProfile::get().height;
+	const uint32_t eyeWidth = hmdWidth / 2;
+	const glm::vec2 toPixels(hmdWidth, hmdHeight);
+
+	for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+		const InverseDistortion& inv = getEye(camIndex);
+		const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+
+		double lutTime = 0.0, secantTime = 0.0;
+		float lutMaxError = 0.f, secantMaxError = 0.f;
+		uint32_t secantFailures = 0;
+		uint32_t count = 0;
+		glm::vec2 tcRed, tcGreen, tcBlue;
+
+		for (uint32_t y = 0; y < hmdHeight; ++y) {
+			for (uint32_t x = 0; x < eyeWidth; ++x) {
+				const glm::vec3 ndc((x + 0.5f) / eyeWidth * 2.f - 1.f, (y + 0.5f) / hmdHeight * 2.f - 1.f, 0.5f);
+				const glm::vec2 target((ndc.x + 1.f)*0.25f + 0.5f*camIndex, (ndc.y + 1.f)*0.5f);
+
+				auto start = std::chrono::high_resolution_clock::now();
+				const glm::vec3 lutResult = inv.inverseNDC(ndc);
+				auto mid = std::chrono::high_resolution_clock::now();
+				bool converged;
+				const glm::vec3 secantResult = secantDistortInverse(ndc, camIndex, converged);
+				auto end = std::chrono::high_resolution_clock::now();
+				lutTime		+= std::chrono::duration<double, std::micro>(mid - start).count();
+				secantTime	+= std::chrono::duration<double, std::micro>(end - mid).count();
+				++count;
+
+				LensDistortion::getSourceUV(eye, glm::vec2((lutResult.x + 1.f)*0.25f + 0.5f*camIndex, (lutResult.y + 1.f)*0.5f), tcRed, tcGreen, tcBlue);
+				lutMaxError = std::max(lutMaxError, glm::length((tcGreen - target)*toPixels));
+
+				if (!converged) { ++secantFailures; continue; }
+				LensDistortion::getSourceUV(eye, glm::vec2((secantResult.x + 1.f)*0.25f + 0.5f*camIndex, (secantResult.y + 1.f)*0.5f), tcRed, tcGreen, tcBlue);
+				secantMaxError = std::max(secantMaxError, glm::length((tcGreen - target)*toPixels));
+			}
+		}
+
+		std::cout << "\n\nInverseDistortion sweep, camIndex " << camIndex << " (" << count << " ndc points)";
+		std::cout << "\n\tlut+newton: max error " << lutMaxError << " px, " << lutTime / count << " us/inversion";
+		std::cout << "\n\tsecant:     max error " << secantMaxError << " px, " << secantTime / count << " us/inversion, "
+			<< secantFailures << " did not converge";
+	}
+	std::cout << std::endl;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "LensDistortion.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+//Inverse of the Brown-Conrady warp for one eye.
+//The warp is purely radial about the lens center: theta1 = theta * k(|theta|^2)
+//so inverting a point is one 1D root find, r*k(r^2) = rho, which is seeded from a
+//monotonic radial table and refined with bracketed newton (bisection fallback)
+class InverseDistortion {
+public:
+	InverseDistortion();
+	InverseDistortion(const EyeDistortionConstants& eye, const uint32_t camIndex, const uint32_t lutSize = 1024);
+	~InverseDistortion();
+
+	//built once per eye, camIndex 0 is left 1 is right
+	static const InverseDistortion& getEye(const uint32_t camIndex);
+
+	//r such that r*k(r^2) == rho (rho is distorted radius in lens space)
+	float inverseRadius(const float rho) const;
+	//absolute screen sampling uv (green channel) -> absolute screen uv that samples it
+	glm::vec2 inverseUV(const glm::vec2& tcGreen) const;
+	//eye ndc of where we want to sample -> eye ndc of where to put the vertex
+	glm::vec3 inverseNDC(const glm::vec3& ndc) const;
+
+	//sweeps the ndc grid of both eyes, reports max error and time per inversion vs the old secant method
+	static void benchmark();
+
+public:
+	EyeDistortionConstants eye;
+	uint32_t camIndex;
+
+	//radialLUT[i] = r for rho = i*rhoStep
+	std::vector<float> radialLUT;
+	float maxRho;
+	float invRhoStep;
+
+	static const uint32_t MAX_ITERATIONS = 8;
+
+private:
+	float warp(const float r) const;
+	float warpDerivative(const float r) const;
+	float solveRadius(const float rho, float lo, float hi, float r) const;
+	float findUpperBracket(const float rho, float lo) const;
+};
@@ -0,0 +1,250 @@
+#pragma once
+#include "LensDistortion.h"
+#include "GlobalSettings.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <cmath>
+
+
+void SourceUVBatch::resize(const uint32_t count) {
+	redU.resize(count);		redV.resize(count);
+	greenU.resize(count);	greenV.resize(count);
+	blueU.resize(count);	blueV.resize(count);
+}
+
+EyeDistortionConstants LensDistortion::calcEyeConstants(const HmdProfile& hmd, const uint32_t camIndex) {
+	//modified code sample from old oculus demo implementation
+	const glm::vec4 HmdWarpParam = hmd.hmdWarpParam;
+	const glm::vec4 ChromAbParam = hmd.chromAbParam;
+	const float HMD_HResolution = hmd.width;
+	const float HMD_VResolution = hmd.height;
+	const float HMD_HScreenSize = hmd.hScreenSize;
+	const float HMD_LensSeparationDistance = hmd.lensSeparation;
+	const float lensOffset = HMD_LensSeparationDistance * 0.5;
+	const float lensShift = HMD_HScreenSize * 0.25 - lensOffset;
+	const float Distortion_XCenterOffset = 4.0 * lensShift / HMD_HScreenSize;
+	const float DistortionFitX = -1.0;
+	const float DistortionFitY = 0.0;
+	const float stereoAspect = 0.5 * HMD_HResolution / HMD_VResolution;
+	const float dx = DistortionFitX - Distortion_XCenterOffset;
+	const float dy = DistortionFitY / stereoAspect;
+	const float fitRadiusSquared = dx * dx + dy * dy;
+	const float Distortion_Scale =
+		HmdWarpParam.x +
+		HmdWarpParam.y * fitRadiusSquared +
+		HmdWarpParam.z * fitRadiusSquared * fitRadiusSquared +
+		HmdWarpParam.w * fitRadiusSquared * fitRadiusSquared * fitRadiusSquared;
+	const float x = (camIndex == 0) ? 0.f : 0.5f;
+	const float y = 0.0;
+	const float w = 0.5;
+	const float h = 1.0;
+
+	const float XCenterOffset = (camIndex == 1) ? -Distortion_XCenterOffset : Distortion_XCenterOffset;
+	const float scaleFactor = 1.0 / Distortion_Scale;
+
+	EyeDistortionConstants eye;
+	eye.hmdWarpParam = HmdWarpParam;
+	eye.chromAbParam = ChromAbParam;
+	eye.lensCenter	= glm::vec2(x + (w + XCenterOffset * 0.5) * 0.5, y + h * 0.5);
+	eye.scale		= glm::vec2(w * 0.5 * scaleFactor, h * 0.5 * scaleFactor * stereoAspect);
+	eye.scaleIn		= glm::vec2(2.0 / w, 2.0 / h / stereoAspect);
+	return eye;
+}
+
+const EyeDistortionConstants& LensDistortion::getEyeConstants(const uint32_t camIndex) {
+	static const EyeDistortionConstants eyes[2] = { calcEyeConstants(HmdProfile::get(), 0),
+													calcEyeConstants(HmdProfile::get(), 1) };
+	return eyes[camIndex];
+}
+
+void LensDistortion::getSourceUV(const EyeDistortionConstants& eye, const glm::vec2& oTexCoord,
+	glm::vec2& out_tcRed, glm::vec2& out_tcGreen, glm::vec2& out_tcBlue) {
+
+	// Compute the warp
+	const glm::vec2 theta = (oTexCoord - eye.lensCenter) * eye.scaleIn; // Scales to [-1, 1]
+	const float rSq = theta.x * theta.x + theta.y * theta.y;
+	const glm::vec2 theta1 = theta * (
+		eye.hmdWarpParam.x +
+		eye.hmdWarpParam.y * rSq +
+		eye.hmdWarpParam.z * rSq * rSq +
+		eye.hmdWarpParam.w * rSq * rSq * rSq);
+
+	// Compute chromatic aberration
+	const glm::vec2 thetaRed = theta1 * (eye.chromAbParam.x + eye.chromAbParam.y * rSq);
+	const glm::vec2 thetaBlue = theta1 * (eye.chromAbParam.z + eye.chromAbParam.w * rSq);
+	out_tcRed	= eye.lensCenter + eye.scale * thetaRed;
+	out_tcGreen = eye.lensCenter + eye.scale * theta1;
+	out_tcBlue	= eye.lensCenter + eye.scale * thetaBlue;
+}
+
+void LensDistortion::getSourceUVBatchScalar(const EyeDistortionConstants& eye, const float* inU, const float* inV,
+	const uint32_t count, SourceUVBatch& out)
+{
+	if (out.greenU.size() < count) { out.resize(count); }
+
+	glm::vec2 tcRed, tcGreen, tcBlue;
+	for (uint32_t i = 0; i < count; ++i) {
+		getSourceUV(eye, glm::vec2(inU[i], inV[i]), tcRed, tcGreen, tcBlue);
+		out.redU[i]		= tcRed.x;		out.redV[i]		= tcRed.y;
+		out.greenU[i]	= tcGreen.x;	out.greenV[i]	= tcGreen.y;
+		out.blueU[i]	= tcBlue.x;		out.blueV[i]	= tcBlue.y;
+	}
+}
+
+void LensDistortion::getSourceUVBatch(const EyeDistortionConstants& eye, const float* inU, const float* inV,
+	const uint32_t count, SourceUVBatch& out)
+{
+	if (out.greenU.size() < count) { out.resize(count); }
+
+	uint32_t i = 0;
+#if defined(__AVX__)
+	//8 wide
+	{
+		const __m256 lcX = _mm256_set1_ps(eye.lensCenter.x);
+		const __m256 lcY = _mm256_set1_ps(eye.lensCenter.y);
+		const __m256 sInX = _mm256_set1_ps(eye.scaleIn.x);
+		const __m256 sInY = _mm256_set1_ps(eye.scaleIn.y);
+		const __m256 sX = _mm256_set1_ps(eye.scale.x);
+		const __m256 sY = _mm256_set1_ps(eye.scale.y);
+		const __m256 k0 = _mm256_set1_ps(eye.hmdWarpParam.x);
+		const __m256 k1 = _mm256_set1_ps(eye.hmdWarpParam.y);
+		const __m256 k2 = _mm256_set1_ps(eye.hmdWarpParam.z);
+		const __m256 k3 = _mm256_set1_ps(eye.hmdWarpParam.w);
+		const __m256 c0 = _mm256_set1_ps(eye.chromAbParam.x);
+		const __m256 c1 = _mm256_set1_ps(eye.chromAbParam.y);
+		const __m256 c2 = _mm256_set1_ps(eye.chromAbParam.z);
+		const __m256 c3 = _mm256_set1_ps(eye.chromAbParam.w);
+		for (; i + 8 <= count; i += 8) {
+			const __m256 thetaX = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(inU + i), lcX), sInX);
+			const __m256 thetaY = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(inV + i), lcY), sInY);
+			const __m256 rSq = _mm256_add_ps(_mm256_mul_ps(thetaX, thetaX), _mm256_mul_ps(thetaY, thetaY));
+			//horner form of k0 + k1*r^2 + k2*r^4 + k3*r^6
+			__m256 warp = _mm256_add_ps(k2, _mm256_mul_ps(k3, rSq));
+			warp = _mm256_add_ps(k1, _mm256_mul_ps(warp, rSq));
+			warp = _mm256_add_ps(k0, _mm256_mul_ps(warp, rSq));
+			//fold lens scale in here so each channel is just one mul add
+			const __m256 t1X = _mm256_mul_ps(_mm256_mul_ps(thetaX, warp), sX);
+			const __m256 t1Y = _mm256_mul_ps(_mm256_mul_ps(thetaY, warp), sY);
+			const __m256 red  = _mm256_add_ps(c0, _mm256_mul_ps(c1, rSq));
+			const __m256 blue = _mm256_add_ps(c2, _mm256_mul_ps(c3, rSq));
+			_mm256_storeu_ps(&out.greenU[i], _mm256_add_ps(lcX, t1X));
+			_mm256_storeu_ps(&out.greenV[i], _mm256_add_ps(lcY, t1Y));
+			_mm256_storeu_ps(&out.redU[i],	 _mm256_add_ps(lcX, _mm256_mul_ps(t1X, red)));
+			_mm256_storeu_ps(&out.redV[i],	 _mm256_add_ps(lcY, _mm256_mul_ps(t1Y, red)));
+			_mm256_storeu_ps(&out.blueU[i],	 _mm256_add_ps(lcX, _mm256_mul_ps(t1X, blue)));
+			_mm256_storeu_ps(&out.blueV[i],	 _mm256_add_ps(lcY, _mm256_mul_ps(t1Y, blue)));
+		}
+	}
+#endif
+	//4 wide (sse2 is always there on x64, and the default for msvc x86)
+	{
+		const __m128 lcX = _mm_set1_ps(eye.lensCenter.x);
+		const __m128 lcY = _mm_set1_ps(eye.lensCenter.y);
+		const __m128 sInX = _mm_set1_ps(eye.scaleIn.x);
+		const __m128 sInY = _mm_set1_ps(eye.scaleIn.y);
+		const __m128 sX = _mm_set1_ps(eye.scale.x);
+		const __m128 sY = _mm_set1_ps(eye.scale.y);
+		const __m128 k0 = _mm_set1_ps(eye.hmdWarpParam.x);
+		const __m128 k1 = _mm_set1_ps(eye.hmdWarpParam.y);
+		const __m128 k2 = _mm_set1_ps(eye.hmdWarpParam.z);
+		const __m128 k3 = _mm_set1_ps(eye.hmdWarpParam.w);
+		const __m128 c0 = _mm_set1_ps(eye.chromAbParam.x);
+		const __m128 c1 = _mm_set1_ps(eye.chromAbParam.y);
+		const __m128 c2 = _mm_set1_ps(eye.chromAbParam.z);
+		const __m128 c3 = _mm_set1_ps(eye.chromAbParam.w);
+		for (; i + 4 <= count; i += 4) {
+			const __m128 thetaX = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(inU + i), lcX), sInX);
+			const __m128 thetaY = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(inV + i), lcY), sInY);
+			const __m128 rSq = _mm_add_ps(_mm_mul_ps(thetaX, thetaX), _mm_mul_ps(thetaY, thetaY));
+			__m128 warp = _mm_add_ps(k2, _mm_mul_ps(k3, rSq));
+			warp = _mm_add_ps(k1, _mm_mul_ps(warp, rSq));
+			warp = _mm_add_ps(k0, _mm_mul_ps(warp, rSq));
+			const __m128 t1X = _mm_mul_ps(_mm_mul_ps(thetaX, warp), sX);
+			const __m128 t1Y = _mm_mul_ps(_mm_mul_ps(thetaY, warp), sY);
+			const __m128 red  = _mm_add_ps(c0, _mm_mul_ps(c1, rSq));
+			const __m128 blue = _mm_add_ps(c2, _mm_mul_ps(c3, rSq));
+			_mm_storeu_ps(&out.greenU[i], _mm_add_ps(lcX, t1X));
+			_mm_storeu_ps(&out.greenV[i], _mm_add_ps(lcY, t1Y));
+			_mm_storeu_ps(&out.redU[i],	  _mm_add_ps(lcX, _mm_mul_ps(t1X, red)));
+			_mm_storeu_ps(&out.redV[i],	  _mm_add_ps(lcY, _mm_mul_ps(t1Y, red)));
+			_mm_storeu_ps(&out.blueU[i],  _mm_add_ps(lcX, _mm_mul_ps(t1X, blue)));
+			_mm_storeu_ps(&out.blueV[i],  _mm_add_ps(lcY, _mm_mul_ps(t1Y, blue)));
+		}
+	}
+
+	//leftovers
+	glm::vec2 tcRed, tcGreen, tcBlue;
+	for (; i < count; ++i) {
+		getSourceUV(eye, glm::vec2(inU[i], inV[i]), tcRed, tcGreen, tcBlue);
+		out.redU[i]		= tcRed.x;		out.redV[i]		= tcRed.y;
+		out.greenU[i]	= tcGreen.x;	out.greenV[i]	= tcGreen.y;
+		out.blueU[i]	= tcBlue.x;		out.blueV[i]	= tcBlue.y;
+	}
+}
+
+void LensDistortion::benchmark() {
+	//same sampling pattern as PreMadeStencil::createPreCalcBarrelSamplingStencilMask, pixel centers of the full hmd res
+	const uint32_t hmdWidth = HmdProfile::get().width;
+	const uint32_t hmdHeight = HmdProfile::get().height;
+	const float invHMDWidth = 1.f / hmdWidth;
+	const float invHMDHeight = 1.f / hmdHeight;
+	std::vector<float> rowU(hmdWidth);
+	std::vector<float> rowV(hmdWidth);
+	for (uint32_t x = 0; x < hmdWidth; ++x) {
+		rowU[x] = (x + 0.5f)*invHMDWidth;
+	}
+
+	SourceUVBatch scalarOut, batchOut;
+	scalarOut.resize(hmdWidth);
+	batchOut.resize(hmdWidth);
+
+	const int NUM_RUNS = 10;
+	double scalarTime = 0.0;
+	double batchTime = 0.0;
+	float maxError = 0.f;
+	float checksum = 0.f;//keep the optimizer from throwing the loops away
+
+	for (int run = 0; run < NUM_RUNS; ++run) {
+		for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+			const EyeDistortionConstants& eye = getEyeConstants(camIndex);
+			for (uint32_t y = 0; y < hmdHeight; ++y) {
+				std::fill(rowV.begin(), rowV.end(), (y + 0.5f)*invHMDHeight);
+
+				auto start = std::chrono::high_resolution_clock::now();
+				getSourceUVBatchScalar(eye, rowU.data(), rowV.data(), hmdWidth, scalarOut);
+				auto mid = std::chrono::high_resolution_clock::now();
+				getSourceUVBatch(eye, rowU.data(), rowV.data(), hmdWidth, batchOut);
+				auto end = std::chrono::high_resolution_clock::now();
+
+				scalarTime += std::chrono::duration<double, std::milli>(mid - start).count();
+				batchTime  += std::chrono::duration<double, std::milli>(end - mid).count();
+				checksum += scalarOut.greenU[y % hmdWidth] + batchOut.greenU[y % hmdWidth];
+
+				if (run > 0) { continue; }
+				for (uint32_t x = 0; x < hmdWidth; ++x) {
+					maxError = std::max(maxError, std::abs(scalarOut.redU[x]	- batchOut.redU[x]));
+					maxError = std::max(maxError, std::abs(scalarOut.redV[x]	- batchOut.redV[x]));
+					maxError = std::max(maxError, std::abs(scalarOut.greenU[x]	- batchOut.greenU[x]));
+					maxError = std::max(maxError, std::abs(scalarOut.greenV[x]	- batchOut.greenV[x]));
+					maxError = std::max(maxError, std::abs(scalarOut.blueU[x]	- batchOut.blueU[x]));
+					maxError = std::max(maxError, std::abs(scalarOut.blueV[x]	- batchOut.blueV[x]));
+				}
+			}
+		}
+	}
+
+	std::cout << "\n\nLensDistortion benchmark (" << hmdWidth << "x" << hmdHeight << " both eyes, " << NUM_RUNS << " runs)";
+#if defined(__AVX__)
+	std::cout << "\n\tbatch path: AVX";
+#else
+	std::cout << "\n\tbatch path: SSE";
+#endif
+	std::cout << "\n\tscalar: " << scalarTime / NUM_RUNS << " ms/mask";
+	std::cout << "\n\tbatch:  " << batchTime / NUM_RUNS << " ms/mask";
+	std::cout << "\n\tspeedup: " << scalarTime / batchTime << "x";
+	std::cout << "\n\tmax uv error vs scalar: " << maxError << " (" << maxError*hmdWidth << " px)";
+	std::cout << "\n\t(checksum " << checksum << ")" << std::endl;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "HmdProfile.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+//Brown-Conrady barrel distortion + chromatic aberration constants for one eye.
+//Everything Mesh::getSourceUV used to recompute per call is hoisted in here
+struct EyeDistortionConstants {
+	glm::vec4 hmdWarpParam;
+	glm::vec4 chromAbParam;
+	glm::vec2 lensCenter;
+	glm::vec2 scale;
+	glm::vec2 scaleIn;
+};
+
+//SoA output for a batch of source uv's (one array per channel per component)
+struct SourceUVBatch {
+	std::vector<float> redU,	redV;
+	std::vector<float> greenU,	greenV;
+	std::vector<float> blueU,	blueV;
+
+	void resize(const uint32_t count);
+};
+
+class LensDistortion {
+public:
+	//computed once per eye for the active HmdProfile, camIndex 0 is left 1 is right
+	static const EyeDistortionConstants& getEyeConstants(const uint32_t camIndex);
+	static EyeDistortionConstants calcEyeConstants(const HmdProfile& hmd, const uint32_t camIndex);
+
+	//scalar reference path, takes absolute screen uv and gives absolute screen sampling uv for rgb channels
+	static void getSourceUV(const EyeDistortionConstants& eye, const glm::vec2& oTexCoord,
+		glm::vec2& out_tcRed, glm::vec2& out_tcGreen, glm::vec2& out_tcBlue);
+
+	//batched SoA versions, inU/inV hold count uv's (e.g. a whole row of pixels)
+	//out is resized to count if its too small
+	static void getSourceUVBatch(const EyeDistortionConstants& eye, const float* inU, const float* inV,
+		const uint32_t count, SourceUVBatch& out);
+	static void getSourceUVBatchScalar(const EyeDistortionConstants& eye, const float* inU, const float* inV,
+		const uint32_t count, SourceUVBatch& out);
+
+	//compares batch vs scalar over every hmd pixel of both eyes, prints max error and timings
+	static void benchmark();
+};
@@ -6,6 +6,7 @@
 #include "Vertex.h"
 #include "VulkanImage.h"
 #include "VulkanDescriptor.h"
+#include "VulkanBuffer.h"
 
 
 struct Texture {
@@ -17,7 +18,7 @@ struct Texture {
 };
 
 enum class MESHTYPE {
-	NDCTRIANGLE = 0, NDCBARRELMESH, NDCBARRELMESH_PRECALC, NDCPIXELPOINTS,
+	NDCTRIANGLE = 0, NDCBARRELMESH, NDCBARRELMESH_PRECALC,
 };
 
 class Mesh {
@@ -26,6 +27,14 @@ public:
 	std::vector<unsigned int> mIndices;
 	std::vector<Texture> mTextures;
 
+	//post process meshes use the compact formats (see Vertex.h) instead of mVertices, only one of the three is filled
+	std::vector<PostProcessVertex> mPPVertices;
+	std::vector<PostProcessPreCalcVertex> mPPPreCalcVertices;
+
+	//precalc barrel mesh vertices (PostProcessPreCalcVertex's) straight from the HmdBakeBundle mapping, mPPPreCalcVertices is left empty
+	const void* mappedVertices = nullptr;
+	VkDeviceSize mappedVerticesSize = 0;
+
 	//vulkan vertex
 	VkBuffer vertexBuffer;
 	VkDeviceMemory vertexBufferMemory;
@@ -44,6 +53,11 @@ public:
 
 	//for barrel mesh
 	uint32_t quadsPerDim = 20;
+	float maxErrorPx = 0.5f;//precalc barrel mesh, max uv interpolation error in hmd pixels (BarrelMeshBuilder::buildForError), 0 uses the uniform quadsPerDim grid
+	//precalc barrel mesh, rings x segments polar mesh clipped to the visible lens region, 0 uses the grid above.
+	//off by default: 24x96 is 2401 verts at 0.73px max error, more and worse than the grid buildForError picks (BarrelMeshBuilder::report)
+	uint32_t lensRings = 0;
+	uint32_t lensSegments = 96;
 
 public: 
 	Mesh(const VulkanContextInfo& contextInfo, const MESHTYPE, uint32_t camIndex = 0);
@@ -51,11 +65,19 @@ public:
 	~Mesh();
 	Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
 		const std::vector<Texture>& textures, const VulkanContextInfo& contextInfo);
+	//cpu side only (no vulkan calls) so meshes can be built on worker threads, upload with queueUploads
+	void build(const VulkanContextInfo& contextInfo, const MESHTYPE meshtype, const uint32_t camIndex = 0);
+	//right eye precalc barrel mesh from the left eye's built (not mapped) mesh, the lens model is mirror symmetric
+	//about the middle of the screen (LensDistortion mirrors the lens center): eye ndc x and the 3 source u's flip
+	//and the winding is swapped to stay front facing
+	void mirrorToRightEye(const Mesh& leftEye);
+	//vertex (and index if any) buffer copies, submitted together with VulkanBuffer::submitUploads
+	void queueUploads(const VulkanContextInfo& contextInfo, std::vector<StagedUpload>& uploads);
 	void createDescriptor(const VulkanContextInfo& contextInfo, const VkBuffer& ubo, const uint32_t sizeofUBOstruct);
 	void createNDCTriangle(const VulkanContextInfo& contextInfo);
 	void createNDCBarrelMesh(const VulkanContextInfo& contextInfo, const uint32_t camIndex);
 	void createNDCBarrelMeshPreCalc(const VulkanContextInfo& contextInfo, const uint32_t camIndex);
-	void createNDCPixelPoints(const VulkanContextInfo& contextInfo);
+	void buildNDCBarrelMeshPreCalc(const uint32_t camIndex);//always builds, ignores the HmdBakeBundle
 
 	static void getSourceUV(const uint32_t camIndex, const glm::vec2& oTexCoord,
 		glm::vec2& out_tcRed, glm::vec2& out_tcGreen, glm::vec2& out_tcBlue);
@@ -0,0 +1,388 @@
+#pragma once
+#include "PostProcessGraph.h"
+#include "VulkanContextInfo.h"
+#include "VulkanRenderPass.h"
+#include "VulkanImage.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+
+PostProcessGraph::PostProcessGraph() {
+}
+
+PostProcessGraph::~PostProcessGraph() {
+}
+
+uint32_t PostProcessGraph::addPass(const PipelineType type, const std::vector<uint32_t>& inputs, const bool isPresent,
+	const std::vector<Mesh>& meshes)
+{
+	PostProcessGraphPass pass;
+	pass.pipelinetype = type;
+	pass.inputs = inputs;
+	pass.isPresent = isPresent;
+	pass.persistent = (type == PipelineType::TEMPORAL);
+	pass.inPlace = (type == PipelineType::HOLES_ONLY);
+	pass.meshes = meshes;
+	passes.push_back(pass);
+	return static_cast<uint32_t>(passes.size() - 1);
+}
+
+void PostProcessGraph::addLinearPasses(const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& stages) {
+	for (uint32_t i = 0; i < stages.size(); ++i) {
+		addPass((PipelineType)std::get<2>(stages[i]), { i == 0 ? FORWARD : i - 1 }, i == stages.size() - 1);
+	}
+}
+
+void PostProcessGraph::compile() {
+	forwardReadStages = 0;
+	for (uint32_t p = 0; p < passes.size(); ++p) {
+		passes[p].lastReader = p;
+		passes[p].readStages = 0;
+		passes[p].slot = NO_SLOT;
+		passes[p].previousInSlot = NO_SLOT;
+		if (passes[p].isPresent && p != passes.size() - 1) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": only the last pp pass can present!";
+			throw std::runtime_error(ss.str());
+		}
+		if (passes[p].inPlace && (passes[p].isPresent || passes[p].inputs.empty() || passes[p].inputs[0] != FORWARD)) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": in place pp pass " << p << " has to write the forward image it samples!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	for (uint32_t p = 0; p < passes.size(); ++p) {
+		for (const uint32_t input : passes[p].inputs) {
+			if (input == FORWARD) {
+				forwardReadStages |= getShaderStage(passes[p].pipelinetype);
+				continue;
+			}
+			if (input >= p) {
+				std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": pp pass " << p << " samples pass " << input << " which isn't before it!";
+				throw std::runtime_error(ss.str());
+			}
+			passes[input].lastReader = std::max(passes[input].lastReader, p);
+			passes[input].readStages |= getShaderStage(passes[p].pipelinetype);
+		}
+	}
+
+	//greedy in pass order: an output takes the first slot whose current output has no readers left, else a new slot
+	std::vector<uint32_t> slotOwners;
+	for (uint32_t p = 0; p < passes.size(); ++p) {
+		if (passes[p].isPresent || passes[p].persistent || passes[p].inPlace) {
+			continue;
+		}
+		for (uint32_t slot = 0; slot < slotOwners.size(); ++slot) {
+			if (passes[slotOwners[slot]].lastReader < p) {
+				passes[p].slot = slot;
+				passes[p].previousInSlot = slotOwners[slot];
+				slotOwners[slot] = p;
+				break;
+			}
+		}
+		if (passes[p].slot == NO_SLOT) {
+			passes[p].slot = static_cast<uint32_t>(slotOwners.size());
+			slotOwners.push_back(p);
+		}
+	}
+	slotSizes.assign(slotOwners.size(), 0);
+}
+
+VkMemoryRequirements PostProcessGraph::getSlotRequirements(const VulkanContextInfo& contextInfo, const uint32_t slot) const {
+	//every image in the slot is bound at offset 0, so the slot is the biggest of them in a memory type they all take
+	VkMemoryRequirements slotRequirements = {};
+	slotRequirements.memoryTypeBits = 0xFFFFFFFF;
+	for (const PostProcessGraphPass& pass : passes) {
+		if (pass.slot != slot) {
+			continue;
+		}
+		const VkMemoryRequirements requirements = VulkanImage::getMemoryRequirements(PostProcessPipeline::getOutputImageType(pass.pipelinetype),
+			contextInfo.camera.renderTargetExtent, PostProcessPipeline::outputFormat, contextInfo);
+		slotRequirements.size = std::max(slotRequirements.size, requirements.size);
+		slotRequirements.alignment = std::max(slotRequirements.alignment, requirements.alignment);
+		slotRequirements.memoryTypeBits &= requirements.memoryTypeBits;
+	}
+	return slotRequirements;
+}
+
+void PostProcessGraph::createSlotMemory(const VulkanContextInfo& contextInfo) {
+	slotMemory.resize(slotSizes.size());
+	for (uint32_t slot = 0; slot < slotSizes.size(); ++slot) {
+		const VkMemoryRequirements requirements = getSlotRequirements(contextInfo, slot);
+		slotSizes[slot] = requirements.size;
+
+		VkMemoryAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = requirements.size;
+		allocInfo.memoryTypeIndex = findMemoryType(contextInfo.physicalDevice, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		slotMemory[slot].resize(contextInfo.swapChainImages.size());
+		for (VkDeviceMemory& memory : slotMemory[slot]) {
+			if (vkAllocateMemory(contextInfo.device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+				std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to allocate pp slot memory!";
+				throw std::runtime_error(ss.str());
+			}
+		}
+	}
+}
+
+std::vector<VkDeviceMemory> PostProcessGraph::getOutputMemory(const uint32_t pass) const {
+	if (passes[pass].slot == NO_SLOT) {
+		return {};
+	}
+	return slotMemory[passes[pass].slot];
+}
+
+VkPipelineStageFlags PostProcessGraph::getShaderStage(const PipelineType type) {
+	return (type == PipelineType::COMPUTE) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+}
+
+VkPipelineStageFlags PostProcessGraph::getWaitStage() const {
+	return (passes.back().pipelinetype == PipelineType::COMPUTE) ?
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+}
+
+bool PostProcessGraph::isFirstReader(const uint32_t resource, const uint32_t pass) const {
+	for (uint32_t p = 0; p < pass; ++p) {
+		if (std::find(passes[p].inputs.begin(), passes[p].inputs.end(), resource) != passes[p].inputs.end()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PostProcessGraph::recordBarriersBefore(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const uint32_t pass,
+	const std::vector<PostProcessPipeline*>& pipelines, const std::vector<VulkanImage>& forwardImages) const
+{
+	VkPipelineStageFlags srcStages = 0;
+	VkPipelineStageFlags dstStages = 0;
+	std::vector<VkImageMemoryBarrier> barriers;
+
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+
+	//the forward pass's depth (temporal hole fill and time warp sample it, finalLayout already has it read only) comes
+	//with the forward color image, an in place pass stencil tests it
+	bool forwardDepth = false;
+	VkAccessFlags forwardDepthAccess = VK_ACCESS_SHADER_READ_BIT;
+
+	//inputs: the writer's output done and in SHADER_READ_ONLY_OPTIMAL (what the descriptors say) before its first reader,
+	//for every stage that samples it
+	for (const uint32_t input : passes[pass].inputs) {
+		if (!isFirstReader(input, pass)) {
+			continue;
+		}
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		if (input == FORWARD) {
+			if (forwardLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+				continue;
+			}
+			barrier.image = forwardImages[imageIndex].image;
+			barrier.oldLayout = forwardLayout;
+			barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			srcStages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			dstStages |= forwardReadStages;
+			forwardDepth = true;
+			if (passes[pass].inPlace) {//sampled and the attachment at once
+				barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+				barrier.dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+				dstStages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+					VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+				forwardDepthAccess |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+			}
+		} else if (passes[input].inPlace) {
+			//the forward image it wrote in GENERAL
+			barrier.image = forwardImages[imageIndex].image;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+			barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			srcStages |= pipelines[input]->getWaitStage();
+			dstStages |= passes[input].readStages;
+		} else {
+			const bool computeWriter = (passes[input].pipelinetype == PipelineType::COMPUTE);
+			barrier.image = pipelines[input]->outputImages[imageIndex].image;
+			barrier.oldLayout = computeWriter ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			barrier.srcAccessMask = computeWriter ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			srcStages |= pipelines[input]->getWaitStage();
+			dstStages |= passes[input].readStages;
+		}
+		barriers.push_back(barrier);
+	}
+
+	//output: an aliased slot's last readers are done before it's overwritten, compute writes it in GENERAL.
+	//UNDEFINED, nothing in it is kept. a render pass without a slot predecessor does its own transition
+	const bool computePass = (passes[pass].pipelinetype == PipelineType::COMPUTE);
+	const uint32_t previous = passes[pass].previousInSlot;
+	if (computePass || previous != NO_SLOT) {
+		barrier.image = pipelines[pass]->outputImages[imageIndex].image;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = computePass ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = computePass ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		//without a predecessor the source is the pass's own stage: the frame's submit waits on the swapchain image there
+		//(getWaitStage), so a compute present pass's transition is chained to that semaphore wait
+		srcStages |= (previous != NO_SLOT) ? passes[previous].readStages : getShaderStage(passes[pass].pipelinetype);
+		dstStages |= pipelines[pass]->getWaitStage();
+		barriers.push_back(barrier);
+	}
+
+	if (barriers.empty()) {
+		return;
+	}
+	VkMemoryBarrier depthBarrier = {};
+	depthBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	depthBarrier.dstAccessMask = forwardDepthAccess;
+	vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, forwardDepth ? 1 : 0, &depthBarrier, 0, nullptr,
+		static_cast<uint32_t>(barriers.size()), barriers.data());
+}
+
+void PostProcessGraph::recordBarriersAfter(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const uint32_t pass,
+	const std::vector<PostProcessPipeline*>& pipelines) const
+{
+	//a compute present pass leaves the swapchain image in GENERAL, the present render pass does this with its finalLayout
+	if (!passes[pass].isPresent || passes[pass].pipelinetype != PipelineType::COMPUTE) {
+		return;
+	}
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+	barrier.image = pipelines[pass]->outputImages[imageIndex].image;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void PostProcessGraph::record(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass,
+	std::vector<PostProcessPipeline>& pipelines, const std::vector<VulkanImage>& forwardImages,
+	const VkQueryPool timestampQueryPool)
+{
+	std::vector<PostProcessPipeline*> pipelinePointers;
+	for (PostProcessPipeline& pipeline : pipelines) {
+		pipelinePointers.push_back(&pipeline);
+	}
+	record(contextInfo, renderPass, pipelinePointers, forwardImages, timestampQueryPool);
+}
+
+void PostProcessGraph::record(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass,
+	const std::vector<PostProcessPipeline*>& pipelines, const std::vector<VulkanImage>& forwardImages,
+	const VkQueryPool timestampQueryPool)
+{
+	if (!commandBuffers.empty()) {//time warp records again every time it starts
+		vkFreeCommandBuffers(contextInfo.device, contextInfo.graphicsCommandPools[0], static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+	}
+	commandBuffers.resize(contextInfo.swapChainImages.size());
+
+	VkCommandBufferAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = contextInfo.graphicsCommandPools[0];
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+
+	if (vkAllocateCommandBuffers(contextInfo.device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to alloc pp graph command buffers!";
+		throw std::runtime_error(ss.str());
+	}
+
+	for (uint32_t i = 0; i < commandBuffers.size(); ++i) {
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+		beginInfo.pInheritanceInfo = nullptr; // Optional
+
+		vkBeginCommandBuffer(commandBuffers[i], &beginInfo);
+		if (timestampQueryPool != VK_NULL_HANDLE) {
+			//bottom of pipe: once the forward commands before it in the submit are done, so only the pp passes are timed
+			vkCmdResetQueryPool(commandBuffers[i], timestampQueryPool, 2 * i, 2);
+			vkCmdWriteTimestamp(commandBuffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, 2 * i);
+		}
+
+		for (uint32_t p = 0; p < passes.size(); ++p) {
+			recordBarriersBefore(commandBuffers[i], i, p, pipelines, forwardImages);
+			pipelines[p]->recordCommands(commandBuffers[i], i, contextInfo, renderPass, passes[p].meshes);
+			recordBarriersAfter(commandBuffers[i], i, p, pipelines);
+		}
+
+		if (timestampQueryPool != VK_NULL_HANDLE) {
+			vkCmdWriteTimestamp(commandBuffers[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool, 2 * i + 1);
+		}
+
+		if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to record command buffer!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+}
+
+void PostProcessGraph::report(const VulkanContextInfo& contextInfo) {
+	const std::vector< std::pair<std::string, const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >*> > chains = {
+		{ "allShaders_PostProcessPipelines    ", &allShaders_PostProcessPipelines },
+		{ "fusedShaders_PostProcessPipelines  ", &fusedShaders_PostProcessPipelines },
+		{ "computeShaders_PostProcessPipelines", &computeShaders_PostProcessPipelines },
+		{ "distortedShaders_PostProcessPipelines", &distortedShaders_PostProcessPipelines },
+		{ "allShaders_TimeWarpPipelines       ", &allShaders_TimeWarpPipelines },
+		{ "fusedShaders_TimeWarpPipelines     ", &fusedShaders_TimeWarpPipelines },
+	};
+	const VkExtent2D extent = contextInfo.camera.renderTargetExtent;
+	std::cout << "\n\nPostProcessGraph report (" << extent.width << "x" << extent.height << " offscreen targets, per swap image)";
+	std::cout << "\n\tchain\t\t\t\t\tpasses\ttargets\tslots\tKB unaliased\tKB aliased\tsubmits before\tafter";
+	for (const auto& chain : chains) {
+		PostProcessGraph graph;
+		graph.addLinearPasses(*chain.second);
+		graph.compile();
+
+		VkDeviceSize unaliased = 0;
+		VkDeviceSize persistent = 0;
+		uint32_t targets = 0;
+		for (const PostProcessGraphPass& pass : graph.passes) {
+			if (pass.isPresent) {
+				continue;
+			}
+			const VkDeviceSize size = VulkanImage::getMemoryRequirements(PostProcessPipeline::getOutputImageType(pass.pipelinetype),
+				extent, PostProcessPipeline::outputFormat, contextInfo).size;
+			unaliased += size;
+			persistent += pass.persistent ? size : 0;
+			++targets;
+		}
+		VkDeviceSize aliased = persistent;
+		for (uint32_t slot = 0; slot < graph.slotSizes.size(); ++slot) {
+			aliased += graph.getSlotRequirements(contextInfo, slot).size;
+		}
+
+		//time warp's chain was submitted on its own (no forward pass while warping)
+		const bool timeWarpChain = (chain.second == &allShaders_TimeWarpPipelines || chain.second == &fusedShaders_TimeWarpPipelines);
+		std::cout << "\n\t" << chain.first << "\t" << graph.passes.size() << "\t" << targets << "\t" << graph.slotSizes.size() << "\t"
+			<< unaliased / 1024 << "\t\t" << aliased / 1024 << "\t\t" << graph.passes.size() + (timeWarpChain ? 0 : 1) << "\t\t1";
+	}
+	std::cout << std::endl;
+}
+
+void PostProcessGraph::destroy(const VulkanContextInfo& contextInfo) {
+	if (!commandBuffers.empty()) {
+		vkFreeCommandBuffers(contextInfo.device, contextInfo.graphicsCommandPools[0], static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+		commandBuffers.clear();
+	}
+	for (auto& memories : slotMemory) {
+		for (VkDeviceMemory& memory : memories) {
+			vkFreeMemory(contextInfo.device, memory, nullptr);
+		}
+	}
+	slotMemory.clear();
+	slotSizes.clear();
+	passes.clear();
+}
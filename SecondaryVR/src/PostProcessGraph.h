@@ -0,0 +1,99 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include "PostProcessPipeline.h"
+#include "Mesh.h"
+#include <vector>
+#include <tuple>
+#include <string>
+#include <cstdint>
+
+class VulkanContextInfo;
+class VulkanRenderPass;
+class VulkanImage;
+
+//one pp stage in a PostProcessGraph, it writes one image (its output, the pass index is its resource id)
+struct PostProcessGraphPass {
+	PipelineType pipelinetype;
+	std::vector<uint32_t> inputs;//resources it samples at bindings 0.., PostProcessGraph::FORWARD or an earlier pass
+	bool isPresent = false;//writes the swapchain image, has to be the last pass
+	bool persistent = false;//output is read again next frame (temporal hole fill history), gets its own memory
+	bool inPlace = false;//PipelineType::HOLES_ONLY: writes the FORWARD image it samples, its readers sample that
+	std::vector<Mesh> meshes;//per eye, see VulkanApplication::getPPMeshes
+
+	//compile()
+	uint32_t lastReader = 0;//last pass that samples the output, the pass itself if none do
+	VkPipelineStageFlags readStages = 0;//where the output is sampled
+	uint32_t slot = 0xFFFFFFFF;//memory slot the output is aliased into, NO_SLOT for the swapchain, persistent and in place outputs
+	uint32_t previousInSlot = 0xFFFFFFFF;//pass whose output had the slot before, its readers go before this pass writes
+};
+
+//A pp chain (postProcessPipelines or timeWarpPipelines) as passes that declare what they sample and write.
+//compile() works out each output's lifetime: outputs that are never alive at the same time share a memory slot
+//(VulkanImage's aliasedMemory, a slot per swap image sized for the biggest image in it), so a linear chain needs 2 offscreen
+//targets however long it gets. record() puts every pass of a swap image in one static command buffer with the barriers
+//and layout transitions derived from the declarations in between (the render passes only cover their own attachment),
+//that and the forward command buffer are the frame's one submit instead of a submit and semaphore per stage.
+class PostProcessGraph {
+public:
+	static const uint32_t FORWARD = 0xFFFFFFFF;//resource id of the forward pass color image
+	static const uint32_t NO_SLOT = 0xFFFFFFFF;
+
+	std::vector<PostProcessGraphPass> passes;
+	//how the forward color image comes in: the forward render pass's finalLayout, or SHADER_READ_ONLY_OPTIMAL if it was
+	//already sampled and isn't rendered again (time warp reuses the frame it warped from)
+	VkImageLayout forwardLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	VkPipelineStageFlags forwardReadStages = 0;
+
+	std::vector<std::vector<VkDeviceMemory>> slotMemory;//[slot][swap image]
+	std::vector<VkDeviceSize> slotSizes;
+	std::vector<VkCommandBuffer> commandBuffers;//per swap image, every pass and the barriers between them
+
+public:
+	PostProcessGraph();
+	~PostProcessGraph();
+
+	//returns the pass's output resource id
+	uint32_t addPass(const PipelineType type, const std::vector<uint32_t>& inputs, const bool isPresent,
+		const std::vector<Mesh>& meshes = {});
+	//each stage samples the one before it, the first the forward image and the last presents (the GlobalSettings.h stage lists)
+	void addLinearPasses(const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& stages);
+	//lifetimes, readers and memory slots, throws if a pass reads a later one, the present pass isn't last or an in place
+	//pass doesn't read FORWARD
+	void compile();
+	//slot memory for the render target extent, before the pipelines make their output images in it
+	void createSlotMemory(const VulkanContextInfo& contextInfo);
+	//per swap image memory for the pass's output images, empty if the pass makes its own (PostProcessPipeline's outputMemory)
+	std::vector<VkDeviceMemory> getOutputMemory(const uint32_t pass) const;
+	//pipelines[i] is passes[i], forwardImages the FORWARD resource per swap image.
+	//with a timestampQueryPool, swap image i's passes are timed by its queries 2i and 2i+1 (PostProcessTimer)
+	void record(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass,
+		std::vector<PostProcessPipeline>& pipelines, const std::vector<VulkanImage>& forwardImages,
+		const VkQueryPool timestampQueryPool = VK_NULL_HANDLE);
+	//same, for graphs that record pipelines another graph owns too (the distortion techniques share every stage but the last).
+	//the shared passes' outputs are in the owning graph's slot memory, this graph's createSlotMemory isn't needed
+	void record(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass,
+		const std::vector<PostProcessPipeline*>& pipelines, const std::vector<VulkanImage>& forwardImages,
+		const VkQueryPool timestampQueryPool = VK_NULL_HANDLE);
+	//where the frame's submit waits for the swapchain image, the present pass's output stage
+	VkPipelineStageFlags getWaitStage() const;
+
+	//passes, memory slots and offscreen target bytes per swap image with and without aliasing for every configured pp chain,
+	//and the submits per frame before (one per stage and the forward one) and after
+	static void report(const VulkanContextInfo& contextInfo);
+
+	//cleanup, after the output images in the slots are destroyed
+	void destroy(const VulkanContextInfo& contextInfo);
+
+private:
+	static VkPipelineStageFlags getShaderStage(const PipelineType type);
+	void recordBarriersBefore(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const uint32_t pass,
+		const std::vector<PostProcessPipeline*>& pipelines, const std::vector<VulkanImage>& forwardImages) const;
+	void recordBarriersAfter(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const uint32_t pass,
+		const std::vector<PostProcessPipeline*>& pipelines) const;
+	bool isFirstReader(const uint32_t resource, const uint32_t pass) const;
+	VkMemoryRequirements getSlotRequirements(const VulkanContextInfo& contextInfo, const uint32_t slot) const;
+};
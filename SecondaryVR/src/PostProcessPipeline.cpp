@@ -3,11 +3,13 @@
 
 #include "Model.h"
 #include "Utils.h"
+#include "HmdProfile.h"
 
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <algorithm>
 
 
 PostProcessPipeline::PostProcessPipeline() {
@@ -17,21 +19,27 @@ PostProcessPipeline::PostProcessPipeline() {
 
 PostProcessPipeline::PostProcessPipeline(const std::vector<std::string>& shaderpaths,
 	const VulkanRenderPass& renderPass, const VulkanContextInfo& contextInfo, 
-	const VkDescriptorSetLayout* setLayouts, const bool isPresent, const PipelineType type) 
-	: shaderpaths(shaderpaths), isPresent(isPresent), pipelinetype(type)
+	const VkDescriptorSetLayout* setLayouts, const bool isPresent, const PipelineType type,
+	const std::vector<VkDeviceMemory>& outputMemory) 
+	: shaderpaths(shaderpaths), isPresent(isPresent), pipelinetype(type), geometry(getGeometry(shaderpaths[0]))
 {
 
 	//TODO: determine renderPass type here based on pipeline type? or will it all be one renderpass in the end?
-	createPipeline(renderPass, contextInfo, setLayouts);
-
-	//NEW
-	addCommandPools(contextInfo, 1);
-
-	allocateCommandBuffers(contextInfo);
-	createSemaphores(contextInfo);
+	if (pipelinetype == PipelineType::COMPUTE) {
+		if (isPresent && !contextInfo.swapChainStorage) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": compute pp stage can't present, the swapchain images aren't storage images!";
+			throw std::runtime_error(ss.str());
+		}
+		createComputePipeline(contextInfo, setLayouts);
+	} else {
+		createPipeline(renderPass, contextInfo, setLayouts);
+	}
 
 	//NEW
-	createOutputImages(contextInfo);
+	if (pipelinetype == PipelineType::HOLES_ONLY) {
+		return;//writes the forward output, createFramebuffersHolesOnly
+	}
+	createOutputImages(contextInfo, outputMemory);
 	createFramebuffers(contextInfo, renderPass);
 }
 
@@ -39,13 +47,18 @@ PostProcessPipeline::PostProcessPipeline(const std::vector<std::string>& shaderp
 PostProcessPipeline::~PostProcessPipeline() {
 }
 
-void PostProcessPipeline::createOutputImages(const VulkanContextInfo& contextInfo) {
+void PostProcessPipeline::createOutputImages(const VulkanContextInfo& contextInfo, const std::vector<VkDeviceMemory>& outputMemory) {
 	outputImages.resize(contextInfo.swapChainImages.size());
 	for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
 		
 		//TODO: if flag is present then use swapchain stuff otherwise 16F
 		if (!isPresent) {
-			outputImages[i] = VulkanImage(IMAGETYPE::COLOR_ATTACHMENT, contextInfo.camera.renderTargetExtent, VK_FORMAT_R16G16B16A16_SFLOAT, contextInfo);
+			const IMAGETYPE imagetype = getOutputImageType(pipelinetype);
+			if (outputMemory.empty()) {
+				outputImages[i] = VulkanImage(imagetype, contextInfo.camera.renderTargetExtent, outputFormat, contextInfo);
+			} else {
+				outputImages[i] = VulkanImage(imagetype, contextInfo.camera.renderTargetExtent, outputFormat, contextInfo, outputMemory[i]);
+			}
 		} else {
 			outputImages[i].image = contextInfo.swapChainImages[i];
 			outputImages[i].imageView = contextInfo.swapChainImageViews[i];
@@ -54,24 +67,10 @@ void PostProcessPipeline::createOutputImages(const VulkanContextInfo& contextInf
 	}
 }
 
-void PostProcessPipeline::addCommandPools(const VulkanContextInfo& contextInfo, const uint32_t num) {
-	VkCommandPoolCreateInfo poolInfo = {};
-	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	poolInfo.queueFamilyIndex = contextInfo.graphicsFamily;
-	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-
-	for (int i = 0; i < num; ++i) {
-		VkCommandPool commandPool;
-		commandPools.push_back(commandPool);
-
-		if (vkCreateCommandPool(contextInfo.device, &poolInfo, nullptr, &commandPools.back()) != VK_SUCCESS) {
-			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create graphics command pool!";
-			throw std::runtime_error(ss.str());
-		}
-	}
-}
-
 void PostProcessPipeline::createFramebuffers(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass) {
+	if (pipelinetype == PipelineType::COMPUTE) {
+		return;//writes its storage image, no render pass
+	}
 	framebuffers.resize(contextInfo.swapChainImages.size());
 	if (isPresent) {
 		for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
@@ -100,19 +99,82 @@ void PostProcessPipeline::createFramebuffers(const VulkanContextInfo& contextInf
 	}
 }
 
-void PostProcessPipeline::allocateCommandBuffers(const VulkanContextInfo& contextInfo) {
-	commandBuffers.resize(contextInfo.swapChainFramebuffers.size());
-	//clean up before record? no need, state is not maintained
-	VkCommandBufferAllocateInfo allocInfo = {};
-	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocInfo.commandPool = commandPools[0];
-	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	//allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
-	allocInfo.commandBufferCount = commandBuffers.size();
-
-	if (vkAllocateCommandBuffers(contextInfo.device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
-		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to alloc pipeline command buffers!";
-		throw std::runtime_error(ss.str());
+void PostProcessPipeline::createFramebuffersHolesOnly(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass,
+	const std::vector<VulkanImage>& targetImages)
+{
+	framebuffers.resize(contextInfo.swapChainImages.size());
+	for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
+		const std::array<VkImageView, 2> attachments = { targetImages[i].imageView, contextInfo.depthImage.imageView };
+		VkFramebufferCreateInfo framebufferCreateInfo = {};
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.pNext = NULL;
+		framebufferCreateInfo.renderPass = renderPass.renderPassPostProcessHoles;
+		framebufferCreateInfo.pAttachments = attachments.data();
+		framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		framebufferCreateInfo.width = contextInfo.camera.renderTargetExtent.width;
+		framebufferCreateInfo.height = contextInfo.camera.renderTargetExtent.height;
+		framebufferCreateInfo.layers = 1;
+
+		if (vkCreateFramebuffer(contextInfo.device, &framebufferCreateInfo, nullptr, &framebuffers[i]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create framebuffer!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+}
+
+uint32_t PostProcessPipeline::getGeometry(const std::string& vertShaderPath) {
+	for (const auto& procedural : proceduralVertexShaders_PostProcessPipelines) {
+		if (procedural.first == vertShaderPath) {
+			return procedural.second;
+		}
+	}
+	return PP_GEOMETRY_MESH;
+}
+
+uint32_t PostProcessPipeline::getProceduralVertexCount(const VulkanContextInfo& contextInfo) const {
+	if (geometry == PP_GEOMETRY_TRIANGLE) {
+		return 3;
+	} else if (geometry == PP_GEOMETRY_GRID) {
+		return gridQuadsPerDim * gridQuadsPerDim * 6;
+	} else if (geometry == PP_GEOMETRY_POINTS) {
+		//one eye's pixels, ppTimeWarpPoints.vert halves the width in vr mode the same way
+		const uint32_t eyeWidth = contextInfo.camera.renderTargetExtent.width >> static_cast<uint32_t>(contextInfo.camera.vrmode);
+		return eyeWidth * contextInfo.camera.renderTargetExtent.height;
+	}
+	return 0;
+}
+
+PostProcessPushConstant PostProcessPipeline::getPushConstant(const VulkanContextInfo& contextInfo, const uint32_t camIndex) const {
+	const uint32_t holesOnly = static_cast<uint32_t>(pipelinetype == PipelineType::HOLES_ONLY);
+	PostProcessPushConstant pushconstant = { holesOnly << holesOnlyBit | camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode),
+											 contextInfo.camera.renderTargetExtent.width, contextInfo.camera.renderTargetExtent.height,
+											 gridQuadsPerDim, glm::vec4(-1.f), 0 };
+	//the stencil in the depth image this quality level (see VulkanContextInfo::createDepthImage)
+	if (static_cast<size_t>(contextInfo.camera.qualityIndex) < contextInfo.radialDensityMasks.size()) {
+		const PreMadeStencil& stencil = contextInfo.radialDensityMasks[contextInfo.camera.qualityIndex];
+		pushconstant.stencilRingRadii = stencil.getRingRadii();
+		pushconstant.stencilRingShifts = stencil.getRingShifts();
+	}
+	return pushconstant;
+}
+
+void PostProcessPipeline::recordDraw(const VkCommandBuffer& commandBuffer, const VulkanContextInfo& contextInfo,
+	const std::vector<Mesh>& meshes, const uint32_t camIndex) const
+{
+	if (geometry != PP_GEOMETRY_MESH) {
+		vkCmdDraw(commandBuffer, getProceduralVertexCount(contextInfo), 1, 0, 0);
+		return;
+	}
+
+	const Mesh& mesh = meshes[camIndex];
+	const VkBuffer vertexBuffers[] = { mesh.vertexBuffer };
+	const VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	if (mesh.mIndices.empty()) {//ndc pixel points
+		vkCmdDraw(commandBuffer, static_cast<uint32_t>(mesh.mPPVertices.size()), 1, 0, 0);
+	} else {
+		vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+		vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(mesh.mIndices.size()), 1, 0, 0, 0);
 	}
 }
 
@@ -124,17 +186,29 @@ void PostProcessPipeline::createPipeline(const VulkanRenderPass& renderPass,
 	VkShaderModule vertShaderModule = createShaderModule(vertShaderCode, contextInfo);
 	VkShaderModule fragShaderModule = createShaderModule(fragShaderCode, contextInfo);
 
+	//hmd lens constants go in as specialization constants so the driver can fold them,
+	//shaders that don't declare a constant_id just ignore its entry
+	const HmdSpecializationData hmdSpecData = HmdProfile::get().getSpecializationData();
+	const std::vector<VkSpecializationMapEntry> hmdSpecEntries = HmdProfile::getSpecializationMapEntries();
+	VkSpecializationInfo specializationInfo = {};
+	specializationInfo.mapEntryCount = static_cast<uint32_t>(hmdSpecEntries.size());
+	specializationInfo.pMapEntries = hmdSpecEntries.data();
+	specializationInfo.dataSize = sizeof(HmdSpecializationData);
+	specializationInfo.pData = &hmdSpecData;
+
 	VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
 	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
 	vertShaderStageInfo.module = vertShaderModule;
 	vertShaderStageInfo.pName = "main";
+	vertShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
 	VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
 	fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
 	fragShaderStageInfo.module = fragShaderModule;
 	fragShaderStageInfo.pName = "main";
+	fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
 
 	//TODO: for dynamic amount of shaders, turn into vector pass .data to the pipeline info at the bottom
 	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
@@ -142,17 +216,33 @@ void PostProcessPipeline::createPipeline(const VulkanRenderPass& renderPass,
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
 	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-	auto bindingDescription = Vertex::getBindingDescription();
-	auto attributeDescriptions = Vertex::getAttributeDescriptions();
+	//compact pp vertex formats, only the attributes the vertex shader reads. nothing for procedural geometry
+	const bool isPreCalcVertex = std::find(preCalcVertexShaders_PostProcessPipelines.begin(),
+		preCalcVertexShaders_PostProcessPipelines.end(), shaderpaths[0]) != preCalcVertexShaders_PostProcessPipelines.end();
+	VkVertexInputBindingDescription bindingDescription;
+	std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+	if (isPreCalcVertex) {
+		bindingDescription = PostProcessPreCalcVertex::getBindingDescription();
+		const auto preCalcAttributes = PostProcessPreCalcVertex::getAttributeDescriptions();
+		attributeDescriptions.assign(preCalcAttributes.begin(), preCalcAttributes.end());
+	} else {
+		bindingDescription = PostProcessVertex::getBindingDescription();
+		const auto positionAttributes = PostProcessVertex::getAttributeDescriptions();
+		attributeDescriptions.assign(positionAttributes.begin(), positionAttributes.end());
+	}
 
-	vertexInputInfo.vertexBindingDescriptionCount = 1;
+	if (geometry != PP_GEOMETRY_MESH) {
+		attributeDescriptions.clear();
+	}
+
+	vertexInputInfo.vertexBindingDescriptionCount = geometry == PP_GEOMETRY_MESH ? 1 : 0;
 	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
 	vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
 	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
 	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
 	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	inputAssembly.topology = pipelinetype == PipelineType::TIMEWARP ? VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	inputAssembly.topology = geometry == PP_GEOMETRY_POINTS ? VK_PRIMITIVE_TOPOLOGY_POINT_LIST : VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 	inputAssembly.primitiveRestartEnable = VK_FALSE;
 
 	VkViewport viewport = {};
@@ -198,6 +288,24 @@ void PostProcessPipeline::createPipeline(const VulkanRenderPass& renderPass,
 	depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
 	depthStencil.depthBoundsTestEnable = VK_FALSE;
 	depthStencil.stencilTestEnable = VK_FALSE;
+	if (pipelinetype == PipelineType::HOLES_ONLY) {
+		//the forward pass's mask, read only: passes where it didn't render (SubpassHoleFill's test the other way round)
+		VkStencilOpState stencilOp = {};
+		stencilOp.failOp = VK_STENCIL_OP_KEEP;
+		stencilOp.passOp = VK_STENCIL_OP_KEEP;
+		stencilOp.depthFailOp = VK_STENCIL_OP_KEEP;
+		stencilOp.compareOp = VK_COMPARE_OP_NOT_EQUAL;
+		stencilOp.compareMask = 0x1;//(dynamic)
+		stencilOp.writeMask = 0;
+		stencilOp.reference = 0x1;//(dynamic)
+
+		depthStencil.depthTestEnable = VK_FALSE;
+		depthStencil.depthWriteEnable = VK_FALSE;
+		depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+		depthStencil.stencilTestEnable = VK_TRUE;
+		depthStencil.front = stencilOp;
+		depthStencil.back = stencilOp;
+	}
 
 	VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
 	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
@@ -238,6 +346,10 @@ void PostProcessPipeline::createPipeline(const VulkanRenderPass& renderPass,
 	dynamicStates.push_back( VK_DYNAMIC_STATE_VIEWPORT );
 	dynamicStates.push_back( VK_DYNAMIC_STATE_SCISSOR );
 	//dynamicStates.push_back( VK_DYNAMIC_STATE_STENCIL_REFERENCE );//also: compare_mask?
+	if (pipelinetype == PipelineType::HOLES_ONLY) {//the stencil bit follows Camera::getStencilTestBit
+		dynamicStates.push_back( VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK );
+		dynamicStates.push_back( VK_DYNAMIC_STATE_STENCIL_REFERENCE );
+	}
 	dynamicInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 	dynamicInfo.pNext = nullptr;
 	dynamicInfo.flags = 0;
@@ -270,6 +382,9 @@ void PostProcessPipeline::createPipeline(const VulkanRenderPass& renderPass,
 	pipelineInfo.pColorBlendState = &colorBlending;
 	pipelineInfo.layout = pipelineLayout;
 	pipelineInfo.renderPass = isPresent ? renderPass.renderPassPostProcessPresent : renderPass.renderPassPostProcess;
+	if (pipelinetype == PipelineType::HOLES_ONLY) {
+		pipelineInfo.renderPass = renderPass.renderPassPostProcessHoles;
+	}
 	pipelineInfo.subpass = 0;
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 	pipelineInfo.pDynamicState = &dynamicInfo;
@@ -283,6 +398,57 @@ void PostProcessPipeline::createPipeline(const VulkanRenderPass& renderPass,
 	vkDestroyShaderModule(contextInfo.device, vertShaderModule, nullptr);
 }
 
+void PostProcessPipeline::createComputePipeline(const VulkanContextInfo& contextInfo, const VkDescriptorSetLayout* setLayouts) {
+	auto compShaderCode = readFile(shaderpaths[0]);
+	VkShaderModule compShaderModule = createShaderModule(compShaderCode, contextInfo);
+
+	//same hmd lens specialization constants as the raster stages
+	const HmdSpecializationData hmdSpecData = HmdProfile::get().getSpecializationData();
+	const std::vector<VkSpecializationMapEntry> hmdSpecEntries = HmdProfile::getSpecializationMapEntries();
+	VkSpecializationInfo specializationInfo = {};
+	specializationInfo.mapEntryCount = static_cast<uint32_t>(hmdSpecEntries.size());
+	specializationInfo.pMapEntries = hmdSpecEntries.data();
+	specializationInfo.dataSize = sizeof(HmdSpecializationData);
+	specializationInfo.pData = &hmdSpecData;
+
+	VkPipelineShaderStageCreateInfo compShaderStageInfo = {};
+	compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	compShaderStageInfo.module = compShaderModule;
+	compShaderStageInfo.pName = "main";
+	compShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
+	VkPushConstantRange push1 = {};
+	push1.offset = 0;
+	push1.size = sizeof(PostProcessPushConstant);
+	push1.stageFlags = PostProcessPushConstant::computeStages;
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = setLayouts;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &push1;
+
+	if (vkCreatePipelineLayout(contextInfo.device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create pipeline layout!";
+		throw std::runtime_error(ss.str());
+	}
+
+	VkComputePipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage = compShaderStageInfo;
+	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	if (vkCreateComputePipelines(contextInfo.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create compute pipeline!";
+		throw std::runtime_error(ss.str());
+	}
+
+	vkDestroyShaderModule(contextInfo.device, compShaderModule, nullptr);
+}
+
 VkShaderModule PostProcessPipeline::createShaderModule( const std::vector<char>& code, 
 	const VulkanContextInfo& contextInfo) const 
 {
@@ -434,219 +600,195 @@ void PostProcessPipeline::getViewportAndScissor(VkViewport& outViewport, VkRect2
 	}
 }
 
-void PostProcessPipeline::createStaticCommandBuffers(const VulkanContextInfo& contextInfo, 
-	const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes) 
+void PostProcessPipeline::recordCommands(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex,
+	const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes)
 {
-	for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
-		VkCommandBufferAllocateInfo allocInfo = {};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.commandPool = commandPools[0];
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		//allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
-		allocInfo.commandBufferCount = 1;
-
-		if (vkAllocateCommandBuffers(contextInfo.device, &allocInfo, &commandBuffers[i]) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to allocate command buffers!");
-		}
-
-		VkCommandBufferBeginInfo beginInfo = {};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-		//beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
-		//beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-		beginInfo.pInheritanceInfo = nullptr; // Optional
-
-
-		vkBeginCommandBuffer(commandBuffers[i], &beginInfo);
-
-		std::array<VkClearValue, 1> clearValues = {};
-		clearValues[0].color = { 0.0f, 0.0f, 0.0f, 0.0f };
-		//clearValues[1].depthStencil = { 1.0f, 0 };
-
-		VkRenderPassBeginInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = isPresent ? renderPass.renderPassPostProcessPresent : renderPass.renderPassPostProcess;
-		renderPassInfo.framebuffer = framebuffers[i];
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = isPresent ? contextInfo.swapChainExtent : contextInfo.camera.renderTargetExtent;
-
-		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassInfo.pClearValues = clearValues.data();
-
-		vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-		vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
-
-
-		vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &inputDescriptors[i].descriptorSet, 0, nullptr);
-
-		//VkBuffer vertexBuffers[] = { mesh.vertexBuffer };
-		//VkBuffer indexBuffer = mesh.indexBuffer;
-		VkBuffer vertexBuffers[] = { meshes[0].vertexBuffer };
-		VkBuffer indexBuffer = meshes[0].indexBuffer;
-		VkDeviceSize offsets[] = { 0 };
-
-		vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers, offsets);
-		vkCmdBindIndexBuffer(commandBuffers[i], indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-
-		
-		const uint32_t camIndex = 0;
-		const PostProcessPushConstant pushconstant = { camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode), 
-														contextInfo.camera.renderTargetExtent.width, contextInfo.camera.renderTargetExtent.height};
-		vkCmdPushConstants(commandBuffers[i], pipelineLayout, PostProcessPushConstant::stages, 0, sizeof(PostProcessPushConstant), (const void*)&pushconstant);
-
-		VkViewport viewport = {}; VkRect2D scissor = {};
-		getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
-		vkCmdSetViewport(commandBuffers[i], 0, 1, &viewport);
-		vkCmdSetScissor(commandBuffers[i], 0, 1, &scissor);
-
-		//vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(mesh.mIndices.size()), 1, 0, 0, 0);
-		vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(meshes[camIndex].mIndices.size()), 1, 0, 0, 0);
-
-		if (contextInfo.camera.vrmode) {
-			//bind other precalc mesh(can't just use the same one since not the same(asymmetrical/mirrored)
-			const uint32_t camIndex = 1;
-			VkBuffer vertexBuffers[] = { meshes[camIndex].vertexBuffer };
-			VkBuffer indexBuffer = meshes[camIndex].indexBuffer;
-			VkDeviceSize offsets[] = { 0 };
-
-			vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers, offsets);
-			vkCmdBindIndexBuffer(commandBuffers[i], indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-
-			const PostProcessPushConstant pushconstant = { camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode),
-															contextInfo.camera.renderTargetExtent.width, contextInfo.camera.renderTargetExtent.height};
-			vkCmdPushConstants(commandBuffers[i], pipelineLayout, PostProcessPushConstant::stages, 0, sizeof(PostProcessPushConstant), (const void*)&pushconstant);
-			getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
-			vkCmdSetViewport(commandBuffers[i], 0, 1, &viewport);
-			vkCmdSetScissor(commandBuffers[i], 0, 1, &scissor);
-
-			//vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(mesh.mIndices.size()), 1, 0, 0, 0);
-			vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(meshes[camIndex].mIndices.size()), 1, 0, 0, 0);
-		}
-
-		vkCmdEndRenderPass(commandBuffers[i]);
-
-		if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS) {
-			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to record command buffer!";
-			throw std::runtime_error(ss.str());
-		}
+	if (pipelinetype == PipelineType::COMPUTE) {
+		recordDispatches(commandBuffer, imageIndex, contextInfo);
+	} else if (pipelinetype == PipelineType::TIMEWARP) {
+		recordRenderPassTimeWarp(commandBuffer, imageIndex, contextInfo, renderPass, meshes);
+	} else {
+		recordRenderPass(commandBuffer, imageIndex, contextInfo, renderPass, meshes);
 	}
 }
 
-void PostProcessPipeline::createStaticCommandBuffersTimeWarp(const VulkanContextInfo& contextInfo, 
-	const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes) 
+void PostProcessPipeline::recordRenderPass(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex,
+	const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes) 
 {
-	for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
-		VkCommandBufferAllocateInfo allocInfo = {};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.commandPool = commandPools[0];
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		//allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
-		allocInfo.commandBufferCount = 1;
-
-		if (vkAllocateCommandBuffers(contextInfo.device, &allocInfo, &commandBuffers[i]) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to allocate command buffers!");
-		}
-
-		VkCommandBufferBeginInfo beginInfo = {};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-		//beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
-		//beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-		beginInfo.pInheritanceInfo = nullptr; // Optional
+	const uint32_t i = imageIndex;
+	std::array<VkClearValue, 1> clearValues = {};
+	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 0.0f };
+	//clearValues[1].depthStencil = { 1.0f, 0 };
+
+	VkRenderPassBeginInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = isPresent ? renderPass.renderPassPostProcessPresent : renderPass.renderPassPostProcess;
+	if (pipelinetype == PipelineType::HOLES_ONLY) {//loads, nothing is cleared
+		renderPassInfo.renderPass = renderPass.renderPassPostProcessHoles;
+	}
+	renderPassInfo.framebuffer = framebuffers[i];
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = isPresent ? contextInfo.swapChainExtent : contextInfo.camera.renderTargetExtent;
 
+	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+	renderPassInfo.pClearValues = clearValues.data();
 
-		vkBeginCommandBuffer(commandBuffers[i], &beginInfo);
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-		std::array<VkClearValue, 1> clearValues = {};
-		clearValues[0].color = { 0.0f, 0.0f, 0.0f, 0.0f };
-		//clearValues[1].depthStencil = { 1.0f, 0 };
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+	if (pipelinetype == PipelineType::HOLES_ONLY) {
+		const uint32_t stencilTestBit = contextInfo.camera.getStencilTestBit();
+		vkCmdSetStencilCompareMask(commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+		vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+	}
 
-		VkRenderPassBeginInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = isPresent ? renderPass.renderPassPostProcessPresent : renderPass.renderPassPostProcess;
-		renderPassInfo.framebuffer = framebuffers[i];
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = isPresent ? contextInfo.swapChainExtent : contextInfo.camera.renderTargetExtent;
 
-		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassInfo.pClearValues = clearValues.data();
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &inputDescriptors[i].descriptorSet, 0, nullptr);
 
-		vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	const uint32_t camIndex = 0;
+	const PostProcessPushConstant pushconstant = getPushConstant(contextInfo, camIndex);
+	vkCmdPushConstants(commandBuffer, pipelineLayout, PostProcessPushConstant::stages, 0, sizeof(PostProcessPushConstant), (const void*)&pushconstant);
 
-		vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+	VkViewport viewport = {}; VkRect2D scissor = {};
+	getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
+	recordDraw(commandBuffer, contextInfo, meshes, camIndex);
 
-		vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &inputDescriptors[i].descriptorSet, 0, nullptr);
+	if (contextInfo.camera.vrmode) {
+		//bind other precalc mesh(can't just use the same one since not the same(asymmetrical/mirrored)
+		const uint32_t camIndex = 1;
+		const PostProcessPushConstant pushconstant = getPushConstant(contextInfo, camIndex);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, PostProcessPushConstant::stages, 0, sizeof(PostProcessPushConstant), (const void*)&pushconstant);
+		getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-		VkBuffer vertexBuffers[] = { meshes[0].vertexBuffer };
-		VkBuffer indexBuffer = meshes[0].indexBuffer;
-		VkDeviceSize offsets[] = { 0 };
+		recordDraw(commandBuffer, contextInfo, meshes, camIndex);
+	}
 
-		vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers, offsets);
-		vkCmdBindIndexBuffer(commandBuffers[i], indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	vkCmdEndRenderPass(commandBuffer);
+}
 
-		
-		uint32_t camIndex = 0;
-		TimeWarpPushConstant pushconstant = { contextInfo.camera.timeWarpInvVP[camIndex],
-													camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode), 
-													contextInfo.camera.renderTargetExtent.width, 
-													contextInfo.camera.renderTargetExtent.height,
-													};
-		vkCmdPushConstants(commandBuffers[i], pipelineLayout, TimeWarpPushConstant::stages, 0, sizeof(TimeWarpPushConstant), (const void*)&pushconstant);
-
-		VkViewport viewport = {}; VkRect2D scissor = {};
-		getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
-		vkCmdSetViewport(commandBuffers[i], 0, 1, &viewport);
-		vkCmdSetScissor(commandBuffers[i], 0, 1, &scissor);
-
-		vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(meshes[0].mIndices.size()), 1, 0, 0, 0);
-		//vkCmdDraw(commandBuffers[i], static_cast<uint32_t>(meshes[0].mVertices.size()), 1, 0, 0);
-
-		//only ran in vr mode
-		camIndex = 1;
-		//VkBuffer vertexBuffers[] = { meshes[camIndex].vertexBuffer };
-		//VkBuffer indexBuffer = meshes[camIndex].indexBuffer;
-		//VkDeviceSize offsets[] = { 0 };
-
-		//vkCmdBindVertexBuffers(commandBuffers[i], 0, 1, vertexBuffers, offsets);
-		//vkCmdBindIndexBuffer(commandBuffers[i], indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-
-		pushconstant = { contextInfo.camera.timeWarpInvVP[camIndex],
-						camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode),
-						contextInfo.camera.renderTargetExtent.width,
-						contextInfo.camera.renderTargetExtent.height };
-		vkCmdPushConstants(commandBuffers[i], pipelineLayout, TimeWarpPushConstant::stages, 0, sizeof(TimeWarpPushConstant), (const void*)&pushconstant);
-		getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
-		vkCmdSetViewport(commandBuffers[i], 0, 1, &viewport);
-		vkCmdSetScissor(commandBuffers[i], 0, 1, &scissor);
+void PostProcessPipeline::recordRenderPassTimeWarp(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex,
+	const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes) 
+{
+	const uint32_t i = imageIndex;
+	std::array<VkClearValue, 1> clearValues = {};
+	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 0.0f };
+	//clearValues[1].depthStencil = { 1.0f, 0 };
+
+	VkRenderPassBeginInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = isPresent ? renderPass.renderPassPostProcessPresent : renderPass.renderPassPostProcess;
+	renderPassInfo.framebuffer = framebuffers[i];
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = isPresent ? contextInfo.swapChainExtent : contextInfo.camera.renderTargetExtent;
+
+	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+	renderPassInfo.pClearValues = clearValues.data();
+
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+
+
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &inputDescriptors[i].descriptorSet, 0, nullptr);
+
+	uint32_t camIndex = 0;
+	TimeWarpPushConstant pushconstant = { contextInfo.camera.timeWarpInvVP[camIndex],
+												camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode), 
+												contextInfo.camera.renderTargetExtent.width, 
+												contextInfo.camera.renderTargetExtent.height,
+												gridQuadsPerDim,
+												};
+	vkCmdPushConstants(commandBuffer, pipelineLayout, TimeWarpPushConstant::stages, 0, sizeof(TimeWarpPushConstant), (const void*)&pushconstant);
+
+	VkViewport viewport = {}; VkRect2D scissor = {};
+	getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	recordDraw(commandBuffer, contextInfo, meshes, camIndex);
+
+	//only ran in vr mode
+	camIndex = 1;
+	pushconstant = { contextInfo.camera.timeWarpInvVP[camIndex],
+					camIndex << 1 | static_cast<uint32_t>(contextInfo.camera.vrmode),
+					contextInfo.camera.renderTargetExtent.width,
+					contextInfo.camera.renderTargetExtent.height,
+					gridQuadsPerDim };
+	vkCmdPushConstants(commandBuffer, pipelineLayout, TimeWarpPushConstant::stages, 0, sizeof(TimeWarpPushConstant), (const void*)&pushconstant);
+	getViewportAndScissor(viewport, scissor, contextInfo, camIndex, contextInfo.camera.vrmode);
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	recordDraw(commandBuffer, contextInfo, meshes, camIndex);
+
+	vkCmdEndRenderPass(commandBuffer);
+}
 
-		vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(meshes[0].mIndices.size()), 1, 0, 0, 0);
-		//vkCmdDraw(commandBuffers[i], static_cast<uint32_t>(meshes[0].mVertices.size()), 1, 0, 0);
+void PostProcessPipeline::recordDispatches(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex,
+	const VulkanContextInfo& contextInfo)
+{
+	//one eye of the output per dispatch (getViewportAndScissor's split), in whole quads of the full image:
+	//with an odd eye width the quad on the seam gets its left pixel from one dispatch and its right from the other.
+	//the output's layout transitions around this are PostProcessGraph's (GENERAL while it's written)
+	const VkExtent2D outputExtent = isPresent ? contextInfo.swapChainExtent : contextInfo.camera.renderTargetExtent;
+	const uint32_t numEyes = contextInfo.camera.vrmode ? 2 : 1;
+	const uint32_t eyeWidth = outputExtent.width / numEyes;
+	const uint32_t quadsY = (outputExtent.height + 1) / 2;
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, graphicsPipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &inputDescriptors[imageIndex].descriptorSet, 0, nullptr);
+
+	for (uint32_t camIndex = 0; camIndex < numEyes; ++camIndex) {
+		const PostProcessPushConstant pushconstant = getPushConstant(contextInfo, camIndex);
+		vkCmdPushConstants(commandBuffer, pipelineLayout, PostProcessPushConstant::computeStages, 0, sizeof(PostProcessPushConstant), (const void*)&pushconstant);
+
+		const uint32_t eyeOrigin = camIndex * eyeWidth;
+		const uint32_t quadsX = ((eyeOrigin + eyeWidth + 1) >> 1) - (eyeOrigin >> 1);
+		vkCmdDispatch(commandBuffer, (quadsX + COMPUTE_GROUP_QUADS - 1) / COMPUTE_GROUP_QUADS,
+			(quadsY + COMPUTE_GROUP_QUADS - 1) / COMPUTE_GROUP_QUADS, 1);
+	}
+}
 
-		vkCmdEndRenderPass(commandBuffers[i]);
+VkPipelineStageFlags PostProcessPipeline::getWaitStage() const {
+	return (pipelinetype == PipelineType::COMPUTE) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+}
 
-		if (vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS) {
-			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to record command buffer!";
-			throw std::runtime_error(ss.str());
-		}
-	}
+IMAGETYPE PostProcessPipeline::getOutputImageType(const PipelineType type) {
+	return (type == PipelineType::COMPUTE) ? IMAGETYPE::STORAGE : IMAGETYPE::COLOR_ATTACHMENT;
 }
 
 void PostProcessPipeline::createInputDescriptors(const VulkanContextInfo& contextInfo, 
-	const std::vector<VulkanImage>& vulkanImages)
+	const std::vector<VulkanImage>& vulkanImages, const std::vector<VulkanImage>& staticImages)
 {
 	inputDescriptors.resize(contextInfo.swapChainImages.size());
 	for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
-		inputDescriptors[i].numImageSamplers = 1;//TODO: determine num image samplers of previous stage from size of VulkanImage vector
-		inputDescriptors[i].createDescriptorSetLayoutPostProcess(contextInfo);
-		inputDescriptors[i].createDescriptorPoolPostProcess(contextInfo);
+		inputDescriptors[i].numImageSamplers = 1 + static_cast<int>(staticImages.size());//TODO: determine num image samplers of previous stage from size of VulkanImage vector
+		if (pipelinetype == PipelineType::COMPUTE) {
+			inputDescriptors[i].createDescriptorSetLayoutPostProcessCompute(contextInfo);
+			inputDescriptors[i].createDescriptorPoolPostProcessCompute(contextInfo);
+		} else {
+			inputDescriptors[i].createDescriptorSetLayoutPostProcess(contextInfo);
+			inputDescriptors[i].createDescriptorPoolPostProcess(contextInfo);
+		}
 
 		//may want to extent this to include cases where a post process has multiple render targets and therefore VulkanImages
-		const std::vector<VulkanImage>& vulkanImagesAtSwapIndex = { vulkanImages[i] };
-		inputDescriptors[i].createDescriptorSetPostProcess(contextInfo, vulkanImagesAtSwapIndex);
+		std::vector<VulkanImage> vulkanImagesAtSwapIndex = { vulkanImages[i] };
+		for (const VulkanImage& staticImage : staticImages) {
+			vulkanImagesAtSwapIndex.push_back(staticImage);
+		}
+		if (pipelinetype == PipelineType::COMPUTE) {
+			inputDescriptors[i].createDescriptorSetPostProcessCompute(contextInfo, vulkanImagesAtSwapIndex, outputImages[i]);
+		} else {
+			//in place the input is the attachment too
+			const VkImageLayout inputLayout = (pipelinetype == PipelineType::HOLES_ONLY) ?
+				VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			inputDescriptors[i].createDescriptorSetPostProcess(contextInfo, vulkanImagesAtSwapIndex, inputLayout);
+		}
 	}
 }
 
@@ -666,30 +808,34 @@ void PostProcessPipeline::createInputDescriptorsTimeWarp(const VulkanContextInfo
 	}
 }
 
+void PostProcessPipeline::createInputDescriptorsTemporal(const VulkanContextInfo& contextInfo, 
+	const std::vector<VulkanImage>& vulkanImages, const VulkanImage& depthImage, const VkBuffer& uniformBuffer,
+	const int sizeofUBOstruct)
+{
+	if (isPresent) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": temporal hole fill reads its own output, it can't be the present stage!";
+		throw std::runtime_error(ss.str());
+	}
 
+	const size_t numImages = contextInfo.swapChainImages.size();
+	inputDescriptors.resize(numImages);
+	for (int i = 0; i < numImages; ++i) {
+		inputDescriptors[i].numImageSamplers = 3;
+		inputDescriptors[i].createDescriptorSetLayoutPostProcessTemporal(contextInfo);
+		inputDescriptors[i].createDescriptorPoolPostProcessTemporal(contextInfo);
 
-void PostProcessPipeline::createSemaphores(const VulkanContextInfo& contextInfo) {
-	VkSemaphoreCreateInfo semaphoreInfo = {};
-	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-
-	if (vkCreateSemaphore(contextInfo.device, &semaphoreInfo, nullptr, &imageAvailableSemaphore) != VK_SUCCESS ||
-		vkCreateSemaphore(contextInfo.device, &semaphoreInfo, nullptr, &renderFinishedSemaphore) != VK_SUCCESS) 
-	{
-		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create semaphores!";
-		throw std::runtime_error(ss.str());
+		inputDescriptors[i].createDescriptorSetPostProcessTemporal(contextInfo, vulkanImages[i],
+			outputImages[(i + numImages - 1) % numImages], depthImage, uniformBuffer, sizeofUBOstruct);
 	}
 }
 
+
+
 void PostProcessPipeline::destroyVulkanPipeline(const VulkanContextInfo& contextInfo) {
-	freeCommandBuffers(contextInfo);
 	destroyPipeline(contextInfo);
 	destroyPipelineLayout(contextInfo);
 }
 
-void PostProcessPipeline::freeCommandBuffers(const VulkanContextInfo& contextInfo) {
-	vkFreeCommandBuffers(contextInfo.device, commandPools[0], static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
-}
-
 void PostProcessPipeline::destroyPipeline(const VulkanContextInfo& contextInfo) {
 	vkDestroyPipeline(contextInfo.device, graphicsPipeline, nullptr);
 }
@@ -697,9 +843,3 @@ void PostProcessPipeline::destroyPipeline(const VulkanContextInfo& contextInfo)
 void PostProcessPipeline::destroyPipelineLayout(const VulkanContextInfo& contextInfo) {
 	vkDestroyPipelineLayout(contextInfo.device, pipelineLayout, nullptr);
 }
-
-void PostProcessPipeline::destroyPipelineSemaphores(const VulkanContextInfo& contextInfo) {
-	vkDestroySemaphore(contextInfo.device, renderFinishedSemaphore, nullptr);
-	vkDestroySemaphore(contextInfo.device, imageAvailableSemaphore, nullptr);
-}
-
@@ -25,14 +25,19 @@
 class Mesh;
 class Model;
 
+//HOLES_ONLY is never in the stage lists, the first stage gets it with camera.subpassHoleFill (holesOnlyFragShaders_PostProcessPipelines)
 enum class PipelineType {
-	PP = 0, TIMEWARP = 1
+	PP = 0, TIMEWARP = 1, TEMPORAL = 2, COMPUTE = 3, HOLES_ONLY = 4
 };
 struct PostProcessPushConstant {
 	uint32_t toggleFlags;
 	uint32_t virtualWidth;
 	uint32_t virtualHeight;
+	uint32_t gridQuadsPerDim;//PP_GEOMETRY_GRID
+	glm::vec4 stencilRingRadii;//ppStencilHoleFill, the vr stencil's rings (PreMadeStencil::getRingRadii)
+	uint32_t stencilRingShifts;//PreMadeStencil::getRingShifts
 	static const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	static const VkShaderStageFlags computeStages = VK_SHADER_STAGE_COMPUTE_BIT;//PipelineType::COMPUTE
 };
 
 struct TimeWarpPushConstant {
@@ -40,62 +45,100 @@ struct TimeWarpPushConstant {
 	uint32_t toggleFlags;
 	uint32_t virtualWidth;
 	uint32_t virtualHeight;
+	uint32_t gridQuadsPerDim;//PP_GEOMETRY_GRID
 	static const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 };
 
+//ppStencilHoleFillTemporal.frag's ubo, written every forward rendered frame (the pp command buffers are static)
+struct TemporalHoleFillUBO {
+	glm::mat4 reprojection[2];//per eye: this frame's ndc to last frame's clip space (lastViewProj * inverse(viewProj))
+	uint32_t stencilPhase;//which checker half the forward pass shaded, Camera::stencilPhase
+	uint32_t historyValid;//0 when the previous output isn't last frame's (first frame, after time warp or a swapchain recreate)
+};
+
 class PostProcessPipeline {
 public:
 	std::vector<std::string> shaderpaths;
-	VkPipeline graphicsPipeline;
+	VkPipeline graphicsPipeline;//the compute pipeline for PipelineType::COMPUTE
 	VkPipelineLayout pipelineLayout;
 
-	std::vector<VkCommandBuffer> commandBuffers;
-	std::vector<VkCommandPool> commandPools;
-
 	//NEW
 	std::vector<VulkanImage> outputImages;//give to this stage's framebuffers and next stage's inputDescriptors
 	std::vector<VkFramebuffer> framebuffers;
 	std::vector<VulkanDescriptor> inputDescriptors;
 
-	VkSemaphore imageAvailableSemaphore;
-	VkSemaphore renderFinishedSemaphore;
-
 	//recording state
 	bool recording = false;
 
 	//is Last post process
 	bool isPresent;
-	PipelineType pipelinetype;//0 is normal, 1 is timewarp
+	PipelineType pipelinetype;//0 is normal, 1 is timewarp, 2 is temporal hole fill, 3 is compute, 4 is hole fill in place
+	uint32_t geometry = PP_GEOMETRY_MESH;//from the vertex shader, see proceduralVertexShaders_PostProcessPipelines
+	uint32_t gridQuadsPerDim = 20;//PP_GEOMETRY_GRID, same as the ndc barrel grid mesh
+
+	//PipelineType::COMPUTE: an invocation per 2x2 pixel quad, a work group is COMPUTE_GROUP_QUADS^2 quads.
+	//no framebuffer, the .comp writes outputImages (or the swapchain image if it's the present stage) as a storage image
+	static const uint32_t COMPUTE_GROUP_QUADS = 8;
+	static const VkFormat outputFormat = VK_FORMAT_R16G16B16A16_SFLOAT;//every stage but the present one
+
+	//PipelineType::HOLES_ONLY: no output images, renderPassPostProcessHoles loads the image it samples (SubpassHoleFill's output)
+	//and the stencil test fails on the pixels the forward pass rendered, so only the holes are written. it's sampled in GENERAL
+	//while it's the attachment, the taps only read rendered pixels and the shader discards past the lens (toggleFlags bit 2)
+	static const uint32_t holesOnlyBit = 2;
 
 public:
 	PostProcessPipeline();
 	PostProcessPipeline(const std::vector<std::string>& shaderspaths, const VulkanRenderPass& renderPass,
 		const VulkanContextInfo& contextInfo, const VkDescriptorSetLayout* setLayouts, const bool isPresent,
-	const PipelineType type);
+	const PipelineType type, const std::vector<VkDeviceMemory>& outputMemory = {});
 
 	~PostProcessPipeline();
 
 	//NEW
-	void createOutputImages(const VulkanContextInfo& contextInfo);
-	void addCommandPools(const VulkanContextInfo& contextInfo, const uint32_t num);
+	//outputMemory: per swap image PostProcessGraph slot to alias the outputs into, empty for their own allocations
+	void createOutputImages(const VulkanContextInfo& contextInfo, const std::vector<VkDeviceMemory>& outputMemory);
 	void createFramebuffers(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass);
-	void createInputDescriptors(const VulkanContextInfo& contextInfo, const std::vector<VulkanImage>& vulkanImages);
+	//PipelineType::HOLES_ONLY: targetImages (the forward output per swap image) and the depth image's stencil
+	void createFramebuffersHolesOnly(const VulkanContextInfo& contextInfo, const VulkanRenderPass& renderPass,
+		const std::vector<VulkanImage>& targetImages);
+	//vulkanImages: previous stage's output per swap image (binding 0), staticImages: same for every swap image (binding 1+, e.g. DistortionLUT)
+	void createInputDescriptors(const VulkanContextInfo& contextInfo, const std::vector<VulkanImage>& vulkanImages,
+		const std::vector<VulkanImage>& staticImages = {});
 	//void createInputDescriptorsTimeWarp(const VulkanContextInfo& contextInfo, const std::vector<VulkanImage>& vulkanImages, const VulkanImage& depthImage);
 	void createInputDescriptorsTimeWarp(const VulkanContextInfo& contextInfo,
 		const std::vector<VulkanImage>& vulkanImages, const VulkanImage& depthImage, const VkBuffer& uniformBuffer,
 		const int sizeofUBOstruct);
-	//void createStaticCommandBuffers(const VulkanContextInfo& contextInfo,
-	//	const VulkanRenderPass& renderPass, const Mesh& mesh, const bool vrmode);
-	void createStaticCommandBuffers(const VulkanContextInfo& contextInfo,
-		const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes);//static since no dynamic input, mesh is just quad or triangle
-	void createStaticCommandBuffersTimeWarp(const VulkanContextInfo& contextInfo,
+	//binding 0 is vulkanImages[i], binding 1 this stage's own output for the swap image before i (last frame's if they're
+	//handed out round robin, TemporalHoleFillUBO::historyValid says if it is), then the depth and the ubo
+	void createInputDescriptorsTemporal(const VulkanContextInfo& contextInfo,
+		const std::vector<VulkanImage>& vulkanImages, const VulkanImage& depthImage, const VkBuffer& uniformBuffer,
+		const int sizeofUBOstruct);
+	//this stage's work for swap image imageIndex, recorded once into the PostProcessGraph's static command buffer (no dynamic input,
+	//mesh is just quad or triangle or none if procedural). no barriers, the graph puts those between the stages
+	void recordCommands(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const VulkanContextInfo& contextInfo,
 		const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes);
-
-
-	void allocateCommandBuffers(const VulkanContextInfo& contextInfo);
+	void recordRenderPass(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const VulkanContextInfo& contextInfo,
+		const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes);
+	void recordRenderPassTimeWarp(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const VulkanContextInfo& contextInfo,
+		const VulkanRenderPass& renderPass, const std::vector<Mesh>& meshes);
+	//PipelineType::COMPUTE: a dispatch per eye
+	void recordDispatches(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const VulkanContextInfo& contextInfo);
+	//where this stage writes its output, what the frame's submit waits on the swapchain image at if it's the present stage
+	VkPipelineStageFlags getWaitStage() const;
+	static IMAGETYPE getOutputImageType(const PipelineType type);
+
+	//PP_GEOMETRY_* flag of a pp vertex shader
+	static uint32_t getGeometry(const std::string& vertShaderPath);
+	uint32_t getProceduralVertexCount(const VulkanContextInfo& contextInfo) const;
+	PostProcessPushConstant getPushConstant(const VulkanContextInfo& contextInfo, const uint32_t camIndex) const;
+	//binds meshes[camIndex] and draws it, or just draws the procedural geometry (meshes can be empty then)
+	void recordDraw(const VkCommandBuffer& commandBuffer, const VulkanContextInfo& contextInfo,
+		const std::vector<Mesh>& meshes, const uint32_t camIndex) const;
 
 	void createPipeline(const VulkanRenderPass& renderPass, const VulkanContextInfo& contextInfo, 
 		const VkDescriptorSetLayout* setLayouts);
+	//shaderpaths[0] is the .comp, setLayouts one of VulkanDescriptor::computeLayoutTypes
+	void createComputePipeline(const VulkanContextInfo& contextInfo, const VkDescriptorSetLayout* setLayouts);
 
 	VkShaderModule createShaderModule(const std::vector<char>& code, const VulkanContextInfo& contextInfo) const;
 
@@ -112,13 +155,9 @@ public:
 
 	void recordCommandBufferPrimary(const VkCommandBuffer& singleCmdBuffer,
 		const uint32_t imageIndex, const VulkanContextInfo& contextInfo, const Model& model, const Mesh& mesh, const bool vrmode);
-	void createSemaphores(const VulkanContextInfo& contextInfo);
-
 	//cleanup
-	void freeCommandBuffers(const VulkanContextInfo& contextInfo);
 	void destroyPipeline(const VulkanContextInfo& contextInfo);
 	void destroyPipelineLayout(const VulkanContextInfo& contextInfo);
-	void destroyPipelineSemaphores(const VulkanContextInfo& contextInfo);
 	void destroyVulkanPipeline(const VulkanContextInfo& contextInfo);
 };
 
@@ -0,0 +1,118 @@
+#pragma once
+#include "PostProcessTimer.h"
+#include "VulkanContextInfo.h"
+
+#include <sstream>
+#include <stdexcept>
+
+
+PostProcessTimer::PostProcessTimer() {
+}
+
+PostProcessTimer::~PostProcessTimer() {
+}
+
+void PostProcessTimer::createQueryPool(const VulkanContextInfo& contextInfo, const uint32_t numChains) {
+	const uint32_t numImages = static_cast<uint32_t>(contextInfo.swapChainImages.size());
+	pendingChain.assign(numImages, NONE);
+	if (totalMs.size() != numChains) {
+		totalMs.assign(numChains, 0.0);
+		frames.assign(numChains, 0);
+	}
+
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(contextInfo.physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(contextInfo.physicalDevice, &queueFamilyCount, queueFamilies.data());
+	const uint32_t validBits = queueFamilies[contextInfo.graphicsFamily].timestampValidBits;
+	if (validBits == 0) {
+		return;
+	}
+	timestampMask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1);
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(contextInfo.physicalDevice, &properties);
+	timestampPeriod_ns = properties.limits.timestampPeriod;
+
+	VkQueryPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = 2 * numImages;
+
+	if (vkCreateQueryPool(contextInfo.device, &poolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create pp timestamp query pool!";
+		throw std::runtime_error(ss.str());
+	}
+}
+
+void PostProcessTimer::frameSubmitted(const uint32_t imageIndex, const uint32_t chain) {
+	if (queryPool == VK_NULL_HANDLE) {
+		return;
+	}
+	pendingChain[imageIndex] = chain;
+}
+
+void PostProcessTimer::collect(const VulkanContextInfo& contextInfo, const uint32_t imageIndex, const bool wait) {
+	const uint32_t chain = pendingChain[imageIndex];
+	if (queryPool == VK_NULL_HANDLE || chain == NONE) {
+		return;
+	}
+
+	uint64_t timestamps[2];
+	const VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | (wait ? VK_QUERY_RESULT_WAIT_BIT : 0);
+	const VkResult result = vkGetQueryPoolResults(contextInfo.device, queryPool, 2 * imageIndex, 2,
+		sizeof(timestamps), timestamps, sizeof(uint64_t), flags);
+	pendingChain[imageIndex] = NONE;
+	if (result != VK_SUCCESS) {//VK_NOT_READY, the frame is dropped from the totals
+		return;
+	}
+
+	const uint64_t ticks = ((timestamps[1] & timestampMask) - (timestamps[0] & timestampMask)) & timestampMask;
+	const double ms = ticks * timestampPeriod_ns * 1e-6;
+	totalMs[chain] += ms;
+	++frames[chain];
+	recentMs += ms;
+	++recentFrames;
+}
+
+void PostProcessTimer::collectAll(const VulkanContextInfo& contextInfo) {
+	for (uint32_t i = 0; i < pendingChain.size(); ++i) {
+		collect(contextInfo, i, true);
+	}
+}
+
+void PostProcessTimer::resetTotals() {
+	//frames submitted before the reset would otherwise be collected into the new totals
+	pendingChain.assign(pendingChain.size(), NONE);
+	totalMs.assign(totalMs.size(), 0.0);
+	frames.assign(frames.size(), 0);
+}
+
+double PostProcessTimer::getAverageMs(const uint32_t chain) const {
+	return frames[chain] == 0 ? -1.0 : totalMs[chain] / frames[chain];
+}
+
+uint32_t PostProcessTimer::getCheapestChain() const {
+	uint32_t cheapest = NONE;
+	for (uint32_t i = 0; i < totalMs.size(); ++i) {
+		if (frames[i] > 0 && (cheapest == NONE || getAverageMs(i) < getAverageMs(cheapest))) {
+			cheapest = i;
+		}
+	}
+	return cheapest;
+}
+
+double PostProcessTimer::takeRecentMs() {
+	const double average = recentFrames == 0 ? -1.0 : recentMs / recentFrames;
+	recentMs = 0.0;
+	recentFrames = 0;
+	return average;
+}
+
+void PostProcessTimer::destroyQueryPool(const VulkanContextInfo& contextInfo) {
+	if (queryPool != VK_NULL_HANDLE) {
+		vkDestroyQueryPool(contextInfo.device, queryPool, nullptr);
+	}
+	queryPool = VK_NULL_HANDLE;
+	pendingChain.clear();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <vector>
+#include <cstdint>
+
+class VulkanContextInfo;
+
+//gpu time of the frame's pp chain from 2 timestamp queries per swap image, PostProcessGraph::record writes them around its passes.
+//summed per chain so the distortion techniques (distortionTechniques_PostProcessPipelines) can be compared while running.
+//a swap image's results are read when it comes round again, the frame that wrote them has been waited on by then
+class PostProcessTimer {
+public:
+	static const uint32_t NONE = 0xFFFFFFFF;
+
+	VkQueryPool queryPool = VK_NULL_HANDLE;//stays VK_NULL_HANDLE (nothing is timed) if the graphics queue has no timestamps
+	double timestampPeriod_ns = 1.0;
+	uint64_t timestampMask = ~0ull;//timestampValidBits of the graphics queue
+
+	std::vector<uint32_t> pendingChain;//[swap image] chain its last submit was, NONE if there's nothing to read
+	std::vector<double> totalMs;//[chain] since resetTotals
+	std::vector<uint32_t> frames;//[chain]
+	double recentMs = 0.0;//any chain, since takeRecentMs
+	uint32_t recentFrames = 0;
+
+public:
+	PostProcessTimer();
+	~PostProcessTimer();
+
+	//2 queries per swap image, keeps the totals if the number of chains is the same (swapchain recreation)
+	void createQueryPool(const VulkanContextInfo& contextInfo, const uint32_t numChains);
+	//the swap image's queries will hold this chain's time
+	void frameSubmitted(const uint32_t imageIndex, const uint32_t chain);
+	//adds the swap image's last results if it has any, before it's submitted again. wait blocks until they're written
+	void collect(const VulkanContextInfo& contextInfo, const uint32_t imageIndex, const bool wait = false);
+	void collectAll(const VulkanContextInfo& contextInfo);
+	//zeroes the totals and drops the results still pending, only frames submitted after it count
+	void resetTotals();
+	//-1 if the chain wasn't timed
+	double getAverageMs(const uint32_t chain) const;
+	//chain with the lowest average of the ones that were timed, NONE if none were
+	uint32_t getCheapestChain() const;
+	//average of every timed frame since the last call, -1 if there were none
+	double takeRecentMs();
+
+	//cleanup
+	void destroyQueryPool(const VulkanContextInfo& contextInfo);
+};
@@ -2,46 +2,100 @@
 #include "PreMadeStencil.h"
 #include "GlobalSettings.h"
 #include "Mesh.h"
+#include "LensDistortion.h"
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <stdexcept>
+#include <limits>
+#include <immintrin.h>
 
 
 PreMadeStencil::PreMadeStencil(const VulkanContextInfo& contextInfo, const uint32_t qualityIndex, const StencilType type)
 	: type(type), qualityIndex(qualityIndex), qualityScale(contextInfo.camera.vrScalings[qualityIndex]) 
 
 
-	//set to false to just read the mask from disk
+	//debug only, set to true to also dump the mask to a bmp (nothing reads it back)
 	, writeStencil(false)
 {
-	if (!writeStencil) { genFileName(); return; }
-	if (StencilType::RadialDensityMask == type) {
-		createRadialDensityStencilMask(contextInfo);
-	} else if (StencilType::FixedFoveated == type) {
-		createFixedFoveatedStencilMask(contextInfo);
-	} else if (StencilType::PreCalcBarrelSamplingMask == type) {
-		createPreCalcBarrelSamplingStencilMask(contextInfo);
+	genFileName();
+	calcExtent(contextInfo);
+	calcRings();
+	if (!writeStencil) { return; }
+	generateMask(contextInfo);
+	writeStencilToImage();
+}
+
+void PreMadeStencil::calcRings() {
+	//ppStencilHoleFill blacks out anything past the last ring
+	if (StencilType::FixedFoveated == type) {
+		const uint32_t numLevels = static_cast<uint32_t>(fixedFoveatedLevels.size());
+		rings = getFixedFoveatedRings(std::min(qualityIndex, numLevels - 1));
+		for (StencilRing& ring : rings) {
+			ring.outerRadius = std::min(ring.outerRadius, 1.f + extraRadius);
+		}
+	} else if (StencilType::RadialDensityMask == type) {
+		rings = { { middleRegionRadius, 0 }, { 1.f + extraRadius, 1 } };
+	} else {
+		//no holes, and the barrel pass reads some quads past the lens circle
+		rings = { { std::numeric_limits<float>::max(), 0 } };
 	}
 }
 
-PreMadeStencil::PreMadeStencil() {
+std::vector<StencilRing> PreMadeStencil::getFixedFoveatedRings(const uint32_t level) {
+	if (level >= fixedFoveatedLevels.size() || fixedFoveatedLevels[level].empty() || fixedFoveatedLevels[level].size() > MAX_RINGS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": fixedFoveatedLevels[" << level << "] needs 1 to " << MAX_RINGS << " rings!";
+		throw std::runtime_error(ss.str());
+	}
+
+	std::vector<StencilRing> levelRings;
+	for (const auto& ring : fixedFoveatedLevels[level]) {
+		if (ring.second > MAX_DENSITY_SHIFT || (!levelRings.empty() && !(ring.first > levelRings.back().outerRadius))) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": fixedFoveatedLevels[" << level
+				<< "] rings must grow outward with density shifts up to " << MAX_DENSITY_SHIFT << "!";
+			throw std::runtime_error(ss.str());
+		}
+		levelRings.push_back({ ring.first, ring.second });
+	}
+	return levelRings;
 }
 
-PreMadeStencil::~PreMadeStencil() {
+bool PreMadeStencil::quadShaded(const uint32_t densityShift, const uint32_t qx, const uint32_t qy) {
+	if (densityShift == 0) {
+		return true;
+	} else if (densityShift == 1) {
+		return ((qx ^ qy) & 1) == 0;
+	}
+	const bool evenQuad = ((qx | qy) & 1) == 0;
+	return densityShift == 2 ? evenQuad : evenQuad && (((qx ^ qy) >> 1) & 1) == 0;
 }
-void PreMadeStencil::createFixedFoveatedStencilMask(const VulkanContextInfo& contextInfo) {
-	width = pretendStartsVR ? contextInfo.camera.renderTargetExtent.width : hmdWidth;
-	height = pretendStartsVR ? contextInfo.camera.renderTargetExtent.height : hmdHeight;
-	width	= (width &  1) == 1 ? width  - 1 : width;
-	height	= (height & 1) == 1 ? height - 1 : height;
 
+bool PreMadeStencil::quadShadedAlternate(const uint32_t densityShift, const uint32_t qx, const uint32_t qy) {
+	//over two frames a checker ring shades every quad, a quarter or eighth one would need 4 or 8 frames for that and ghost more than it saves
+	return quadShaded(densityShift, densityShift == 1 ? qx + 1 : qx, qy);
+}
 
+glm::vec4 PreMadeStencil::getRingRadii() const {
+	glm::vec4 radii(-1.f);
+	for (uint32_t i = 0; i < rings.size(); ++i) {
+		radii[i] = rings[i].outerRadius;
+	}
+	return radii;
 }
 
-//if this works should be able to avoid having to hole fill like the other radial quad masking technuiques
-void PreMadeStencil::createPreCalcBarrelSamplingStencilMask(const VulkanContextInfo& contextInfo) {
-	//width = pretendStartsVR ? contextInfo.camera.renderTargetExtent[qualityIndex].width : hmdWidth;
-	//height = pretendStartsVR ? contextInfo.camera.renderTargetExtent[qualityIndex].height : hmdHeight;
+uint32_t PreMadeStencil::getRingShifts() const {
+	uint32_t shifts = 0;
+	for (uint32_t i = 0; i < rings.size(); ++i) {
+		shifts |= rings[i].densityShift << (4 * i);
+	}
+	return shifts;
+}
+
+void PreMadeStencil::calcExtent(const VulkanContextInfo& contextInfo) {
+	//every type is the quality level's vr render target, that's the depth image it goes in
 	width = pretendStartsVR ? qualityScale * hmdWidth : hmdWidth;
 	height = pretendStartsVR ? qualityScale * hmdHeight : hmdHeight;
 
@@ -49,178 +103,270 @@ void PreMadeStencil::createPreCalcBarrelSamplingStencilMask(const VulkanContextI
 	//ensure that dims are even to avoid stencil issues
 	width	= (width &  1) == 1 ? width  - 1 : width;
 	height	= (height & 1) == 1 ? height - 1 : height;
+}
 
-	const float invWidth = 1.f / width;
-	const float invHeight = 1.f / height;
+void PreMadeStencil::generateMask(const VulkanContextInfo& contextInfo) {
+	if (StencilType::RadialDensityMask == type || StencilType::FixedFoveated == type) {
+		createRingStencilMask(contextInfo);
+	} else if (StencilType::PreCalcBarrelSamplingMask == type) {
+		createPreCalcBarrelSamplingStencilMask(contextInfo);
+	}
+}
+
+void PreMadeStencil::expandMask(uint8_t* out_mask) const {
+	if (!temporalCheckerStencil) {
+		mask.expand(out_mask, static_cast<uint8_t>(stencilMaskVal));
+		return;
+	}
+	mask.expand(out_mask, 1);
+	alternateMask.expandOr(out_mask, 2);
+}
+
+PreMadeStencil::PreMadeStencil() {
+}
+
+PreMadeStencil::~PreMadeStencil() {
+}
+//every texel the barrel/aberration pass (ppBarrelAbFragCommonUse.frag) fetches for the present pixels inside the lens circle,
+//all 3 channels. that's the only place the forward render target is read so shading exactly these quads at full res
+//leaves nothing to hole fill. the precalc/grid mesh barrel passes interpolate the same uv's so they land on the same texels give or take one
+void PreMadeStencil::createPreCalcBarrelSamplingStencilMask(const VulkanContextInfo& contextInfo) {
 	const float invHMDWidth = 1.f / hmdWidth;
 	const float invHMDHeight = 1.f / hmdHeight;
-	std::vector<std::vector<uint8_t>>radialDensityMask(3);
-	radialDensityMask[0].resize(width*height);//left
-	radialDensityMask[1].resize(width*height);//right
-	radialDensityMask[2].resize(width*height);//combined (xor)
-
-	//go through all 2x2 set of pixels (center of group) and determine if that point samples outside of
-	//the UV space for that eye, if so mark as 0 (z-near in vulkan). make a once that is blank for non vr mode?
-	for (int camIndex = 0; camIndex <= 1; ++camIndex) {
-		for (int hmdY = 0; hmdY < hmdHeight; ++hmdY) {
-			for (int hmdX = 0; hmdX < hmdWidth; ++hmdX) {
-				/////////////////////////////////////////////
-				//////////CHECK IF WITHIN RADIUS/////////////
-				/////////////////////////////////////////////
-				//determine if im inside the radius
-				//dont distinguish between checker band and center
-				//maybe there's a quad that doesnt get sampled in the middle for certain HMD's lenses because it gets blown out so much
-				//glm::vec2 uv(hmdX*invHMDWidth, hmdY*invHMDHeight);
-				//Should probably be this:
-				glm::vec2 uv((hmdX+0.5f)*invHMDWidth, (hmdY+0.5f)*invHMDHeight);
-
-				//convert this uv to ndc based on camIndex
+	const uint32_t eyeHMDWidth = hmdWidth / 2;
+	//a bit per quad, quad row qy starts at word qy*wordsPerRow. the eyes read their own half so their quads are just or'd
+	const uint32_t quadsX = width / 2;
+	const uint32_t quadsY = height / 2;
+	const uint32_t wordsPerRow = (quadsX + 63) / 64;
+	std::vector<uint64_t> quadBits(wordsPerRow*quadsY, 0);
+
+	//nearest sampling, clamp to edge (see VulkanImage::createImageSampler) so the fetch is the texel the uv is in
+	auto markTexel = [&](const float u, const float v) {
+		const uint32_t x = static_cast<uint32_t>(glm::clamp(static_cast<int>(std::floor(u*width)), 0, static_cast<int>(width) - 1));
+		const uint32_t y = static_cast<uint32_t>(glm::clamp(static_cast<int>(std::floor(v*height)), 0, static_cast<int>(height) - 1));
+		const uint32_t qx = x >> 1;
+		const uint32_t qy = y >> 1;
+		quadBits[qy*wordsPerRow + (qx >> 6)] |= uint64_t(1) << (qx & 63);
+	};
+
+	//uv's for one row of an eye's hmd pixel centers, the distortion is evaluated a row at a time (SoA, SIMD)
+	std::vector<float> rowU(eyeHMDWidth);
+	std::vector<float> rowV(eyeHMDWidth);
+	SourceUVBatch rowSourceUVs;
+	rowSourceUVs.resize(eyeHMDWidth);
+	for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+		const EyeDistortionConstants& eye = LensDistortion::getEyeConstants(camIndex);
+		for (uint32_t eyeX = 0; eyeX < eyeHMDWidth; ++eyeX) {
+			rowU[eyeX] = (camIndex*eyeHMDWidth + eyeX + 0.5f)*invHMDWidth;
+		}
+		for (uint32_t hmdY = 0; hmdY < hmdHeight; ++hmdY) {
+			std::fill(rowV.begin(), rowV.end(), (hmdY + 0.5f)*invHMDHeight);
+			//calls Brown-Conrady distortion, to get sampling uv's for the whole row
+			LensDistortion::getSourceUVBatch(eye, rowU.data(), rowV.data(), eyeHMDWidth, rowSourceUVs);
+
+			for (uint32_t eyeX = 0; eyeX < eyeHMDWidth; ++eyeX) {
+				//present pixels that can't be seen through the lens don't count
+				const glm::vec2 uv(rowU[eyeX], rowV[eyeX]);
 				glm::vec2 equivNDC = glm::vec2((uv.x - 0.5f*camIndex)*4.f - 1.f, uv.y*2.f - 1.f);
 				equivNDC *= glm::vec2(1.f , hmdHeight/(hmdWidth*0.5f));//normalize y ndc against half width (eye viewport size) so we get circles and not long vertical ellipses if Y is greater than vr eye viewport x (width/2)
-				float radius = glm::length(equivNDC - ndcCenter[camIndex]);
-
-				if (radius < (1.f + extraRadius)) {
-					//if so use Mesh::getSourceUV to get all 3 UV channels needed
-					glm::vec2 tcRed, tcGreen, tcBlue;
-					Mesh::getSourceUV(camIndex, uv, tcRed, tcGreen, tcBlue);//calls Brown-Conrady distortion, to get sampling uv's
-
-					//convert these UV's to pixels for the scaled vr source image
-					glm::ivec2 groupRed	  = tcRed	* glm::vec2(width, height);
-					glm::ivec2 groupGreen = tcGreen * glm::vec2(width, height);
-					glm::ivec2 groupBlue  = tcBlue  * glm::vec2(width, height);
-
-
-					//snap to a pixel quad for each 
-					groupRed.x		= ((groupRed.x		& 1) == 1) ? groupRed.x		: groupRed.x 	+ 1;
-					groupRed.y 		= ((groupRed.y 		& 1) == 1) ? groupRed.y 	: groupRed.y 	+ 1;
-					groupGreen.x	= ((groupGreen.x	& 1) == 1) ? groupGreen.x 	: groupGreen.x 	+ 1;
-					groupGreen.y 	= ((groupGreen.y 	& 1) == 1) ? groupGreen.y 	: groupGreen.y 	+ 1;
-					groupBlue.x 	= ((groupBlue.x 	& 1) == 1) ? groupBlue.x 	: groupBlue.x 	+ 1;
-					groupBlue.y 	= ((groupBlue.y 	& 1) == 1) ? groupBlue.y 	: groupBlue.y 	+ 1;
-
-					
-					//tag all 4 pixels in each of teh 3 channel's pixel quads
-						  //set group of 4 to stencilMask. uv as it is resolves to lower right pixel
-						//radialDensityMask[camIndex][(groupRed.y    )*width	+ groupRed.x    ] = stencilMaskVal;//lowerright
-						//radialDensityMask[camIndex][(groupRed.y - 1)*width	+ groupRed.x    ] = stencilMaskVal;//upperright
-						//radialDensityMask[camIndex][(groupRed.y - 1)*width	+ groupRed.x - 1] = stencilMaskVal;//upperleft
-						//radialDensityMask[camIndex][(groupRed.y	   )*width	+ groupRed.x - 1] = stencilMaskVal;//lowerleft
-
-						  //set group of 4 to stencilMask. uv as it is resolves to lower right pixel
-						radialDensityMask[camIndex][(groupGreen.y    )*width	+ groupGreen.x    ] = stencilMaskVal;//lowerright
-						radialDensityMask[camIndex][(groupGreen.y - 1)*width	+ groupGreen.x    ] = stencilMaskVal;//upperright
-						radialDensityMask[camIndex][(groupGreen.y - 1)*width	+ groupGreen.x - 1] = stencilMaskVal;//upperleft
-						radialDensityMask[camIndex][(groupGreen.y	 )*width	+ groupGreen.x - 1] = stencilMaskVal;//lowerleft
-
-						  //set group of 4 to stencilMask. uv as it is resolves to lower right pixel
-						//radialDensityMask[camIndex][(groupBlue.y    )*width	+ groupBlue.x    ] = stencilMaskVal;//lowerright
-						//radialDensityMask[camIndex][(groupBlue.y - 1)*width	+ groupBlue.x    ] = stencilMaskVal;//upperright
-						//radialDensityMask[camIndex][(groupBlue.y - 1)*width	+ groupBlue.x - 1] = stencilMaskVal;//upperleft
-						//radialDensityMask[camIndex][(groupBlue.y	)*width	+ groupBlue.x - 1] = stencilMaskVal;//lowerleft
-				} //if in radius
+				const float radius = glm::length(equivNDC - ndcCenter[camIndex]);
+				if (!(radius < (1.f + extraRadius))) {
+					continue;
+				}
+
+				//the pass writes black without fetching anything when green lands outside the eye
+				const glm::vec2 greenNDC((rowSourceUVs.greenU[eyeX] - 0.5f*camIndex)*4.f - 1.f, rowSourceUVs.greenV[eyeX]*2.f - 1.f);
+				if (glm::any(glm::greaterThan(glm::abs(greenNDC), glm::vec2(1.f)))) {
+					continue;
+				}
+
+				markTexel(rowSourceUVs.redU[eyeX],		rowSourceUVs.redV[eyeX]);
+				markTexel(rowSourceUVs.greenU[eyeX],	rowSourceUVs.greenV[eyeX]);
+				markTexel(rowSourceUVs.blueU[eyeX],		rowSourceUVs.blueV[eyeX]);
 			}//x
-		}//x
+		}//y
 	}//camIndex
 
-	//XOR values to get result
-	int uniquePixels = 0;
-	for (int y = 0; y <height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			const int stencilIndex = (y*width + x);
-			uint32_t xorResult = radialDensityMask[0][stencilIndex] ^ radialDensityMask[1][stencilIndex];
-			//radialDensityMask[2][stencilIndex] = radialDensityMask[0][stencilIndex];
-			radialDensityMask[2][stencilIndex] = xorResult;
-			uniquePixels += xorResult;
-		}
+	mask = QuadMask(quadsX, quadsY);
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		mask.appendRow(&quadBits[qy*wordsPerRow]);
 	}
-
-	std::cout << "\nUniquePixels: " << uniquePixels << " : " << filename;
-	writeStencilToImage(radialDensityMask[2]);
+	//no checker rings, every frame shades the same quads
+	alternateMask = mask;
 }
 
-void PreMadeStencil::createRadialDensityStencilMask(const VulkanContextInfo& contextInfo) {
-	//width = pretendStartsVR ? contextInfo.camera.renderTargetExtent[qualityIndex].width : hmdWidth;
-	//height = pretendStartsVR ? contextInfo.camera.renderTargetExtent[qualityIndex].height : hmdHeight;
-
-	width = pretendStartsVR ? qualityScale * hmdWidth : hmdWidth;
-	height = pretendStartsVR ? qualityScale * hmdHeight : hmdHeight;
-
-	//ensure that dims are even to avoid stencil issues
-	width	= (width &  1) == 1 ? width  - 1 : width;
-	height	= (height & 1) == 1 ? height - 1 : height;
-
+void PreMadeStencil::createRingStencilMask(const VulkanContextInfo& contextInfo) {
+	//every 2x2 pixel quad is decided once for both eyes and the xor of the two (the eye regions only overlap
+	//outside the lens circles) goes straight into the quad row's bits, then the row is run length encoded.
+	//a quad row is done 4 quads at a time with sse, the quad is tested at its lower right pixel.
+	//a quad is in the first ring whose outer radius it's inside of and is shaded if that ring's density pattern has it.
+	//alternateMask is built alongside with the checker rings' other parity (quadShadedAlternate).
+	//x,y correspond to pixel number where 0,0 is upper left in vulkan
+	const uint32_t quadsX = width / 2;
+	const uint32_t quadsY = height / 2;
 	const float invWidth = 1.f / width;
 	const float invHeight = 1.f / height;
-	std::vector<std::vector<uint8_t>>radialDensityMask(3);
-	radialDensityMask[0].resize(width*height);
-	radialDensityMask[1].resize(width*height);
-	radialDensityMask[2].resize(width*height);
-
-	//go through all 2x2 set of pixels (center of group) and determine if that point samples outside of
-	//the UV space for that eye, if so mark as 0 (z-near in vulkan). make a once that is blank for non vr mode?
-	for (int camIndex = 0; camIndex <= 1; ++camIndex) {
-		
-		//x,y correspond to pixel number where 0,0 is upper left in vulkan
-		//loop over entire render area for each eye, if outside of r=1.15 or render area set to stencilMask(need to XOR later to get middle cutout)
-		for (int y = 1; y < height; y+=2) {
-			for (int x = 1; x < width; x+=2) {
-				//if (x == 881 && y == 601 && camIndex == 1) {
-				//if (x == 1367 && y == 1 && camIndex == 1) {
-				//	int adinvow = 1;
-				//}
-
-				//convert to uv
-				const glm::vec2 uv(x*invWidth, y*invHeight);
-
-				//convert this uv to ndc based on camIndex
-				glm::vec2 equivNDC = glm::vec2((uv.x - 0.5f*camIndex)*4.f - 1.f, uv.y*2.f - 1.f);
-				equivNDC *= glm::vec2(1.f , height/(width*0.5f));//normalize y ndc against half width (eye viewport size) so we get circles and not long vertical ellipses if Y is greater than vr eye viewport x (width/2)
-				float radius = glm::length(equivNDC - ndcCenter[camIndex]);
-
-
-
-				if (radius < (1.f + extraRadius)) {
-					if (radius > middleRegionRadius) {//middle region checkerboard 2x2
-						if ( (((x - 1) & 0x3) == 0) && (((y - 1) & 0x3) == 0) //both divis by 4
-					      || (((x - 3) & 0x3) == 0) && (((y - 3) & 0x3) == 0) ) { //shift the above pattern right and down to get checker
-							//set group of 4 to stencilMask. uv as it is resolves to lower right pixel
-							radialDensityMask[camIndex][(y  )*width + x  ] = stencilMaskVal;//lowerright
-							radialDensityMask[camIndex][(y-1)*width + x  ] = stencilMaskVal;//upperright
-							radialDensityMask[camIndex][(y-1)*width + x-1] = stencilMaskVal;//upperleft
-							radialDensityMask[camIndex][(y  )*width + x-1] = stencilMaskVal;//lowerleft
-						}
-					} else { //center region
-						//set group of 4 to stencilMask. uv as it is resolves to lower right pixel
-						radialDensityMask[camIndex][(y  )*width + x  ] = stencilMaskVal;//lowerright
-						radialDensityMask[camIndex][(y-1)*width + x  ] = stencilMaskVal;//upperright
-						radialDensityMask[camIndex][(y-1)*width + x-1] = stencilMaskVal;//upperleft
-						radialDensityMask[camIndex][(y  )*width + x-1] = stencilMaskVal;//lowerleft
-					}
-				} 
+	//normalize y ndc against half width (eye viewport size) so we get circles and not long vertical ellipses if Y is greater than vr eye viewport x (width/2)
+	const float ndcScaleY = height / (width*0.5f);
+	const float outerRadius = 1.f + extraRadius;
+	const uint32_t numRings = static_cast<uint32_t>(rings.size());
+
+	//per eye ndc x offset from the lens center of every quad column
+	std::vector<float> quadDX[2];
+	for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+		quadDX[camIndex].resize(quadsX);
+		for (uint32_t qx = 0; qx < quadsX; ++qx) {
+			const float u = (2*qx + 1)*invWidth;
+			quadDX[camIndex][qx] = (u - 0.5f*camIndex)*4.f - 1.f - ndcCenter[camIndex].x;
+		}
+	}
 
-			}//x pixel ID
-		}//y pixel ID
-	}//camIndex
+	const __m128 outerRadius4 = _mm_set1_ps(outerRadius);
+	__m128 ringRadius4[MAX_RINGS];
+	for (uint32_t r = 0; r < numRings; ++r) {
+		ringRadius4[r] = _mm_set1_ps(rings[r].outerRadius);
+	}
+	mask = QuadMask(quadsX, quadsY);
+	alternateMask = QuadMask(quadsX, quadsY);
+	std::vector<uint64_t> rowBits((quadsX + 63) / 64);
+	std::vector<uint64_t> alternateRowBits((quadsX + 63) / 64);
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		const float v = (2*qy + 1)*invHeight;
+		const float ndcY = (v*2.f - 1.f)*ndcScaleY;
+		const float dy[2] = { ndcY - ndcCenter[0].y, ndcY - ndcCenter[1].y };
+		const __m128 dySq[2] = { _mm_set1_ps(dy[0]*dy[0]), _mm_set1_ps(dy[1]*dy[1]) };
+		//the density patterns repeat every 4 quads in x, so 4 quads starting at a multiple of 4 are the first 4's
+		uint32_t ringPattern4[MAX_RINGS];
+		uint32_t alternatePattern4[MAX_RINGS];
+		for (uint32_t r = 0; r < numRings; ++r) {
+			ringPattern4[r] = 0;
+			alternatePattern4[r] = 0;
+			for (uint32_t i = 0; i < 4; ++i) {
+				ringPattern4[r] |= quadShaded(rings[r].densityShift, i, qy) ? 1 << i : 0;
+				alternatePattern4[r] |= quadShadedAlternate(rings[r].densityShift, i, qy) ? 1 << i : 0;
+			}
+		}
 
-	//XOR values to get result
-	int uniquePixels = 0;
-	for (int y = 0; y <height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			const int stencilIndex = (y*width + x);
-			uint32_t xorResult = radialDensityMask[0][stencilIndex] ^ radialDensityMask[1][stencilIndex];
-			//radialDensityMask[2][stencilIndex] = radialDensityMask[0][stencilIndex];
-			radialDensityMask[2][stencilIndex] = xorResult;
-			uniquePixels += xorResult;
+		std::fill(rowBits.begin(), rowBits.end(), 0);
+		std::fill(alternateRowBits.begin(), alternateRowBits.end(), 0);
+		uint32_t qx = 0;
+		for (; qx + 4 <= quadsX; qx += 4) {
+			uint32_t eyeBits[2];
+			uint32_t alternateEyeBits[2];
+			for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+				const __m128 dx = _mm_loadu_ps(&quadDX[camIndex][qx]);
+				const __m128 radius = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), dySq[camIndex]));
+				const uint32_t inside = _mm_movemask_ps(_mm_cmplt_ps(radius, outerRadius4));
+				uint32_t inInnerRing = 0;
+				uint32_t shaded = 0;
+				uint32_t alternateShaded = 0;
+				for (uint32_t r = 0; r < numRings; ++r) {
+					const uint32_t inRing = _mm_movemask_ps(_mm_cmple_ps(radius, ringRadius4[r])) & ~inInnerRing;
+					shaded |= inRing & ringPattern4[r];
+					alternateShaded |= inRing & alternatePattern4[r];
+					inInnerRing |= inRing;
+				}
+				eyeBits[camIndex] = inside & shaded;
+				alternateEyeBits[camIndex] = inside & alternateShaded;
+			}
+			//qx is a multiple of 4 so the 4 bits never straddle words
+			const uint64_t xorBits = eyeBits[0] ^ eyeBits[1];
+			rowBits[qx >> 6] |= xorBits << (qx & 63);
+			const uint64_t alternateXorBits = alternateEyeBits[0] ^ alternateEyeBits[1];
+			alternateRowBits[qx >> 6] |= alternateXorBits << (qx & 63);
 		}
+		for (; qx < quadsX; ++qx) {
+			bool eyeCovers[2];
+			bool alternateEyeCovers[2];
+			for (uint32_t camIndex = 0; camIndex <= 1; ++camIndex) {
+				const float dx = quadDX[camIndex][qx];
+				const float radius = std::sqrt(dx*dx + dy[camIndex]*dy[camIndex]);
+				eyeCovers[camIndex] = false;
+				alternateEyeCovers[camIndex] = false;
+				for (uint32_t r = 0; r < numRings && radius < outerRadius; ++r) {
+					if (radius <= rings[r].outerRadius) {
+						eyeCovers[camIndex] = quadShaded(rings[r].densityShift, qx, qy);
+						alternateEyeCovers[camIndex] = quadShadedAlternate(rings[r].densityShift, qx, qy);
+						break;
+					}
+				}
+			}
+			if (eyeCovers[0] != eyeCovers[1]) {
+				rowBits[qx >> 6] |= uint64_t(1) << (qx & 63);
+			}
+			if (alternateEyeCovers[0] != alternateEyeCovers[1]) {
+				alternateRowBits[qx >> 6] |= uint64_t(1) << (qx & 63);
+			}
+		}
+		mask.appendRow(rowBits.data());
+		alternateMask.appendRow(alternateRowBits.data());
 	}
+}
 
-	std::cout << "\nUniquePixels: " << uniquePixels << " : " << filename;
-	writeStencilToImage(radialDensityMask[2]);
+void PreMadeStencil::reportFixedFoveated(const VulkanContextInfo& contextInfo) {
+	//all at quality level 0's extent so the ring lists compare directly
+	PreMadeStencil stencil(contextInfo, 0, StencilType::RadialDensityMask);
+	const uint32_t targetFragments = stencil.width * stencil.height;
+
+	std::cout << "\n\nFixed foveated stencil report (" << stencil.width << "x" << stencil.height << ", "
+		<< targetFragments << " fragments without a stencil)";
+	std::cout << "\n\tmask\t\t\t\tshaded frags\t% of target\tsaved frags\tmask bytes\tgen ms";
+
+	auto printRow = [&](const std::string& name) {
+		auto start = std::chrono::high_resolution_clock::now();
+		stencil.createRingStencilMask(contextInfo);
+		auto end = std::chrono::high_resolution_clock::now();
+		const uint32_t shaded = stencil.mask.countSetQuads() * 4;
+		std::cout << "\n\t" << name << "\t" << shaded << "\t\t" << 100.f * shaded / targetFragments << "\t\t"
+			<< targetFragments - shaded << "\t\t" << stencil.mask.getSizeBytes() << "\t\t"
+			<< std::chrono::duration<double, std::milli>(end - start).count();
+	};
+
+	//just the lens circles at full res, then the radial density mask
+	stencil.rings = { { 1.f + stencil.extraRadius, 0 } };
+	printRow("lens only\t\t\t");
+	stencil.calcRings();
+	printRow("radial density\t\t\t");
+
+	const char* densityNames[MAX_DENSITY_SHIFT + 1] = { "1", "1/2", "1/4", "1/8" };
+	stencil.type = StencilType::FixedFoveated;
+	for (uint32_t level = 0; level < fixedFoveatedLevels.size(); ++level) {
+		stencil.rings = getFixedFoveatedRings(level);
+		std::stringstream name; name << "level " << level << ":";
+		for (const StencilRing& ring : stencil.rings) {
+			name << " " << densityNames[ring.densityShift] << "<" << ring.outerRadius;
+		}
+		printRow(name.str());
+	}
+	std::cout << std::endl;
 }
 
 
-void PreMadeStencil::writeStencilToImage(const std::vector<uint8_t>& maskData) {
+void PreMadeStencil::reportPreCalcBarrelSampling(const VulkanContextInfo& contextInfo) {
+	std::cout << "\n\nPrecalc barrel sampling stencil report (unique shaded pixels, both eyes)";
+	std::cout << "\n\tquality\textent\t\tradial density\tbarrel sampling\tvs radial\t% of target\tgen ms";
+	for (uint32_t i = 0; i < static_cast<uint32_t>(contextInfo.camera.numQualitySettings); ++i) {
+		PreMadeStencil radial(contextInfo, i, StencilType::RadialDensityMask);
+		radial.generateMask(contextInfo);
+		PreMadeStencil sampling(contextInfo, i, StencilType::PreCalcBarrelSamplingMask);
+		auto start = std::chrono::high_resolution_clock::now();
+		sampling.generateMask(contextInfo);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const uint32_t radialPixels = radial.mask.countSetQuads() * 4;
+		const uint32_t samplingPixels = sampling.mask.countSetQuads() * 4;
+		std::cout << "\n\t" << sampling.qualityScale << "\t" << sampling.width << "x" << sampling.height << "\t" << radialPixels
+			<< "\t\t" << samplingPixels << "\t\t" << 100.f * samplingPixels / radialPixels << "%\t\t"
+			<< 100.f * samplingPixels / (sampling.width*sampling.height) << "\t\t"
+			<< std::chrono::duration<double, std::milli>(end - start).count();
+	}
+	std::cout << std::endl;
+}
+
+void PreMadeStencil::writeStencilToImage() {
 	//stb write to an image to check it out
+	std::vector<uint8_t> maskData(width*height);
+	expandMask(maskData.data());
 	const int NUM_CHANNELS = 4;
 	uint8_t* rgb_image = (uint8_t*)malloc(width * height * NUM_CHANNELS);
 	for (int y = 0; y < height; ++y) {
@@ -253,4 +399,13 @@ void PreMadeStencil::genFileName() {
 
 	std::stringstream ss; ss << basename << qualityScale << ".bmp";
 	filename = ss.str();
+}
+
+std::string PreMadeStencil::getTypeName(const StencilType type) {
+	if (type == StencilType::RadialDensityMask) {
+		return "radial density";
+	} else if (type == StencilType::FixedFoveated) {
+		return "fixed foveated";
+	}
+	return "precalc barrel sampling";
 }
\ No newline at end of file
@@ -1,22 +1,56 @@
 #pragma once
 
+#include "GlobalSettings.h"
 #include "VulkanContextInfo.h"
+#include "HmdProfile.h"
+#include "QuadMask.h"
 #include "stb_image_write.h"
 #include "stb_image.h"
 #include <string>
-enum class StencilType {
-	RadialDensityMask = 0, FixedFoveated, 
-	PreCalcBarrelSamplingMask
+//band around the lens center, out to outerRadius (eye ndc) from the previous ring, that shades 1 in 2^densityShift quads
+struct StencilRing {
+	float outerRadius;
+	uint32_t densityShift;
 };
 class PreMadeStencil {
 public:
+	static const uint32_t MAX_RINGS = 4;//push constants hold them as a vec4 (see getRingRadii)
+	static const uint32_t MAX_DENSITY_SHIFT = 3;
+
 	PreMadeStencil(const VulkanContextInfo& contextInfo, const uint32_t qualityIndex, const StencilType type);
 	PreMadeStencil();
 	~PreMadeStencil();
+	//width and height for this type and quality, set by the constructor
+	void calcExtent(const VulkanContextInfo& contextInfo);
+	//rings for this type and quality, set by the constructor. the radial density mask is a full res center and a half density band
+	void calcRings();
+	//fixedFoveatedLevels[level] (GlobalSettings.h), throws if it isn't a valid ring list
+	static std::vector<StencilRing> getFixedFoveatedRings(const uint32_t level);
+	//density patterns are nested so a quad shaded at one shift is shaded at every lower one, rings blend into each other:
+	//1 every quad, 2 quad checkerboard, 4 quads at even x and y, 8 every other one of those (a checkerboard of 2x2 quad blocks)
+	static bool quadShaded(const uint32_t densityShift, const uint32_t qx, const uint32_t qy);
+	//alternateMask's pattern (temporalCheckerStencil): the checkerboard flips parity, the sparser patterns stay where they are
+	static bool quadShadedAlternate(const uint32_t densityShift, const uint32_t qx, const uint32_t qy);
+	//ring outer radii, unused rings are -1 so nothing falls in them
+	glm::vec4 getRingRadii() const;
+	//4 bits per ring, ring i at bit 4*i
+	uint32_t getRingShifts() const;
+	//fills mask for this type and quality, no file output
+	void generateMask(const VulkanContextInfo& contextInfo);
+	//writes all width*height bytes of out_mask (e.g. a staging buffer, see VulkanContextInfo::createDepthImage).
+	//with temporalCheckerStencil mask is stencil bit 0 and alternateMask bit 1 (see Camera::getStencilTestBit)
+	void expandMask(uint8_t* out_mask) const;
+	//quads the barrel pass reads, shaded at full res with nothing to hole fill
 	void createPreCalcBarrelSamplingStencilMask(const VulkanContextInfo& contextInfo);
-	void createRadialDensityStencilMask(const VulkanContextInfo& contextInfo);
-	void createFixedFoveatedStencilMask(const VulkanContextInfo& contextInfo);
-	void writeStencilToImage(const std::vector<uint8_t>& maskData);
+	//radial density and fixed foveated masks, each lens circle shaded at its rings' densities
+	void createRingStencilMask(const VulkanContextInfo& contextInfo);
+	//shaded fragments and fragments saved per fixedFoveatedLevels ring list next to the radial density mask, at quality level 0
+	static void reportFixedFoveated(const VulkanContextInfo& contextInfo);
+	//unique shaded pixels of the barrel sampling mask vs the radial density mask at every quality level
+	static void reportPreCalcBarrelSampling(const VulkanContextInfo& contextInfo);
+	static std::string getTypeName(const StencilType type);
+	//debug dump, nothing reads it back
+	void writeStencilToImage();
 	void genFileName();
 
 public:
@@ -28,11 +62,17 @@ public:
 	std::string filename;
 	uint32_t width;
 	uint32_t height;
+	QuadMask mask;//set where the forward pass renders (stencilMaskVal), from generateMask or the HmdBakeBundle
+	QuadMask alternateMask;//odd frames' mask with temporalCheckerStencil, the checker rings' other half (quadShadedAlternate)
+	std::vector<StencilRing> rings;//innermost first, ppStencilHoleFill reconstructs each from these
 	
 	bool pretendStartsVR = true;
 	uint32_t stencilMaskVal = 1;
-	float middleRegionRadius = 0.52;//roughly 0.52
-	float NDCcenterOffset = 0.1425;//0.15 ndc centeer UV center offset 0.0375
+	//lens specific, see HmdProfile
+	uint32_t hmdWidth = HmdProfile::get().width;
+	uint32_t hmdHeight = HmdProfile::get().height;
+	float middleRegionRadius = HmdProfile::get().middleRegionRadius;
+	float NDCcenterOffset = HmdProfile::get().ndcCenterOffset;
 	float extraRadius = NDCcenterOffset*0.5f;//same as NDCcenterOffset?
 	std::vector<glm::vec2> ndcCenter = { glm::vec2( NDCcenterOffset, 0.f), 
 											   glm::vec2(-NDCcenterOffset, 0.f) };
@@ -0,0 +1,250 @@
+#pragma once
+#include "QuadMask.h"
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+
+
+//helpers
+static inline uint16_t runFill(const uint16_t run) { return run >> QuadMask::FILL_SHIFT; }
+static inline uint32_t runLength(const uint16_t run) { return run & QuadMask::MAX_RUN_LENGTH; }
+static inline bool fillValue(const uint16_t fill, const uint32_t qx, const uint32_t qy) {
+	return ((fill >> ((qx ^ qy) & 1)) & 1) != 0;
+}
+
+//[parity][quad value]: bit per fill whose bit for that parity is the quad's value
+static const uint32_t FILL_MATCHES[2][2] = { { 0x5, 0xA }, { 0x3, 0xC } };
+
+QuadMask::QuadMask() {
+}
+
+QuadMask::QuadMask(const uint32_t quadsX, const uint32_t quadsY)
+	: quadsX(quadsX), quadsY(quadsY)
+{
+	rowStarts.reserve(quadsY + 1);
+	rowStarts.push_back(0);
+}
+
+QuadMask::~QuadMask() {
+}
+
+void QuadMask::pushRun(const uint16_t fill, uint32_t length, const uint32_t rowStart) {
+	if (runs.size() > rowStart && runFill(runs.back()) == fill) {
+		const uint32_t merged = std::min(length, MAX_RUN_LENGTH - runLength(runs.back()));
+		runs.back() += static_cast<uint16_t>(merged);
+		length -= merged;
+	}
+	while (length > 0) {
+		const uint32_t runLen = std::min(length, static_cast<uint32_t>(MAX_RUN_LENGTH));
+		runs.push_back(static_cast<uint16_t>((fill << FILL_SHIFT) | runLen));
+		length -= runLen;
+	}
+}
+
+void QuadMask::appendRow(const uint64_t* rowBits) {
+	//greedy: keep extending the run while some fill still matches every quad in it,
+	//candidates is a bit per fill that does, clear and set are preferred over the checkers
+	const uint32_t qy = static_cast<uint32_t>(rowStarts.size() - 1);
+	const uint32_t rowStart = static_cast<uint32_t>(runs.size());
+	auto pickFill = [](const uint32_t candidates) -> uint16_t {
+		if (candidates & (1 << FILL_CLEAR)) { return FILL_CLEAR; }
+		if (candidates & (1 << FILL_SET)) { return FILL_SET; }
+		return (candidates & (1 << FILL_CHECKER_EVEN)) ? FILL_CHECKER_EVEN : FILL_CHECKER_ODD;
+	};
+
+	uint32_t candidates = 0xF;
+	uint32_t runStart = 0;
+	for (uint32_t qx = 0; qx < quadsX; ++qx) {
+		const uint32_t val = (rowBits[qx >> 6] >> (qx & 63)) & 1;
+		const uint32_t parity = (qx ^ qy) & 1;
+		const uint32_t matches = FILL_MATCHES[parity][val];
+		if ((candidates & matches) == 0) {
+			pushRun(pickFill(candidates), qx - runStart, rowStart);
+			runStart = qx;
+			candidates = matches;
+		} else {
+			candidates &= matches;
+		}
+	}
+	pushRun(pickFill(candidates), quadsX - runStart, rowStart);
+	rowStarts.push_back(static_cast<uint32_t>(runs.size()));
+}
+
+bool QuadMask::isComplete() const {
+	return quadsX > 0 && rowStarts.size() == quadsY + 1;
+}
+
+bool QuadMask::get(const uint32_t qx, const uint32_t qy) const {
+	uint32_t x = 0;
+	for (uint32_t r = rowStarts[qy]; r < rowStarts[qy + 1]; ++r) {
+		x += runLength(runs[r]);
+		if (qx < x) { return fillValue(runFill(runs[r]), qx, qy); }
+	}
+	return false;
+}
+
+uint32_t QuadMask::countSetQuads() const {
+	uint32_t count = 0;
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		uint32_t x = 0;
+		for (uint32_t r = rowStarts[qy]; r < rowStarts[qy + 1]; ++r) {
+			const uint16_t fill = runFill(runs[r]);
+			const uint32_t length = runLength(runs[r]);
+			if (FILL_SET == fill) {
+				count += length;
+			} else if (FILL_CLEAR != fill) {
+				//every other quad, the first one is set if its parity matches the checker's
+				const uint32_t firstSet = fillValue(fill, x, qy) ? 1 : 0;
+				count += (length + firstSet) / 2;
+			}
+			x += length;
+		}
+	}
+	return count;
+}
+
+size_t QuadMask::getSizeBytes() const {
+	return 3 * sizeof(uint32_t) + rowStarts.size() * sizeof(uint32_t) + runs.size() * sizeof(uint16_t);
+}
+
+void QuadMask::expand(uint8_t* out_pixels, const uint8_t setVal) const {
+	const uint32_t width = 2 * quadsX;
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		uint8_t* upperRow = out_pixels + (2 * qy)*width;
+		uint32_t qx = 0;
+		for (uint32_t r = rowStarts[qy]; r < rowStarts[qy + 1]; ++r) {
+			const uint16_t fill = runFill(runs[r]);
+			const uint32_t length = runLength(runs[r]);
+			if (FILL_CLEAR == fill || FILL_SET == fill) {
+				memset(upperRow + 2 * qx, FILL_SET == fill ? setVal : 0, 2 * length);
+			} else {
+				for (uint32_t end = qx + length, i = qx; i < end; ++i) {
+					const uint8_t val = fillValue(fill, i, qy) ? setVal : 0;
+					upperRow[2 * i] = val;
+					upperRow[2 * i + 1] = val;
+				}
+			}
+			qx += length;
+		}
+		//lower row of the quads is the same
+		memcpy(upperRow + width, upperRow, width);
+	}
+}
+
+void QuadMask::expandOr(uint8_t* out_pixels, const uint8_t setVal) const {
+	const uint32_t width = 2 * quadsX;
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		uint8_t* upperRow = out_pixels + (2 * qy)*width;
+		uint8_t* lowerRow = upperRow + width;
+		uint32_t qx = 0;
+		for (uint32_t r = rowStarts[qy]; r < rowStarts[qy + 1]; ++r) {
+			const uint16_t fill = runFill(runs[r]);
+			const uint32_t length = runLength(runs[r]);
+			if (FILL_CLEAR != fill) {
+				for (uint32_t end = qx + length, i = qx; i < end; ++i) {
+					if (FILL_SET == fill || fillValue(fill, i, qy)) {
+						upperRow[2 * i] |= setVal;
+						upperRow[2 * i + 1] |= setVal;
+						lowerRow[2 * i] |= setVal;
+						lowerRow[2 * i + 1] |= setVal;
+					}
+				}
+			}
+			qx += length;
+		}
+	}
+}
+
+template<typename CombineOp>
+QuadMask QuadMask::combine(const QuadMask& a, const QuadMask& b, CombineOp op) {
+	if (a.quadsX != b.quadsX || a.quadsY != b.quadsY) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": can't combine masks of different sizes!";
+		throw std::runtime_error(ss.str());
+	}
+
+	QuadMask out(a.quadsX, a.quadsY);
+	out.runs.reserve(a.runs.size() + b.runs.size());
+	for (uint32_t qy = 0; qy < a.quadsY; ++qy) {
+		//walk both rows' runs, a step ends wherever either input's run does
+		const uint32_t rowStart = static_cast<uint32_t>(out.runs.size());
+		uint32_t ra = a.rowStarts[qy], rb = b.rowStarts[qy];
+		uint32_t leftA = 0, leftB = 0;
+		uint16_t fillA = FILL_CLEAR, fillB = FILL_CLEAR;
+		uint32_t x = 0;
+		while (x < a.quadsX) {
+			if (leftA == 0) { fillA = runFill(a.runs[ra]); leftA = runLength(a.runs[ra]); ++ra; }
+			if (leftB == 0) { fillB = runFill(b.runs[rb]); leftB = runLength(b.runs[rb]); ++rb; }
+
+			const uint32_t step = std::min(leftA, leftB);
+			out.pushRun(op(fillA, fillB), step, rowStart);
+			leftA -= step;
+			leftB -= step;
+			x += step;
+		}
+		out.rowStarts.push_back(static_cast<uint32_t>(out.runs.size()));
+	}
+	return out;
+}
+
+QuadMask QuadMask::combineXor(const QuadMask& a, const QuadMask& b) {
+	return combine(a, b, [](const uint16_t fillA, const uint16_t fillB) { return static_cast<uint16_t>(fillA ^ fillB); });
+}
+
+QuadMask QuadMask::combineUnion(const QuadMask& a, const QuadMask& b) {
+	return combine(a, b, [](const uint16_t fillA, const uint16_t fillB) { return static_cast<uint16_t>(fillA | fillB); });
+}
+
+void QuadMask::serialize(std::vector<char>& out_bytes) const {
+	const uint32_t header[3] = { quadsX, quadsY, static_cast<uint32_t>(runs.size()) };
+	out_bytes.resize(getSizeBytes());
+	char* dst = out_bytes.data();
+	memcpy(dst, header, sizeof(header));									dst += sizeof(header);
+	memcpy(dst, rowStarts.data(), rowStarts.size() * sizeof(uint32_t));	dst += rowStarts.size() * sizeof(uint32_t);
+	memcpy(dst, runs.data(), runs.size() * sizeof(uint16_t));
+}
+
+void QuadMask::deserialize(const void* data, const size_t size) {
+	uint32_t header[3];
+	if (size < sizeof(header)) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": quad mask data is smaller than its header!";
+		throw std::runtime_error(ss.str());
+	}
+	memcpy(header, data, sizeof(header));
+
+	const size_t rowStartsSize = (static_cast<size_t>(header[1]) + 1) * sizeof(uint32_t);
+	const size_t runsSize = static_cast<size_t>(header[2]) * sizeof(uint16_t);
+	if (size != sizeof(header) + rowStartsSize + runsSize) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": quad mask data size doesn't match its header!";
+		throw std::runtime_error(ss.str());
+	}
+
+	quadsX = header[0];
+	quadsY = header[1];
+	const char* src = static_cast<const char*>(data) + sizeof(header);
+	rowStarts.resize(quadsY + 1);
+	runs.resize(header[2]);
+	memcpy(rowStarts.data(), src, rowStartsSize);
+	memcpy(runs.data(), src + rowStartsSize, runsSize);
+
+	//every row's runs have to cover exactly quadsX quads, get and expand walk them without bounds checks
+	if (rowStarts.front() != 0 || rowStarts.back() != runs.size()) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": quad mask row starts don't span its runs!";
+		throw std::runtime_error(ss.str());
+	}
+	for (uint32_t qy = 0; qy < quadsY; ++qy) {
+		if (rowStarts[qy] > rowStarts[qy + 1]) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": quad mask row " << qy << " starts after the next one!";
+			throw std::runtime_error(ss.str());
+		}
+		uint64_t rowLength = 0;
+		for (uint32_t r = rowStarts[qy]; r < rowStarts[qy + 1]; ++r) {
+			rowLength += runLength(runs[r]);
+		}
+		if (rowLength != quadsX) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": quad mask row " << qy << " runs cover "
+				<< rowLength << " quads, not " << quadsX << "!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//Stencil mask at 2x2 pixel quad granularity (every stencil technique here masks whole quads).
+//Each quad row is run length encoded, a run is its fill in the top 2 bits and its length in quads below.
+//The fill's bits are the value at quads where ((qx ^ qy) & 1) is 0 and where it is 1, so besides clear and set
+//a run can be either phase of the quad checkerboard (the radial masks' middle band) and
+//xor/union of two runs is just xor/or of their fills.
+//The radial masks are a handful of runs per row, a few KB instead of width*height bytes,
+//so every quality level stays resident (see VulkanContextInfo::initStencils)
+class QuadMask {
+public:
+	static const uint16_t FILL_CLEAR = 0;
+	static const uint16_t FILL_CHECKER_EVEN = 1;//set where ((qx ^ qy) & 1) == 0
+	static const uint16_t FILL_CHECKER_ODD = 2;
+	static const uint16_t FILL_SET = 3;
+	static const uint16_t FILL_SHIFT = 14;
+	static const uint16_t MAX_RUN_LENGTH = (1 << FILL_SHIFT) - 1;
+
+	uint32_t quadsX = 0;
+	uint32_t quadsY = 0;
+	std::vector<uint32_t> rowStarts;//quadsY + 1 once complete, index of each row's first run in runs
+	std::vector<uint16_t> runs;
+
+public:
+	QuadMask();
+	QuadMask(const uint32_t quadsX, const uint32_t quadsY);
+	~QuadMask();
+
+	//appends the next row (top to bottom) from one bit per quad, quad qx is bit qx%64 of rowBits[qx/64]
+	void appendRow(const uint64_t* rowBits);
+	bool isComplete() const;
+
+	bool get(const uint32_t qx, const uint32_t qy) const;
+	uint32_t countSetQuads() const;
+	size_t getSizeBytes() const;
+
+	//2*quadsX by 2*quadsY bytes, setVal for pixels in set quads and 0 elsewhere, every byte is written once
+	void expand(uint8_t* out_pixels, const uint8_t setVal) const;
+	//same size, ors setVal into the pixels of set quads and leaves the rest, packs another mask into other stencil bits
+	void expandOr(uint8_t* out_pixels, const uint8_t setVal) const;
+
+	//merge the two masks' runs row by row, nothing is expanded. masks must be the same size
+	static QuadMask combineXor(const QuadMask& a, const QuadMask& b);
+	static QuadMask combineUnion(const QuadMask& a, const QuadMask& b);
+
+	//compact on-disk form (HmdBakeBundle): quadsX, quadsY, numRuns as uint32's, then rowStarts, then runs
+	void serialize(std::vector<char>& out_bytes) const;
+	//throws if the bytes aren't a complete mask: sizes that don't match the header, or a row whose runs don't sum to quadsX
+	void deserialize(const void* data, const size_t size);
+
+private:
+	//appends a run to the current row, merging it into the last run if it has the same fill
+	void pushRun(const uint16_t fill, uint32_t length, const uint32_t rowStart);
+	template<typename CombineOp>
+	static QuadMask combine(const QuadMask& a, const QuadMask& b, CombineOp op);
+};
@@ -0,0 +1,368 @@
+#pragma once
+#include "StencilGenerator.h"
+#include "VulkanContextInfo.h"
+#include "PreMadeStencil.h"
+#include "Utils.h"
+#include <array>
+#include <chrono>
+#include <iostream>
+
+
+StencilGenerator::StencilGenerator() {
+}
+
+StencilGenerator::~StencilGenerator() {
+}
+
+void StencilGenerator::create(const VulkanContextInfo& contextInfo) {
+	if (pipeline != VK_NULL_HANDLE && format == contextInfo.depthFormat) { return; }
+	destroy(contextInfo);
+	format = contextInfo.depthFormat;
+	createRenderPass(contextInfo);
+	createPipeline(contextInfo);
+}
+
+bool StencilGenerator::supports(const PreMadeStencil& stencil) {
+	return StencilType::PreCalcBarrelSamplingMask != stencil.type && !temporalCheckerStencil;
+}
+
+StencilGenPushConstant StencilGenerator::getPushConstant(const PreMadeStencil& stencil) {
+	StencilGenPushConstant pushConstant = {};
+	pushConstant.ndcCenters = glm::vec4(stencil.ndcCenter[0], stencil.ndcCenter[1]);
+	pushConstant.invWidth = 1.f / stencil.width;
+	pushConstant.invHeight = 1.f / stencil.height;
+	pushConstant.ndcScaleY = stencil.height / (stencil.width*0.5f);
+	pushConstant.outerRadius = 1.f + stencil.extraRadius;
+	pushConstant.ringRadii = stencil.getRingRadii();
+	pushConstant.ringShifts = stencil.getRingShifts();
+	return pushConstant;
+}
+
+VulkanImage StencilGenerator::createDepthImage(const VulkanContextInfo& contextInfo, const PreMadeStencil& stencil) const {
+	VulkanImage depthImage;
+	depthImage.extent = { stencil.width, stencil.height };
+	depthImage.format = contextInfo.depthFormat;
+	depthImage.imagetype = IMAGETYPE::DEPTH;
+	depthImage.importedStencil = true;
+	depthImage.createImage(contextInfo);
+	depthImage.createImageView(contextInfo);
+
+	generate(contextInfo, depthImage, getPushConstant(stencil), stencil.stencilMaskVal);
+	return depthImage;
+}
+
+void StencilGenerator::generate(const VulkanContextInfo& contextInfo, const VulkanImage& depthImage,
+	const StencilGenPushConstant& pushConstant, const uint32_t stencilMaskVal) const
+{
+	VkFramebufferCreateInfo framebufferInfo = {};
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferInfo.renderPass = renderPass;
+	framebufferInfo.attachmentCount = 1;
+	framebufferInfo.pAttachments = &depthImage.imageView;
+	framebufferInfo.width = depthImage.extent.width;
+	framebufferInfo.height = depthImage.extent.height;
+	framebufferInfo.layers = 1;
+
+	VkFramebuffer framebuffer;
+	if (vkCreateFramebuffer(contextInfo.device, &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create framebuffer!";
+		throw std::runtime_error(ss.str());
+	}
+
+	VkCommandBuffer commandBuffer = beginSingleTimeCommands(contextInfo);
+	record(commandBuffer, framebuffer, depthImage.extent, pushConstant, stencilMaskVal);
+	endSingleTimeCommands(contextInfo, commandBuffer);
+
+	vkDestroyFramebuffer(contextInfo.device, framebuffer, nullptr);
+}
+
+void StencilGenerator::record(const VkCommandBuffer& commandBuffer, const VkFramebuffer& framebuffer, const VkExtent2D& extent,
+	const StencilGenPushConstant& pushConstant, const uint32_t stencilMaskVal) const
+{
+	VkClearValue clearValue = {};
+	clearValue.depthStencil = { 1.f, 0 };
+
+	VkRenderPassBeginInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = renderPass;
+	renderPassInfo.framebuffer = framebuffer;
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = extent;
+	renderPassInfo.clearValueCount = 1;
+	renderPassInfo.pClearValues = &clearValue;
+
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+	VkViewport viewport = {};
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.minDepth = 0.f;
+	viewport.maxDepth = 1.f;
+	VkRect2D scissor = {};
+	scissor.extent = extent;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FRONT_AND_BACK, stencilMaskVal);
+
+	vkCmdPushConstants(commandBuffer, pipelineLayout, StencilGenPushConstant::stages, 0, sizeof(StencilGenPushConstant), &pushConstant);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+	vkCmdEndRenderPass(commandBuffer);
+}
+
+void StencilGenerator::createRenderPass(const VulkanContextInfo& contextInfo) {
+	VkAttachmentDescription depthAttachment = {};
+	depthAttachment.format = format;
+	depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;//forward pass clears depth
+	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	VkAttachmentReference depthAttachmentRef = {};
+	depthAttachmentRef.attachment = 0;
+	depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	VkSubpassDescription subpass = {};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 0;
+	subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+	//the forward pass (or a readback) waits on the stencil writes
+	VkSubpassDependency dependency = {};
+	dependency.srcSubpass = 0;
+	dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	dependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	dependency.dependencyFlags = 0;
+
+	VkRenderPassCreateInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &depthAttachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 1;
+	renderPassInfo.pDependencies = &dependency;
+
+	if (vkCreateRenderPass(contextInfo.device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create render pass!";
+		throw std::runtime_error(ss.str());
+	}
+}
+
+void StencilGenerator::createPipeline(const VulkanContextInfo& contextInfo) {
+	const std::vector<std::string> shaderpaths = { "src/shaders/ppFullscreenTriangle.vert.spv",
+		"src/shaders/stencilRadialDensity.frag.spv" };
+	VkShaderModule shaderModules[2];
+	for (int i = 0; i < 2; ++i) {
+		const std::vector<char> code = readFile(shaderpaths[i]);
+		VkShaderModuleCreateInfo createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = code.size();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+		if (vkCreateShaderModule(contextInfo.device, &createInfo, nullptr, &shaderModules[i]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create shader module!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = shaderModules[0];
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = shaderModules[1];
+	shaderStages[1].pName = "main";
+
+	//procedural fullscreen triangle, no vertex buffer
+	VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+	//dynamic, set in record
+	VkPipelineViewportStateCreateInfo viewportState = {};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer = {};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling = {};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	//every fragment that survives the discard writes the reference (stencilMaskVal)
+	VkStencilOpState stencilOp = {};
+	stencilOp.failOp = VK_STENCIL_OP_KEEP;
+	stencilOp.passOp = VK_STENCIL_OP_REPLACE;
+	stencilOp.depthFailOp = VK_STENCIL_OP_KEEP;
+	stencilOp.compareOp = VK_COMPARE_OP_ALWAYS;
+	stencilOp.compareMask = 0xFF;
+	stencilOp.writeMask = 0xFF;
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = VK_FALSE;
+	depthStencil.depthWriteEnable = VK_FALSE;
+	depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+	depthStencil.depthBoundsTestEnable = VK_FALSE;
+	depthStencil.stencilTestEnable = VK_TRUE;
+	depthStencil.front = stencilOp;
+	depthStencil.back = stencilOp;
+
+	//no color attachments
+	VkPipelineColorBlendStateCreateInfo colorBlending = {};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.attachmentCount = 0;
+
+	const std::array<VkDynamicState, 3> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_STENCIL_REFERENCE };
+	VkPipelineDynamicStateCreateInfo dynamicInfo = {};
+	dynamicInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	dynamicInfo.pDynamicStates = dynamicStates.data();
+
+	VkPushConstantRange pushConstantRange = {};
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(StencilGenPushConstant);
+	pushConstantRange.stageFlags = StencilGenPushConstant::stages;
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 0;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+	if (vkCreatePipelineLayout(contextInfo.device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create pipeline layout!";
+		throw std::runtime_error(ss.str());
+	}
+
+	VkGraphicsPipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicInfo;
+	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.renderPass = renderPass;
+	pipelineInfo.subpass = 0;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	if (vkCreateGraphicsPipelines(contextInfo.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create graphics pipeline!";
+		throw std::runtime_error(ss.str());
+	}
+
+	vkDestroyShaderModule(contextInfo.device, shaderModules[0], nullptr);
+	vkDestroyShaderModule(contextInfo.device, shaderModules[1], nullptr);
+}
+
+void StencilGenerator::report(const VulkanContextInfo& contextInfo) {
+	StencilGenerator generator;
+	generator.create(contextInfo);
+
+	std::cout << "\n\nStencilGenerator::report, gpu vs cpu vr stencil";
+	for (size_t i = 0; i < contextInfo.radialDensityMasks.size(); ++i) {
+		const PreMadeStencil& stencil = contextInfo.radialDensityMasks[i];
+		const VkDeviceSize maskSize = stencil.width * stencil.height;
+		if (!supports(stencil)) {
+			std::cout << "\n\tquality " << i << ": " << PreMadeStencil::getTypeName(stencil.type) << " has no gpu generator";
+			continue;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		VulkanImage depthImage = generator.createDepthImage(contextInfo, stencil);
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		//stencil aspect to a host visible buffer, one byte per pixel
+		VkBuffer readbackBuffer;
+		VkDeviceMemory readbackMemory;
+		createBuffer(contextInfo, maskSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, readbackBuffer, readbackMemory);
+
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands(contextInfo);
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = depthImage.image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent = { stencil.width, stencil.height, 1 };
+		vkCmdCopyImageToBuffer(commandBuffer, depthImage.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer, 1, &region);
+		endSingleTimeCommands(contextInfo, commandBuffer);
+
+		std::vector<uint8_t> cpuMask(maskSize);
+		stencil.expandMask(cpuMask.data());
+
+		void* data;
+		vkMapMemory(contextInfo.device, readbackMemory, 0, maskSize, 0, &data);
+		const uint8_t* gpuMask = static_cast<const uint8_t*>(data);
+		uint32_t mismatches = 0;
+		for (VkDeviceSize p = 0; p < maskSize; ++p) {
+			mismatches += gpuMask[p] != cpuMask[p] ? 1 : 0;
+		}
+		vkUnmapMemory(contextInfo.device, readbackMemory);
+
+		std::cout << "\n\tquality " << i << " (" << stencil.width << "x" << stencil.height << "): "
+			<< mismatches << " mismatched pixels, generate + submit "
+			<< std::chrono::duration<double, std::milli>(end - start).count() << " ms";
+
+		vkDestroyBuffer(contextInfo.device, readbackBuffer, nullptr);
+		vkFreeMemory(contextInfo.device, readbackMemory, nullptr);
+		depthImage.destroyVulkanImage(contextInfo);
+	}
+	std::cout << "\n";
+
+	generator.destroy(contextInfo);
+}
+
+void StencilGenerator::destroy(const VulkanContextInfo& contextInfo) {
+	if (pipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(contextInfo.device, pipeline, nullptr);
+		vkDestroyPipelineLayout(contextInfo.device, pipelineLayout, nullptr);
+		vkDestroyRenderPass(contextInfo.device, renderPass, nullptr);
+	}
+	pipeline = VK_NULL_HANDLE;
+	pipelineLayout = VK_NULL_HANDLE;
+	renderPass = VK_NULL_HANDLE;
+}
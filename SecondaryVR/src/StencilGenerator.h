@@ -0,0 +1,69 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+class VulkanContextInfo;
+class VulkanImage;
+class PreMadeStencil;
+
+//same layout as stencilRadialDensity.frag
+struct StencilGenPushConstant {
+	glm::vec4 ndcCenters;//xy left eye lens center, zw right eye
+	float invWidth;
+	float invHeight;
+	float ndcScaleY;//height / eye width, keeps the lens regions circles
+	float outerRadius;
+	glm::vec4 ringRadii;//PreMadeStencil::getRingRadii
+	uint32_t ringShifts;//PreMadeStencil::getRingShifts
+	static const VkShaderStageFlags stages = VK_SHADER_STAGE_FRAGMENT_BIT;
+};
+
+//Writes the radial density or fixed foveated stencil on the gpu (generateStencilOnGPU, see GlobalSettings.h).
+//A depth/stencil only pass clears the stencil to 0 and draws a fullscreen triangle (ppFullscreenTriangle.vert)
+//with stencil op replace, stencilRadialDensity.frag does PreMadeStencil::createRingStencilMask's
+//radius/ring density test per quad and discards everything outside the mask. Nothing goes through host memory,
+//so it is cheap at any resolution and record() can go in a frame's command buffer with new parameters.
+class StencilGenerator {
+public:
+	VkFormat format = VK_FORMAT_UNDEFINED;
+	VkRenderPass renderPass = VK_NULL_HANDLE;
+	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+	VkPipeline pipeline = VK_NULL_HANDLE;
+
+public:
+	StencilGenerator();
+	~StencilGenerator();
+
+	//render pass and pipeline for contextInfo.depthFormat, does nothing if they already exist for it
+	void create(const VulkanContextInfo& contextInfo);
+
+	//radial density and fixed foveated, the barrel sampling mask comes from the distortion per panel pixel so it's cpu only.
+	//none with temporalCheckerStencil, the pass writes one stencil value and that needs both phases' bits
+	static bool supports(const PreMadeStencil& stencil);
+	//the parameters PreMadeStencil's cpu generator uses for this stencil's quality level
+	static StencilGenPushConstant getPushConstant(const PreMadeStencil& stencil);
+
+	//depth image the size of the stencil with the mask written to its stencil aspect, left in DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+	VulkanImage createDepthImage(const VulkanContextInfo& contextInfo, const PreMadeStencil& stencil) const;
+	void generate(const VulkanContextInfo& contextInfo, const VulkanImage& depthImage,
+		const StencilGenPushConstant& pushConstant, const uint32_t stencilMaskVal) const;
+	//framebuffer holds depthImage's view, clears depth to 1 and stencil to 0 before drawing the mask
+	void record(const VkCommandBuffer& commandBuffer, const VkFramebuffer& framebuffer, const VkExtent2D& extent,
+		const StencilGenPushConstant& pushConstant, const uint32_t stencilMaskVal) const;
+
+	//reads every quality level's gpu stencil back and compares it to the cpu one (contextInfo.radialDensityMasks),
+	//prints mismatched pixels per level. meant for a software vulkan driver where the gpu path is deterministic
+	static void report(const VulkanContextInfo& contextInfo);
+
+	//cleanup
+	void destroy(const VulkanContextInfo& contextInfo);
+
+private:
+	void createRenderPass(const VulkanContextInfo& contextInfo);
+	void createPipeline(const VulkanContextInfo& contextInfo);
+};
@@ -0,0 +1,262 @@
+#pragma once
+#include "SubpassHoleFill.h"
+#include "VulkanContextInfo.h"
+#include "QuadMask.h"
+#include "Utils.h"
+#include "GlobalSettings.h"
+#include <array>
+#include <iostream>
+
+
+SubpassHoleFill::SubpassHoleFill() {
+}
+
+SubpassHoleFill::~SubpassHoleFill() {
+}
+
+VkFormat SubpassHoleFill::getOutputFormat(const VulkanContextInfo& contextInfo) {
+	if (!subpassHoleFillPackedOutput) {
+		return VK_FORMAT_R16G16B16A16_SFLOAT;
+	}
+	const VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+	VkFormatProperties props;
+	vkGetPhysicalDeviceFormatProperties(contextInfo.physicalDevice, VK_FORMAT_B10G11R11_UFLOAT_PACK32, &props);
+	return ((props.optimalTilingFeatures & needed) == needed) ? VK_FORMAT_B10G11R11_UFLOAT_PACK32 : VK_FORMAT_R16G16B16A16_SFLOAT;
+}
+
+void SubpassHoleFill::createOutputImages(const VulkanContextInfo& contextInfo) {
+	const VkFormat format = getOutputFormat(contextInfo);
+	outputImages.resize(contextInfo.swapChainImages.size());
+	for (size_t i = 0; i < outputImages.size(); ++i) {
+		outputImages[i] = VulkanImage(IMAGETYPE::COLOR_ATTACHMENT, contextInfo.camera.renderTargetExtent, format, contextInfo);
+	}
+}
+
+void SubpassHoleFill::createPipeline(const VulkanContextInfo& contextInfo, const VkRenderPass& renderPass,
+	const std::vector<VulkanImage>& forwardImages)
+{
+	inputDescriptors.resize(forwardImages.size());
+	for (size_t i = 0; i < forwardImages.size(); ++i) {
+		inputDescriptors[i].createDescriptorSetLayoutInputAttachment(contextInfo);
+		inputDescriptors[i].createDescriptorPoolInputAttachment(contextInfo);
+		inputDescriptors[i].createDescriptorSetInputAttachment(contextInfo, forwardImages[i]);
+	}
+
+	const std::vector<std::string> shaderpaths = { "src/shaders/ppFullscreenTriangle.vert.spv",
+		"src/shaders/subpassHoleFill.frag.spv" };
+	VkShaderModule shaderModules[2];
+	for (int i = 0; i < 2; ++i) {
+		const std::vector<char> code = readFile(shaderpaths[i]);
+		VkShaderModuleCreateInfo createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = code.size();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+		if (vkCreateShaderModule(contextInfo.device, &createInfo, nullptr, &shaderModules[i]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create shader module!";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = shaderModules[0];
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = shaderModules[1];
+	shaderStages[1].pName = "main";
+
+	//the fullscreen triangle comes from gl_VertexIndex
+	VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+	//dynamic, set in record
+	VkPipelineViewportStateCreateInfo viewportState = {};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer = {};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling = {};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	//same test as the forward pipelines: only the pixels subpass 0 rendered are copied, the holes keep the clear
+	VkStencilOpState stencilOp = {};
+	stencilOp.failOp = VK_STENCIL_OP_KEEP;
+	stencilOp.passOp = VK_STENCIL_OP_KEEP;
+	stencilOp.depthFailOp = VK_STENCIL_OP_KEEP;
+	stencilOp.compareOp = VK_COMPARE_OP_EQUAL;
+	stencilOp.compareMask = 0x1;//(dynamic)
+	stencilOp.writeMask = 0;
+	stencilOp.reference = 0x1;//(dynamic)
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = VK_FALSE;
+	depthStencil.depthWriteEnable = VK_FALSE;
+	depthStencil.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+	depthStencil.depthBoundsTestEnable = VK_FALSE;
+	depthStencil.stencilTestEnable = VK_TRUE;
+	depthStencil.front = stencilOp;
+	depthStencil.back = stencilOp;
+
+	VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachment.blendEnable = VK_FALSE;
+
+	VkPipelineColorBlendStateCreateInfo colorBlending = {};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+
+	const std::array<VkDynamicState, 4> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR,
+		VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK, VK_DYNAMIC_STATE_STENCIL_REFERENCE };
+	VkPipelineDynamicStateCreateInfo dynamicInfo = {};
+	dynamicInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	dynamicInfo.pDynamicStates = dynamicStates.data();
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(VulkanDescriptor::inputAttachmentLayoutTypes.size());
+	pipelineLayoutInfo.pSetLayouts = VulkanDescriptor::inputAttachmentLayoutTypes.data();
+	pipelineLayoutInfo.pushConstantRangeCount = 0;
+
+	if (vkCreatePipelineLayout(contextInfo.device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create pipeline layout!";
+		throw std::runtime_error(ss.str());
+	}
+
+	VkGraphicsPipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicInfo;
+	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.renderPass = renderPass;
+	pipelineInfo.subpass = 1;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	if (vkCreateGraphicsPipelines(contextInfo.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create graphics pipeline!";
+		throw std::runtime_error(ss.str());
+	}
+
+	vkDestroyShaderModule(contextInfo.device, shaderModules[0], nullptr);
+	vkDestroyShaderModule(contextInfo.device, shaderModules[1], nullptr);
+}
+
+void SubpassHoleFill::record(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex,
+	const VulkanContextInfo& contextInfo) const
+{
+	const Camera& camera = contextInfo.camera;
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+	//both eyes at once
+	VkViewport viewport = {};
+	viewport.width = static_cast<float>(camera.renderTargetExtent.width);
+	viewport.height = static_cast<float>(camera.renderTargetExtent.height);
+	viewport.minDepth = 0.f;
+	viewport.maxDepth = 1.f;
+	VkRect2D scissor = {};
+	scissor.extent = camera.renderTargetExtent;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	const uint32_t stencilTestBit = camera.getStencilTestBit();
+	vkCmdSetStencilCompareMask(commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+	vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+		&inputDescriptors[imageIndex].descriptorSet, 0, nullptr);
+	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+void SubpassHoleFill::report(const VulkanContextInfo& contextInfo) {
+	//the store ops write the whole extent whatever the stencil, so the bytes through memory per pixel are one figure:
+	//separate passes store the R16G16B16A16_SFLOAT forward color and the pp chain reads it back, the subpasses store and read the output
+	const VkFormat outputFormat = getOutputFormat(contextInfo);
+	const uint64_t forwardBytes = 8;
+	const uint64_t outputBytes = (outputFormat == VK_FORMAT_B10G11R11_UFLOAT_PACK32) ? 4 : 8;
+	const uint64_t separateBytes = 2 * forwardBytes;
+	const uint64_t subpassBytes = 2 * outputBytes;
+
+	std::cout << "\n\nSubpassHoleFill report (" << PreMadeStencil::getTypeName(contextInfo.vrStencilType) << ")";
+	std::cout << "\n\toutput format: " << (outputBytes == 4 ? "B10G11R11_UFLOAT_PACK32" : "R16G16B16A16_SFLOAT");
+	std::cout << "\n\tbytes per pixel through memory: separate passes " << separateBytes << ", subpasses " << subpassBytes
+		<< ", saved " << 100.0 * (1.0 - static_cast<double>(subpassBytes) / separateBytes) << "%";
+
+	//the hole fill stage in place (PipelineType::HOLES_ONLY) writes the holes into the output instead of every pixel to a
+	//target of its own that the next stage reads back
+	const uint64_t holeFillTargetBytes = 2 * 8;//PostProcessPipeline::outputFormat
+	std::cout << "\n\tbytes per pixel through memory of the hole fill stage's target: own target " << holeFillTargetBytes
+		<< ", in place 0 (the holes and the discarded pixels past the lens are shaded, below)";
+
+	//what the stencil decides: how many pixels the copy subpass shades and writes over the output's clear, the rest are
+	//holes the pp chain fills from their neighbours in place
+	std::cout << "\n\tlevel\textent\t\tcleared px\tcopied px\tcopied\tsubpass input MB (on tile)\tpx shaded in place";
+	for (size_t i = 0; i < contextInfo.radialDensityMasks.size(); ++i) {
+		const PreMadeStencil& stencil = contextInfo.radialDensityMasks[i];
+		const uint64_t pixels = static_cast<uint64_t>(stencil.width) * stencil.height;
+		const uint64_t copied = static_cast<uint64_t>(stencil.mask.countSetQuads()) * 4;
+		std::cout << "\n\t" << i << "\t" << stencil.width << "x" << stencil.height << "\t" << pixels << "\t\t" << copied << "\t\t"
+			<< 100.0 * static_cast<double>(copied) / pixels << "%\t" << copied*forwardBytes / (1024.0*1024.0) << "\t\t\t" << pixels - copied;
+	}
+
+	//what the forward color commits per swap image, nothing up front where the driver has lazily allocated memory
+	const VkExtent2D extent = contextInfo.camera.renderTargetExtent;
+	const VkMemoryRequirements colorReqs = VulkanImage::getMemoryRequirements(IMAGETYPE::COLOR_ATTACHMENT, extent,
+		VK_FORMAT_R16G16B16A16_SFLOAT, contextInfo);
+	const VkMemoryRequirements transientReqs = VulkanImage::getMemoryRequirements(IMAGETYPE::TRANSIENT_ATTACHMENT, extent,
+		VK_FORMAT_R16G16B16A16_SFLOAT, contextInfo);
+	const bool lazy = hasMemoryType(contextInfo.physicalDevice, transientReqs.memoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+	std::cout << "\n\tforward color per swap image: " << colorReqs.size << " bytes as a sampled target, "
+		<< transientReqs.size << " bytes as a transient attachment, lazily allocated memory: " << (lazy ? "yes" : "no");
+	std::cout << "\n\tvulkan 1.0 has no bandwidth counters, the bytes are worked out from the formats and the stencil" << std::endl;
+}
+
+void SubpassHoleFill::destroyPipeline(const VulkanContextInfo& contextInfo) {
+	if (pipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(contextInfo.device, pipeline, nullptr);
+		vkDestroyPipelineLayout(contextInfo.device, pipelineLayout, nullptr);
+	}
+	pipeline = VK_NULL_HANDLE;
+	pipelineLayout = VK_NULL_HANDLE;
+	//the layout is VulkanDescriptor's shared inputAttachmentLayoutTypes, only the pools are ours
+	for (auto& descriptor : inputDescriptors) {
+		descriptor.destroyDescriptorPool(contextInfo);
+	}
+	inputDescriptors.clear();
+}
+
+void SubpassHoleFill::destroyOutputImages(const VulkanContextInfo& contextInfo) {
+	for (auto& image : outputImages) {
+		image.destroyVulkanImage(contextInfo);
+	}
+	outputImages.clear();
+}
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include "VulkanImage.h"
+#include "VulkanDescriptor.h"
+#include <vector>
+#include <cstdint>
+
+class VulkanContextInfo;
+
+//The per pixel part of the stencil hole fill as the second subpass of the forward render pass (Camera::subpassHoleFill).
+//the forward color (attachment 0) is a transient input attachment: the subpass reads it with subpassLoad where the forward
+//pass's stencil test passes and writes the rendered pixels to outputImages (attachment 2, cleared black like the forward image),
+//so on tile based gpus the forward color is never stored and resampled, only the output (getOutputFormat) is.
+//the holes need their neighbours so they're filled by the pp chain, its first stage samples outputImages instead of the
+//forward images (VulkanApplication::getForwardOutputImages). a raster hole fill stage fills them in place (PipelineType::HOLES_ONLY):
+//it loads outputImages and tests the stencil the other way round, so it writes only the holes and has no target of its own
+class SubpassHoleFill {
+public:
+	std::vector<VulkanImage> outputImages;//per swap image, the pp chain's FORWARD resource
+	std::vector<VulkanDescriptor> inputDescriptors;//per swap image, that swap image's forward color as the input attachment
+
+	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+	VkPipeline pipeline = VK_NULL_HANDLE;
+
+public:
+	SubpassHoleFill();
+	~SubpassHoleFill();
+
+	//the forward color's R16G16B16A16, or with subpassHoleFillPackedOutput B10G11R11 (4 bytes a pixel, no alpha) if the device
+	//renders to and samples it
+	static VkFormat getOutputFormat(const VulkanContextInfo& contextInfo);
+
+	//attachment 2 of the forward framebuffers, render target extent
+	void createOutputImages(const VulkanContextInfo& contextInfo);
+	//subpass 1 of the forward render pass (renderPass or renderPassStencilLoading), forwardImages its attachment 0 per swap image
+	void createPipeline(const VulkanContextInfo& contextInfo, const VkRenderPass& renderPass, const std::vector<VulkanImage>& forwardImages);
+	//after vkCmdNextSubpass in the forward command buffer
+	void record(const VkCommandBuffer& commandBuffer, const uint32_t imageIndex, const VulkanContextInfo& contextInfo) const;
+
+	//bytes per pixel the forward color and the pp chain's input move through memory, separate passes vs the subpass,
+	//what the in place hole fill stage saves over writing its own target,
+	//the pixels the copy subpass writes over the clear per quality level of the vr stencil, and the memory the forward
+	//color commits with and without lazily allocated memory
+	static void report(const VulkanContextInfo& contextInfo);
+
+	//cleanup
+	void destroyPipeline(const VulkanContextInfo& contextInfo);
+	void destroyOutputImages(const VulkanContextInfo& contextInfo);
+};
@@ -1,4 +1,5 @@
 #include "Vertex.h"
+#include <cmath>
 
 Vertex::Vertex()
 	: pos(glm::vec3(0.f)), color(glm::vec3(0.f)), uv(glm::vec2(0.f)),
@@ -67,3 +68,119 @@ bool Vertex::operator==(const Vertex& other) const {
 	return pos == other.pos && color == other.color && uv == other.uv &&
 		   nor == other.nor && tan == other.tan && bitan == other.bitan;
 }
+
+
+constexpr float PostProcessVertex::POSITION_RANGE;
+constexpr float PostProcessPreCalcVertex::UV_MIN;
+constexpr float PostProcessPreCalcVertex::UV_MAX;
+
+glm::i16vec2 PostProcessVertex::packPosition(const glm::vec2& ndc) {
+	const glm::vec2 snorm = glm::clamp(ndc / POSITION_RANGE, -1.f, 1.f) * 32767.f;
+	return glm::i16vec2(static_cast<int16_t>(std::round(snorm.x)), static_cast<int16_t>(std::round(snorm.y)));
+}
+
+glm::vec2 PostProcessVertex::unpackPosition(const glm::i16vec2& packed) {
+	return glm::vec2(packed) * (POSITION_RANGE / 32767.f);
+}
+
+VkVertexInputBindingDescription PostProcessVertex::getBindingDescription() {
+	VkVertexInputBindingDescription bindingDescription = {};
+	bindingDescription.binding = 0;
+	bindingDescription.stride = sizeof(PostProcessVertex);
+	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 1> PostProcessVertex::getAttributeDescriptions() {
+	std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions = {};
+
+	attributeDescriptions[0].binding = 0;
+	attributeDescriptions[0].location = 0;
+	attributeDescriptions[0].format = VK_FORMAT_R16G16_SNORM;
+	attributeDescriptions[0].offset = offsetof(PostProcessVertex, pos);
+
+	return attributeDescriptions;
+}
+
+glm::u16vec2 PostProcessPreCalcVertex::packUV(const glm::vec2& uv) {
+	const glm::vec2 unorm = glm::clamp((uv - UV_MIN) / (UV_MAX - UV_MIN), 0.f, 1.f) * 65535.f;
+	return glm::u16vec2(static_cast<uint16_t>(std::round(unorm.x)), static_cast<uint16_t>(std::round(unorm.y)));
+}
+
+glm::vec2 PostProcessPreCalcVertex::unpackUV(const glm::u16vec2& packed) {
+	return UV_MIN + glm::vec2(packed) * ((UV_MAX - UV_MIN) / 65535.f);
+}
+
+PostProcessPreCalcVertex PostProcessPreCalcVertex::pack(const Vertex& v) {
+	PostProcessPreCalcVertex packed;
+	packed.pos = PostProcessVertex::packPosition(glm::vec2(v.pos));
+	packed.tcRed = packUV(glm::vec2(v.color));
+	packed.tcGreen = packUV(v.uv);
+	packed.tcBlue = packUV(glm::vec2(v.nor));
+	return packed;
+}
+
+PostProcessPreCalcVertex PostProcessPreCalcVertex::mirror(const PostProcessPreCalcVertex& v) {
+	PostProcessPreCalcVertex mirrored = v;
+	mirrored.pos.x = -v.pos.x;
+	mirrored.tcRed.x = 65535 - v.tcRed.x;
+	mirrored.tcGreen.x = 65535 - v.tcGreen.x;
+	mirrored.tcBlue.x = 65535 - v.tcBlue.x;
+	return mirrored;
+}
+
+VkVertexInputBindingDescription PostProcessPreCalcVertex::getBindingDescription() {
+	VkVertexInputBindingDescription bindingDescription = {};
+	bindingDescription.binding = 0;
+	bindingDescription.stride = sizeof(PostProcessPreCalcVertex);
+	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 4> PostProcessPreCalcVertex::getAttributeDescriptions() {
+	std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions = {};
+
+	attributeDescriptions[0].binding = 0;
+	attributeDescriptions[0].location = 0;
+	attributeDescriptions[0].format = VK_FORMAT_R16G16_SNORM;
+	attributeDescriptions[0].offset = offsetof(PostProcessPreCalcVertex, pos);
+
+	attributeDescriptions[1].binding = 0;
+	attributeDescriptions[1].location = 1;
+	attributeDescriptions[1].format = VK_FORMAT_R16G16_UNORM;
+	attributeDescriptions[1].offset = offsetof(PostProcessPreCalcVertex, tcRed);
+
+	attributeDescriptions[2].binding = 0;
+	attributeDescriptions[2].location = 2;
+	attributeDescriptions[2].format = VK_FORMAT_R16G16_UNORM;
+	attributeDescriptions[2].offset = offsetof(PostProcessPreCalcVertex, tcGreen);
+
+	attributeDescriptions[3].binding = 0;
+	attributeDescriptions[3].location = 3;
+	attributeDescriptions[3].format = VK_FORMAT_R16G16_UNORM;
+	attributeDescriptions[3].offset = offsetof(PostProcessPreCalcVertex, tcBlue);
+
+	return attributeDescriptions;
+}
+
+VkVertexInputBindingDescription HiddenAreaVertex::getBindingDescription() {
+	VkVertexInputBindingDescription bindingDescription = {};
+	bindingDescription.binding = 0;
+	bindingDescription.stride = sizeof(HiddenAreaVertex);
+	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 1> HiddenAreaVertex::getAttributeDescriptions() {
+	std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions = {};
+
+	attributeDescriptions[0].binding = 0;
+	attributeDescriptions[0].location = 0;
+	attributeDescriptions[0].format = VK_FORMAT_R16G16_UINT;
+	attributeDescriptions[0].offset = offsetof(HiddenAreaVertex, pos);
+
+	return attributeDescriptions;
+}
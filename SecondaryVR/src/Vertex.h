@@ -4,6 +4,7 @@
 
 #include <array>
 #include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 class Vertex {
 public:
@@ -25,3 +26,44 @@ public:
 };
 //
 
+
+//post process meshes (ndc triangle, barrel grids, pixel points) only need an ndc position, binding 0 location 0.
+//their uv is always (ndc + 1) / 2 so the pp vertex shaders derive it and z is always 0.5.
+//ndc = snorm * POSITION_RANGE, the fullscreen triangle reaches 3 (keep in sync with the pp vertex shaders)
+struct PostProcessVertex {
+	glm::i16vec2 pos;
+
+	static constexpr float POSITION_RANGE = 4.f;
+	static glm::i16vec2 packPosition(const glm::vec2& ndc);
+	static glm::vec2 unpackPosition(const glm::i16vec2& packed);
+	static VkVertexInputBindingDescription getBindingDescription();
+	static std::array<VkVertexInputAttributeDescription, 1> getAttributeDescriptions();
+};
+
+//precalc barrel mesh, ndc position plus the r g b source uv's (locations 1 2 3) the fragment shader samples with.
+//uv = UV_MIN + unorm * (UV_MAX - UV_MIN), symmetric about 0.5 so mirroring to the right eye is exact on the packed values
+struct PostProcessPreCalcVertex {
+	glm::i16vec2 pos;
+	glm::u16vec2 tcRed;
+	glm::u16vec2 tcGreen;
+	glm::u16vec2 tcBlue;
+
+	static constexpr float UV_MIN = -0.5f;
+	static constexpr float UV_MAX = 1.5f;
+	static glm::u16vec2 packUV(const glm::vec2& uv);
+	static glm::vec2 unpackUV(const glm::u16vec2& packed);
+	//pos from Vertex::pos, tcRed tcGreen tcBlue from color uv nor (see BarrelMeshBuilder)
+	static PostProcessPreCalcVertex pack(const Vertex& v);
+	//left eye to right eye: x = -x, u = 1 - u
+	static PostProcessPreCalcVertex mirror(const PostProcessPreCalcVertex& v);
+	static VkVertexInputBindingDescription getBindingDescription();
+	static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions();
+};
+
+//HiddenAreaMesh rectangle corner in render target pixels (quad corners are always whole pixels), hiddenAreaMesh.vert
+struct HiddenAreaVertex {
+	glm::u16vec2 pos;
+
+	static VkVertexInputBindingDescription getBindingDescription();
+	static std::array<VkVertexInputAttributeDescription, 1> getAttributeDescriptions();
+};
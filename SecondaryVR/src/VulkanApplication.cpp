@@ -24,11 +24,21 @@
 
 #include "GlobalSettings.h"
 #include "Utils.h"
+#include "LensDistortion.h"
+#include "InverseDistortion.h"
+#include "BarrelMeshBuilder.h"
+#include "DistortionLUT.h"
+#include "HoleFillClassification.h"
+#include "HiddenAreaMesh.h"
+#include "StencilGenerator.h"
+#include "DistortedForward.h"
 
 #include <fstream>
 #include <chrono>
 #include <cstring>
 #include <tuple>
+#include <future>
+#include <algorithm>
 
 std::string convertIntToString(int number)
 {
@@ -97,6 +107,18 @@ void VulkanApplication::initVulkan() {
 	contextInfo = VulkanContextInfo(window);
 	VulkanApplication::setupDebugCallback();
 	//PreMadeStencil stencil = PreMadeStencil(contextInfo, 0, StencilType::PreCalcBarrelSamplingMask);
+	//LensDistortion::benchmark();//scalar vs SIMD getSourceUV equivalence and timing on a full res sampling mask
+	//InverseDistortion::benchmark();//lut+newton inverse vs old secant inverse over the ndc grid
+	//BarrelMeshBuilder::report();//uniform/adaptive/lens ring precalc barrel meshes, vertex count vs uv error vs pixels rasterized
+	//DistortionLUT::report();//half float lut reconstruction error vs getSourceUV and bake time
+	//PostProcessGraph::report(contextInfo);//pp chain passes, aliased memory slots and target bytes per swap image, submits per frame
+	//HiddenAreaMesh::report(contextInfo);//hidden area rectangles per quality level vs the stencil upload, cpu rasterized vs the mask
+	//SubpassHoleFill::report(contextInfo);//forward color + pp input bytes per frame as separate passes vs subpasses, lazy memory
+	//DistortedForward::report(contextInfo);//shader warp error vs InverseDistortion, straight edge error by length, target pixels
+	//HoleFillClassification::report(contextInfo);//per pixel hole fill classes per quality level vs the vr stencil mask, bake time
+	//StencilGenerator::report(contextInfo);//gpu vs cpu radial density stencil per quality level, run under a software vulkan driver
+	//PreMadeStencil::reportFixedFoveated(contextInfo);//fragments shaded/saved per fixedFoveatedLevels ring list vs the radial density mask
+	//PreMadeStencil::reportPreCalcBarrelSampling(contextInfo);//unique shaded pixels of the barrel sampling mask vs radial density per quality level
 
 	
 	//describes input and output attachments and how subpasses relate to one another
@@ -111,6 +133,9 @@ void VulkanApplication::initVulkan() {
 	createPPMeshes();
 
 	VulkanBuffer::createUniformBuffer(contextInfo, sizeof(UniformBufferObject), uniformBuffer, uniformBufferMemory);
+	if (temporalCheckerStencil) {
+		VulkanBuffer::createUniformBuffer(contextInfo, sizeof(TemporalHoleFillUBO), temporalUniformBuffer, temporalUniformBufferMemory);
+	}
 
 	//setup all pipelines
 	createPipelines();
@@ -154,6 +179,12 @@ void VulkanApplication::renderNormally(const uint32_t imageIndex) {
 	std::vector<VkPipelineStageFlags> forwardWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
 
 	updateUniformBuffer();
+	//the chains share their hole fill stage, so a temporal hole fill's history carries over when the chain changes
+	const uint32_t chain = selectPostProcessChain();
+	lastPostProcessChain = chain;
+	if (temporalCheckerStencil) {
+		updateTemporalUniformBuffer(imageIndex);
+	}
 	//////////////////
 	//// FORWARD /////
 	//////////////////
@@ -199,50 +230,36 @@ void VulkanApplication::renderNormally(const uint32_t imageIndex) {
 	endRecordingPrimary(imageIndex);
 
 
-	VkSubmitInfo forwardSubmitInfo = {};
-	forwardSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	////////////////////////////////
+	//// FORWARD + POST PROCESS ////
+	////////////////////////////////
+	//one submit: the pp graph's barriers order its passes after the forward pass and each other, no semaphore between them
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	forwardSubmitInfo.waitSemaphoreCount = forwardWaitSemaphores.size();
-	forwardSubmitInfo.pWaitSemaphores = &forwardWaitSemaphores[0];
-	forwardSubmitInfo.pWaitDstStageMask = &forwardWaitStages[0];
+	//nothing touches the swapchain image before the present pass
+	forwardWaitStages[0] = postProcessGraphs[chain].getWaitStage();
+	submitInfo.waitSemaphoreCount = forwardWaitSemaphores.size();
+	submitInfo.pWaitSemaphores = &forwardWaitSemaphores[0];
+	submitInfo.pWaitDstStageMask = &forwardWaitStages[0];
 
-	forwardSubmitInfo.commandBufferCount = 1;
-	forwardSubmitInfo.pCommandBuffers = &primaryForwardCommandBuffers[imageIndex];
+	std::vector<VkCommandBuffer> frameCommandBuffers = { primaryForwardCommandBuffers[imageIndex], postProcessGraphs[chain].commandBuffers[imageIndex] };
+	submitInfo.commandBufferCount = frameCommandBuffers.size();
+	submitInfo.pCommandBuffers = &frameCommandBuffers[0];
 
-	std::vector<VkSemaphore> forwardSignalSemaphores = { forwardRenderFinishedSemaphore };
-	forwardSubmitInfo.signalSemaphoreCount = forwardSignalSemaphores.size();
-	forwardSubmitInfo.pSignalSemaphores = &forwardSignalSemaphores[0];
+	std::vector<VkSemaphore> signalSemaphores = { renderFinishedSemaphore };
+	submitInfo.signalSemaphoreCount = signalSemaphores.size();
+	submitInfo.pSignalSemaphores = &signalSemaphores[0];
 
-	if (vkQueueSubmit(contextInfo.graphicsQueue, 1, &forwardSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+	//the swap image's queries are written again by this submit
+	postProcessTimer.collect(contextInfo, imageIndex);
+	if (vkQueueSubmit(contextInfo.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to submit draw command buffer!";
 		throw std::runtime_error(ss.str());
 	}
-
-	///////////////////////////////
-	//////// POST PROCESS /////////
-	///////////////////////////////
-	VkSubmitInfo postProcessSubmitInfo = {};
-	postProcessSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-	std::vector<VkSemaphore> postProcessWaitSemaphores = { forwardRenderFinishedSemaphore };
-	std::vector<VkPipelineStageFlags> postProcessWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	postProcessSubmitInfo.waitSemaphoreCount = postProcessWaitSemaphores.size();
-	postProcessSubmitInfo.pWaitDstStageMask = &postProcessWaitStages[0];
-	postProcessSubmitInfo.commandBufferCount = 1;
-
-	for (auto& pipeline : postProcessPipelines) {
-		postProcessSubmitInfo.pWaitSemaphores = &postProcessWaitSemaphores[0];
-		postProcessSubmitInfo.pCommandBuffers = &pipeline.commandBuffers[imageIndex];
-		std::vector<VkSemaphore> postProcessSignalSemaphores = { pipeline.renderFinishedSemaphore };
-		postProcessSubmitInfo.signalSemaphoreCount = postProcessSignalSemaphores.size();
-		postProcessSubmitInfo.pSignalSemaphores = &postProcessSignalSemaphores[0];
-
-		if (vkQueueSubmit(contextInfo.graphicsQueue, 1, &postProcessSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
-			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to submit draw command buffer!";
-			throw std::runtime_error(ss.str());
-		}
-		postProcessWaitSemaphores = { pipeline.renderFinishedSemaphore };
-	}
+	postProcessTimer.frameSubmitted(imageIndex, chain);
+	//next frame shades the other checker half and reprojects this one
+	contextInfo.camera.finishTemporalFrame(imageIndex);
 
 	///////////////////////
 	/////// PRESENT////////
@@ -250,7 +267,7 @@ void VulkanApplication::renderNormally(const uint32_t imageIndex) {
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
-	std::vector<VkSemaphore> presentSignalSemaphores = { postProcessPipelines.back().renderFinishedSemaphore };
+	std::vector<VkSemaphore> presentSignalSemaphores = { renderFinishedSemaphore };
 	presentInfo.waitSemaphoreCount = presentSignalSemaphores.size();
 	presentInfo.pWaitSemaphores = &presentSignalSemaphores[0];
 	//presentInfo.waitSemaphoreCount = forwardSignalSemaphores.size();
@@ -276,6 +293,8 @@ void VulkanApplication::renderTimeWarp(const uint32_t imageIndex) {
 	std::vector<VkSemaphore> forwardWaitSemaphores = { imageAvailableSemaphore };
 	std::vector<VkPipelineStageFlags> forwardWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
 	updateUniformBuffer();
+	//the temporal hole fill doesn't run while warping, its outputs are stale once we render normally again
+	contextInfo.camera.resetTemporalHistory();
 
 	//////////////////////////////////
 	//////// TIME WARP AND PP/////////
@@ -283,24 +302,20 @@ void VulkanApplication::renderTimeWarp(const uint32_t imageIndex) {
 	VkSubmitInfo timeWarpSubmitInfo = {};
 	timeWarpSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	std::vector<VkSemaphore> timeWarpWaitSemaphores = { forwardWaitSemaphores };
-	std::vector<VkPipelineStageFlags> postProcessWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	timeWarpSubmitInfo.waitSemaphoreCount = timeWarpWaitSemaphores.size();
-	timeWarpSubmitInfo.pWaitDstStageMask = &postProcessWaitStages[0];
+	forwardWaitStages[0] = timeWarpGraph.getWaitStage();
+	timeWarpSubmitInfo.waitSemaphoreCount = forwardWaitSemaphores.size();
+	timeWarpSubmitInfo.pWaitSemaphores = &forwardWaitSemaphores[0];
+	timeWarpSubmitInfo.pWaitDstStageMask = &forwardWaitStages[0];
 	timeWarpSubmitInfo.commandBufferCount = 1;
+	timeWarpSubmitInfo.pCommandBuffers = &timeWarpGraph.commandBuffers[imageIndex];
 
-	for (auto& pipeline : timeWarpPipelines) {
-		timeWarpSubmitInfo.pWaitSemaphores = &timeWarpWaitSemaphores[0];
-		timeWarpSubmitInfo.pCommandBuffers = &pipeline.commandBuffers[imageIndex];
-		std::vector<VkSemaphore> timeWarpSignalSemaphores = { pipeline.renderFinishedSemaphore };
-		timeWarpSubmitInfo.signalSemaphoreCount = timeWarpSignalSemaphores.size();
-		timeWarpSubmitInfo.pSignalSemaphores = &timeWarpSignalSemaphores[0];
+	std::vector<VkSemaphore> timeWarpSignalSemaphores = { renderFinishedSemaphore };
+	timeWarpSubmitInfo.signalSemaphoreCount = timeWarpSignalSemaphores.size();
+	timeWarpSubmitInfo.pSignalSemaphores = &timeWarpSignalSemaphores[0];
 
-		if (vkQueueSubmit(contextInfo.graphicsQueue, 1, &timeWarpSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
-			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to submit draw command buffer!";
-			throw std::runtime_error(ss.str());
-		}
-		timeWarpWaitSemaphores = { pipeline.renderFinishedSemaphore };
+	if (vkQueueSubmit(contextInfo.graphicsQueue, 1, &timeWarpSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to submit draw command buffer!";
+		throw std::runtime_error(ss.str());
 	}
 
 	///////////////////////
@@ -309,7 +324,7 @@ void VulkanApplication::renderTimeWarp(const uint32_t imageIndex) {
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
-	std::vector<VkSemaphore> presentSignalSemaphores = { timeWarpPipelines.back().renderFinishedSemaphore };
+	std::vector<VkSemaphore> presentSignalSemaphores = { renderFinishedSemaphore };
 	presentInfo.waitSemaphoreCount = presentSignalSemaphores.size();
 	presentInfo.pWaitSemaphores = &presentSignalSemaphores[0];
 	//presentInfo.waitSemaphoreCount = forwardSignalSemaphores.size();
@@ -338,7 +353,7 @@ void VulkanApplication::beginRecordingPrimary(VkCommandBufferInheritanceInfo& in
 	inheritanceInfo.pNext = NULL;
 	//inheritanceInfo.framebuffer = contextInfo.swapChainFramebuffers[imageIndex];
 	inheritanceInfo.framebuffer = forwardPipelinesFramebuffers[imageIndex];
-	inheritanceInfo.renderPass = (contextInfo.camera.vrmode && contextInfo.camera.useStencil) ? 
+	inheritanceInfo.renderPass = contextInfo.camera.usesStencilLoading() ? 
 		allRenderPasses.renderPassStencilLoading : allRenderPasses.renderPass;
 	inheritanceInfo.occlusionQueryEnable = VK_FALSE;
 	inheritanceInfo.pipelineStatistics = 0;
@@ -359,12 +374,14 @@ void VulkanApplication::beginRecordingPrimary(VkCommandBufferInheritanceInfo& in
 //	renderPassInfo.renderArea.extent = contextInfo.swapChainExtent;
 	renderPassInfo.renderArea.extent = contextInfo.camera.renderTargetExtent;
 
-	std::array<VkClearValue, 2> clearValues = {};
+	//[2] SubpassHoleFill's output, ignored when the render pass has no attachment 2
+	std::array<VkClearValue, 3> clearValues = {};
 	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
-	if(contextInfo.camera.vrmode && contextInfo.camera.useStencil)
+	if(contextInfo.camera.usesStencilLoading())
 		clearValues[1].depthStencil = { 1.f };
 	else
 		clearValues[1].depthStencil = { 1.f, 1 };
+	clearValues[2].color = { 0.0f, 0.0f, 0.0f, 1.0f };
 
 	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 	renderPassInfo.pClearValues = clearValues.data();
@@ -381,7 +398,7 @@ void VulkanApplication::beginRecordingPrimary(const uint32_t imageIndex) {
 
 	VkRenderPassBeginInfo renderPassInfo = {};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = (contextInfo.camera.vrmode && contextInfo.camera.useStencil) ? 
+	renderPassInfo.renderPass = contextInfo.camera.usesStencilLoading() ? 
 		allRenderPasses.renderPassStencilLoading : allRenderPasses.renderPass;
 	//renderPassInfo.framebuffer = contextInfo.swapChainFramebuffers[imageIndex];
 	renderPassInfo.framebuffer = forwardPipelinesFramebuffers[imageIndex];
@@ -389,22 +406,31 @@ void VulkanApplication::beginRecordingPrimary(const uint32_t imageIndex) {
 	//renderPassInfo.renderArea.extent = contextInfo.swapChainExtent;
 	renderPassInfo.renderArea.extent = contextInfo.camera.renderTargetExtent;
 
-	std::array<VkClearValue, 2> clearValues = {};
+	//[2] SubpassHoleFill's output, ignored when the render pass has no attachment 2
+	std::array<VkClearValue, 3> clearValues = {};
 	clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
-	if(contextInfo.camera.vrmode && contextInfo.camera.useStencil)
+	if(contextInfo.camera.usesStencilLoading())
 		clearValues[1].depthStencil = { 1.f };
 	else
 		clearValues[1].depthStencil = { 1.f, 1 };
+	clearValues[2].color = { 0.0f, 0.0f, 0.0f, 1.0f };
 
 
 	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 	renderPassInfo.pClearValues = clearValues.data();
 
 	vkCmdBeginRenderPass(primaryForwardCommandBuffers[imageIndex], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	if (contextInfo.camera.usesHiddenAreaMesh()) {
+		contextInfo.hiddenAreaMesh.record(primaryForwardCommandBuffers[imageIndex], contextInfo);
+	}
 }
 
 
 void VulkanApplication::endRecordingPrimary(const uint32_t imageIndex) {
+	if (contextInfo.camera.subpassHoleFill) {
+		vkCmdNextSubpass(primaryForwardCommandBuffers[imageIndex], VK_SUBPASS_CONTENTS_INLINE);
+		subpassHoleFill.record(primaryForwardCommandBuffers[imageIndex], imageIndex, contextInfo);
+	}
 	vkCmdEndRenderPass(primaryForwardCommandBuffers[imageIndex]);
 	if (vkEndCommandBuffer(primaryForwardCommandBuffers[imageIndex]) != VK_SUCCESS) {
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to record command buffer!";
@@ -419,7 +445,7 @@ void VulkanApplication::createSemaphores() {
 	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
 	if (vkCreateSemaphore(contextInfo.device, &semaphoreInfo, nullptr, &imageAvailableSemaphore) != VK_SUCCESS ||
-		vkCreateSemaphore(contextInfo.device, &semaphoreInfo, nullptr, &forwardRenderFinishedSemaphore) != VK_SUCCESS)
+		vkCreateSemaphore(contextInfo.device, &semaphoreInfo, nullptr, &renderFinishedSemaphore) != VK_SUCCESS)
 	{
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create semaphores!";
 		throw std::runtime_error(ss.str());
@@ -445,6 +471,24 @@ void VulkanApplication::updateUniformBuffer() {
 	vkUnmapMemory(contextInfo.device, uniformBufferMemory);
 }
 
+void VulkanApplication::updateTemporalUniformBuffer(const uint32_t imageIndex) {
+	const Camera& camera = contextInfo.camera;
+	const uint32_t numImages = static_cast<uint32_t>(contextInfo.swapChainImages.size());
+
+	TemporalHoleFillUBO ubo = {};
+	//the stage reads its output for the swap image before this one, only last frame's if the swapchain went round robin
+	ubo.historyValid = (camera.lastForwardImageIndex == (imageIndex + numImages - 1) % numImages) ? 1 : 0;
+	ubo.stencilPhase = camera.stencilPhase;
+	for (int i = 0; i < 2; ++i) {
+		ubo.reprojection[i] = camera.lastViewProj[i] * glm::inverse(camera.proj * camera.view[i]);
+	}
+
+	void* data;
+	vkMapMemory(contextInfo.device, temporalUniformBufferMemory, 0, sizeof(ubo), 0, &data);
+	memcpy(data, &ubo, sizeof(ubo));
+	vkUnmapMemory(contextInfo.device, temporalUniformBufferMemory);
+}
+
 void VulkanApplication::allocateGlobalCommandBuffers() {
 	primaryForwardCommandBuffers.resize(contextInfo.swapChainFramebuffers.size());
 	addGraphicsCommandPool(primaryForwardCommandBuffers.size());
@@ -497,6 +541,14 @@ void VulkanApplication::updateFPS() {
 		fpstracker = 0;
 		oldtime = currenttime;
 		std::string title = "render | " + convertIntToString(fps) + " FPS " + convertFloatToString(1000.f / (double)fps) + " ms";
+		//gpu time of the pp chain (PostProcessTimer), and which distortion technique it is when there's a choice
+		const double postProcessMs = postProcessTimer.takeRecentMs();
+		if (postProcessMs >= 0.0) {
+			title += " | pp " + convertFloatToString(postProcessMs) + " ms";
+			if (postProcessGraphs.size() > 1) {
+				title += " (" + distortionTechniques_PostProcessPipelines[lastPostProcessChain].first + ")";
+			}
+		}
 		glfwSetWindowTitle(window, title.c_str());
 	}
 }
@@ -536,6 +588,42 @@ void VulkanApplication::processInputAndUpdateFPS() {
 		contextInfo.camera.useStencil = !contextInfo.camera.useStencil;
 		recreateSwapChain();
 	}
+	if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS && contextInfo.camera.vrmode) {
+		//next vr stencil (radial density, fixed foveated, barrel sampling), ppStencilHoleFill follows its rings
+		contextInfo.vrStencilType = static_cast<StencilType>((static_cast<uint32_t>(contextInfo.vrStencilType) + 1) % NUM_STENCIL_TYPES);
+		contextInfo.initStencils();
+		std::cout << "\nVR stencil: " << PreMadeStencil::getTypeName(contextInfo.vrStencilType);
+		recreateSwapChain();
+	}
+	if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS && !temporalCheckerStencil) {
+		//fused hole fill + barrel/aberration stage vs the two stage chain
+		fusedPostProcess = !fusedPostProcess;
+		std::cout << "\nPost process: " << (fusedPostProcess ? "fused hole fill + barrel/aberration" : "hole fill, barrel/aberration");
+		recreateSwapChain();
+	}
+	if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS && !temporalCheckerStencil && !contextInfo.swapChainStorage) {
+		//the compute barrel/aberration stage presents by writing the swapchain image
+		std::cout << "\nPost process: compute isn't available, the swapchain images can't be storage images (surface usage or format)";
+	}
+	if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS && !temporalCheckerStencil && contextInfo.swapChainStorage) {
+		//compute hole fill and barrel/aberration vs the raster stages F picks
+		computePostProcess = !computePostProcess;
+		std::cout << "\nPost process: " << (computePostProcess ? "compute" : "raster");
+		recreateSwapChain();
+	}
+	if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS && !temporalCheckerStencil) {
+		//forward + per pixel hole fill copy as subpasses (forward color stays on tile) vs the forward image stored and sampled
+		contextInfo.camera.subpassHoleFill = !contextInfo.camera.subpassHoleFill;
+		std::cout << "\nForward render pass: " << (contextInfo.camera.subpassHoleFill ? "forward + hole fill subpasses" : "forward only");
+		recreateSwapChain();
+	}
+	if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS && contextInfo.camera.vrmode && !contextInfo.camera.timewarp && !temporalCheckerStencil) {
+		//forward pipelines warp into lens space (panel sized target, one present stage) vs stencil + hole fill + barrel chain
+		contextInfo.camera.distortedForward = !contextInfo.camera.distortedForward;
+		std::cout << "\nForward rendering: " << (contextInfo.camera.distortedForward ?
+			(contextInfo.tessellationShader ? "direct to distorted, tessellated" : "direct to distorted, per vertex") : "undistorted");
+		recreateSwapChain();
+	}
 	if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS && contextInfo.camera.vrmode) {
 		//we need to disable stencil, recreateSwapChain(so that forward render graphics pipeline
 		//uses the stencil-less render pass format so we can get a depth image that has depth info for each pixel
@@ -613,6 +701,9 @@ void VulkanApplication::cleanup() {
 
 	//clean up command pools
 	contextInfo.destroyCommandPools();
+	contextInfo.destroyBakeBundle();
+	contextInfo.destroyStencilGenerator();
+	contextInfo.destroyHiddenAreaMesh();
 
 	//clean up logical device, debug callback surface, instance
 	contextInfo.destroyDevice();
@@ -628,9 +719,6 @@ void VulkanApplication::destroyPipelinesSemaphores() {
 	for (auto& pipeline : forwardPipelines) {
 		pipeline.destroyPipelineSemaphores(contextInfo);
 	}
-	for (auto& pipeline : postProcessPipelines) {
-		pipeline.destroyPipelineSemaphores(contextInfo);
-	}
 }
 
 void VulkanApplication::createPipelines() {
@@ -650,88 +738,259 @@ void VulkanApplication::createPipelines() {
 		forwardPipelines[i] = VulkanGraphicsPipeline(allShaders_ForwardPipelines[i].first,
 			allRenderPasses, contextInfo, &(VulkanDescriptor::layoutTypes[numImageSamplers]));
 	}
+	if (contextInfo.camera.usesHiddenAreaMesh()) {
+		contextInfo.hiddenAreaMesh.createPipeline(contextInfo, allRenderPasses.renderPass);
+	}
+	if (contextInfo.camera.subpassHoleFill) {
+		subpassHoleFill.createPipeline(contextInfo, allRenderPasses.renderPass, forwardPipelinesVulkanImages);
+	}
 
 	////////////////////////////////////
 	/////// POST PROCESS PIPELINES//////
 	////////////////////////////////////
-	postProcessPipelines.resize(allShaders_PostProcessPipelines.size());
-	for (uint32_t i = 0; i < allShaders_PostProcessPipelines.size(); ++i) {
+	//every distortion technique's chain is recorded, a frame submits one of them (selectPostProcessChain).
+	//the first chain owns the stages they share, the others only build their last one
+	const auto postProcessChains = getPostProcessChains();
+	postProcessTimer.createQueryPool(contextInfo, static_cast<uint32_t>(postProcessChains.size()));
+	postProcessPipelines.resize(postProcessChains.size());
+	postProcessGraphs.resize(postProcessChains.size());
+	for (uint32_t i = 0; i < postProcessChains.size(); ++i) {
+		createPostProcessChain(postProcessChains[i], i);
+	}
+
+
+	/////////////////////////////////////
+	//////// TIME WARP PIPELINES/////////
+	/////////////////////////////////////
+	if (contextInfo.camera.timewarp) {
+		createTimeWarpPipelines();
+	}
+}
+
+void VulkanApplication::createPostProcessChain(const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& postProcessStages,
+	const uint32_t chain)
+{
+	std::vector<PostProcessPipeline>& pipelines = postProcessPipelines[chain];
+	PostProcessGraph& graph = postProcessGraphs[chain];
+	const uint32_t numStages = static_cast<uint32_t>(postProcessStages.size());
+	//the chains only differ in their last stage (getPostProcessChains), every other stage and its output is chain 0's
+	const uint32_t firstOwnStage = (chain == 0) ? 0 : numStages - 1;
+
+	//each stage samples the one before it, the graph works out the barriers and which outputs can share memory
+	for (uint32_t i = 0; i < numStages; ++i) {
+		graph.addPass(getPostProcessStageType(postProcessStages, i), { i == 0 ? PostProcessGraph::FORWARD : i - 1 },
+			(i == numStages - 1), getPPMeshes(std::get<0>(postProcessStages[i])));
+	}
+	graph.compile();
+	if (chain == 0) {//the last stage presents, so the others have nothing in their slots
+		graph.createSlotMemory(contextInfo);
+	}
+
+	pipelines.resize(numStages - firstOwnStage);
+	for (uint32_t i = firstOwnStage; i < numStages; ++i) {
 		//const uint32_t numImageSamplers = allShaders_PostProcessPipelines[i].second;
-		const std::vector<std::string>& shaderPaths = std::get<0>(allShaders_PostProcessPipelines[i]);
-		const uint32_t numImageSamplers = std::get<1>(allShaders_PostProcessPipelines[i]);
-		const PipelineType typeFlags = (PipelineType)std::get<2>(allShaders_PostProcessPipelines[i]);
-		postProcessPipelines[i] = PostProcessPipeline(shaderPaths, allRenderPasses, contextInfo,
-			&(VulkanDescriptor::postProcessLayoutTypes[numImageSamplers - 1]), (i == allShaders_PostProcessPipelines.size() - 1),
-			typeFlags);
+		const std::vector<std::string>& shaderPaths = std::get<0>(postProcessStages[i]);
+		const uint32_t numImageSamplers = std::get<1>(postProcessStages[i]);
+		const PipelineType typeFlags = getPostProcessStageType(postProcessStages, i);
+		const VkDescriptorSetLayout* setLayouts = &(VulkanDescriptor::postProcessLayoutTypes[numImageSamplers - 1]);
+		if (PipelineType::TEMPORAL == typeFlags) {
+			setLayouts = &(VulkanDescriptor::temporalHoleFillLayoutTypes[0]);
+		} else if (PipelineType::COMPUTE == typeFlags) {
+			setLayouts = &(VulkanDescriptor::computeLayoutTypes[numImageSamplers - 1]);
+		}
+		pipelines[i - firstOwnStage] = PostProcessPipeline(shaderPaths, allRenderPasses, contextInfo,
+			setLayouts, (i == numStages - 1),
+			typeFlags, graph.getOutputMemory(i));
+		if (PipelineType::HOLES_ONLY == typeFlags) {
+			pipelines[i - firstOwnStage].createFramebuffersHolesOnly(contextInfo, allRenderPasses, getForwardOutputImages());
+		}
+	}
+
+	//chain 0's shared stages then this chain's own
+	std::vector<PostProcessPipeline*> chainPipelines;
+	for (uint32_t i = 0; i < firstOwnStage; ++i) {
+		chainPipelines.push_back(&postProcessPipelines[0][i]);
+	}
+	for (PostProcessPipeline& pipeline : pipelines) {
+		chainPipelines.push_back(&pipeline);
 	}
 
 	//each pp needs inputdescriptor set ofprevious stage
-	postProcessPipelines[0].createInputDescriptors(contextInfo, forwardPipelinesVulkanImages);
-	for (uint32_t i = 1; i < postProcessPipelines.size(); ++i) {
-		//TODO: second are should be determined from tuple element in allShaders_PostProcessPipelines specifying which stage feeds it
-		postProcessPipelines[i].createInputDescriptors(contextInfo, postProcessPipelines[i-1].outputImages);
+	for (uint32_t i = firstOwnStage; i < numStages; ++i) {
+		if (i == 0 && PipelineType::TEMPORAL == chainPipelines[0]->pipelinetype) {
+			chainPipelines[0]->createInputDescriptorsTemporal(contextInfo, getForwardOutputImages(), contextInfo.depthImage,
+				temporalUniformBuffer, sizeof(TemporalHoleFillUBO));
+			continue;
+		}
+		//an in place stage's output is the forward image
+		const uint32_t source = graph.passes[i].inputs[0];
+		const bool forwardSource = (source == PostProcessGraph::FORWARD || graph.passes[source].inPlace);
+		chainPipelines[i]->createInputDescriptors(contextInfo,
+			forwardSource ? getForwardOutputImages() : chainPipelines[source]->outputImages,
+			getStaticPostProcessInputs(std::get<0>(postProcessStages[i]), std::get<1>(postProcessStages[i])));
 	}
 
-	//create the static command buffers(no dynamic input for post processing)
-	for (uint32_t i = 0; i < allShaders_PostProcessPipelines.size()-1; ++i) {
-		postProcessPipelines[i].createStaticCommandBuffers(contextInfo, allRenderPasses, { ndcTriangle, ndcTriangle });
+	//create the static command buffers(no dynamic input for post processing), every stage in one per swap image
+	//the vertex shader picks the mesh (triangle, barrel grid, precalc barrel mesh) or none if it is procedural
+	graph.record(contextInfo, allRenderPasses, chainPipelines, getForwardOutputImages(), postProcessTimer.queryPool);
+}
+
+PipelineType VulkanApplication::getPostProcessStageType(const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& postProcessStages,
+	const uint32_t stage) const
+{
+	const PipelineType typeFlags = (PipelineType)std::get<2>(postProcessStages[stage]);
+	const std::vector<std::string>& shaderPaths = std::get<0>(postProcessStages[stage]);
+	const bool holesOnlyShader = std::find(holesOnlyFragShaders_PostProcessPipelines.begin(),
+		holesOnlyFragShaders_PostProcessPipelines.end(), shaderPaths.back()) != holesOnlyFragShaders_PostProcessPipelines.end();
+	//the present stage writes the swapchain image, it has nothing to fill in place
+	if (contextInfo.camera.subpassHoleFill && stage == 0 && postProcessStages.size() > 1 &&
+		PipelineType::PP == typeFlags && holesOnlyShader)
+	{
+		return PipelineType::HOLES_ONLY;
 	}
-	postProcessPipelines.back().createStaticCommandBuffers(contextInfo, allRenderPasses, { ndcTriangle, ndcTriangle });
-	//postProcessPipelines.back().createStaticCommandBuffers(contextInfo, allRenderPasses, {ndcBarrelMesh[0], ndcBarrelMesh[1]});
-	//postProcessPipelines.back().createStaticCommandBuffers(contextInfo, allRenderPasses, {ndcBarrelMesh_PreCalc[0], ndcBarrelMesh_PreCalc[1]});
+	return typeFlags;
+}
 
+const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& VulkanApplication::getPostProcessStages() const {
+	if (contextInfo.camera.usesDistortedForward()) {
+		return distortedShaders_PostProcessPipelines;
+	}
+	//startComputePostProcess too needs swapchain images it can write as storage images
+	if (computePostProcess && contextInfo.swapChainStorage) {
+		return computeShaders_PostProcessPipelines;
+	}
+	return fusedPostProcess ? fusedShaders_PostProcessPipelines : allShaders_PostProcessPipelines;
+}
 
-	/////////////////////////////////////
-	//////// TIME WARP PIPELINES/////////
-	/////////////////////////////////////
-	if (contextInfo.camera.timewarp) {
-		createTimeWarpPipelines();
+std::vector< std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > > VulkanApplication::getPostProcessChains() const {
+	const auto& postProcessStages = getPostProcessStages();
+	if (&postProcessStages != &allShaders_PostProcessPipelines) {
+		return { postProcessStages };
 	}
+	std::vector< std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > > chains;
+	for (const auto& technique : distortionTechniques_PostProcessPipelines) {
+		chains.push_back(postProcessStages);
+		chains.back().back() = technique.second;
+	}
+	return chains;
+}
+
+uint32_t VulkanApplication::selectPostProcessChain() {
+	if (postProcessGraphs.size() == 1) {
+		return 0;
+	}
+	if (!distortionABTest) {
+		return distortionTechnique;
+	}
+
+	//turns of distortionABFramesPerTechnique frames, every technique once per round
+	const uint32_t numTechniques = static_cast<uint32_t>(postProcessGraphs.size());
+	const uint32_t turn = distortionABFrame / distortionABFramesPerTechnique;
+	if (turn < numTechniques * distortionABRounds) {
+		++distortionABFrame;
+		return turn % numTechniques;
+	}
+
+	postProcessTimer.collectAll(contextInfo);
+	std::cout << "\n\nDistortion A/B timing, " << distortionABRounds << " rounds of " << distortionABFramesPerTechnique << " frames ("
+		<< contextInfo.camera.renderTargetExtent.width << "x" << contextInfo.camera.renderTargetExtent.height << " render target)";
+	std::cout << "\n\ttechnique\t\tpp chain gpu ms\tframes";
+	for (uint32_t i = 0; i < numTechniques; ++i) {
+		std::cout << "\n\t" << distortionTechniques_PostProcessPipelines[i].first << "\t\t" << postProcessTimer.getAverageMs(i)
+			<< "\t\t" << postProcessTimer.frames[i];
+	}
+	const uint32_t cheapest = postProcessTimer.getCheapestChain();
+	if (cheapest == PostProcessTimer::NONE) {
+		std::cout << "\n\tno timestamps on the graphics queue, keeping " << distortionTechniques_PostProcessPipelines[distortionTechnique].first;
+	} else {
+		distortionTechnique = cheapest;
+		std::cout << "\n\tkeeping " << distortionTechniques_PostProcessPipelines[distortionTechnique].first;
+	}
+	std::cout << std::endl;
+	distortionABTest = false;
+	return distortionTechnique;
+}
+
+const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& VulkanApplication::getTimeWarpStages() const {
+	return fusedTimeWarp ? fusedShaders_TimeWarpPipelines : allShaders_TimeWarpPipelines;
 }
 
 void VulkanApplication::createTimeWarpPipelines() {
 	contextInfo.camera.timewarpCleanUp = true;
-	timeWarpPipelines.resize(allShaders_TimeWarpPipelines.size());
-	for (uint32_t i = 0; i < allShaders_TimeWarpPipelines.size(); ++i) {
+	const auto& timeWarpStages = getTimeWarpStages();
+	//the forward image it warps was sampled by the pp graph of the init frame and isn't rendered again while warping
+	timeWarpGraph.forwardLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	for (uint32_t i = 0; i < timeWarpStages.size(); ++i) {
+		timeWarpGraph.addPass((PipelineType)std::get<2>(timeWarpStages[i]), { i == 0 ? PostProcessGraph::FORWARD : i - 1 },
+			(i == timeWarpStages.size() - 1), getPPMeshes(std::get<0>(timeWarpStages[i])));
+	}
+	timeWarpGraph.compile();
+	timeWarpGraph.createSlotMemory(contextInfo);
+
+	timeWarpPipelines.resize(timeWarpStages.size());
+	for (uint32_t i = 0; i < timeWarpStages.size(); ++i) {
 		//const uint32_t numImageSamplers = allShaders_TimeWarpPipelines[i].second;
-		const std::vector<std::string>& shaderPaths = std::get<0>(allShaders_TimeWarpPipelines[i]);
-		const uint32_t numImageSamplers = std::get<1>(allShaders_TimeWarpPipelines[i]);
-		const PipelineType typeFlags = (PipelineType)std::get<2>(allShaders_TimeWarpPipelines[i]);
+		const std::vector<std::string>& shaderPaths = std::get<0>(timeWarpStages[i]);
+		const uint32_t numImageSamplers = std::get<1>(timeWarpStages[i]);
+		const PipelineType typeFlags = (PipelineType)std::get<2>(timeWarpStages[i]);
 		//raster prim was a dumb idea, just need a flag for timewarp
 
 		//need an mapping from numimagesamplers to layouttypes index
-		if (i == 0) {//first one is actual time warp
+		if (i == 0) {//first one is actual time warp (fused, it's also the present stage)
 			timeWarpPipelines[i] = PostProcessPipeline(shaderPaths, allRenderPasses, contextInfo,
-				&(VulkanDescriptor::timeWarpLayoutTypes[0]), (i == (allShaders_TimeWarpPipelines.size()-1)),//isPresent
-				typeFlags);
+				&(VulkanDescriptor::timeWarpLayoutTypes[0]), (i == (timeWarpStages.size()-1)),//isPresent
+				typeFlags, timeWarpGraph.getOutputMemory(i));
 		} else { //last one, outputImage should be swapchain format
 			timeWarpPipelines[i] = PostProcessPipeline(shaderPaths, allRenderPasses, contextInfo,
-				&(VulkanDescriptor::postProcessLayoutTypes[numImageSamplers - 1]), (i == allShaders_TimeWarpPipelines.size()-1) ,//isPresent
-				typeFlags);
+				&(VulkanDescriptor::postProcessLayoutTypes[numImageSamplers - 1]), (i == timeWarpStages.size()-1) ,//isPresent
+				typeFlags, timeWarpGraph.getOutputMemory(i));
 		}
 	}
 
 }
 
+//pp stages with 2 image samplers get the baked distortion lut as their second input (ppBarrelAbLUT.frag), or the hole fill
+//classification if their fragment shader is in classificationFragShaders_PostProcessPipelines (ppStencilHoleFillClassified.frag).
+//made on first use after each swapchain (re)creation since they have a texel per present/render target pixel
+std::vector<VulkanImage> VulkanApplication::getStaticPostProcessInputs(const std::vector<std::string>& shaderPaths,
+	const uint32_t numImageSamplers) 
+{
+	if (numImageSamplers < 2) {
+		return {};
+	}
+	if (std::find(classificationFragShaders_PostProcessPipelines.begin(), classificationFragShaders_PostProcessPipelines.end(),
+		shaderPaths.back()) != classificationFragShaders_PostProcessPipelines.end())
+	{
+		//quality level and stencil type changes recreate the swapchain so this follows them
+		if (!holeFillClassificationCleanUp) {
+			holeFillClassification = HoleFillClassification::createImage(contextInfo);
+			holeFillClassificationCleanUp = true;
+		}
+		return { holeFillClassification };
+	}
+	if (!distortionLUTCleanUp) {
+		const VkExtent2D eyeExtent = { contextInfo.swapChainExtent.width / 2, contextInfo.swapChainExtent.height };
+		distortionLUT = DistortionLUT::createImage(contextInfo, eyeExtent);
+		distortionLUTCleanUp = true;
+	}
+	return { distortionLUT };
+}
+
 void VulkanApplication::createTimeWarpDescriptorAndCommands() {
 	//each pp needs inputdescriptor set ofprevious stage
-	timeWarpPipelines[0].createInputDescriptorsTimeWarp(contextInfo, forwardPipelinesVulkanImages, contextInfo.depthImage,
+	const auto& timeWarpStages = getTimeWarpStages();
+	timeWarpPipelines[0].createInputDescriptorsTimeWarp(contextInfo, getForwardOutputImages(), contextInfo.depthImage,
 		uniformBuffer, sizeof(UniformBufferObject));
 	for (uint32_t i = 1; i < timeWarpPipelines.size(); ++i) {
-		//TODO: second are should be determined from tuple element in allShaders_TimeWarpPipelines specifying which stage feeds it
-		timeWarpPipelines[i].createInputDescriptors(contextInfo, timeWarpPipelines[i - 1].outputImages);
+		const uint32_t source = timeWarpGraph.passes[i].inputs[0];
+		timeWarpPipelines[i].createInputDescriptors(contextInfo,
+			source == PostProcessGraph::FORWARD ? getForwardOutputImages() : timeWarpPipelines[source].outputImages,
+			getStaticPostProcessInputs(std::get<0>(timeWarpStages[i]), std::get<1>(timeWarpStages[i])));
 	}
 
-	//create the static command buffers(no dynamic input for post processing)
-	for (uint32_t i = 0; i < allShaders_TimeWarpPipelines.size(); ++i) {
-		//need an mapping from numimagesamplers to layouttypes index
-		if (i == 0) { //first one, time warp, use ndcPixelPoints
-			//timeWarpPipelines[i].createStaticCommandBuffersTimeWarp(contextInfo, allRenderPasses, { ndcPixelPoints, ndcPixelPoints });
-			timeWarpPipelines[i].createStaticCommandBuffersTimeWarp(contextInfo, allRenderPasses, { ndcBarrelMesh[0], ndcBarrelMesh[0] });
-		} else { //normal pp mesh(triangle)
-			timeWarpPipelines[i].createStaticCommandBuffers(contextInfo, allRenderPasses, { ndcTriangle, ndcTriangle });
-		}
-	}
+	//create the static command buffers(no dynamic input for post processing), the time warp stage records its
+	//barrel grid or procedural grid/pixel points, the rest their pp mesh
+	timeWarpGraph.record(contextInfo, allRenderPasses, timeWarpPipelines, getForwardOutputImages());
 }
 
 void VulkanApplication::initForwardPipelinesVulkanImagesAndFramebuffers() {
@@ -749,9 +1008,14 @@ void VulkanApplication::initForwardPipelinesVulkanImagesAndFramebuffers() {
 
 		//TODO: if flag is present then use swapchain format otherwise 16F
 		//forwardPipelinesVulkanImages[i] = VulkanImage(IMAGETYPE::COLOR_ATTACHMENT, contextInfo.swapChainExtent, VK_FORMAT_R16G16B16A16_SFLOAT, contextInfo);
-		forwardPipelinesVulkanImages[i] = VulkanImage(IMAGETYPE::COLOR_ATTACHMENT, contextInfo.camera.renderTargetExtent, VK_FORMAT_R16G16B16A16_SFLOAT, contextInfo);
+		//with camera.subpassHoleFill it never leaves the forward render pass, SubpassHoleFill's output is what gets stored
+		const IMAGETYPE forwardImageType = contextInfo.camera.subpassHoleFill ? IMAGETYPE::TRANSIENT_ATTACHMENT : IMAGETYPE::COLOR_ATTACHMENT;
+		forwardPipelinesVulkanImages[i] = VulkanImage(forwardImageType, contextInfo.camera.renderTargetExtent, VK_FORMAT_R16G16B16A16_SFLOAT, contextInfo);
 
 	}
+	if (contextInfo.camera.subpassHoleFill) {
+		subpassHoleFill.createOutputImages(contextInfo);
+	}
 
 	//for (int i = 0; i < contextInfo.swapChainImages.size(); ++i) {
 	//	forwardPipelinesFramebuffers[i] = contextInfo.swapChainFramebuffers[i];
@@ -763,7 +1027,10 @@ void VulkanApplication::initForwardPipelinesVulkanImagesAndFramebuffers() {
 		framebufferCreateInfo.pNext = NULL;
 
 		std::vector<VkImageView> attachments = { forwardPipelinesVulkanImages[i].imageView, contextInfo.depthImage.imageView };
-		framebufferCreateInfo.renderPass = (contextInfo.camera.vrmode && contextInfo.camera.useStencil) ? 
+		if (contextInfo.camera.subpassHoleFill) {
+			attachments.push_back(subpassHoleFill.outputImages[i].imageView);
+		}
+		framebufferCreateInfo.renderPass = contextInfo.camera.usesStencilLoading() ? 
 			allRenderPasses.renderPassStencilLoading : allRenderPasses.renderPass;
 		framebufferCreateInfo.pAttachments = attachments.data();
 		framebufferCreateInfo.attachmentCount = attachments.size();
@@ -781,6 +1048,10 @@ void VulkanApplication::initForwardPipelinesVulkanImagesAndFramebuffers() {
 		}
 	}
 }
+const std::vector<VulkanImage>& VulkanApplication::getForwardOutputImages() const {
+	return contextInfo.camera.subpassHoleFill ? subpassHoleFill.outputImages : forwardPipelinesVulkanImages;
+}
+
 uint32_t VulkanApplication::getForwardPipelineIndexFromTextureMapFlags(const uint32_t textureMapFlags) {
 	for (uint32_t i = 0; i < textureMapFlagsToForwardPipelineIndex.size(); ++i) {
 		if ((textureMapFlags & textureMapFlagsToForwardPipelineIndex[i]) == textureMapFlags) {
@@ -806,13 +1077,30 @@ void VulkanApplication::destroyOffScreenRenderTargets() {
 		image.destroyVulkanImage(contextInfo);
 		//depthImage destroyed before this call
 	}
+	subpassHoleFill.destroyOutputImages(contextInfo);
 
 	//dont need to do the last one since it refers to the swap chain
-	for (uint32_t i = 0; i < postProcessPipelines.size() - 1; ++i) {
-		for (auto& image : postProcessPipelines[i].outputImages) {
-			image.destroyVulkanImage(contextInfo);
+	for (auto& pipelines : postProcessPipelines) {
+		for (uint32_t i = 0; i < pipelines.size() - 1; ++i) {
+			for (auto& image : pipelines[i].outputImages) {
+				image.destroyVulkanImage(contextInfo);
+			}
 		}
 	}
+	//slot memory the outputs were aliased into and the frame's pp command buffers
+	for (auto& graph : postProcessGraphs) {
+		graph.destroy(contextInfo);
+	}
+	postProcessTimer.destroyQueryPool(contextInfo);
+
+	if (distortionLUTCleanUp) {
+		distortionLUT.destroyVulkanImage(contextInfo);
+		distortionLUTCleanUp = false;
+	}
+	if (holeFillClassificationCleanUp) {
+		holeFillClassification.destroyVulkanImage(contextInfo);
+		holeFillClassificationCleanUp = false;
+	}
 
 	////dont need to do the last one since it refers to the swap chain
 	if (contextInfo.camera.timewarpCleanUp) {
@@ -821,6 +1109,7 @@ void VulkanApplication::destroyOffScreenRenderTargets() {
 				image.destroyVulkanImage(contextInfo);
 			}
 		}
+		timeWarpGraph.destroy(contextInfo);
 		contextInfo.camera.timewarpCleanUp = false;
 	}
 }
@@ -835,8 +1124,12 @@ void VulkanApplication::destroyPipelines() {
 	for (auto& pipeline : forwardPipelines) {
 		pipeline.destroyVulkanPipeline(contextInfo);
 	}
-	for (auto& pipeline : postProcessPipelines) {
-		pipeline.destroyVulkanPipeline(contextInfo);
+	contextInfo.hiddenAreaMesh.destroyPipeline(contextInfo);
+	subpassHoleFill.destroyPipeline(contextInfo);
+	for (auto& pipelines : postProcessPipelines) {
+		for (auto& pipeline : pipelines) {
+			pipeline.destroyVulkanPipeline(contextInfo);
+		}
 	}
 	if (contextInfo.camera.timewarpCleanUp) {
 		for (auto& pipeline : timeWarpPipelines) {
@@ -864,6 +1157,8 @@ void VulkanApplication::recreateSwapChain() {
 	allocateGlobalCommandBuffers();//primary for forward render pass
 
 	createPipelines();
+	//new pp output images, nothing to reproject from
+	contextInfo.camera.resetTemporalHistory();
 }
 
 
@@ -902,7 +1197,7 @@ void VulkanApplication::initWindow() {
 
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
-	window = glfwCreateWindow(hmdWidth, hmdHeight, "VulkanVR", nullptr, nullptr);
+	window = glfwCreateWindow(HmdProfile::get().width, HmdProfile::get().height, "VulkanVR", nullptr, nullptr);
 	if (!window) {
 		glfwTerminate();
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create glfw window!";
@@ -975,6 +1270,28 @@ void VulkanApplication::GLFW_MouseButtonCallback(GLFWwindow * window, int button
 }
 
 void VulkanApplication::GLFW_KeyCallback(GLFWwindow * window, int key, int scanmode, int action, int mods) {
+	//keys that act once per press, the ones polled in processInputAndUpdateFPS repeat every frame they're held
+	if (action != GLFW_PRESS) {
+		return;
+	}
+	VulkanApplication* app = reinterpret_cast<VulkanApplication*>(glfwGetWindowUserPointer(window));
+	if (key == GLFW_KEY_N && app->postProcessGraphs.size() > 1 && !app->distortionABTest) {
+		//every technique's chain is already recorded, the next frame submits another one
+		app->distortionTechnique = (app->distortionTechnique + 1) % app->postProcessGraphs.size();
+		std::cout << "\nDistortion technique: " << distortionTechniques_PostProcessPipelines[app->distortionTechnique].first;
+	}
+	if (key == GLFW_KEY_G && app->contextInfo.camera.vrmode && !app->contextInfo.camera.timewarp) {
+		//fused time warp + barrel/aberration present stage vs the two stage chain, T makes the time warp pipelines with it
+		app->fusedTimeWarp = !app->fusedTimeWarp;
+		std::cout << "\nTime warp: " << (app->fusedTimeWarp ? "fused time warp + barrel/aberration" : "time warp, barrel/aberration");
+	}
+	if (key == GLFW_KEY_J && app->postProcessGraphs.size() > 1 && !app->distortionABTest) {
+		//techniques take turns and get timed, selectPostProcessChain prints them and keeps the cheapest at the end
+		app->distortionABTest = true;
+		app->distortionABFrame = 0;
+		app->postProcessTimer.resetTotals();
+		std::cout << "\nDistortion A/B timing...";
+	}
 }
 
 void VulkanApplication::GLFW_ScrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
@@ -982,11 +1299,125 @@ void VulkanApplication::GLFW_ScrollCallback(GLFWwindow* window, double xoffset,
 	app->contextInfo.camera.processScrollAndUpdateView(yoffset);
 }
 
+bool VulkanApplication::getPPMeshType(const std::vector<std::string>& shaderPaths, MESHTYPE& out_meshtype) {
+	const std::string& vertShaderPath = shaderPaths[0];
+	if (shaderPaths.size() == 1) {
+		return false;//compute stage, just the .comp
+	}
+	if (PostProcessPipeline::getGeometry(vertShaderPath) != PP_GEOMETRY_MESH) {
+		return false;
+	}
+	if (std::find(preCalcVertexShaders_PostProcessPipelines.begin(), preCalcVertexShaders_PostProcessPipelines.end(),
+		vertShaderPath) != preCalcVertexShaders_PostProcessPipelines.end())
+	{
+		out_meshtype = MESHTYPE::NDCBARRELMESH_PRECALC;
+	} else if (std::find(gridVertexShaders_PostProcessPipelines.begin(), gridVertexShaders_PostProcessPipelines.end(),
+		vertShaderPath) != gridVertexShaders_PostProcessPipelines.end())
+	{
+		out_meshtype = MESHTYPE::NDCBARRELMESH;
+	} else {
+		out_meshtype = MESHTYPE::NDCTRIANGLE;
+	}
+	return true;
+}
+
+std::vector<Mesh> VulkanApplication::getPPMeshes(const std::vector<std::string>& shaderPaths) {
+	MESHTYPE meshtype;
+	if (!getPPMeshType(shaderPaths, meshtype)) {
+		return {};
+	}
+	if (meshtype == MESHTYPE::NDCBARRELMESH_PRECALC) {
+		return { ndcBarrelMesh_PreCalc[0], ndcBarrelMesh_PreCalc[1] };
+	} else if (meshtype == MESHTYPE::NDCBARRELMESH) {
+		return { ndcBarrelMesh[0], ndcBarrelMesh[1] };
+	}
+	return { ndcTriangle, ndcTriangle };
+}
+
 void VulkanApplication::createPPMeshes() {
-	ndcTriangle = Mesh(contextInfo, MESHTYPE::NDCTRIANGLE);//ndc triangle for post processing
-	ndcBarrelMesh[0] = Mesh(contextInfo, MESHTYPE::NDCBARRELMESH, 0);
-	ndcBarrelMesh[1] = Mesh(contextInfo, MESHTYPE::NDCBARRELMESH, 1);
-	ndcBarrelMesh_PreCalc[0] = Mesh(contextInfo, MESHTYPE::NDCBARRELMESH_PRECALC, 0);
-	ndcBarrelMesh_PreCalc[1] = Mesh(contextInfo, MESHTYPE::NDCBARRELMESH_PRECALC, 1);
-	ndcPixelPoints = Mesh(contextInfo, MESHTYPE::NDCPIXELPOINTS);
+	//only the meshes some configured pp or time warp stage draws (time warp can be toggled on later),
+	//the default procedural vertex shaders need none of them
+	bool needed[4] = { false, false, false, false };//indexed by MESHTYPE
+	MESHTYPE meshtype;
+	for (const auto& stage : allShaders_PostProcessPipelines) {
+		if (getPPMeshType(std::get<0>(stage), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	for (const auto& stage : fusedShaders_PostProcessPipelines) {
+		if (getPPMeshType(std::get<0>(stage), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	for (const auto& stage : computeShaders_PostProcessPipelines) {
+		if (getPPMeshType(std::get<0>(stage), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	for (const auto& stage : distortedShaders_PostProcessPipelines) {
+		if (getPPMeshType(std::get<0>(stage), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	for (const auto& technique : distortionTechniques_PostProcessPipelines) {
+		if (getPPMeshType(std::get<0>(technique.second), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	for (const auto& stage : allShaders_TimeWarpPipelines) {
+		if (getPPMeshType(std::get<0>(stage), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	for (const auto& stage : fusedShaders_TimeWarpPipelines) {
+		if (getPPMeshType(std::get<0>(stage), meshtype)) {
+			needed[static_cast<uint32_t>(meshtype)] = true;
+		}
+	}
+	const bool needTriangle = needed[static_cast<uint32_t>(MESHTYPE::NDCTRIANGLE)];
+	const bool needGrid = needed[static_cast<uint32_t>(MESHTYPE::NDCBARRELMESH)];
+	const bool needPreCalc = needed[static_cast<uint32_t>(MESHTYPE::NDCBARRELMESH_PRECALC)];
+
+	//cpu side of every needed pp mesh as parallel tasks (msvc's std::async runs them on the concrt thread pool),
+	//right eyes come from the left ones, then all the uploads go in one submit
+	std::vector<std::future<void>> builds;
+	if (needTriangle) {
+		builds.push_back(std::async(std::launch::async, [this] {
+			ndcTriangle.build(contextInfo, MESHTYPE::NDCTRIANGLE);//ndc triangle for post processing
+		}));
+	}
+	if (needGrid) {
+		builds.push_back(std::async(std::launch::async, [this] {
+			//the grid doesn't depend on the eye, ppBarrelAbMesh2.vert warps it by camIndex
+			ndcBarrelMesh[0].build(contextInfo, MESHTYPE::NDCBARRELMESH, 0);
+			ndcBarrelMesh[1] = ndcBarrelMesh[0];
+		}));
+	}
+	if (needPreCalc) {
+		builds.push_back(std::async(std::launch::async, [this] {
+			ndcBarrelMesh_PreCalc[0].build(contextInfo, MESHTYPE::NDCBARRELMESH_PRECALC, 0);
+			if (ndcBarrelMesh_PreCalc[0].mappedVertices) {//both eyes are in the HmdBakeBundle
+				ndcBarrelMesh_PreCalc[1].build(contextInfo, MESHTYPE::NDCBARRELMESH_PRECALC, 1);
+			} else {
+				ndcBarrelMesh_PreCalc[1].mirrorToRightEye(ndcBarrelMesh_PreCalc[0]);
+			}
+		}));
+	}
+	for (auto& build : builds) {
+		build.get();//rethrows anything a task threw
+	}
+
+	std::vector<StagedUpload> uploads;
+	if (needTriangle) {
+		ndcTriangle.queueUploads(contextInfo, uploads);
+	}
+	if (needGrid) {
+		ndcBarrelMesh[0].queueUploads(contextInfo, uploads);
+		ndcBarrelMesh[1].queueUploads(contextInfo, uploads);
+	}
+	if (needPreCalc) {
+		ndcBarrelMesh_PreCalc[0].queueUploads(contextInfo, uploads);
+		ndcBarrelMesh_PreCalc[1].queueUploads(contextInfo, uploads);
+	}
+	VulkanBuffer::submitUploads(contextInfo, uploads);
 }
@@ -13,6 +13,9 @@
 #include "VulkanDescriptor.h"
 #include "VulkanGraphicsPipeline.h"
 #include "PostProcessPipeline.h"
+#include "PostProcessGraph.h"
+#include "PostProcessTimer.h"
+#include "SubpassHoleFill.h"
 #include "VulkanImage.h"
 #include "VulkanBuffer.h"
 #include "Model.h"
@@ -73,11 +76,14 @@ private:
 	
 	//camera
 	bool firstmouse = true;
-	float lastX = hmdWidth / 2.f;
-	float lastY = hmdHeight / 2.f;
+	float lastX = HmdProfile::get().width / 2.f;
+	float lastY = HmdProfile::get().height / 2.f;
 
     VkBuffer uniformBuffer;
     VkDeviceMemory uniformBufferMemory;
+	//TemporalHoleFillUBO, temporalCheckerStencil only
+	VkBuffer temporalUniformBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory temporalUniformBufferMemory = VK_NULL_HANDLE;
 
 
 	//Vulkan components
@@ -85,16 +91,31 @@ private:
 	std::vector<VulkanGraphicsPipeline> forwardPipelines;
 	std::vector<VkFramebuffer> forwardPipelinesFramebuffers;
 	std::vector<VulkanImage> forwardPipelinesVulkanImages;
+	SubpassHoleFill subpassHoleFill;//forward render pass's second subpass and its stored output (camera.subpassHoleFill)
 	VulkanRenderPass allRenderPasses;
-	std::vector<PostProcessPipeline> postProcessPipelines;
+	std::vector<std::vector<PostProcessPipeline>> postProcessPipelines;//[chain][stage], chains after 0 only have their last stage, see createPostProcessChain
 	std::vector<PostProcessPipeline> timeWarpPipelines;
+	std::vector<PostProcessGraph> postProcessGraphs;//[chain] postProcessPipelines' barriers, aliased targets and per frame command buffers
+	PostProcessTimer postProcessTimer;//gpu ms of each chain
+	PostProcessGraph timeWarpGraph;//same for timeWarpPipelines, recorded once the warped frame is known
+	VulkanImage distortionLUT;//baked barrel/aberration source uv's, only made if a pp stage samples it
+	bool distortionLUTCleanUp = false;
+	VulkanImage holeFillClassification;//baked per pixel hole fill classes of the vr stencil, only made if a pp stage samples it
+	bool holeFillClassificationCleanUp = false;
+	bool fusedPostProcess = startFusedPostProcess && !temporalCheckerStencil;//see fusedShaders_PostProcessPipelines
+	bool fusedTimeWarp = startFusedTimeWarp;//see fusedShaders_TimeWarpPipelines
+	bool computePostProcess = startComputePostProcess && !temporalCheckerStencil;//see computeShaders_PostProcessPipelines
+	uint32_t distortionTechnique = startDistortionTechnique;//see distortionTechniques_PostProcessPipelines
+	bool distortionABTest = startDistortionABTest;
+	uint32_t distortionABFrame = 0;//frames into the A/B timing
+	uint32_t lastPostProcessChain = 0;//chain submitted last frame
 
 
 	//post process meshes
+	//only built if a configured pp stage's vertex shader draws it (procedural ones draw from gl_VertexIndex, see GlobalSettings.h)
 	Mesh ndcTriangle;
 	Mesh ndcBarrelMesh[2];//0 left, 1 right
 	Mesh ndcBarrelMesh_PreCalc[2];
-	Mesh ndcPixelPoints;//needed for timewarp
 
 	//used for fps tracker
 	double oldtime = 0.f;
@@ -109,7 +130,7 @@ private:
 
 	//semphores for communication bewteen various stages
 	VkSemaphore imageAvailableSemaphore;
-	VkSemaphore forwardRenderFinishedSemaphore;
+	VkSemaphore renderFinishedSemaphore;//the frame's one submit (forward and pp, or time warp) is done
 
 private:
 	//void createRadialStencilMask();
@@ -123,7 +144,10 @@ private:
 
 	void loadModels();
 	void updateUniformBuffer();
+	void updateTemporalUniformBuffer(const uint32_t imageIndex);
 	void initForwardPipelinesVulkanImagesAndFramebuffers();
+	//what the pp and time warp chains sample as the forward image: SubpassHoleFill's output with camera.subpassHoleFill
+	const std::vector<VulkanImage>& getForwardOutputImages() const;
 
 
 	//drawing
@@ -136,6 +160,10 @@ private:
 	//helper
 	uint32_t getForwardPipelineIndexFromTextureMapFlags(const uint32_t textureMapFlags);
 	void VulkanApplication::createPPMeshes();
+	//which pp mesh a stage's vertex shader draws, false if it is procedural
+	static bool getPPMeshType(const std::vector<std::string>& shaderPaths, MESHTYPE& out_meshtype);
+	//per eye meshes a pp graph pass draws, empty if procedural
+	std::vector<Mesh> getPPMeshes(const std::vector<std::string>& shaderPaths);
 
 	//callbacks
 	void setupDebugCallback();
@@ -158,6 +186,26 @@ private:
 	void endRecordingPrimary(const uint32_t imageIndex);
 	void createPipelines();
 	void createTimeWarpPipelines();
+	//distortedShaders_PostProcessPipelines when the camera renders straight into lens space (Camera::usesDistortedForward),
+	//otherwise computeShaders_PostProcessPipelines, fusedShaders_PostProcessPipelines or allShaders_PostProcessPipelines,
+	//whichever computePostProcess and fusedPostProcess select (compute first, if contextInfo.swapChainStorage)
+	const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& getPostProcessStages() const;
+	//the chains postProcessPipelines are built for: getPostProcessStages, or if that is allShaders_PostProcessPipelines
+	//one per distortionTechniques_PostProcessPipelines entry with it as the last stage (the stages before it are shared)
+	std::vector< std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> > > getPostProcessChains() const;
+	//postProcessPipelines[chain] and postProcessGraphs[chain]. chain 0 builds every stage, the others only their last one
+	//and record chain 0's pipelines (and its outputs) for the stages before it
+	void createPostProcessChain(const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& postProcessStages,
+		const uint32_t chain);
+	//the stage's typeFlags, or PipelineType::HOLES_ONLY for a first stage in holesOnlyFragShaders_PostProcessPipelines with
+	//camera.subpassHoleFill (it fills the holes of SubpassHoleFill's output in place)
+	PipelineType getPostProcessStageType(const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& postProcessStages,
+		const uint32_t stage) const;
+	//chain this frame submits: distortionTechnique's, or the A/B timing's turn (which ends it and keeps the cheapest)
+	uint32_t selectPostProcessChain();
+	//fusedShaders_TimeWarpPipelines or allShaders_TimeWarpPipelines, whichever fusedTimeWarp selects
+	const std::vector< std::tuple<std::vector<std::string>, uint32_t, uint32_t> >& getTimeWarpStages() const;
+	std::vector<VulkanImage> getStaticPostProcessInputs(const std::vector<std::string>& shaderPaths, const uint32_t numImageSamplers);
 
 	void createSemaphores();
 	void destroyPipelines();
@@ -63,46 +63,60 @@ void VulkanBuffer::createUniformBuffer(const VulkanContextInfo& contextInfo, con
 	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, uniformBuffer, uniformBufferMemory);
 }
 
-void VulkanBuffer::createVertexBuffer(const VulkanContextInfo& contextInfo,
-	const std::vector<Vertex>& vertices, VkBuffer& vertexBuffer, VkDeviceMemory& vertexBufferMemory) 
+void VulkanBuffer::createDeviceLocalBuffer(const VulkanContextInfo& contextInfo, const void* srcData, const VkDeviceSize& bufferSize,
+	const VkBufferUsageFlags& usage, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
 {
-	VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+	std::vector<StagedUpload> uploads;
+	queueDeviceLocalBuffer(contextInfo, uploads, srcData, bufferSize, usage, buffer, bufferMemory);
+	submitUploads(contextInfo, uploads);
+}
 
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
-	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+void VulkanBuffer::queueDeviceLocalBuffer(const VulkanContextInfo& contextInfo, std::vector<StagedUpload>& uploads,
+	const void* srcData, const VkDeviceSize& bufferSize, const VkBufferUsageFlags& usage, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+{
+	StagedUpload upload;
+	upload.size = bufferSize;
+	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, upload.stagingBuffer, upload.stagingBufferMemory);
 
 	void* data;
-	vkMapMemory(contextInfo.device, stagingBufferMemory, 0, bufferSize, 0, &data);
-	memcpy(data, vertices.data(), (size_t)bufferSize);
-	vkUnmapMemory(contextInfo.device, stagingBufferMemory);
+	vkMapMemory(contextInfo.device, upload.stagingBufferMemory, 0, bufferSize, 0, &data);
+	memcpy(data, srcData, (size_t)bufferSize);
+	vkUnmapMemory(contextInfo.device, upload.stagingBufferMemory);
+
+	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, bufferMemory);
+	upload.dstBuffer = buffer;
+	uploads.push_back(upload);
+}
+
+void VulkanBuffer::submitUploads(const VulkanContextInfo& contextInfo, std::vector<StagedUpload>& uploads) {
+	if (uploads.empty()) { return; }
+	VkCommandBuffer commandBuffer = beginSingleTimeCommands(contextInfo);
 
-	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexBufferMemory);
+	for (const StagedUpload& upload : uploads) {
+		VkBufferCopy copyRegion = {};
+		copyRegion.size = upload.size;
+		vkCmdCopyBuffer(commandBuffer, upload.stagingBuffer, upload.dstBuffer, 1, &copyRegion);
+	}
+
+	endSingleTimeCommands(contextInfo, commandBuffer);
 
-	copyBuffer(contextInfo, stagingBuffer, vertexBuffer, bufferSize);
+	for (const StagedUpload& upload : uploads) {
+		vkDestroyBuffer(contextInfo.device, upload.stagingBuffer, nullptr);
+		vkFreeMemory(contextInfo.device, upload.stagingBufferMemory, nullptr);
+	}
+	uploads.clear();
+}
 
-	vkDestroyBuffer(contextInfo.device, stagingBuffer, nullptr);
-	vkFreeMemory(contextInfo.device, stagingBufferMemory, nullptr);
+void VulkanBuffer::createVertexBuffer(const VulkanContextInfo& contextInfo,
+	const std::vector<Vertex>& vertices, VkBuffer& vertexBuffer, VkDeviceMemory& vertexBufferMemory) 
+{
+	VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+	createDeviceLocalBuffer(contextInfo, vertices.data(), bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferMemory);
 }
 
 void VulkanBuffer::createIndexBuffer(const VulkanContextInfo& contextInfo, 
 	const std::vector<uint32_t>& indices, VkBuffer& indexBuffer, VkDeviceMemory& indexBufferMemory)
 {
 	VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
-	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-	void* data;
-	vkMapMemory(contextInfo.device, stagingBufferMemory, 0, bufferSize, 0, &data);
-	memcpy(data, indices.data(), (size_t)bufferSize);
-	vkUnmapMemory(contextInfo.device, stagingBufferMemory);
-
-	createBuffer(contextInfo, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexBufferMemory);
-
-	copyBuffer(contextInfo, stagingBuffer, indexBuffer, bufferSize);
-
-	vkDestroyBuffer(contextInfo.device, stagingBuffer, nullptr);
-	vkFreeMemory(contextInfo.device, stagingBufferMemory, nullptr);
+	createDeviceLocalBuffer(contextInfo, indices.data(), bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferMemory);
 }
@@ -7,6 +7,14 @@
 #include "Vertex.h"
 class VulkanContexInfo;
 
+//one staged copy into a device local buffer, see VulkanBuffer::queueDeviceLocalBuffer
+struct StagedUpload {
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingBufferMemory;
+	VkBuffer dstBuffer;
+	VkDeviceSize size;
+};
+
 
 //VkBuffer buffers are required in various places, just bundle the methods into a static class (namespaced functions)
 class VulkanBuffer {
@@ -20,6 +28,17 @@ public:
 	static void createUniformBuffer(const VulkanContextInfo& contextInfo, const VkDeviceSize& bufferSize,
 		VkBuffer& uniformBuffer, VkDeviceMemory& uniformBufferMemory);
 
+	//staged copy of size bytes from data (any host memory, e.g. a mapped file) into a new device local buffer
+	static void createDeviceLocalBuffer(const VulkanContextInfo& contextInfo, const void* data, const VkDeviceSize& size,
+		const VkBufferUsageFlags& usage, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+
+	//creates the device local buffer and fills a staging copy of data now, the copy itself is recorded by submitUploads
+	static void queueDeviceLocalBuffer(const VulkanContextInfo& contextInfo, std::vector<StagedUpload>& uploads,
+		const void* data, const VkDeviceSize& size, const VkBufferUsageFlags& usage, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+
+	//records every queued copy into one command buffer, one submit and wait for all of them, frees the staging buffers
+	static void submitUploads(const VulkanContextInfo& contextInfo, std::vector<StagedUpload>& uploads);
+
 	static void createVertexBuffer(const VulkanContextInfo& contextInfo, const std::vector<Vertex>& vertices,
 		VkBuffer& vertexBuffer, VkDeviceMemory& vertexBufferMemory);
 
@@ -8,6 +8,7 @@
 #include <set>
 #include <algorithm>
 #include <array>
+#include <future>
 
 
 VulkanContextInfo::VulkanContextInfo() {
@@ -25,6 +26,7 @@ VulkanContextInfo::VulkanContextInfo(GLFWwindow* window)
 	createSwapChainImageViews();
 	determineDepthFormat();
 	camera = Camera();
+	bakeBundle.open(*this);
 	initStencils();
 	createDepthImage();
 }
@@ -199,6 +201,14 @@ void VulkanContextInfo::createLogicalDevice() {
 
 	VkPhysicalDeviceFeatures deviceFeatures = {};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
+	//compute pp stages writing the swapchain (swapChainStorage)
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	storageImageWriteWithoutFormat = supportedFeatures.shaderStorageImageWriteWithoutFormat == VK_TRUE;
+	deviceFeatures.shaderStorageImageWriteWithoutFormat = supportedFeatures.shaderStorageImageWriteWithoutFormat;
+	//direct to distorted forward rendering splits the forward triangles by projected edge length (DistortedForward)
+	tessellationShader = supportedFeatures.tessellationShader == VK_TRUE;
+	deviceFeatures.tessellationShader = supportedFeatures.tessellationShader;
 
 	VkDeviceCreateInfo createInfo = {};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -231,19 +241,58 @@ void VulkanContextInfo::acquireDeviceQueues() {
 }
 
 void VulkanContextInfo::initStencils() {
+	//every quality level's mask stays resident (QuadMask, a few KB each) so changing quality just expands one
+	//in createDepthImage. decoded from the bakeBundle, generated if it doesn't have them.
+	//called again when vrStencilType changes (the bundle has every type). alternateMask is only kept with temporalCheckerStencil
 	radialDensityMasks.resize(camera.numQualitySettings);
+	std::vector<std::future<void>> stencils;
+	for (int i = 0; i < camera.numQualitySettings; ++i) {
+		stencils.push_back(std::async(std::launch::async, [this, i] {
+			PreMadeStencil& stencil			= radialDensityMasks[i];
+			stencil							= PreMadeStencil(*this,i, vrStencilType);
+			const uint32_t bakeIndex		= static_cast<uint32_t>(vrStencilType)*camera.numQualitySettings + i;
+			const HmdBakeEntry* baked		= bakeBundle.find(HmdBakeType::STENCIL, bakeIndex);
+			const HmdBakeEntry* bakedAlt	= bakeBundle.find(HmdBakeType::STENCIL_ALTERNATE, bakeIndex);
+			if (baked && (!temporalCheckerStencil || bakedAlt)) {
+				stencil.mask.deserialize(bakeBundle.getData(*baked), baked->size);
+				if (temporalCheckerStencil) {
+					stencil.alternateMask.deserialize(bakeBundle.getData(*bakedAlt), bakedAlt->size);
+				}
+			} else {
+				stencil.generateMask(*this);
+			}
+			if (!temporalCheckerStencil) {
+				stencil.alternateMask = QuadMask();
+			}
+		}));
+	}
+	size_t residentBytes = 0;
 	for (int i = 0; i < camera.numQualitySettings; ++i) {
-		radialDensityMasks[i]			= PreMadeStencil(*this,i, StencilType::RadialDensityMask);
+		stencils[i].get();
+		residentBytes += radialDensityMasks[i].mask.getSizeBytes();
+		residentBytes += temporalCheckerStencil ? radialDensityMasks[i].alternateMask.getSizeBytes() : 0;
+	}
+	std::cout << "\nStencil masks resident: " << residentBytes << " bytes for " << camera.numQualitySettings << " quality levels";
+	if (hiddenAreaMeshMask) {
+		hiddenAreaMesh.createMeshes(*this);
 	}
 }
 
 void VulkanContextInfo::createDepthImage() {
 	determineDepthFormat();
-	if (!camera.vrmode || (camera.vrmode && camera.timewarp)) {
+	if (!camera.vrmode || (camera.vrmode && camera.timewarp) || camera.usesHiddenAreaMesh()) {
 		depthImage = VulkanImage(IMAGETYPE::DEPTH, camera.renderTargetExtent, depthFormat, *this, std::string(""));
 	} else {
-		const int i = camera.qualityIndex;
-		depthImage = VulkanImage(IMAGETYPE::DEPTH, camera.renderTargetExtent, depthFormat, *this, radialDensityMasks[i].filename);
+		const PreMadeStencil& stencil = radialDensityMasks[camera.qualityIndex];
+		if (generateStencilOnGPU && StencilGenerator::supports(stencil)) {
+			stencilGenerator.create(*this);
+			depthImage = stencilGenerator.createDepthImage(*this, stencil);
+		} else {
+			//expanded straight into the upload's staging buffer, see initStencils
+			const VkExtent2D stencilExtent = { stencil.width, stencil.height };
+			depthImage = VulkanImage(IMAGETYPE::DEPTH, stencilExtent, depthFormat, *this,
+				[&stencil](uint8_t* out_mask) { stencil.expandMask(out_mask); });
+		}
 	}
 }
 
@@ -359,6 +408,15 @@ void VulkanContextInfo::createSwapChain(GLFWwindow* window) {
 	createInfo.imageArrayLayers = 1;
 	createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, surfaceFormat.format, &formatProperties);
+	swapChainStorage = storageImageWriteWithoutFormat &&
+		(surfaceDetails.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) &&
+		(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
+	if (swapChainStorage) {
+		createInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+	}
+
 
 	if (graphicsFamily != presentFamily) {
 		uint32_t queueFamilyIndices[] = { (uint32_t)graphicsFamily, (uint32_t)presentFamily };
@@ -498,6 +556,18 @@ void VulkanContextInfo::destroyCommandPools() {
 	}
 }
 
+void VulkanContextInfo::destroyBakeBundle() {
+	bakeBundle.close();
+}
+
+void VulkanContextInfo::destroyStencilGenerator() {
+	stencilGenerator.destroy(*this);
+}
+
+void VulkanContextInfo::destroyHiddenAreaMesh() {
+	hiddenAreaMesh.destroy(*this);
+}
+
 void VulkanContextInfo::destroyDevice() {
 	vkDestroyDevice(device, nullptr);
 }
@@ -9,6 +9,9 @@
 #include "VulkanImage.h"
 #include "Camera.h"
 #include "PreMadeStencil.h"
+#include "HmdBakeBundle.h"
+#include "StencilGenerator.h"
+#include "HiddenAreaMesh.h"
 //This class holds vulkan things that get created once and are used for the duration of the program
 //these things generally won't change across typical vulkan applications
 
@@ -47,9 +50,17 @@ public:
 	//depth image 
 	VkFormat depthFormat;
 	VulkanImage depthImage;
-	std::vector<PreMadeStencil> radialDensityMasks;
+	StencilType vrStencilType = startVrStencilType;
+	std::vector<PreMadeStencil> radialDensityMasks;//vrStencilType's mask per quality level, see initStencils
 	std::vector<PreMadeStencil> preCalcBarrelSamplingMasks;
 
+	//stencils, precalc barrel meshes and distortion lut baked for the HmdProfile, memory mapped
+	HmdBakeBundle bakeBundle;
+	//generateStencilOnGPU
+	StencilGenerator stencilGenerator;
+	//hiddenAreaMeshMask, every quality level's rectangles (its pipeline is made with the forward pipelines)
+	HiddenAreaMesh hiddenAreaMesh;
+
 	//Camera
 	Camera camera;
 
@@ -63,6 +74,11 @@ public:
     VkExtent2D swapChainExtent;
     std::vector<VkImageView> swapChainImageViews;
     std::vector<VkFramebuffer> swapChainFramebuffers;
+    //swapchain images are also storage images, a compute pp stage can be the present stage (PipelineType::COMPUTE).
+    //needs the surface usage, storage on its format and storage writes without a format qualifier (bgra has none)
+    bool swapChainStorage = false;
+    bool storageImageWriteWithoutFormat = false;//the device feature, enabled when supported
+    bool tessellationShader = false;//the device feature, enabled when supported (DistortedForward, per vertex warp without it)
 
 private:
 	std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
@@ -121,6 +137,9 @@ public:
 	void destroySwapChainImageViews();
 	void destroySwapChain();
 	void destroyCommandPools();
+	void destroyBakeBundle();
+	void destroyStencilGenerator();
+	void destroyHiddenAreaMesh();
 	void destroyDevice();
 	void destroySurface();
 	void destroyInstance();
@@ -11,11 +11,20 @@ std::vector<VkDescriptorSetLayout> VulkanDescriptor::layoutTypes =
 std::vector<VkDescriptorSetLayout>(VulkanDescriptor::MAX_IMAGESAMPLERS + 1);
 
 std::vector<VkDescriptorSetLayout> VulkanDescriptor::postProcessLayoutTypes = 
-std::vector<VkDescriptorSetLayout>(1);
+std::vector<VkDescriptorSetLayout>(VulkanDescriptor::MAX_POSTPROCESS_IMAGESAMPLERS);
 
 std::vector<VkDescriptorSetLayout> VulkanDescriptor::timeWarpLayoutTypes = 
 std::vector<VkDescriptorSetLayout>(1);
 
+std::vector<VkDescriptorSetLayout> VulkanDescriptor::temporalHoleFillLayoutTypes = 
+std::vector<VkDescriptorSetLayout>(1);
+
+std::vector<VkDescriptorSetLayout> VulkanDescriptor::computeLayoutTypes = 
+std::vector<VkDescriptorSetLayout>(VulkanDescriptor::MAX_POSTPROCESS_IMAGESAMPLERS);
+
+std::vector<VkDescriptorSetLayout> VulkanDescriptor::inputAttachmentLayoutTypes = 
+std::vector<VkDescriptorSetLayout>(1);
+
 bool VulkanDescriptor::layoutsInitialized = false;
 
 void initDescriptorSetLayoutTypes(const VulkanContextInfo& contextInfo) {
@@ -81,23 +90,26 @@ void initDescriptorSetLayoutTypes(const VulkanContextInfo& contextInfo) {
 		//good use case would be deferred: gather info into gbuffers in sub0 then use those for lighting calc in sub1
 		//since you only need frag-to-frag reading
 		std::vector<VkDescriptorSetLayoutBinding> bindings = {};
-		//BasicColorRenderTarget
-		VkDescriptorSetLayoutBinding postProcessInputBinding = {};
-		postProcessInputBinding.binding = 0;
-		postProcessInputBinding.descriptorCount = 1;
-		postProcessInputBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		postProcessInputBinding.pImmutableSamplers = nullptr;
-		postProcessInputBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-		bindings.push_back(postProcessInputBinding);
-		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
-		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-		layoutInfo.pBindings = bindings.data();
+		//BasicColorRenderTarget at 0, extra inputs (e.g. the baked distortion lut) after it
+		//postProcessLayoutTypes[i] has i+1 image samplers
+		for (uint32_t i = 0; i < VulkanDescriptor::MAX_POSTPROCESS_IMAGESAMPLERS; ++i) {
+			VkDescriptorSetLayoutBinding postProcessInputBinding = {};
+			postProcessInputBinding.binding = i;
+			postProcessInputBinding.descriptorCount = 1;
+			postProcessInputBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			postProcessInputBinding.pImmutableSamplers = nullptr;
+			postProcessInputBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+			bindings.push_back(postProcessInputBinding);
+			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutInfo.pBindings = bindings.data();
 
-		if (vkCreateDescriptorSetLayout(contextInfo.device, &layoutInfo, nullptr, &VulkanDescriptor::postProcessLayoutTypes[0]) != VK_SUCCESS) {
-			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set layout!";
-			throw std::runtime_error(ss.str());
+			if (vkCreateDescriptorSetLayout(contextInfo.device, &layoutInfo, nullptr, &VulkanDescriptor::postProcessLayoutTypes[i]) != VK_SUCCESS) {
+				std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set layout!";
+				throw std::runtime_error(ss.str());
+			}
 		}
 	}//end post process layouts
 
@@ -141,6 +153,109 @@ void initDescriptorSetLayoutTypes(const VulkanContextInfo& contextInfo) {
 		}
 	}//end time warp layouts
 
+
+	//////////////////////////////////////////////////////
+	//// Temporal Hole Fill Layout ///////////////////////
+	//// 3 image samplers then a UBO in fragment shader ////
+	//////////////////////////////////////////////////////
+	{
+		std::vector<VkDescriptorSetLayoutBinding> bindings = {};
+
+		//forward image, previous output, depth
+		for (uint32_t i = 0; i < 3; ++i) {
+			VkDescriptorSetLayoutBinding samplerLayoutBinding = {};
+			samplerLayoutBinding.binding = i;
+			samplerLayoutBinding.descriptorCount = 1;
+			samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			samplerLayoutBinding.pImmutableSamplers = nullptr;
+			samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+			bindings.push_back(samplerLayoutBinding);
+		}
+
+		VkDescriptorSetLayoutBinding uboLayoutBinding = {};
+		uboLayoutBinding.binding = 3;
+		uboLayoutBinding.descriptorCount = 1;
+		uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		uboLayoutBinding.pImmutableSamplers = nullptr;
+		uboLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		bindings.push_back(uboLayoutBinding);
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+		if (vkCreateDescriptorSetLayout(contextInfo.device, &layoutInfo, nullptr, &VulkanDescriptor::temporalHoleFillLayoutTypes[0]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set layout!";
+			throw std::runtime_error(ss.str());
+		}
+	}//end temporal hole fill layouts
+
+
+	//////////////////////////////////////////////////////
+	//// Compute Post Process Layouts ////////////////////
+	//// 1 to 2 image samplers then the storage image ////
+	//////////////////////////////////////////////////////
+	{
+		//computeLayoutTypes[i] has i+1 image samplers, same inputs as postProcessLayoutTypes[i],
+		//the stage writes its output image at binding i+1 instead of through a framebuffer
+		for (uint32_t i = 0; i < VulkanDescriptor::MAX_POSTPROCESS_IMAGESAMPLERS; ++i) {
+			std::vector<VkDescriptorSetLayoutBinding> bindings = {};
+			for (uint32_t j = 0; j <= i; ++j) {
+				VkDescriptorSetLayoutBinding samplerLayoutBinding = {};
+				samplerLayoutBinding.binding = j;
+				samplerLayoutBinding.descriptorCount = 1;
+				samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				samplerLayoutBinding.pImmutableSamplers = nullptr;
+				samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+				bindings.push_back(samplerLayoutBinding);
+			}
+
+			VkDescriptorSetLayoutBinding storageLayoutBinding = {};
+			storageLayoutBinding.binding = i + 1;
+			storageLayoutBinding.descriptorCount = 1;
+			storageLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			storageLayoutBinding.pImmutableSamplers = nullptr;
+			storageLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+			bindings.push_back(storageLayoutBinding);
+
+			VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+			layoutInfo.pBindings = bindings.data();
+			if (vkCreateDescriptorSetLayout(contextInfo.device, &layoutInfo, nullptr, &VulkanDescriptor::computeLayoutTypes[i]) != VK_SUCCESS) {
+				std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set layout!";
+				throw std::runtime_error(ss.str());
+			}
+		}
+	}//end compute post process layouts
+
+
+	//////////////////////////////////////////////////////
+	//// Input Attachment Layout /////////////////////////
+	//// 1 input attachment in fragment shader ///////////
+	//////////////////////////////////////////////////////
+	{
+		VkDescriptorSetLayoutBinding inputLayoutBinding = {};
+		inputLayoutBinding.binding = 0;
+		inputLayoutBinding.descriptorCount = 1;
+		inputLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+		inputLayoutBinding.pImmutableSamplers = nullptr;
+		inputLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &inputLayoutBinding;
+		if (vkCreateDescriptorSetLayout(contextInfo.device, &layoutInfo, nullptr, &VulkanDescriptor::inputAttachmentLayoutTypes[0]) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set layout!";
+			throw std::runtime_error(ss.str());
+		}
+	}//end input attachment layouts
+
 	VulkanDescriptor::layoutsInitialized = true;
 }
 
@@ -177,6 +292,27 @@ void VulkanDescriptor::createDescriptorSetLayoutPostProcessTimeWarp(const Vulkan
 	descriptorSetLayout = VulkanDescriptor::timeWarpLayoutTypes[0];
 }
 
+void VulkanDescriptor::createDescriptorSetLayoutPostProcessTemporal(const VulkanContextInfo& contextInfo) {
+	if (VulkanDescriptor::layoutsInitialized == false) 
+		initDescriptorSetLayoutTypes(contextInfo);
+
+	descriptorSetLayout = VulkanDescriptor::temporalHoleFillLayoutTypes[0];
+}
+
+void VulkanDescriptor::createDescriptorSetLayoutPostProcessCompute(const VulkanContextInfo& contextInfo) {
+	if (VulkanDescriptor::layoutsInitialized == false) 
+		initDescriptorSetLayoutTypes(contextInfo);
+
+	descriptorSetLayout = VulkanDescriptor::computeLayoutTypes[numImageSamplers-1];
+}
+
+void VulkanDescriptor::createDescriptorSetLayoutInputAttachment(const VulkanContextInfo& contextInfo) {
+	if (VulkanDescriptor::layoutsInitialized == false) 
+		initDescriptorSetLayoutTypes(contextInfo);
+
+	descriptorSetLayout = VulkanDescriptor::inputAttachmentLayoutTypes[0];
+}
+
 void VulkanDescriptor::createDescriptorPool(const VulkanContextInfo& contextInfo) {
 	std::vector<VkDescriptorPoolSize> poolSizes(numImageSamplers+1);
 	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -239,6 +375,65 @@ void VulkanDescriptor::createDescriptorPoolPostProcessTimeWarp(const VulkanConte
 	}
 }
 
+void VulkanDescriptor::createDescriptorPoolPostProcessTemporal(const VulkanContextInfo& contextInfo) {
+	std::vector<VkDescriptorPoolSize> poolSizes(numImageSamplers+1);
+	for (int i = 0; i < numImageSamplers; ++i) {
+		poolSizes[i].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSizes[i].descriptorCount = 1;
+	}
+	poolSizes[numImageSamplers].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	poolSizes[numImageSamplers].descriptorCount = 1;
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = 1;
+
+	if (vkCreateDescriptorPool(contextInfo.device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set pool!";
+		throw std::runtime_error(ss.str());
+	}
+}
+
+void VulkanDescriptor::createDescriptorPoolPostProcessCompute(const VulkanContextInfo& contextInfo) {
+	std::vector<VkDescriptorPoolSize> poolSizes(numImageSamplers+1);
+	for (int i = 0; i < numImageSamplers; ++i) {
+		poolSizes[i].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSizes[i].descriptorCount = 1;
+	}
+	poolSizes[numImageSamplers].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	poolSizes[numImageSamplers].descriptorCount = 1;
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = 1;
+
+	if (vkCreateDescriptorPool(contextInfo.device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set pool!";
+		throw std::runtime_error(ss.str());
+	}
+}
+
+void VulkanDescriptor::createDescriptorPoolInputAttachment(const VulkanContextInfo& contextInfo) {
+	VkDescriptorPoolSize poolSize = {};
+	poolSize.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	poolSize.descriptorCount = 1;
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	poolInfo.maxSets = 1;
+
+	if (vkCreateDescriptorPool(contextInfo.device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create descriptor set pool!";
+		throw std::runtime_error(ss.str());
+	}
+}
+
 void VulkanDescriptor::createDescriptorSet(const VulkanContextInfo& contextInfo, const VkBuffer& uniformBuffer,
 	const int sizeofUBOstruct, const Mesh* const mesh)
 {
@@ -297,7 +492,7 @@ void VulkanDescriptor::createDescriptorSet(const VulkanContextInfo& contextInfo,
 }
 
 void VulkanDescriptor::createDescriptorSetPostProcess(const VulkanContextInfo& contextInfo,
-	const std::vector<VulkanImage>& vulkanImages)
+	const std::vector<VulkanImage>& vulkanImages, const VkImageLayout inputLayout)
 {
 	VkDescriptorSetLayout layouts[] = { descriptorSetLayout };
 	VkDescriptorSetAllocateInfo allocInfo = {};
@@ -315,7 +510,7 @@ void VulkanDescriptor::createDescriptorSetPostProcess(const VulkanContextInfo& c
 	std::vector<VkDescriptorImageInfo> imageInfos(numImageSamplers);
 	for (int i = 0; i < numImageSamplers; ++i) {
 		VkDescriptorImageInfo imageInfo = {};
-		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; 
+		imageInfo.imageLayout = (i == 0) ? inputLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 		imageInfo.imageView = vulkanImages[i].imageView;
 		imageInfo.sampler	= vulkanImages[i].sampler;
 		imageInfos[i] = imageInfo;
@@ -411,6 +606,129 @@ void VulkanDescriptor::createDescriptorSetPostProcessTimeWarp(const VulkanContex
 	vkUpdateDescriptorSets(contextInfo.device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 }
 
+void VulkanDescriptor::createDescriptorSetPostProcessTemporal(const VulkanContextInfo& contextInfo,
+	const VulkanImage& forwardImage, const VulkanImage& historyImage, const VulkanImage& depthImage,
+	const VkBuffer& uniformBuffer, const int sizeofUBOstruct)
+{
+	VkDescriptorSetLayout layouts[] = { descriptorSetLayout };
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = layouts;
+
+	if (vkAllocateDescriptorSets(contextInfo.device, &allocInfo, &descriptorSet) != VK_SUCCESS) {
+		throw std::runtime_error("failed to allocate descriptor set!");
+	}
+
+	//all nearest clamp to edge, the depth goes through the forward image's sampler
+	std::vector<VkDescriptorImageInfo> imageInfos(numImageSamplers);
+	imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfos[0].imageView = forwardImage.imageView;
+	imageInfos[0].sampler = forwardImage.sampler;
+	imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfos[1].imageView = historyImage.imageView;
+	imageInfos[1].sampler = historyImage.sampler;
+	imageInfos[2].imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+	imageInfos[2].imageView = depthImage.depthSampleView != VK_NULL_HANDLE ? depthImage.depthSampleView : depthImage.imageView;
+	imageInfos[2].sampler = forwardImage.sampler;
+
+	VkDescriptorBufferInfo bufferInfo = {};
+	bufferInfo.buffer = uniformBuffer;
+	bufferInfo.offset = 0;
+	bufferInfo.range = sizeofUBOstruct;
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites(numImageSamplers+1);
+	for (int i = 0; i < numImageSamplers; ++i) {
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[i].dstSet = descriptorSet;
+		descriptorWrites[i].dstBinding = i;
+		descriptorWrites[i].dstArrayElement = 0;
+		descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[i].descriptorCount = 1;
+		descriptorWrites[i].pImageInfo = &imageInfos[i];
+	}
+	descriptorWrites[numImageSamplers].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrites[numImageSamplers].dstSet = descriptorSet;
+	descriptorWrites[numImageSamplers].dstBinding = numImageSamplers;
+	descriptorWrites[numImageSamplers].dstArrayElement = 0;
+	descriptorWrites[numImageSamplers].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	descriptorWrites[numImageSamplers].descriptorCount = 1;
+	descriptorWrites[numImageSamplers].pBufferInfo = &bufferInfo;
+
+	vkUpdateDescriptorSets(contextInfo.device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+void VulkanDescriptor::createDescriptorSetPostProcessCompute(const VulkanContextInfo& contextInfo,
+	const std::vector<VulkanImage>& vulkanImages, const VulkanImage& outputImage)
+{
+	VkDescriptorSetLayout layouts[] = { descriptorSetLayout };
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = layouts;
+
+	if (vkAllocateDescriptorSets(contextInfo.device, &allocInfo, &descriptorSet) != VK_SUCCESS) {
+		throw std::runtime_error("failed to allocate descriptor set!");
+	}
+
+	std::vector<VkDescriptorImageInfo> imageInfos(numImageSamplers+1);
+	for (int i = 0; i < numImageSamplers; ++i) {
+		imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfos[i].imageView = vulkanImages[i].imageView;
+		imageInfos[i].sampler = vulkanImages[i].sampler;
+	}
+	//the stage's command buffer moves it to GENERAL for the dispatch
+	imageInfos[numImageSamplers].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+	imageInfos[numImageSamplers].imageView = outputImage.imageView;
+	imageInfos[numImageSamplers].sampler = VK_NULL_HANDLE;
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites(numImageSamplers+1);
+	for (int i = 0; i < numImageSamplers+1; ++i) {
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[i].dstSet = descriptorSet;
+		descriptorWrites[i].dstBinding = i;
+		descriptorWrites[i].dstArrayElement = 0;
+		descriptorWrites[i].descriptorType = (i < numImageSamplers) ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		descriptorWrites[i].descriptorCount = 1;
+		descriptorWrites[i].pImageInfo = &imageInfos[i];
+	}
+
+	vkUpdateDescriptorSets(contextInfo.device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+void VulkanDescriptor::createDescriptorSetInputAttachment(const VulkanContextInfo& contextInfo, const VulkanImage& attachmentImage) {
+	VkDescriptorSetLayout layouts[] = { descriptorSetLayout };
+	VkDescriptorSetAllocateInfo allocInfo = {};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = layouts;
+
+	if (vkAllocateDescriptorSets(contextInfo.device, &allocInfo, &descriptorSet) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to allocate descriptor set!";
+		throw std::runtime_error(ss.str());
+	}
+
+	//input attachments have no sampler, the subpass's attachment reference says the layout
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfo.imageView = attachmentImage.imageView;
+	imageInfo.sampler = VK_NULL_HANDLE;
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = descriptorSet;
+	descriptorWrite.dstBinding = 0;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pImageInfo = &imageInfo;
+
+	vkUpdateDescriptorSets(contextInfo.device, 1, &descriptorWrite, 0, nullptr);
+}
+
 void VulkanDescriptor::determineNumImageSamplersAndTextureMapFlags(const Mesh* const mesh) {
 	if (mesh->diffuseindices.size() == 0) {
 		textureMapFlags |= HAS_NONE;
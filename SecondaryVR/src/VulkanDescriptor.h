@@ -35,6 +35,7 @@ public:
 	VkSampler sampler;
 
 	static const int MAX_IMAGESAMPLERS	= 4;
+	static const int MAX_POSTPROCESS_IMAGESAMPLERS = 2;
 	uint32_t textureMapFlags = 0;
 	int numImageSamplers = 0;
 
@@ -42,6 +43,9 @@ public:
 	static std::vector<VkDescriptorSetLayout> layoutTypes;
 	static std::vector<VkDescriptorSetLayout> postProcessLayoutTypes;
 	static std::vector<VkDescriptorSetLayout> timeWarpLayoutTypes;
+	static std::vector<VkDescriptorSetLayout> temporalHoleFillLayoutTypes;
+	static std::vector<VkDescriptorSetLayout> computeLayoutTypes;
+	static std::vector<VkDescriptorSetLayout> inputAttachmentLayoutTypes;
 
 public:
 	VulkanDescriptor();
@@ -58,13 +62,29 @@ public:
 	void createDescriptorSetLayoutPostProcessTimeWarp(const VulkanContextInfo& contextInfo);
 	void createDescriptorPoolPostProcess(const VulkanContextInfo& contextInfo);
 	void createDescriptorPoolPostProcessTimeWarp(const VulkanContextInfo& contextInfo);
+	void createDescriptorSetLayoutPostProcessTemporal(const VulkanContextInfo& contextInfo);
+	void createDescriptorPoolPostProcessTemporal(const VulkanContextInfo& contextInfo);
+	void createDescriptorSetLayoutPostProcessCompute(const VulkanContextInfo& contextInfo);
+	void createDescriptorPoolPostProcessCompute(const VulkanContextInfo& contextInfo);
+	void createDescriptorSetLayoutInputAttachment(const VulkanContextInfo& contextInfo);
+	void createDescriptorPoolInputAttachment(const VulkanContextInfo& contextInfo);
+	//inputLayout: vulkanImages[0]'s, GENERAL for PipelineType::HOLES_ONLY which renders to it too
 	void createDescriptorSetPostProcess(const VulkanContextInfo& contextInfo,
-		const std::vector<VulkanImage>& vulkanImages);
+		const std::vector<VulkanImage>& vulkanImages, const VkImageLayout inputLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 	//void createDescriptorSetPostProcessTimeWarp(const VulkanContextInfo& contextInfo,
 	//	const std::vector<VulkanImage>& vulkanImages, const VulkanImage& depthImage);
 	void createDescriptorSetPostProcessTimeWarp(const VulkanContextInfo& contextInfo,
 		const std::vector<VulkanImage>& vulkanImages, const VulkanImage& depthImage, const VkBuffer& uniformBuffer,
 		const int sizeofUBOstruct);
+	//ppStencilHoleFillTemporal.frag: this frame's forward image, the stage's previous output, the depth, then the ubo
+	void createDescriptorSetPostProcessTemporal(const VulkanContextInfo& contextInfo,
+		const VulkanImage& forwardImage, const VulkanImage& historyImage, const VulkanImage& depthImage,
+		const VkBuffer& uniformBuffer, const int sizeofUBOstruct);
+	//compute pp stages: the samplers like createDescriptorSetPostProcess, then outputImage as the storage image after them
+	void createDescriptorSetPostProcessCompute(const VulkanContextInfo& contextInfo,
+		const std::vector<VulkanImage>& vulkanImages, const VulkanImage& outputImage);
+	//SubpassHoleFill: the forward color as the subpass input attachment, read in the layout the render pass gives it
+	void createDescriptorSetInputAttachment(const VulkanContextInfo& contextInfo, const VulkanImage& attachmentImage);
 
 	void determineNumImageSamplersAndTextureMapFlags(const Mesh* const mesh);
 
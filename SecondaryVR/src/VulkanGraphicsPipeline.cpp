@@ -3,6 +3,7 @@
 
 #include "Utils.h"
 #include "Model.h";
+#include "DistortedForward.h"
 
 #include <stdexcept>
 #include <iostream>
@@ -47,26 +48,41 @@ void VulkanGraphicsPipeline::allocateCommandBuffers(const VulkanContextInfo& con
 void VulkanGraphicsPipeline::createGraphicsPipeline(const VulkanRenderPass& renderPass,
 	const VulkanContextInfo& contextInfo, const VkDescriptorSetLayout* setLayouts)
 {
-	auto vertShaderCode = readFile(shaderpaths[0]);
-	auto fragShaderCode = readFile(shaderpaths[1]);
-
-	VkShaderModule vertShaderModule = createShaderModule(vertShaderCode, contextInfo);
-	VkShaderModule fragShaderModule = createShaderModule(fragShaderCode, contextInfo);
-
-	VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
-	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertShaderStageInfo.module = vertShaderModule;
-	vertShaderStageInfo.pName = "main";
-	
-	VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
-	fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragShaderStageInfo.module = fragShaderModule;
-	fragShaderStageInfo.pName = "main";
-
-	//TODO: for dynamic amount of shaders, turn into vector pass .data to the pipeline info at the bottom
-	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
+	//direct to distorted forward rendering (DistortedForward): forwardDistorted.tesc/.tese between the vert and frag,
+	//or forwardDistorted.vert for forward.vert where the device has no tessellation shaders
+	const bool distorted = contextInfo.camera.usesDistortedForward();
+	const bool tessellated = distorted && contextInfo.tessellationShader;
+	std::vector<std::pair<std::string, VkShaderStageFlagBits>> stagePaths = {
+		{ distorted && !tessellated ? distortedVertexShader_ForwardPipelines : shaderpaths[0], VK_SHADER_STAGE_VERTEX_BIT },
+		{ shaderpaths[1], VK_SHADER_STAGE_FRAGMENT_BIT },
+	};
+	if (tessellated) {
+		stagePaths.insert(stagePaths.begin() + 1, std::make_pair(distortedTessShaders_ForwardPipelines[0], VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT));
+		stagePaths.insert(stagePaths.begin() + 2, std::make_pair(distortedTessShaders_ForwardPipelines[1], VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT));
+	}
+
+	//the hmd and tessellation constants, the undistorted shaders declare none
+	const DistortedForwardSpecializationData specializationData = DistortedForward::getSpecializationData(contextInfo);
+	const std::vector<VkSpecializationMapEntry> specializationEntries = DistortedForward::getSpecializationMapEntries();
+	VkSpecializationInfo specializationInfo = {};
+	specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+	specializationInfo.pMapEntries = specializationEntries.data();
+	specializationInfo.dataSize = sizeof(DistortedForwardSpecializationData);
+	specializationInfo.pData = &specializationData;
+
+	std::vector<VkShaderModule> shaderModules;
+	std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+	for (const auto& stagePath : stagePaths) {
+		shaderModules.push_back(createShaderModule(readFile(stagePath.first), contextInfo));
+
+		VkPipelineShaderStageCreateInfo shaderStageInfo = {};
+		shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStageInfo.stage = stagePath.second;
+		shaderStageInfo.module = shaderModules.back();
+		shaderStageInfo.pName = "main";
+		shaderStageInfo.pSpecializationInfo = distorted ? &specializationInfo : nullptr;
+		shaderStages.push_back(shaderStageInfo);
+	}
 
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
 	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -81,9 +97,14 @@ void VulkanGraphicsPipeline::createGraphicsPipeline(const VulkanRenderPass& rend
 
 	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
 	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	inputAssembly.topology = tessellated ? VK_PRIMITIVE_TOPOLOGY_PATCH_LIST : VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 	inputAssembly.primitiveRestartEnable = VK_FALSE;
 
+	//the mesh's triangles are the patches
+	VkPipelineTessellationStateCreateInfo tessellationState = {};
+	tessellationState.sType = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
+	tessellationState.patchControlPoints = 3;
+
 	VkViewport viewport = {};
 	viewport.x = 0.0f;
 	viewport.y = 0.0f;
@@ -130,8 +151,8 @@ void VulkanGraphicsPipeline::createGraphicsPipeline(const VulkanRenderPass& rend
 	//NEW
 	depthStencil.stencilTestEnable = VK_TRUE;
 	VkStencilOpState stencilOpState = {}; uint32_t mask = 0x1;
-	stencilOpState.compareMask = mask;//AND'd with reference val to get final compare val to test against stencil val
-	stencilOpState.reference = mask;
+	stencilOpState.compareMask = mask;//AND'd with reference val to get final compare val to test against stencil val (dynamic)
+	stencilOpState.reference = mask;//(dynamic)
 	stencilOpState.writeMask = mask;
 	stencilOpState.compareOp = VK_COMPARE_OP_EQUAL; 
 	//what to do with stored stencil val in these events
@@ -172,7 +193,9 @@ void VulkanGraphicsPipeline::createGraphicsPipeline(const VulkanRenderPass& rend
 	std::vector<VkDynamicState> dynamicStates;
 	dynamicStates.push_back( VK_DYNAMIC_STATE_VIEWPORT );
 	dynamicStates.push_back( VK_DYNAMIC_STATE_SCISSOR );
-	//dynamicStates.push_back( VK_DYNAMIC_STATE_STENCIL_REFERENCE );//also: compare_mask?
+	//which stencil bit is tested changes every frame with temporalCheckerStencil (Camera::getStencilTestBit)
+	dynamicStates.push_back( VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK );
+	dynamicStates.push_back( VK_DYNAMIC_STATE_STENCIL_REFERENCE );
 	dynamicInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 	dynamicInfo.pNext = nullptr;
 	dynamicInfo.flags = 0;
@@ -194,17 +217,18 @@ void VulkanGraphicsPipeline::createGraphicsPipeline(const VulkanRenderPass& rend
 
 	VkGraphicsPipelineCreateInfo pipelineInfo = {};
 	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineInfo.stageCount = 2;
-	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+	pipelineInfo.pStages = shaderStages.data();
 	pipelineInfo.pVertexInputState = &vertexInputInfo;
 	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pTessellationState = tessellated ? &tessellationState : nullptr;
 	pipelineInfo.pViewportState = &viewportState;
 	pipelineInfo.pRasterizationState = &rasterizer;
 	pipelineInfo.pMultisampleState = &multisampling;
 	pipelineInfo.pDepthStencilState = &depthStencil;
 	pipelineInfo.pColorBlendState = &colorBlending;
 	pipelineInfo.layout = pipelineLayout;
-	pipelineInfo.renderPass = (contextInfo.camera.vrmode && contextInfo.camera.useStencil)? renderPass.renderPassStencilLoading : renderPass.renderPass;
+	pipelineInfo.renderPass = contextInfo.camera.usesStencilLoading() ? renderPass.renderPassStencilLoading : renderPass.renderPass;
 	pipelineInfo.subpass = 0;
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 	pipelineInfo.pDynamicState = &dynamicInfo;
@@ -214,8 +238,9 @@ void VulkanGraphicsPipeline::createGraphicsPipeline(const VulkanRenderPass& rend
 		throw std::runtime_error(ss.str());
 	}
 
-	vkDestroyShaderModule(contextInfo.device, fragShaderModule, nullptr);
-	vkDestroyShaderModule(contextInfo.device, vertShaderModule, nullptr);
+	for (const VkShaderModule shaderModule : shaderModules) {
+		vkDestroyShaderModule(contextInfo.device, shaderModule, nullptr);
+	}
 }
 
 VkShaderModule VulkanGraphicsPipeline::createShaderModule( const std::vector<char>& code, 
@@ -252,6 +277,10 @@ void VulkanGraphicsPipeline::recordCommandBufferSecondary(const VkCommandBufferI
 
 	vkCmdBindDescriptorSets(commandBuffers[imageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &mesh.descriptor.descriptorSet, 0, nullptr);
 
+	const uint32_t stencilTestBit = contextInfo.camera.getStencilTestBit();
+	vkCmdSetStencilCompareMask(commandBuffers[imageIndex], VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+	vkCmdSetStencilReference(commandBuffers[imageIndex], VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+
 	const int camIndex = 0;
 	const ForwardPushConstant pushconstant = { model.modelMatrix, camIndex << 1 | model.isDynamic };
 	vkCmdPushConstants(commandBuffers[imageIndex], pipelineLayout, ForwardPushConstant::stages, 0, sizeof(ForwardPushConstant), (const void*)&pushconstant);
@@ -319,6 +348,10 @@ void VulkanGraphicsPipeline::recordCommandBufferPrimary(const VkCommandBuffer& p
 
 	vkCmdBindDescriptorSets(primaryCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &mesh.descriptor.descriptorSet, 0, nullptr);
 
+	const uint32_t stencilTestBit = contextInfo.camera.getStencilTestBit();
+	vkCmdSetStencilCompareMask(primaryCmdBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+	vkCmdSetStencilReference(primaryCmdBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencilTestBit);
+
 	const uint32_t camIndex = 0;
 	const ForwardPushConstant pushconstant = { model.modelMatrix, uint32_t( camIndex << 1 | model.isDynamic )};
 	vkCmdPushConstants(primaryCmdBuffer, pipelineLayout, ForwardPushConstant::stages, 0, sizeof(ForwardPushConstant), (const void*)&pushconstant);
@@ -28,7 +28,8 @@ class Model;
 struct ForwardPushConstant {
 	glm::mat4 modelMatrix;
 	uint32_t toggleFlags;
-	static const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT;
+	//forwardDistorted.tese warps with the camera index (DistortedForward)
+	static const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
 };
 
 class VulkanGraphicsPipeline {
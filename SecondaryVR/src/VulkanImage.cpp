@@ -29,13 +29,37 @@ VulkanImage::VulkanImage(const IMAGETYPE& imagetype, const VkExtent2D& extent, c
 		createDepthImage(contextInfo);
 	} else if (imagetype == IMAGETYPE::TEXTURE) {
 		createTextureImage(contextInfo);
-	} else if (imagetype == IMAGETYPE::COLOR_ATTACHMENT) {
+	} else if (imagetype == IMAGETYPE::COLOR_ATTACHMENT || imagetype == IMAGETYPE::STORAGE) {
 		createColorAttachmentImage(contextInfo);
 		//sceneImageStage->createImages(VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	} else if (imagetype == IMAGETYPE::TRANSIENT_ATTACHMENT) {//no sampler, it's never sampled
+		createImage(contextInfo);
+		createImageView(contextInfo);
 	}
 }
 
 
+VulkanImage::VulkanImage(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
+	const VulkanContextInfo& contextInfo, const std::function<void(uint8_t*)>& writeStencilMask)
+	: extent(extent), format(format), imagetype(imagetype), importedStencil(true)
+{
+	uploadStaticStencilMask(contextInfo, writeStencilMask);
+}
+
+VulkanImage::VulkanImage(const VkExtent2D& extent, const VkFormat& format, const void* pixels, const VkDeviceSize imageSize,
+	const VulkanContextInfo& contextInfo)
+	: extent(extent), format(format), imagetype(IMAGETYPE::LUT)
+{
+	createLUTImage(contextInfo, pixels, imageSize);
+}
+
+VulkanImage::VulkanImage(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
+	const VulkanContextInfo& contextInfo, const VkDeviceMemory& slotMemory)
+	: extent(extent), format(format), imagetype(imagetype), imageMemory(slotMemory), aliasedMemory(true)
+{
+	createColorAttachmentImage(contextInfo);
+}
+
 VulkanImage::~VulkanImage() {
 }
 
@@ -48,6 +72,9 @@ void VulkanImage::operator=(const VulkanImage& rightside) {
 	imagetype		= rightside.imagetype;
 	filepath		= rightside.filepath;
 	sampler			= rightside.sampler;
+	importedStencil	= rightside.importedStencil;
+	depthSampleView	= rightside.depthSampleView;
+	aliasedMemory	= rightside.aliasedMemory;
 
 	//no need for cascading assigment so no need to return *this
 }
@@ -59,46 +86,23 @@ void VulkanImage::createColorAttachmentImage(const VulkanContextInfo& contextInf
 }
 
 void VulkanImage::createDepthImage(const VulkanContextInfo& contextInfo) {
-	if (filepath != std::string("")) {
-		createDepthImageWithImportedStaticStencilMask(contextInfo);
-	} else {
-		createImage(contextInfo);
-		createImageView(contextInfo);
-		transitionImageLayout(contextInfo, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-	}
+	createImage(contextInfo);
+	createImageView(contextInfo);
+	transitionImageLayout(contextInfo, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 }
-void VulkanImage::createDepthImageWithImportedStaticStencilMask(const VulkanContextInfo& contextInfo) {
-	int texWidth, texHeight, texChannels;
-	stbi_uc* pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-	extent.width = texWidth;
-	extent.height = texHeight;
-	VkDeviceSize imageSize = extent.width * extent.height * 1;
 
-
-	if (!pixels) {
-		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to load texture image!";
-		throw std::runtime_error(ss.str());
-	}
+void VulkanImage::uploadStaticStencilMask(const VulkanContextInfo& contextInfo, const std::function<void(uint8_t*)>& writeStencilMask) {
+	VkDeviceSize imageSize = extent.width * extent.height * 1;
 
 	VkBuffer stagingBuffer;
 	VkDeviceMemory stagingBufferMemory;
 	createBuffer(contextInfo, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
 
-	//convert to single bytes and test print to see if image got through ok
-	uint8_t* stencilBytes = new uint8_t[extent.width*extent.height];
-	for (int index = 0; index < extent.width*extent.height; ++index) {
-		stencilBytes[index] = pixels[index * 4];
-	}
-
-
-
 	void* data;
 	vkMapMemory(contextInfo.device, stagingBufferMemory, 0, imageSize, 0, &data);
-	memcpy(data, stencilBytes, static_cast<size_t>(imageSize));
+	writeStencilMask(static_cast<uint8_t*>(data));
 	vkUnmapMemory(contextInfo.device, stagingBufferMemory);
 
-	stbi_image_free(pixels);
-	free(stencilBytes);
 	createImage(contextInfo);
 
 	transitionImageLayout(contextInfo, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true);
@@ -148,21 +152,47 @@ void VulkanImage::createTextureImage(const VulkanContextInfo& contextInfo) {
 	createImageSampler(contextInfo);
 }
 
-void VulkanImage::createImage(const VulkanContextInfo& contextInfo) {
+void VulkanImage::createLUTImage(const VulkanContextInfo& contextInfo, const void* pixels, const VkDeviceSize imageSize) {
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingBufferMemory;
+	createBuffer(contextInfo, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+	void* data;
+	vkMapMemory(contextInfo.device, stagingBufferMemory, 0, imageSize, 0, &data);
+	memcpy(data, pixels, static_cast<size_t>(imageSize));
+	vkUnmapMemory(contextInfo.device, stagingBufferMemory);
+
+	createImage(contextInfo);
+
+	transitionImageLayout(contextInfo, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	copyBufferToImage(contextInfo, stagingBuffer, image, extent.width, extent.height, VK_IMAGE_ASPECT_COLOR_BIT);
+	transitionImageLayout(contextInfo, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	vkDestroyBuffer(contextInfo.device, stagingBuffer, nullptr);
+	vkFreeMemory(contextInfo.device, stagingBufferMemory, nullptr);
+
+	createImageView(contextInfo);
+
+	createImageSampler(contextInfo);
+}
+
+VkImageCreateInfo VulkanImage::getImageCreateInfo(const VulkanContextInfo& contextInfo, VkMemoryPropertyFlags& out_properties) const {
 	//VkThings
 	VkImageTiling tiling;
 	VkImageUsageFlags usage;
 	VkMemoryPropertyFlags properties;
 	if (imagetype == IMAGETYPE::DEPTH) {
 		tiling = VK_IMAGE_TILING_OPTIMAL;
-		if (filepath != std::string("")) {
-			usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		if (importedStencil) {
+			//src: StencilGenerator::report reads the stencil back
+			usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+				(temporalCheckerStencil ? VK_IMAGE_USAGE_SAMPLED_BIT : 0x0);
 		} else {
 			usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
-				(contextInfo.camera.timewarp ? VK_IMAGE_USAGE_SAMPLED_BIT : 0x0);
+				((contextInfo.camera.timewarp || temporalCheckerStencil) ? VK_IMAGE_USAGE_SAMPLED_BIT : 0x0);
 		}
 		properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-	} else if (imagetype == IMAGETYPE::TEXTURE) {
+	} else if (imagetype == IMAGETYPE::TEXTURE || imagetype == IMAGETYPE::LUT) {
 		tiling = VK_IMAGE_TILING_OPTIMAL;
 		usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 		properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -170,7 +200,17 @@ void VulkanImage::createImage(const VulkanContextInfo& contextInfo) {
 		tiling = VK_IMAGE_TILING_OPTIMAL;
 		usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 		properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	} else if (imagetype == IMAGETYPE::STORAGE) {
+		tiling = VK_IMAGE_TILING_OPTIMAL;
+		usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	} else if (imagetype == IMAGETYPE::TRANSIENT_ATTACHMENT) {
+		//createImage asks for lazily allocated memory if the driver has it, tilers may then never back it at all
+		tiling = VK_IMAGE_TILING_OPTIMAL;
+		usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 	}
+	out_properties = properties;
 
 
 	VkImageCreateInfo imageInfo = {};
@@ -187,14 +227,51 @@ void VulkanImage::createImage(const VulkanContextInfo& contextInfo) {
 	imageInfo.usage = usage;
 	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	return imageInfo;
+}
+
+VkMemoryRequirements VulkanImage::getMemoryRequirements(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
+	const VulkanContextInfo& contextInfo)
+{
+	VulkanImage probe;
+	probe.imagetype = imagetype;
+	probe.extent = extent;
+	probe.format = format;
+	VkMemoryPropertyFlags properties;
+	const VkImageCreateInfo imageInfo = probe.getImageCreateInfo(contextInfo, properties);
 
+	VkImage image;
 	if (vkCreateImage(contextInfo.device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create image!";
 		throw std::runtime_error(ss.str());
 	}
+	VkMemoryRequirements memRequirements;
+	vkGetImageMemoryRequirements(contextInfo.device, image, &memRequirements);
+	vkDestroyImage(contextInfo.device, image, nullptr);
+	return memRequirements;
+}
+
+void VulkanImage::createImage(const VulkanContextInfo& contextInfo) {
+	VkMemoryPropertyFlags properties;
+	const VkImageCreateInfo imageInfo = getImageCreateInfo(contextInfo, properties);
+
+	if (vkCreateImage(contextInfo.device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create image!";
+		throw std::runtime_error(ss.str());
+	}
+
+	if (aliasedMemory) {//the slot was sized for every image that shares it
+		vkBindImageMemory(contextInfo.device, image, imageMemory, 0);
+		return;
+	}
 
 	VkMemoryRequirements memRequirements;
 	vkGetImageMemoryRequirements(contextInfo.device, image, &memRequirements);
+	if (imagetype == IMAGETYPE::TRANSIENT_ATTACHMENT &&
+		hasMemoryType(contextInfo.physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT))
+	{
+		properties = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+	}
 
 	VkMemoryAllocateInfo allocInfo = {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -217,7 +294,9 @@ void VulkanImage::createImageView(const VulkanContextInfo& contextInfo) {
 		} else {
 			aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
 		}
-	} else if (imagetype == IMAGETYPE::TEXTURE || imagetype == IMAGETYPE::COLOR_ATTACHMENT) {
+	} else if (imagetype == IMAGETYPE::TEXTURE || imagetype == IMAGETYPE::COLOR_ATTACHMENT || imagetype == IMAGETYPE::LUT ||
+		imagetype == IMAGETYPE::STORAGE || imagetype == IMAGETYPE::TRANSIENT_ATTACHMENT)
+	{
 		aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
 	}
 
@@ -236,6 +315,11 @@ void VulkanImage::createImageView(const VulkanContextInfo& contextInfo) {
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create image view!";
 		throw std::runtime_error(ss.str());
 	}
+
+	//a sampled view can only have one aspect
+	if (imagetype == IMAGETYPE::DEPTH && hasStencilComponent(format) && temporalCheckerStencil) {
+		depthSampleView = createImageView(image, format, VK_IMAGE_ASPECT_DEPTH_BIT, contextInfo.device);
+	}
 }
 
 void VulkanImage::transitionImageLayout(const VulkanContextInfo& contextInfo, 
@@ -317,7 +401,7 @@ void VulkanImage::createImageSampler(const VulkanContextInfo& contextInfo) {
 	samplerInfo.unnormalizedCoordinates = VK_FALSE;
 	samplerInfo.compareEnable = VK_FALSE;
 	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-	if (imagetype == IMAGETYPE::COLOR_ATTACHMENT) {
+	if (imagetype == IMAGETYPE::COLOR_ATTACHMENT || imagetype == IMAGETYPE::LUT || imagetype == IMAGETYPE::STORAGE) {
 		samplerInfo.magFilter = VK_FILTER_NEAREST;
 		samplerInfo.minFilter = VK_FILTER_NEAREST;
 		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
@@ -366,7 +450,7 @@ VkImageView VulkanImage::createImageView(const VkImage& image, const VkFormat& f
 }
 
 void VulkanImage::destroyVulkanImage(const VulkanContextInfo& contextInfo) {
-	if (imagetype == IMAGETYPE::TEXTURE) {
+	if (imagetype == IMAGETYPE::TEXTURE || imagetype == IMAGETYPE::LUT) {
 		destroySampler(contextInfo);
 	}
 	destroyImageView(contextInfo);
@@ -382,6 +466,8 @@ void VulkanImage::destroySampler(const VulkanContextInfo& contextInfo) {
 void VulkanImage::destroyImageView(const VulkanContextInfo& contextInfo) {
 	if(imageView != VK_NULL_HANDLE)
 		vkDestroyImageView(contextInfo.device, imageView, nullptr);
+	if(depthSampleView != VK_NULL_HANDLE)
+		vkDestroyImageView(contextInfo.device, depthSampleView, nullptr);
 }
 
 void VulkanImage::destroyImage(const VulkanContextInfo& contextInfo) {
@@ -390,6 +476,6 @@ void VulkanImage::destroyImage(const VulkanContextInfo& contextInfo) {
 }
 
 void VulkanImage::destroyImageMemory(const VulkanContextInfo& contextInfo) {
-	if(imageMemory != VK_NULL_HANDLE)
+	if(imageMemory != VK_NULL_HANDLE && !aliasedMemory)
 		vkFreeMemory(contextInfo.device, imageMemory, nullptr);
 }
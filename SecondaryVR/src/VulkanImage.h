@@ -6,13 +6,15 @@
 
 
 #include <string>
+#include <functional>
 
 //TODO: turn into base image class and subclasses
 
 class VulkanContextInfo;
 
 enum class IMAGETYPE {
-	DEPTH=0, TEXTURE, COLOR_ATTACHMENT
+	DEPTH=0, TEXTURE, COLOR_ATTACHMENT, LUT, STORAGE,
+	TRANSIENT_ATTACHMENT//color attachment only read as an input attachment in its render pass, never stored (SubpassHoleFill)
 };
 
 class VulkanImage {
@@ -28,18 +30,40 @@ public:
 	std::string filepath;
 	VkSampler sampler;
 
+	//depth image whose stencil aspect is uploaded from a static mask (see PreMadeStencil::expandMask)
+	bool importedStencil = false;
+	//depth aspect only view of a depth/stencil image, what ppStencilHoleFillTemporal.frag samples (temporalCheckerStencil)
+	VkImageView depthSampleView = VK_NULL_HANDLE;
+	//imageMemory belongs to a PostProcessGraph memory slot shared with other transient targets, bound but not allocated or freed here
+	bool aliasedMemory = false;
+
 public:
 	VulkanImage();
 	VulkanImage(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
 		const VulkanContextInfo& contextInfo, std::string& filepath = std::string(""));
+	//DEPTH: writeStencilMask fills the extent.width*extent.height mask bytes straight into the upload's staging memory
+	VulkanImage(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
+		const VulkanContextInfo& contextInfo, const std::function<void(uint8_t*)>& writeStencilMask);
+	//LUT: texels uploaded from memory, sampled with texelFetch (nearest, clamp)
+	VulkanImage(const VkExtent2D& extent, const VkFormat& format, const void* pixels, const VkDeviceSize imageSize,
+		const VulkanContextInfo& contextInfo);
+	//COLOR_ATTACHMENT or STORAGE bound at offset 0 of slotMemory (a PostProcessGraph slot) instead of its own allocation
+	VulkanImage(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
+		const VulkanContextInfo& contextInfo, const VkDeviceMemory& slotMemory);
 	~VulkanImage();
 
 	void operator=(const VulkanImage& rightside);
-	void createColorAttachmentImage(const VulkanContextInfo& contextInfo);
+	void createColorAttachmentImage(const VulkanContextInfo& contextInfo);//also STORAGE, written by compute pp stages
 	void createDepthImage(const VulkanContextInfo& contextInfo);
 	void createTextureImage(const VulkanContextInfo& contextInfo);
-	void createDepthImageWithImportedStaticStencilMask(const VulkanContextInfo& contextInfo);
+	void createLUTImage(const VulkanContextInfo& contextInfo, const void* pixels, const VkDeviceSize imageSize);
+	void uploadStaticStencilMask(const VulkanContextInfo& contextInfo, const std::function<void(uint8_t*)>& writeStencilMask);
 	void createImage(const VulkanContextInfo& contextInfo);
+	//createImage's usage and tiling for the imagetype, out_properties the memory it wants
+	VkImageCreateInfo getImageCreateInfo(const VulkanContextInfo& contextInfo, VkMemoryPropertyFlags& out_properties) const;
+	//what an image of this type, extent and format would need, made and destroyed without memory (PostProcessGraph slot sizes)
+	static VkMemoryRequirements getMemoryRequirements(const IMAGETYPE& imagetype, const VkExtent2D& extent, const VkFormat& format,
+		const VulkanContextInfo& contextInfo);
 	void createImageView(const VulkanContextInfo& contextInfo);
 	void transitionImageLayout(const VulkanContextInfo& contextInfo,
 		const VkImageLayout oldLayout, const VkImageLayout newLayout, bool fillStencil = false);
@@ -20,6 +20,7 @@ void VulkanRenderPass::createRenderPasses(const VulkanContextInfo& contextInfo)
 	createRenderPassForwardStencilLoading(contextInfo);
 	createRenderPassPostProcess(contextInfo);
 	createRenderPassPostProcessPresent(contextInfo);
+	createRenderPassPostProcessHoles(contextInfo);
 }
 
 void VulkanRenderPass::createRenderPassForward(const VulkanContextInfo& contextInfo) {
@@ -41,7 +42,8 @@ void VulkanRenderPass::createRenderPassForward(const VulkanContextInfo& contextI
 	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;//(can actually be don't care)
 	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	//ppStencilHoleFillTemporal.frag samples it
+	depthAttachment.finalLayout = temporalCheckerStencil ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
 	VkAttachmentReference colorAttachmentRef = {};
 	colorAttachmentRef.attachment = 0;
@@ -79,6 +81,12 @@ void VulkanRenderPass::createRenderPassForward(const VulkanContextInfo& contextI
 	dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
 
 	dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+	if (temporalCheckerStencil) {//hiddenAreaMeshMask renders the alternating stencil in this pass, same as renderPassStencilLoading
+		dependencies[1].srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependencies[1].dstStageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
+		dependencies[1].dependencyFlags = 0;
+	}
 	//example:
 	//dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
 	//dependencies[0].dstSubpass = 0;
@@ -95,20 +103,7 @@ void VulkanRenderPass::createRenderPassForward(const VulkanContextInfo& contextI
 	//dependencies[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
 	//dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
-	std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
-	VkRenderPassCreateInfo renderPassInfo = {};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-	renderPassInfo.pAttachments = attachments.data();
-	renderPassInfo.subpassCount = 1;
-	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = dependencies.size();;
-	renderPassInfo.pDependencies = &dependencies[0];
-
-	if (vkCreateRenderPass(contextInfo.device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
-		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create render pass!";
-		throw std::runtime_error(ss.str());
-	}
+	createRenderPassForward(contextInfo, colorAttachment, depthAttachment, subpass, dependencies, renderPass);
 }
 
 void VulkanRenderPass::createRenderPassForwardStencilLoading(const VulkanContextInfo& contextInfo) {
@@ -126,11 +121,12 @@ void VulkanRenderPass::createRenderPassForwardStencilLoading(const VulkanContext
 	depthAttachment.format = contextInfo.depthFormat;
 	depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
 	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	//ppStencilHoleFillTemporal.frag reprojects the holes with the depth of the quads around them
+	depthAttachment.storeOp = temporalCheckerStencil ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;//allows us to read, 
 	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;//allows us keep around for the next frame, to read from later
 	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	depthAttachment.finalLayout = temporalCheckerStencil ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
 	VkAttachmentReference colorAttachmentRef = {};
 	colorAttachmentRef.attachment = 0;
@@ -164,18 +160,99 @@ void VulkanRenderPass::createRenderPassForwardStencilLoading(const VulkanContext
 	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
 	dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
 	dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+	if (temporalCheckerStencil) {//depth writes have to land before the hole fill's fragment shader reads them
+		dependencies[1].srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependencies[1].dstStageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
+		dependencies[1].dependencyFlags = 0;
+	}
 
-	std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+	createRenderPassForward(contextInfo, colorAttachment, depthAttachment, subpass, dependencies, renderPassStencilLoading);
+}
+
+void VulkanRenderPass::createRenderPassForward(const VulkanContextInfo& contextInfo, VkAttachmentDescription colorAttachment,
+	const VkAttachmentDescription& depthAttachment, const VkSubpassDescription& subpass,
+	std::array<VkSubpassDependency, 2> dependencies, VkRenderPass& out_renderPass)
+{
+	if (!contextInfo.camera.subpassHoleFill) {
+		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+		VkRenderPassCreateInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = dependencies.size();;
+		renderPassInfo.pDependencies = &dependencies[0];
+
+		if (vkCreateRenderPass(contextInfo.device, &renderPassInfo, nullptr, &out_renderPass) != VK_SUCCESS) {
+			std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create render pass!";
+			throw std::runtime_error(ss.str());
+		}
+		return;
+	}
+
+	//SubpassHoleFill: the forward color only lives for the render pass, subpass 1 reads it on tile
+	//and writes the rendered pixels to attachment 2, the only color the pp chain samples
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkAttachmentDescription outputAttachment = {};
+	outputAttachment.format = SubpassHoleFill::getOutputFormat(contextInfo);
+	outputAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	outputAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;//the holes stay black like the forward image's
+	outputAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	outputAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	outputAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	outputAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	outputAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;//what PostProcessGraph::forwardLayout expects
+
+	VkAttachmentReference inputAttachmentRef = {};
+	inputAttachmentRef.attachment = 0;
+	inputAttachmentRef.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkAttachmentReference outputAttachmentRef = {};
+	outputAttachmentRef.attachment = 2;
+	outputAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	//stencil tested against the forward pass's mask, not written
+	VkAttachmentReference depthAttachmentRef = {};
+	depthAttachmentRef.attachment = 1;
+	depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	std::array<VkSubpassDescription, 2> subpasses = { subpass, VkSubpassDescription{} };
+	subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpasses[1].inputAttachmentCount = 1;
+	subpasses[1].pInputAttachments = &inputAttachmentRef;
+	subpasses[1].colorAttachmentCount = 1;
+	subpasses[1].pColorAttachments = &outputAttachmentRef;
+	subpasses[1].pDepthStencilAttachment = &depthAttachmentRef;
+
+	//by region: subpass 1 only reads the pixel it writes, so a tiler never has to flush the forward color
+	VkSubpassDependency forwardToHoleFill = {};
+	forwardToHoleFill.srcSubpass = 0;
+	forwardToHoleFill.dstSubpass = 1;
+	forwardToHoleFill.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	forwardToHoleFill.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+	forwardToHoleFill.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	forwardToHoleFill.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+	forwardToHoleFill.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	dependencies[1].srcSubpass = 1;
+	std::array<VkSubpassDependency, 3> allDependencies = { dependencies[0], forwardToHoleFill, dependencies[1] };
+
+	std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, outputAttachment };
 	VkRenderPassCreateInfo renderPassInfo = {};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 	renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
 	renderPassInfo.pAttachments = attachments.data();
-	renderPassInfo.subpassCount = 1;
-	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = dependencies.size();;
-	renderPassInfo.pDependencies = &dependencies[0];
+	renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+	renderPassInfo.pSubpasses = subpasses.data();
+	renderPassInfo.dependencyCount = static_cast<uint32_t>(allDependencies.size());
+	renderPassInfo.pDependencies = allDependencies.data();
 
-	if (vkCreateRenderPass(contextInfo.device, &renderPassInfo, nullptr, &renderPassStencilLoading) != VK_SUCCESS) {
+	if (vkCreateRenderPass(contextInfo.device, &renderPassInfo, nullptr, &out_renderPass) != VK_SUCCESS) {
 		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create render pass!";
 		throw std::runtime_error(ss.str());
 	}
@@ -293,6 +370,76 @@ void VulkanRenderPass::createRenderPassPostProcessPresent(const VulkanContextInf
 	}
 }
 
+void VulkanRenderPass::createRenderPassPostProcessHoles(const VulkanContextInfo& contextInfo) {
+	VkAttachmentDescription colorAttachment = {};
+	colorAttachment.format = SubpassHoleFill::getOutputFormat(contextInfo);
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;//the rendered pixels, the holes are written over
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_GENERAL;//PostProcessGraph's transition from the forward render pass's finalLayout
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkAttachmentDescription depthAttachment = {};
+	depthAttachment.format = contextInfo.depthFormat;
+	depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;//the forward render passes' finalLayout
+	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	VkAttachmentReference colorAttachmentRef = {};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_GENERAL;
+
+	VkAttachmentReference depthAttachmentRef = {};
+	depthAttachmentRef.attachment = 1;
+	depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+	VkSubpassDescription subpass = {};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+	subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+	std::array<VkSubpassDependency, 2> dependencies;
+
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+	dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+	dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+	dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+	VkRenderPassCreateInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+	renderPassInfo.pAttachments = attachments.data();
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+	renderPassInfo.pDependencies = dependencies.data();
+
+	if (vkCreateRenderPass(contextInfo.device, &renderPassInfo, nullptr, &renderPassPostProcessHoles) != VK_SUCCESS) {
+		std::stringstream ss; ss << "\n" << __LINE__ << ": " << __FILE__ << ": failed to create render pass!";
+		throw std::runtime_error(ss.str());
+	}
+}
+
 void VulkanRenderPass::destroyRenderPasses(const VulkanContextInfo& contextInfo) {
 	if (renderPass != VK_NULL_HANDLE)
 		vkDestroyRenderPass(contextInfo.device, renderPass, nullptr);
@@ -302,4 +449,6 @@ void VulkanRenderPass::destroyRenderPasses(const VulkanContextInfo& contextInfo)
 		vkDestroyRenderPass(contextInfo.device, renderPassPostProcess, nullptr);
 	if (renderPassPostProcessPresent != VK_NULL_HANDLE)
 		vkDestroyRenderPass(contextInfo.device, renderPassPostProcessPresent, nullptr);
+	if (renderPassPostProcessHoles != VK_NULL_HANDLE)
+		vkDestroyRenderPass(contextInfo.device, renderPassPostProcessHoles, nullptr);
 }
\ No newline at end of file
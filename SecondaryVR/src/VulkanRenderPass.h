@@ -7,6 +7,8 @@
 
 #include "VulkanContextInfo.h"
 #include "VulkanDescriptor.h"
+#include "SubpassHoleFill.h"
+#include <array>
 
 
 //"A pipeline is always built relative to a specific subpass of a specific render pass. It cannot be used in any other subpass.
@@ -22,6 +24,7 @@ public:
 	VkRenderPass renderPassStencilLoading;
 	VkRenderPass renderPassPostProcess;
 	VkRenderPass renderPassPostProcessPresent;
+	VkRenderPass renderPassPostProcessHoles;//PipelineType::HOLES_ONLY
 	
 
 public:
@@ -31,8 +34,16 @@ public:
 	void createRenderPasses(const VulkanContextInfo& contextInfo);
 	void createRenderPassForward(const VulkanContextInfo& contextInfo);
 	void createRenderPassForwardStencilLoading(const VulkanContextInfo& contextInfo);
+	//the forward passes' shared tail: one subpass, or with Camera::subpassHoleFill a second one reading colorAttachment
+	//as an input attachment and writing SubpassHoleFill's output (attachment 2), the external dependencies then leave from it
+	void createRenderPassForward(const VulkanContextInfo& contextInfo, VkAttachmentDescription colorAttachment,
+		const VkAttachmentDescription& depthAttachment, const VkSubpassDescription& subpass,
+		std::array<VkSubpassDependency, 2> dependencies, VkRenderPass& out_renderPass);
 	void createRenderPassPostProcess(const VulkanContextInfo& contextInfo);
 	void createRenderPassPostProcessPresent(const VulkanContextInfo& contextInfo);
+	//SubpassHoleFill's output loaded and stored in GENERAL (the stage samples it too) and the forward pass's stencil to test,
+	//read only and kept for the next frame's stencil loading
+	void createRenderPassPostProcessHoles(const VulkanContextInfo& contextInfo);
 
 	//cleanup
 	void destroyRenderPasses(const VulkanContextInfo& contextInfo);
@@ -6,11 +6,35 @@ C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardDiffuseHeight.frag
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardSpecNor.frag.spv		forwardSpecNor.frag
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardSpecHeight.frag.spv	forwardSpecHeight.frag
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardAll.frag.spv 		forwardAll.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardDistorted.vert.spv 	forwardDistorted.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardDistorted.tesc.spv 	forwardDistorted.tesc
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o forwardDistorted.tese.spv 	forwardDistorted.tese
 
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppPassthrough.vert.spv 		ppPassthrough.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppFullscreenTriangle.vert.spv 	ppFullscreenTriangle.vert
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppPassthrough.frag.spv 		ppPassthrough.frag
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppStencilHoleFill.frag.spv 	ppStencilHoleFill.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppStencilHoleFillPrefetch.frag.spv 	ppStencilHoleFillPrefetch.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppStencilHoleFillTemporal.frag.spv 	ppStencilHoleFillTemporal.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppStencilHoleFillClassified.frag.spv 	ppStencilHoleFillClassified.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppStencilHoleFillBarrelAb.frag.spv 	ppStencilHoleFillBarrelAb.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppStencilHoleFill.comp.spv 	ppStencilHoleFill.comp
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAb.comp.spv 		ppBarrelAb.comp
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAbFragCommonUse.frag.spv ppBarrelAbFragCommonUse.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppLateralChromAb.frag.spv 	ppLateralChromAb.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAbLUT.frag.spv 		ppBarrelAbLUT.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAbMeshPreCalc.vert.spv 	ppBarrelAbMeshPreCalc.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAbMeshPreCalc.frag.spv 	ppBarrelAbMeshPreCalc.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAbMesh2.vert.spv 	ppBarrelAbMesh2.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppBarrelAbMesh.frag.spv 		ppBarrelAbMesh.frag
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppTimeWarp.vert.spv 		ppTimeWarp.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppTimeWarpGrid.vert.spv 		ppTimeWarpGrid.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppTimeWarpPoints.vert.spv 	ppTimeWarpPoints.vert
 C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppTimeWarp.frag.spv 		ppTimeWarp.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppTimeWarpBarrelAb.vert.spv 	ppTimeWarpBarrelAb.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o ppTimeWarpBarrelAb.frag.spv 	ppTimeWarpBarrelAb.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o stencilRadialDensity.frag.spv 	stencilRadialDensity.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o hiddenAreaMesh.vert.spv 		hiddenAreaMesh.vert
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o hiddenAreaMesh.frag.spv 		hiddenAreaMesh.frag
+C:/VulkanSDK/1.0.61.1/Bin32/glslangValidator.exe -V -o subpassHoleFill.frag.spv 	subpassHoleFill.frag
 pause
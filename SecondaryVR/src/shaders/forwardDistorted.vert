@@ -0,0 +1,114 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//forward.vert with the barrel warp per vertex (DistortedForward) for devices without tessellation shaders,
+//edges stay straight between the warped vertices so big triangles are off by however much the lens bends them
+
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view[2];
+    mat4 proj;
+    float time;
+} ubo;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    mat4 model;
+    int toggleFlags;
+} PushConstant;
+const int camBit = 1;
+const int dynamicBit = 0;
+
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+layout(constant_id = 0)  const float WARP_K0 = 1.0;
+layout(constant_id = 1)  const float WARP_K1 = 0.22;
+layout(constant_id = 2)  const float WARP_K2 = 0.24;
+layout(constant_id = 3)  const float WARP_K3 = 0.0;
+layout(constant_id = 8)  const float LENS_CENTER_SHIFT = 0.0379941;
+layout(constant_id = 9)  const float SCALE_X = 0.145806;
+layout(constant_id = 10) const float SCALE_Y = 0.233290;
+layout(constant_id = 11) const float SCALE_IN_X = 4.0;
+layout(constant_id = 12) const float SCALE_IN_Y = 2.5;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 inNor;
+layout(location = 4) in vec3 inTan;
+layout(location = 5) in vec3 inBiTan;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 worldNor;
+layout(location = 3) out vec3 worldTan;
+layout(location = 4) out vec3 worldBiTan;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+mat4 rotationMatrix(vec3 axis, const float angle);
+vec2 warpNDC(const vec2 ndc, const int camIndex);
+mat4 rotationMatrixBasic(const float angle);
+
+void main() {
+    const int isDynamic = (PushConstant.toggleFlags >> dynamicBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    mat4 updatedModelMatrix = PushConstant.model * rotationMatrix(vec3(0.f, 1.f, 0.f), isDynamic * ubo.time * 3.1415f/4.f);
+    gl_Position = ubo.proj * ubo.view[camIndex] * updatedModelMatrix * vec4(inPosition, 1.0);
+    if (gl_Position.w > 0.0) {
+        gl_Position.xy = warpNDC(gl_Position.xy / gl_Position.w, camIndex) * gl_Position.w;
+    }
+
+    fragColor       = inColor;
+    fragTexCoord    = inTexCoord;
+	worldNor         = normalize(transpose(inverse(mat3(updatedModelMatrix))) * inNor);
+    worldTan         = normalize(mat3(updatedModelMatrix) * inTan);
+    worldBiTan       = normalize(mat3(updatedModelMatrix) * inBiTan);
+
+}
+
+mat4 rotationMatrixBasic(const float angle) {
+    float s = sin(angle);
+    float c = cos(angle);
+    
+    //column major?
+    return mat4( 1.f, 0.f, 0.f,  0.f,
+                 0.f,   c,   s,  0.f,
+                 0.f,  -s,   c,  0.f,
+                 0.f,  0.f, 0.f, 1.f);
+}
+
+mat4 rotationMatrix(vec3 axis, const float angle) {
+    axis = normalize(axis);
+    float s = sin(angle);
+    float c = cos(angle);
+    float oc = 1.0 - c;
+    
+    return mat4(oc * axis.x * axis.x + c,           oc * axis.x * axis.y - axis.z * s,  oc * axis.z * axis.x + axis.y * s,  0.0,
+                oc * axis.x * axis.y + axis.z * s,  oc * axis.y * axis.y + c,           oc * axis.y * axis.z - axis.x * s,  0.0,
+                oc * axis.z * axis.x - axis.y * s,  oc * axis.y * axis.z + axis.x * s,  oc * axis.z * axis.z + c,           0.0,
+                0.0,                                0.0,                                0.0,                                1.0);
+}
+
+//eye ndc the barrel stage samples -> eye ndc of the pixel that samples it, InverseDistortion::inverseNDC
+//with DistortedForward::WARP_NEWTON_STEPS newton steps on r*k(r^2) = rho from DistortedForward::getInitialRadius
+const int WARP_NEWTON_STEPS = 3;
+vec2 warpNDC(const vec2 ndc, const int camIndex) {
+    const vec2 LensCenter = vec2(camIndex == 1 ? 0.75 - LENS_CENTER_SHIFT : 0.25 + LENS_CENTER_SHIFT, 0.5);
+    const vec2 uv = vec2((ndc.x + 1.0)*0.25 + 0.5*camIndex, (ndc.y + 1.0)*0.5);
+    const vec2 theta1 = (uv - LensCenter) / vec2(SCALE_X, SCALE_Y);
+    const float rho = length(theta1);
+    if (rho < 1e-6) { return ndc; }
+
+    float r = min(rho, pow(rho / (WARP_K0 + WARP_K1 + WARP_K2 + WARP_K3), 1.0/3.0));
+    for (int i = 0; i < WARP_NEWTON_STEPS; ++i) {
+        const float rSq = r*r;
+        const float err = r*(WARP_K0 + rSq*(WARP_K1 + rSq*(WARP_K2 + rSq*WARP_K3))) - rho;
+        const float deriv = WARP_K0 + rSq*(3.0*WARP_K1 + rSq*(5.0*WARP_K2 + rSq*7.0*WARP_K3));
+        r -= err / deriv;
+    }
+
+    const vec2 warped = LensCenter + theta1 * (r / rho) / vec2(SCALE_IN_X, SCALE_IN_Y);
+    return vec2((warped.x - 0.5*camIndex)*4.0 - 1.0, warped.y*2.0 - 1.0);
+}
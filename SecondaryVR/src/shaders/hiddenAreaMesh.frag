@@ -0,0 +1,17 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//HiddenAreaMesh, a checker run's rectangle only masks out every other quad (QuadMask::FILL_CHECKER_EVEN/ODD),
+//the others were shaded by the mask and keep the cleared stencil. no color output
+
+layout (push_constant) uniform HiddenAreaInfo {
+    vec2 invExtent;
+    int keepParity;//-1 the whole rectangle, else the quads where ((qx ^ qy) & 1) is this
+} PushConstant;
+
+void main() {
+    const ivec2 quad = ivec2(gl_FragCoord.xy) >> 1;
+    if (PushConstant.keepParity >= 0 && ((quad.x ^ quad.y) & 1) != PushConstant.keepParity) {
+        discard;
+    }
+}
@@ -0,0 +1,20 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//HiddenAreaMesh rectangles over the quads the vr stencil masks out, corners in render target pixels.
+//z doesn't matter, the pipeline only writes stencil
+
+layout (push_constant) uniform HiddenAreaInfo {
+    vec2 invExtent;
+    int keepParity;
+} PushConstant;
+
+layout(location = 0) in uvec2 inPos;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+    gl_Position = vec4(vec2(inPos) * PushConstant.invExtent * 2.0 - 1.0, 0.5, 1.0);
+}
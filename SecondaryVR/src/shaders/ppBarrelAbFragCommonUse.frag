@@ -19,30 +19,21 @@ layout(location = 4) in vec3 fragBiTan;
 layout(location = 0) out vec4 outColor;
 
 
-// Values that were scattered throughout the Oculus world demo
-const vec4 HmdWarpParam = vec4(1.0, 0.22, 0.24, 0.0); // For the 7-inch device
-const vec4 ChromAbParam = vec4(0.996, -0.004, 1.014, 0.0);
-const float HMD_HResolution = 1280.0;
-const float HMD_VResolution = 800.0;
-const float HMD_HScreenSize = 0.14976;
-const float HMD_VScreenSize = HMD_HScreenSize / (HMD_HResolution / HMD_VResolution);
-const float HMD_InterpupillaryDistance = 0.064;
-const float HMD_LensSeparationDistance = 0.0635;
-const float HMD_EyeToScreenDistance = 0.041;
-const float lensOffset = HMD_LensSeparationDistance * 0.5;
-const float lensShift = HMD_HScreenSize * 0.25 - lensOffset;
-const float Distortion_XCenterOffset = 4.0 * lensShift / HMD_HScreenSize;
-const float DistortionFitX = -1.0;
-const float DistortionFitY = 0.0;
-const float stereoAspect = 0.5 * HMD_HResolution / HMD_VResolution;
-const float dx = DistortionFitX - Distortion_XCenterOffset;
-const float dy = DistortionFitY / stereoAspect;
-const float fitRadiusSquared = dx * dx + dy * dy;
-const float Distortion_Scale =
-  HmdWarpParam.x +
-  HmdWarpParam.y * fitRadiusSquared +
-  HmdWarpParam.z * fitRadiusSquared * fitRadiusSquared +
-  HmdWarpParam.w * fitRadiusSquared * fitRadiusSquared * fitRadiusSquared;
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+//lens center, scale and scale in are worked out on the cpu per profile
+layout(constant_id = 0)  const float WARP_K0 = 1.0;
+layout(constant_id = 1)  const float WARP_K1 = 0.22;
+layout(constant_id = 2)  const float WARP_K2 = 0.24;
+layout(constant_id = 3)  const float WARP_K3 = 0.0;
+layout(constant_id = 4)  const float CHROMAB_C0 = 0.996;
+layout(constant_id = 5)  const float CHROMAB_C1 = -0.004;
+layout(constant_id = 6)  const float CHROMAB_C2 = 1.014;
+layout(constant_id = 7)  const float CHROMAB_C3 = 0.0;
+layout(constant_id = 8)  const float LENS_CENTER_SHIFT = 0.0379941;
+layout(constant_id = 9)  const float SCALE_X = 0.145806;
+layout(constant_id = 10) const float SCALE_Y = 0.233290;
+layout(constant_id = 11) const float SCALE_IN_X = 4.0;
+layout(constant_id = 12) const float SCALE_IN_Y = 2.5;
 
 // This samples from a single unwarped [0,0]x[1,1] box containing two views
 // side-by-side that have been rendered using normal perspective projection.
@@ -66,33 +57,20 @@ void main() {
     vec2 oTexCoord = fragUV;
     oTexCoord.x = (oTexCoord.x * (1.f - 0.5f*vrMode)) + 0.5f*camIndex;
 
-    // Compute the viewport size
-    bool isRight = oTexCoord.x > 0.5;
-    float x = isRight ? 0.5 : 0.0;
-    float y = 0.0;
-    float w = 0.5;
-    float h = 1.0;
-
     // Set up values for the shader
-    float XCenterOffset = isRight ? -Distortion_XCenterOffset : Distortion_XCenterOffset;
-    vec2 LensCenter = vec2(x + (w + XCenterOffset * 0.5) * 0.5, y + h * 0.5);
-    vec2 ScreenCenter = vec2(x + w * 0.5, y + h * 0.5);
-    float scaleFactor = 1.0 / Distortion_Scale;
-    vec2 Scale = vec2(w * 0.5 * scaleFactor, h * 0.5 * scaleFactor * stereoAspect);
-    vec2 ScaleIn = vec2(2.0 / w, 2.0 / h / stereoAspect);
+    const bool isRight = oTexCoord.x > 0.5;
+    const vec2 LensCenter = vec2(isRight ? 0.75 - LENS_CENTER_SHIFT : 0.25 + LENS_CENTER_SHIFT, 0.5);
+    const vec2 Scale = vec2(SCALE_X, SCALE_Y);
+    const vec2 ScaleIn = vec2(SCALE_IN_X, SCALE_IN_Y);
 
     // Compute the warp
     vec2 theta = (oTexCoord - LensCenter) * ScaleIn; // Scales to [-1, 1]
     float rSq = theta.x * theta.x + theta.y * theta.y;
-    vec2 theta1 = theta * (
-            HmdWarpParam.x +
-            HmdWarpParam.y * rSq +
-            HmdWarpParam.z * rSq * rSq +
-            HmdWarpParam.w * rSq * rSq * rSq);
+    vec2 theta1 = theta * (WARP_K0 + rSq * (WARP_K1 + rSq * (WARP_K2 + rSq * WARP_K3)));
 
     // Compute chromatic aberration
-    vec2 thetaRed = theta1 * (ChromAbParam.x + ChromAbParam.y * rSq);
-    vec2 thetaBlue = theta1 * (ChromAbParam.z + ChromAbParam.w * rSq);
+    vec2 thetaRed = theta1 * (CHROMAB_C0 + CHROMAB_C1 * rSq);
+    vec2 thetaBlue = theta1 * (CHROMAB_C2 + CHROMAB_C3 * rSq);
     vec2 tcRed = LensCenter + Scale * thetaRed;
     vec2 tcGreen = LensCenter + Scale * theta1;
     vec2 tcBlue = LensCenter + Scale * thetaBlue;
@@ -0,0 +1,62 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(binding = 0) uniform sampler2D texSampler;
+layout(binding = 1) uniform sampler2D distortionLUT;//see DistortionLUT.h, left eye, one texel per present pixel
+
+layout (push_constant) uniform PerDrawCallInfo {
+    int toggleFlags;
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragNor;
+layout(location = 3) in vec3 fragTan;
+layout(location = 4) in vec3 fragBiTan;
+
+layout(location = 0) out vec4 outColor;
+
+
+//HmdProfile specialization constant (see HmdSpecializationData), default is the dk1
+layout(constant_id = 8)  const float LENS_CENTER_SHIFT = 0.0379941;
+
+
+void main() {
+    const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+	//dont do barrel and chroma ab if not vrMode
+	if(0 == vrMode ) { outColor = texture(texSampler, fragUV); return;}
+
+    //if vrMode, shrink UV.x by half and shift
+    //to sample one eye of the original full screen texture
+    //mapping UV(0-1) to either 0-.5 or .5-1 based on camIndex
+    vec2 oTexCoord = fragUV;
+    oTexCoord.x = (oTexCoord.x * (1.f - 0.5f*vrMode)) + 0.5f*camIndex;
+
+    const bool isRight = oTexCoord.x > 0.5;
+    const vec2 LensCenter = vec2(isRight ? 0.75 - LENS_CENTER_SHIFT : 0.25 + LENS_CENTER_SHIFT, 0.5);
+
+    //the right eye is the left eye mirrored, fetch the mirrored texel and flip the x offset
+    const ivec2 lutSize = textureSize(distortionLUT, 0);
+    ivec2 texel = min(ivec2(fragUV * vec2(lutSize)), lutSize - 1);
+    texel.x = isRight ? lutSize.x - 1 - texel.x : texel.x;
+    const vec4 lut = texelFetch(distortionLUT, texel, 0);
+    const vec2 mirror = vec2(isRight ? -1.0 : 1.0, 1.0);
+
+    const vec2 tcGreen = oTexCoord + mirror * lut.xy;
+    const vec2 tcRed   = LensCenter + (tcGreen - LensCenter) * (1.0 + lut.z);
+    const vec2 tcBlue  = LensCenter + (tcGreen - LensCenter) * (1.0 + lut.w);
+
+    vec2 tc = tcGreen;
+    vec2 equivNDC = vec2((tc.x - 0.5*camIndex)*4.f-1.f , tc.y*2.f-1.f);
+    if(any(greaterThan(abs(equivNDC), vec2(1.f)))) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+    } else {
+		outColor = vec4(texture(texSampler, tcRed).r,
+						texture(texSampler, tcGreen).g,
+						texture(texSampler, tcBlue).b, 1.f);
+   }
+}
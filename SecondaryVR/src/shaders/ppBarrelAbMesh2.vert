@@ -7,12 +7,9 @@ layout (push_constant) uniform PerDrawCallInfo {
 const int camBit = 1;
 const int vrBit = 0;
 
-layout(location = 0) in vec3 inPos;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inUV;
-layout(location = 3) in vec3 inNor;
-layout(location = 4) in vec3 inTan;
-layout(location = 5) in vec3 inBiTan;
+//PostProcessVertex (see Vertex.h): snorm ndc scaled by POSITION_RANGE, uv is derived from it
+layout(location = 0) in vec2 inPosition;
+const float POSITION_RANGE = 4.0;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragUV;
@@ -140,8 +137,10 @@ void main() {
     const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
     const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
 
+    const vec3 inPos = vec3(inPosition * POSITION_RANGE, 0.5);
+
     //if vrMode, shrink UV.x by half and shift to order to sample correct region for the eye
-    fragUV = inUV;
+    fragUV = inPos.xy * 0.5 + 0.5;
     fragUV.x = (fragUV.x * (1.f - 0.5*vrMode)) + 0.5f*camIndex;
 
     if(1 == vrMode) {
@@ -7,12 +7,15 @@ layout (push_constant) uniform PerDrawCallInfo {
 const int camBit = 1;
 const int vrBit = 0;
 
-layout(location = 0) in vec3 inPos;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inUV;
-layout(location = 3) in vec3 inNor;
-layout(location = 4) in vec3 inTan;
-layout(location = 5) in vec3 inBiTan;
+//PostProcessPreCalcVertex (see Vertex.h): snorm ndc scaled by POSITION_RANGE,
+//r g b source uv's as unorm over [UV_MIN, UV_MAX]
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inTcRed;
+layout(location = 2) in vec2 inTcGreen;
+layout(location = 3) in vec2 inTcBlue;
+const float POSITION_RANGE = 4.0;
+const float UV_MIN = -0.5;
+const float UV_MAX = 1.5;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragUV;
@@ -28,10 +31,10 @@ void main() {
     const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
     const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
 
-    gl_Position = vec4(inPos, 1.f);
+    gl_Position = vec4(inPosition * POSITION_RANGE, 0.5f, 1.f);
 
     //tex coords, could pack more but keep it this way for readability
-    fragColor = inColor; //stores tcRed
-    fragUV    = inUV;    //stores tcGreen
-    fragNor   = inNor;   //stores tcBlue 
+    fragColor = vec3(UV_MIN + inTcRed   * (UV_MAX - UV_MIN), 1.f); //stores tcRed
+    fragUV    =      UV_MIN + inTcGreen * (UV_MAX - UV_MIN);       //stores tcGreen
+    fragNor   = vec3(UV_MIN + inTcBlue  * (UV_MAX - UV_MIN), 1.f); //stores tcBlue
 }
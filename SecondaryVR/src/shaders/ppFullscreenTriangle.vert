@@ -0,0 +1,21 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//ppPassthrough.vert without a vertex buffer (PP_GEOMETRY_TRIANGLE, see GlobalSettings.h), draw 3 vertices
+//vertex 0 1 2 -> uv (0,0) (0,2) (2,0), same triangle and winding as Mesh::createNDCTriangle
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNor;
+layout(location = 3) out vec3 fragTan;
+layout(location = 4) out vec3 fragBiTan;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+    const vec2 uv   = vec2(gl_VertexIndex & 2, (gl_VertexIndex << 1) & 2);
+    gl_Position     = vec4(uv * 2.0 - 1.0, 0.5, 1.0);
+    fragTexCoord    = uv;
+}
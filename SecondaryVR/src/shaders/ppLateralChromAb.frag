@@ -0,0 +1,82 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//present stage of the direct to distorted forward mode (DistortedForward): the forward pass already drew the green channel
+//through the lens, red and blue are the same image scaled about the lens center by how much further out ChromAbParam sends them.
+//the scale is first order in the warp (d(rho)/dr), so it's 3 fetches at nearly the same uv instead of a resample of an undistorted image
+
+layout(binding = 0) uniform sampler2D texSampler;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    int toggleFlags;
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragNor;
+layout(location = 3) in vec3 fragTan;
+layout(location = 4) in vec3 fragBiTan;
+
+layout(location = 0) out vec4 outColor;
+
+
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+layout(constant_id = 0)  const float WARP_K0 = 1.0;
+layout(constant_id = 1)  const float WARP_K1 = 0.22;
+layout(constant_id = 2)  const float WARP_K2 = 0.24;
+layout(constant_id = 3)  const float WARP_K3 = 0.0;
+layout(constant_id = 4)  const float CHROMAB_C0 = 0.996;
+layout(constant_id = 5)  const float CHROMAB_C1 = -0.004;
+layout(constant_id = 6)  const float CHROMAB_C2 = 1.014;
+layout(constant_id = 7)  const float CHROMAB_C3 = 0.0;
+layout(constant_id = 8)  const float LENS_CENTER_SHIFT = 0.0379941;
+layout(constant_id = 9)  const float SCALE_X = 0.145806;
+layout(constant_id = 10) const float SCALE_Y = 0.233290;
+layout(constant_id = 11) const float SCALE_IN_X = 4.0;
+layout(constant_id = 12) const float SCALE_IN_Y = 2.5;
+
+
+void main() {
+    const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    vec2 oTexCoord = fragUV;
+    oTexCoord.x = (oTexCoord.x * (1.f - 0.5f*vrMode)) + 0.5f*camIndex;
+    if(0 == vrMode ) { outColor = texture(texSampler, oTexCoord); return;}
+
+    const vec2 LensCenter = vec2(camIndex == 1 ? 0.75 - LENS_CENTER_SHIFT : 0.25 + LENS_CENTER_SHIFT, 0.5);
+    const vec2 Scale = vec2(SCALE_X, SCALE_Y);
+    const vec2 ScaleIn = vec2(SCALE_IN_X, SCALE_IN_Y);
+
+    const vec2 theta = (oTexCoord - LensCenter) * ScaleIn;
+    const float rSq = theta.x * theta.x + theta.y * theta.y;
+    const float k = WARP_K0 + rSq * (WARP_K1 + rSq * (WARP_K2 + rSq * WARP_K3));
+    const float dRho = WARP_K0 + rSq * (3.0*WARP_K1 + rSq * (5.0*WARP_K2 + rSq * 7.0*WARP_K3));
+
+    //where the undistorted frustum ends, black like ppBarrelAbFragCommonUse.frag leaves it
+    const vec2 tcGreen = LensCenter + Scale * theta * k;
+    const vec2 equivNDC = vec2((tcGreen.x - 0.5*camIndex)*4.f-1.f , tcGreen.y*2.f-1.f);
+    if(any(greaterThan(abs(equivNDC), vec2(1.f)))) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    //rho scaled by c moves r by (c - 1)*rho/(d rho/dr), as a scale of r that's (c - 1)*k/(d rho/dr)
+    const float lateral = k / dRho;
+    const float redScale = 1.0 + (CHROMAB_C0 + CHROMAB_C1 * rSq - 1.0) * lateral;
+    const float blueScale = 1.0 + (CHROMAB_C2 + CHROMAB_C3 * rSq - 1.0) * lateral;
+
+    //stay in this eye's half of the target
+    const vec2 eyeMin = vec2(0.5*camIndex, 0.0);
+    const vec2 eyeMax = vec2(0.5*camIndex + 0.5, 1.0);
+    const vec2 offset = oTexCoord - LensCenter;
+    const vec2 tcRed = clamp(LensCenter + offset * redScale, eyeMin, eyeMax);
+    const vec2 tcBlue = clamp(LensCenter + offset * blueScale, eyeMin, eyeMax);
+
+    outColor = vec4(texture(texSampler, tcRed).r,
+                    texture(texSampler, oTexCoord).g,
+                    texture(texSampler, tcBlue).b, 1.f);
+}
@@ -12,12 +12,9 @@
 //    int toggleFlags;
 //} PushConstant;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inNor;
-layout(location = 4) in vec3 inTan;
-layout(location = 5) in vec3 inBiTan;
+//PostProcessVertex (see Vertex.h): snorm ndc scaled by POSITION_RANGE, uv is derived from it
+layout(location = 0) in vec2 inPosition;
+const float POSITION_RANGE = 4.0;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
@@ -30,6 +27,7 @@ out gl_PerVertex {
 };
 
 void main() {
-    gl_Position     = vec4(inPosition, 1.0);
-    fragTexCoord    = inTexCoord;
+    const vec2 ndc  = inPosition * POSITION_RANGE;
+    gl_Position     = vec4(ndc, 0.5, 1.0);
+    fragTexCoord    = ndc * 0.5 + 0.5;
 }
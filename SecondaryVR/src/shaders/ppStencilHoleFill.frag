@@ -7,7 +7,11 @@ layout (push_constant) uniform PerDrawCallInfo {
     int toggleFlags;
     int virtualWidth;
     int virtualHeight;
+    int gridQuadsPerDim;
+    vec4 stencilRingRadii;//PreMadeStencil::getRingRadii, innermost first, unused rings are -1
+    int stencilRingShifts;//4 bits per ring, the ring shades 1 in 2^shift quads
 } PushConstant;
+const int holesOnlyBit = 2;//PipelineType::HOLES_ONLY, writing SubpassHoleFill's output where the stencil test says it's a hole
 const int camBit = 1;
 const int vrBit = 0;
 
@@ -20,13 +24,16 @@ layout(location = 4) in vec3 fragBiTan;
 
 layout(location = 0) out vec4 outColor;
 
-const float middleRegionRadius = 0.52;//roughly 0.52
-const float NDCcenterOffset = 0.1425;//0.15 ndc centeer UV center offset 0.0375
-const float extraRadius = NDCcenterOffset*0.5f;//same as NDCcenterOffset?
-const vec2 ndcCenter[2] = { vec2(NDCcenterOffset, 0.f), vec2(-NDCcenterOffset, 0.f) };
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+layout(constant_id = 14) const float NDCcenterOffset = 0.1425;//0.15 ndc centeer UV center offset 0.0375
 
-void fillCheckerHole(const ivec2 pixel, const vec2 invWandH);
-void reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH);
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const int camIndex);
+bool reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const int camIndex);
+bool quadShaded(const int densityShift, const ivec2 quad);
+int getDensityShift(const ivec2 quad, const int camIndex);
+bool tapShaded(const vec2 pixelCenter, const int camIndex);
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex);
+void fillHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex);
 
 void main() {
     const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
@@ -50,38 +57,68 @@ void main() {
 
 
     const ivec2 pixel = ivec2(gl_FragCoord.x, gl_FragCoord.y);
-    const ivec2 groupPixel = ivec2( ((pixel.x & 1) == 1) ? pixel.x : pixel.x+1,
-                                    ((pixel.y & 1) == 1) ? pixel.y : pixel.y+1);
+    const ivec2 quad = pixel >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+
+    if (densityShift >= 0) {
+        if (!quadShaded(densityShift, quad)) {//black pixel 
+            fillHole(pixel, densityShift, invWandH, camIndex);
+//            outColor = vec4(0.f,1.f,0.f,1.f); 
+        } else if (densityShift != 1 || !reshadeRenderedChecker(pixel, invWandH, camIndex)) {
+            //full res region, a rendered lattice quad, or a rendered checker pixel whose taps reach a sparser ring
+            outColor = texture(texSampler, fragTexCoord);
+        }
+    } else {//outside lens range
+        //in place it already is and the holes' taps read it, so it's left alone
+        if (0 != ((PushConstant.toggleFlags >> holesOnlyBit) & 1)) { discard; }
+        outColor = vec4(0.f,0.f,0.f,1.f); //no need to fetch, it's black
+    }
+}
+
+//the taps assume the neighbours are in the hole's ring. near a sparser ring some land on quads it doesn't shade (black),
+//so the hole takes the sparser ring's fill: the patterns are nested, its lattice quads are shaded in both rings
+void fillHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex) {
+    if (densityShift == 1 && fillCheckerHole(pixel, invWandH, camIndex)) {
+        return;
+    }
+    for (int shift = max(densityShift, 2); shift < 3; ++shift) {
+        if (fillLatticeHole(pixel, shift, invWandH, camIndex)) {
+            return;
+        }
+    }
+    //the eighth lattice's quads are shaded in every ring
+    fillLatticeHole(pixel, 3, invWandH, camIndex);
+}
+
+//PreMadeStencil's ring test for the quad at its lower right pixel: the density shift of the first ring it's inside of,
+//-1 if it's in none of them (never shaded, the lens edge is the last ring's limit)
+int getDensityShift(const ivec2 quad, const int camIndex) {
+    const int width = PushConstant.virtualWidth;
+    const int height = PushConstant.virtualHeight;
 
     //UV for the 2x2 pixel quad in which it resides
-    const vec2 groupUV = vec2(groupPixel.x*invWidth, groupPixel.y*invHeight);
+    const vec2 groupUV = vec2(quad*2 + 1) / vec2(width, height);
     vec2 equivNDC = vec2((groupUV.x - 0.5*camIndex)*4.f - 1.f, groupUV.y*2.f - 1.f);//convert to eye ndc
 
     //normalize y ndc against half width (eye viewport size) so we get circles and not tall/short vertical ellipses
     //if Y is greater/less than vr eye viewport x (rendertarget width/2)
     equivNDC *= vec2(1.f , height/(width*0.5f)); 
-    const float radius = length(equivNDC - ndcCenter[camIndex]);
-
-
-    if (radius < (1.f + extraRadius)) {
-        if (radius > middleRegionRadius) {//middle region checkerboard 2x2
-            if ( (((groupPixel.x - 1) & 0x3) == 0) && (((groupPixel.y - 1) & 0x3) == 0) //both divis by 4
-              || (((groupPixel.x - 3) & 0x3) == 0) && (((groupPixel.y - 3) & 0x3) == 0)  //shift above pattern to get checker
-            ) {//rendered pixel 
-                reshadeRenderedChecker(pixel, invWandH);
-//                outColor = vec4(1.f,0.f,0.f,1.f); 
-//                outColor = texture(texSampler, fragTexCoord);
-            } else {//black pixel 
-                fillCheckerHole(pixel, invWandH);
-//                outColor = vec4(0.f,1.f,0.f,1.f); 
-//                outColor = texture(texSampler, fragTexCoord);
-            }
-        } else {//inner region
-            outColor = texture(texSampler, fragTexCoord);
+    const vec2 ndcCenter = vec2(camIndex == 0 ? NDCcenterOffset : -NDCcenterOffset, 0.f);
+    const float radius = length(equivNDC - ndcCenter);
+
+    for (int ring = 0; ring < 4; ++ring) {
+        if (radius <= PushConstant.stencilRingRadii[ring]) {
+            return (PushConstant.stencilRingShifts >> (4*ring)) & 0xF;
         }
-    } else {//outside lens range
-        outColor = vec4(0.f,0.f,0.f,1.f); //no need to fetch, it's black
     }
+    return -1;
+}
+
+//did the forward pass render the pixel a tap lands on, past the last ring it reads black like the output there
+bool tapShaded(const vec2 pixelCenter, const int camIndex) {
+    const ivec2 quad = ivec2(floor(pixelCenter)) >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+    return densityShift < 0 || quadShaded(densityShift, quad);
 }
 
 int determinePixelID2x2(const ivec2 pixel) {
@@ -106,7 +143,8 @@ vec2 pixelCenterToUV(const vec2 pixelCenter, const vec2 invWandH) {
 	return pixelCenter * invWandH;
 }
 
-void fillCheckerHole(const ivec2 pixel, const vec2 invWandH) {
+//false (nothing written) if one of the taps wasn't rendered
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const int camIndex) {
 	const int pixelID = determinePixelID2x2(pixel);//numbered like reading a book(0 is upper left, 3 is lower right)
 	const vec2 pixelC = vec2(pixel.x + 0.5f, pixel.y + 0.5f);
 	const float w1 = 0.375f;
@@ -138,14 +176,20 @@ void fillCheckerHole(const ivec2 pixel, const vec2 invWandH) {
 		offset3 = vec2(-2.f,  0.f);//skip left
 		offset4 = vec2( 0.f, -2.f);//skip up
 	}
+    if (!tapShaded(pixelC+offset1, camIndex) || !tapShaded(pixelC+offset2, camIndex) ||
+        !tapShaded(pixelC+offset3, camIndex) || !tapShaded(pixelC+offset4, camIndex)) {
+        return false;
+    }
     const vec3 sample1 =  w1 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset1, invWandH)) );
     const vec3 sample2 =  w2 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset2, invWandH)) );
     const vec3 sample3 =  w3 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset3, invWandH)) );
     const vec3 sample4 =  w4 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset4, invWandH)) );
     outColor = vec4(sample1 + sample2 + sample3 + sample4, 1.f);
+    return true;
 }
 
-void reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH) {
+//false (nothing written) if one of the taps wasn't rendered
+bool reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const int camIndex) {
 	const int pixelID = determinePixelID2x2(pixel);//numbered like reading a book(0 is upper left, 3 is lower right)
 	const vec2 pixelC = vec2(pixel.x + 0.5f, pixel.y + 0.5f);
 	const float w1 = 0.50000f;
@@ -183,10 +227,53 @@ void reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH) {
 		offset4 = vec2( 1.f, -2.f);//1Right 2Up
 		offset5 = vec2(-2.f, -2.f);//2Left 2Up
 	}
+    if (!tapShaded(pixelC+offset2, camIndex) || !tapShaded(pixelC+offset3, camIndex) ||
+        !tapShaded(pixelC+offset4, camIndex) || !tapShaded(pixelC+offset5, camIndex)) {
+        return false;
+    }
     const vec3 sample1 =  w1 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset1, invWandH)) );
     const vec3 sample2 =  w2 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset2, invWandH)) );
     const vec3 sample3 =  w3 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset3, invWandH)) );
     const vec3 sample4 =  w4 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset4, invWandH)) );
     const vec3 sample5 =  w5 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset5, invWandH)) );
     outColor = vec4(sample1 + sample2 + sample3 + sample4 + sample5, 1.f);
+    return true;
+}
+
+//PreMadeStencil::quadShaded, the density patterns are nested so a quad shaded at one shift is shaded at every lower one
+bool quadShaded(const int densityShift, const ivec2 quad) {
+    if (densityShift == 0) { return true; }
+    if (densityShift == 1) { return ((quad.x ^ quad.y) & 1) == 0; }
+    const bool evenQuad = ((quad.x | quad.y) & 1) == 0;
+    return densityShift == 2 ? evenQuad : evenQuad && (((quad.x ^ quad.y) >> 1) & 1) == 0;
+}
+
+//a quarter density ring is shaded on a square lattice of quads (every other quad in x and y),
+//an eighth density ring on every other point of it (a lattice rotated 45 degrees).
+//bilinear between the 4 shaded lattice quads around the pixel, false (nothing written) if one of them wasn't rendered
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex) {
+    //lattice point i is quad 2i, its center is pixel corner 4i+1
+    const vec2 p = (vec2(pixel) + 0.5f - 1.f) * 0.25f;
+    //eighth density: shaded points have an even x+y, in (x+y)/2, (x-y)/2 those are every integer point
+    const vec2 a = densityShift == 2 ? p : vec2(p.x + p.y, p.x - p.y) * 0.5f;
+    const vec2 base = floor(a);
+    const vec2 f = a - base;
+
+    vec2 latticePixels[4];
+    for (int i = 0; i < 4; ++i) {
+        const vec2 c = base + vec2(i & 1, i >> 1);
+        const vec2 latticePoint = densityShift == 2 ? c : vec2(c.x + c.y, c.x - c.y);
+        //sample the middle of the quad, any of its 4 pixels were shaded
+        latticePixels[i] = latticePoint*4.f + 1.f;
+        if (!tapShaded(latticePixels[i] + 0.5f, camIndex)) {
+            return false;
+        }
+    }
+
+    vec3 corners[4];
+    for (int i = 0; i < 4; ++i) {
+        corners[i] = vec3( texture(texSampler, pixelCenterToUV(latticePixels[i], invWandH)) );
+    }
+    outColor = vec4(mix(mix(corners[0], corners[1], f.x), mix(corners[2], corners[3], f.x), f.y), 1.f);
+    return true;
 }
@@ -0,0 +1,235 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//ppStencilHoleFill.frag and ppBarrelAbFragCommonUse.frag as one pass straight from the masked forward image:
+//each of the 3 chromatic source uv's is hole filled where it lands instead of being read from a hole filled intermediate.
+//COLOR_ATTACHMENT images have a nearest sampler, so like the two pass chain every channel reads the one pixel its uv falls in:
+//full density and rendered lattice pixels as they are, holes filled at that pixel. channels that land in the same pixel share one fill
+
+layout(binding = 0) uniform sampler2D texSampler;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    int toggleFlags;
+    int virtualWidth;
+    int virtualHeight;
+    int gridQuadsPerDim;
+    vec4 stencilRingRadii;//PreMadeStencil::getRingRadii, innermost first, unused rings are -1
+    int stencilRingShifts;//4 bits per ring, the ring shades 1 in 2^shift quads
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragNor;
+layout(location = 3) in vec3 fragTan;
+layout(location = 4) in vec3 fragBiTan;
+
+layout(location = 0) out vec4 outColor;
+
+
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+//lens center, scale and scale in are worked out on the cpu per profile
+layout(constant_id = 0)  const float WARP_K0 = 1.0;
+layout(constant_id = 1)  const float WARP_K1 = 0.22;
+layout(constant_id = 2)  const float WARP_K2 = 0.24;
+layout(constant_id = 3)  const float WARP_K3 = 0.0;
+layout(constant_id = 4)  const float CHROMAB_C0 = 0.996;
+layout(constant_id = 5)  const float CHROMAB_C1 = -0.004;
+layout(constant_id = 6)  const float CHROMAB_C2 = 1.014;
+layout(constant_id = 7)  const float CHROMAB_C3 = 0.0;
+layout(constant_id = 8)  const float LENS_CENTER_SHIFT = 0.0379941;
+layout(constant_id = 9)  const float SCALE_X = 0.145806;
+layout(constant_id = 10) const float SCALE_Y = 0.233290;
+layout(constant_id = 11) const float SCALE_IN_X = 4.0;
+layout(constant_id = 12) const float SCALE_IN_Y = 2.5;
+layout(constant_id = 14) const float NDCcenterOffset = 0.1425;
+
+vec3 sampleFilled(const ivec2 pixel, const vec2 uv, const int camIndex);
+
+void main() {
+    const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+    //no stencil and no lens outside vr mode
+    if(0 == vrMode ) { outColor = texture(texSampler, fragUV); return;}
+
+    //ppBarrelAbFragCommonUse.frag's warp, uv of one eye of the forward image
+    vec2 oTexCoord = fragUV;
+    oTexCoord.x = (oTexCoord.x * 0.5f) + 0.5f*camIndex;
+
+    const vec2 LensCenter = vec2(camIndex == 1 ? 0.75 - LENS_CENTER_SHIFT : 0.25 + LENS_CENTER_SHIFT, 0.5);
+    const vec2 Scale = vec2(SCALE_X, SCALE_Y);
+    const vec2 ScaleIn = vec2(SCALE_IN_X, SCALE_IN_Y);
+
+    const vec2 theta = (oTexCoord - LensCenter) * ScaleIn; // Scales to [-1, 1]
+    const float rSq = theta.x * theta.x + theta.y * theta.y;
+    const vec2 theta1 = theta * (WARP_K0 + rSq * (WARP_K1 + rSq * (WARP_K2 + rSq * WARP_K3)));
+
+    const vec2 tcRed = LensCenter + Scale * (theta1 * (CHROMAB_C0 + CHROMAB_C1 * rSq));
+    const vec2 tcGreen = LensCenter + Scale * theta1;
+    const vec2 tcBlue = LensCenter + Scale * (theta1 * (CHROMAB_C2 + CHROMAB_C3 * rSq));
+
+    const vec2 equivNDC = vec2((tcGreen.x - 0.5*camIndex)*4.f-1.f , tcGreen.y*2.f-1.f);
+    if(any(greaterThan(abs(equivNDC), vec2(1.f)))) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    //forward image pixel under each channel's uv
+    const vec2 extent = vec2(PushConstant.virtualWidth, PushConstant.virtualHeight);
+    const ivec2 maxPixel = ivec2(PushConstant.virtualWidth - 1, PushConstant.virtualHeight - 1);
+    const ivec2 pixelRed = clamp(ivec2(tcRed * extent), ivec2(0), maxPixel);
+    const ivec2 pixelGreen = clamp(ivec2(tcGreen * extent), ivec2(0), maxPixel);
+    const ivec2 pixelBlue = clamp(ivec2(tcBlue * extent), ivec2(0), maxPixel);
+
+    const vec3 green = sampleFilled(pixelGreen, tcGreen, camIndex);
+    const float red = (pixelRed == pixelGreen) ? green.r : sampleFilled(pixelRed, tcRed, camIndex).r;
+    const float blue = (pixelBlue == pixelGreen) ? green.b : sampleFilled(pixelBlue, tcBlue, camIndex).b;
+    outColor = vec4(red, green.g, blue, 1.f);
+}
+
+int determinePixelID2x2(const ivec2 pixel);
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const int camIndex, out vec3 color);
+bool reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const int camIndex, out vec3 color);
+bool quadShaded(const int densityShift, const ivec2 quad);
+int getDensityShift(const ivec2 quad, const int camIndex);
+bool tapShaded(const vec2 pixelCenter, const int camIndex);
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex, out vec3 color);
+
+//what ppStencilHoleFill.frag writes for pixel, uv is only fetched as is where nothing needs filling
+vec3 sampleFilled(const ivec2 pixel, const vec2 uv, const int camIndex) {
+    const vec2 invWandH = vec2(1.f / PushConstant.virtualWidth, 1.f / PushConstant.virtualHeight);
+
+    //ring test at the lower right pixel of the pixel's quad, like the stencil
+    const ivec2 quad = pixel >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+
+    vec3 color;
+    if (densityShift < 0) {//outside lens range
+        return vec3(0.f);
+    } else if (quadShaded(densityShift, quad)) {
+        if (densityShift == 1 && reshadeRenderedChecker(pixel, invWandH, camIndex, color)) {
+            return color;
+        }
+        return vec3(texture(texSampler, uv));//nearest, the pixel the uv falls in
+    }
+
+    //ppStencilHoleFill.frag's fillHole: near a sparser ring the hole takes that ring's lattice fill
+    if (densityShift == 1 && fillCheckerHole(pixel, invWandH, camIndex, color)) {
+        return color;
+    }
+    for (int shift = max(densityShift, 2); shift < 3; ++shift) {
+        if (fillLatticeHole(pixel, shift, invWandH, camIndex, color)) {
+            return color;
+        }
+    }
+    fillLatticeHole(pixel, 3, invWandH, camIndex, color);
+    return color;
+}
+
+//ppStencilHoleFill.frag's ring test for the quad at its lower right pixel, -1 outside every ring
+int getDensityShift(const ivec2 quad, const int camIndex) {
+    const int width = PushConstant.virtualWidth;
+    const int height = PushConstant.virtualHeight;
+    const vec2 groupUV = vec2(quad*2 + 1) / vec2(width, height);
+    vec2 equivNDC = vec2((groupUV.x - 0.5*camIndex)*4.f - 1.f, groupUV.y*2.f - 1.f);
+    equivNDC *= vec2(1.f , height/(width*0.5f));
+    const vec2 ndcCenter = vec2(camIndex == 0 ? NDCcenterOffset : -NDCcenterOffset, 0.f);
+    const float radius = length(equivNDC - ndcCenter);
+
+    for (int ring = 0; ring < 4; ++ring) {
+        if (radius <= PushConstant.stencilRingRadii[ring]) {
+            return (PushConstant.stencilRingShifts >> (4*ring)) & 0xF;
+        }
+    }
+    return -1;
+}
+
+//did the forward pass render the pixel a tap lands on, past the last ring it reads black like the output there
+bool tapShaded(const vec2 pixelCenter, const int camIndex) {
+    const ivec2 quad = ivec2(floor(pixelCenter)) >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+    return densityShift < 0 || quadShaded(densityShift, quad);
+}
+
+int determinePixelID2x2(const ivec2 pixel) {
+    return (pixel.x & 1) | ((pixel.y & 1) << 1);//numbered like reading a book(0 is upper left, 3 is lower right)
+}
+
+//ppStencilHoleFill.frag's fillCheckerHole taps per pixel id: above/below, left/right, then the skips across the hole
+const float checkerHoleWeights[4] = float[](0.375f, 0.375f, 0.125f, 0.125f);
+const vec2 checkerHoleTaps[16] = vec2[](
+    vec2( 0.f, -1.f), vec2(-1.f,  0.f), vec2( 2.f,  0.f), vec2( 0.f,  2.f),
+    vec2( 0.f, -1.f), vec2( 1.f,  0.f), vec2(-2.f,  0.f), vec2( 0.f,  2.f),
+    vec2( 0.f,  1.f), vec2(-1.f,  0.f), vec2( 2.f,  0.f), vec2( 0.f, -2.f),
+    vec2( 0.f,  1.f), vec2( 1.f,  0.f), vec2(-2.f,  0.f), vec2( 0.f, -2.f));
+
+//reshadeRenderedChecker taps per pixel id: self, then the diagonal rendered neighbours
+const float renderedCheckerWeights[5] = float[](0.50000f, 0.28125f, 0.09375f, 0.09375f, 0.03125f);
+const vec2 renderedCheckerTaps[20] = vec2[](
+    vec2( 0.f,  0.f), vec2(-1.f, -1.f), vec2( 2.f, -1.f), vec2(-1.f,  2.f), vec2( 2.f,  2.f),
+    vec2( 0.f,  0.f), vec2( 1.f, -1.f), vec2(-2.f, -1.f), vec2( 1.f,  2.f), vec2(-2.f,  2.f),
+    vec2( 0.f,  0.f), vec2(-1.f,  1.f), vec2( 2.f,  1.f), vec2(-1.f, -2.f), vec2( 2.f, -2.f),
+    vec2( 0.f,  0.f), vec2( 1.f,  1.f), vec2(-2.f,  1.f), vec2( 1.f, -2.f), vec2(-2.f, -2.f));
+
+//false if one of the taps wasn't rendered
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const int camIndex, out vec3 color) {
+    const int pixelID = determinePixelID2x2(pixel);
+    const vec2 pixelC = vec2(pixel) + 0.5f;
+    color = vec3(0.f);
+    for (int i = 0; i < 4; ++i) {
+        const vec2 tap = pixelC + checkerHoleTaps[pixelID*4 + i];
+        if (!tapShaded(tap, camIndex)) {
+            return false;
+        }
+        color += checkerHoleWeights[i] * vec3( texture(texSampler, tap * invWandH) );
+    }
+    return true;
+}
+
+//false if one of the taps wasn't rendered
+bool reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const int camIndex, out vec3 color) {
+    const int pixelID = determinePixelID2x2(pixel);
+    const vec2 pixelC = vec2(pixel) + 0.5f;
+    color = vec3(0.f);
+    for (int i = 0; i < 5; ++i) {
+        const vec2 tap = pixelC + renderedCheckerTaps[pixelID*5 + i];
+        if (!tapShaded(tap, camIndex)) {
+            return false;
+        }
+        color += renderedCheckerWeights[i] * vec3( texture(texSampler, tap * invWandH) );
+    }
+    return true;
+}
+
+//PreMadeStencil::quadShaded, the density patterns are nested so a quad shaded at one shift is shaded at every lower one
+bool quadShaded(const int densityShift, const ivec2 quad) {
+    if (densityShift == 0) { return true; }
+    if (densityShift == 1) { return ((quad.x ^ quad.y) & 1) == 0; }
+    const bool evenQuad = ((quad.x | quad.y) & 1) == 0;
+    return densityShift == 2 ? evenQuad : evenQuad && (((quad.x ^ quad.y) >> 1) & 1) == 0;
+}
+
+//ppStencilHoleFill.frag's lattice fill, bilinear between the 4 shaded lattice quads around the pixel.
+//false if one of them wasn't rendered
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex, out vec3 color) {
+    //lattice point i is quad 2i, its center is pixel corner 4i+1
+    const vec2 p = (vec2(pixel) + 0.5f - 1.f) * 0.25f;
+    //eighth density: shaded points have an even x+y, in (x+y)/2, (x-y)/2 those are every integer point
+    const vec2 a = densityShift == 2 ? p : vec2(p.x + p.y, p.x - p.y) * 0.5f;
+    const vec2 base = floor(a);
+    const vec2 f = a - base;
+
+    vec3 corners[4];
+    for (int i = 0; i < 4; ++i) {
+        const vec2 c = base + vec2(i & 1, i >> 1);
+        const vec2 latticePoint = densityShift == 2 ? c : vec2(c.x + c.y, c.x - c.y);
+        if (!tapShaded(latticePoint*4.f + 1.5f, camIndex)) {
+            return false;
+        }
+        corners[i] = vec3( texture(texSampler, (latticePoint*4.f + 1.f) * invWandH) );
+    }
+    color = mix(mix(corners[0], corners[1], f.x), mix(corners[2], corners[3], f.x), f.y);
+    return true;
+}
@@ -0,0 +1,113 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+//ppStencilHoleFill.frag with the lens radius, ring and checker parity tests baked into HoleFillClassification,
+//one texelFetch says what the pixel is and where it sits in its quad, that picks a fixed tap pattern.
+//the bake already gave holes next to a sparser ring that ring's lattice class, so every tap here was rendered
+
+layout(binding = 0) uniform sampler2D texSampler;
+layout(binding = 1) uniform usampler2D classSampler;//HoleFillClassification, a texel per render target pixel
+
+layout (push_constant) uniform PerDrawCallInfo {
+    int toggleFlags;
+    int virtualWidth;
+    int virtualHeight;
+} PushConstant;
+const int holesOnlyBit = 2;//PipelineType::HOLES_ONLY, writing SubpassHoleFill's output where the stencil test says it's a hole
+const int camBit = 1;
+const int vrBit = 0;
+
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragNor;
+layout(location = 3) in vec3 fragTan;
+layout(location = 4) in vec3 fragBiTan;
+
+layout(location = 0) out vec4 outColor;
+
+//HoleFillClassification::CLASS_*, bits 0-2 of the texel. bits 3-4 are the pixel id (0 upper left, 3 lower right of its quad)
+const uint CLASS_OUTSIDE            = 0u;
+const uint CLASS_RENDERED           = 1u;
+const uint CLASS_RENDERED_CHECKER   = 2u;
+const uint CLASS_CHECKER_HOLE       = 3u;
+const uint CLASS_QUARTER_HOLE       = 4u;
+const uint CLASS_EIGHTH_HOLE        = 5u;
+
+//ppStencilHoleFill.frag's fillCheckerHole taps per pixel id: above/below, left/right, then the skips across the hole
+const float checkerHoleWeights[4] = float[](0.375f, 0.375f, 0.125f, 0.125f);
+const vec2 checkerHoleTaps[16] = vec2[](
+    vec2( 0.f, -1.f), vec2(-1.f,  0.f), vec2( 2.f,  0.f), vec2( 0.f,  2.f),
+    vec2( 0.f, -1.f), vec2( 1.f,  0.f), vec2(-2.f,  0.f), vec2( 0.f,  2.f),
+    vec2( 0.f,  1.f), vec2(-1.f,  0.f), vec2( 2.f,  0.f), vec2( 0.f, -2.f),
+    vec2( 0.f,  1.f), vec2( 1.f,  0.f), vec2(-2.f,  0.f), vec2( 0.f, -2.f));
+
+//reshadeRenderedChecker taps per pixel id: self, then the diagonal rendered neighbours
+const float renderedCheckerWeights[5] = float[](0.50000f, 0.28125f, 0.09375f, 0.09375f, 0.03125f);
+const vec2 renderedCheckerTaps[20] = vec2[](
+    vec2( 0.f,  0.f), vec2(-1.f, -1.f), vec2( 2.f, -1.f), vec2(-1.f,  2.f), vec2( 2.f,  2.f),
+    vec2( 0.f,  0.f), vec2( 1.f, -1.f), vec2(-2.f, -1.f), vec2( 1.f,  2.f), vec2(-2.f,  2.f),
+    vec2( 0.f,  0.f), vec2(-1.f,  1.f), vec2( 2.f,  1.f), vec2(-1.f, -2.f), vec2( 2.f, -2.f),
+    vec2( 0.f,  0.f), vec2( 1.f,  1.f), vec2(-2.f,  1.f), vec2( 1.f, -2.f), vec2(-2.f, -2.f));
+
+void fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH);
+
+void main() {
+    const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    //if vrMode, shrink UV.x by half and shift to sample one eye
+    vec2 fragTexCoord = fragUV;
+    fragTexCoord.x = (fragTexCoord.x * (1.f - 0.5*vrMode)) + 0.5f*camIndex;
+
+    //just sample normally if not vrMode
+    if(0 == vrMode) { outColor = texture(texSampler, fragTexCoord); return;}
+
+    const ivec2 pixel = ivec2(gl_FragCoord.x, gl_FragCoord.y);
+    const uint texel = texelFetch(classSampler, pixel, 0).x;
+    const uint pixelClass = texel & 0x7u;
+    const int pixelID = int(texel >> 3u);
+
+    const vec2 invWandH = vec2(1.f / PushConstant.virtualWidth, 1.f / PushConstant.virtualHeight);
+    const vec2 pixelC = vec2(pixel) + 0.5f;
+
+    if (pixelClass == CLASS_RENDERED) {
+        outColor = texture(texSampler, fragTexCoord);
+    } else if (pixelClass == CLASS_RENDERED_CHECKER) {
+        vec3 color = vec3(0.f);
+        for (int i = 0; i < 5; ++i) {
+            color += renderedCheckerWeights[i] * vec3( texture(texSampler, (pixelC + renderedCheckerTaps[pixelID*5 + i]) * invWandH) );
+        }
+        outColor = vec4(color, 1.f);
+    } else if (pixelClass == CLASS_CHECKER_HOLE) {
+        vec3 color = vec3(0.f);
+        for (int i = 0; i < 4; ++i) {
+            color += checkerHoleWeights[i] * vec3( texture(texSampler, (pixelC + checkerHoleTaps[pixelID*4 + i]) * invWandH) );
+        }
+        outColor = vec4(color, 1.f);
+    } else if (pixelClass == CLASS_QUARTER_HOLE || pixelClass == CLASS_EIGHTH_HOLE) {
+        fillLatticeHole(pixel, pixelClass == CLASS_QUARTER_HOLE ? 2 : 3, invWandH);
+    } else {//outside lens range
+        //in place it already is and the holes' taps read it, so it's left alone
+        if (0 != ((PushConstant.toggleFlags >> holesOnlyBit) & 1)) { discard; }
+        outColor = vec4(0.f,0.f,0.f,1.f); //no need to fetch, it's black
+    }
+}
+
+//ppStencilHoleFill.frag's lattice fill, bilinear between the 4 shaded lattice quads around the pixel
+void fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH) {
+    //lattice point i is quad 2i, its center is pixel corner 4i+1
+    const vec2 p = (vec2(pixel) + 0.5f - 1.f) * 0.25f;
+    //eighth density: shaded points have an even x+y, in (x+y)/2, (x-y)/2 those are every integer point
+    const vec2 a = densityShift == 2 ? p : vec2(p.x + p.y, p.x - p.y) * 0.5f;
+    const vec2 base = floor(a);
+    const vec2 f = a - base;
+
+    vec3 corners[4];
+    for (int i = 0; i < 4; ++i) {
+        const vec2 c = base + vec2(i & 1, i >> 1);
+        const vec2 latticePoint = densityShift == 2 ? c : vec2(c.x + c.y, c.x - c.y);
+        //sample the middle of the quad, any of its 4 pixels were shaded
+        corners[i] = vec3( texture(texSampler, (latticePoint*4.f + 1.f) * invWandH) );
+    }
+    outColor = vec4(mix(mix(corners[0], corners[1], f.x), mix(corners[2], corners[3], f.x), f.y), 1.f);
+}
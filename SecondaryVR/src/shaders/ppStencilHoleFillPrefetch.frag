@@ -7,7 +7,11 @@ layout (push_constant) uniform PerDrawCallInfo {
     int toggleFlags;
     int virtualWidth;
     int virtualHeight;
+    int gridQuadsPerDim;
+    vec4 stencilRingRadii;//PreMadeStencil::getRingRadii, innermost first, unused rings are -1
+    int stencilRingShifts;//4 bits per ring, the ring shades 1 in 2^shift quads
 } PushConstant;
+const int holesOnlyBit = 2;//PipelineType::HOLES_ONLY, writing SubpassHoleFill's output where the stencil test says it's a hole
 const int camBit = 1;
 const int vrBit = 0;
 
@@ -20,13 +24,17 @@ layout(location = 4) in vec3 fragBiTan;
 
 layout(location = 0) out vec4 outColor;
 
-const float middleRegionRadius = 0.52;//roughly 0.52
-const float NDCcenterOffset = 0.1425;//0.15 ndc centeer UV center offset 0.0375
-const float extraRadius = NDCcenterOffset*0.5f;//same as NDCcenterOffset?
-const vec2 ndcCenter[2] = { vec2(NDCcenterOffset, 0.f), vec2(-NDCcenterOffset, 0.f) };
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+layout(constant_id = 14) const float NDCcenterOffset = 0.1425;//0.15 ndc centeer UV center offset 0.0375
 
-void fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16]);
-void reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16]);
+vec2 pixelCenterToUV(const vec2 pixelCenter, const vec2 invWandH);
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16], const bool prefetchQuadsShaded[9]);
+bool reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16], const bool prefetchQuadsShaded[9]);
+bool quadShaded(const int densityShift, const ivec2 quad);
+int getDensityShift(const ivec2 quad, const int camIndex);
+bool tapShaded(const vec2 pixelCenter, const int camIndex);
+bool prefetchShaded(const int index, const bool prefetchQuadsShaded[9]);
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex);
 
 void main() {
     const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
@@ -41,17 +49,6 @@ void main() {
 
     //else fill holes
     //POSSIBLE SPIR-V COMPILER BUG: when width and height aren't const bad things happen for the odd cases
-    const ivec2 pixel = ivec2(gl_FragCoord.x, gl_FragCoord.y);
-    const ivec2 groupPixel = ivec2( ((pixel.x & 1) == 1) ? pixel.x : pixel.x+1,
-                                    ((pixel.y & 1) == 1) ? pixel.y : pixel.y+1);
-
-    const vec2 gp = vec2(groupPixel.x+0.5f, groupPixel.y+0.5f);
-    const vec3 prefetch[16] = {vec3(texture(texSampler, gp+vec2(-2.f,-2.f))), vec3(texture(texSampler, gp+vec2(-1.f,-2.f))), vec3(texture(texSampler, gp+vec2( 0.f,-2.f))), vec3(texture(texSampler, gp+vec2( 1.f,-2.f))),
-                               vec3(texture(texSampler, gp+vec2(-2.f,-1.f))), vec3(texture(texSampler, gp+vec2(-1.f,-1.f))), vec3(texture(texSampler, gp+vec2( 0.f,-1.f))), vec3(texture(texSampler, gp+vec2( 1.f,-1.f))),
-                               vec3(texture(texSampler, gp+vec2(-2.f, 0.f))), vec3(texture(texSampler, gp+vec2(-1.f, 0.f))), vec3(texture(texSampler, gp+vec2( 0.f, 0.f))), vec3(texture(texSampler, gp+vec2( 1.f, 0.f))),
-                               vec3(texture(texSampler, gp+vec2(-2.f, 1.f))), vec3(texture(texSampler, gp+vec2(-1.f, 1.f))), vec3(texture(texSampler, gp+vec2( 0.f, 1.f))), vec3(texture(texSampler, gp+vec2( 1.f, 1.f)))
-                              };
-
     const int width = PushConstant.virtualWidth;
     const int height = PushConstant.virtualHeight;
 
@@ -60,36 +57,89 @@ void main() {
     const vec2 invWandH = vec2(invWidth, invHeight);
 
 
+    const ivec2 pixel = ivec2(gl_FragCoord.x, gl_FragCoord.y);
+    const ivec2 quad = pixel >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+
+    if (densityShift >= 0) {
+        const bool rendered = quadShaded(densityShift, quad);
+        bool filled = false;
+        if (densityShift == 1) {//checkerboard 2x2
+            //the 4x4 pixels around the quad every pixel of it needs, fetched once (the quad's lower right pixel is index 10)
+            const vec2 gp = vec2(quad*2 + 1) + 0.5f;
+            const vec3 prefetch[16] = {
+                vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-2.f,-2.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-1.f,-2.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 0.f,-2.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 1.f,-2.f), invWandH))),
+                vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-2.f,-1.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-1.f,-1.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 0.f,-1.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 1.f,-1.f), invWandH))),
+                vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-2.f, 0.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-1.f, 0.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 0.f, 0.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 1.f, 0.f), invWandH))),
+                vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-2.f, 1.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2(-1.f, 1.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 0.f, 1.f), invWandH))), vec3(texture(texSampler, pixelCenterToUV(gp+vec2( 1.f, 1.f), invWandH)))
+            };
+            //the 3x3 quads the prefetch overlaps, near a sparser ring some of them weren't rendered
+            bool prefetchQuadsShaded[9];
+            for (int i = 0; i < 9; ++i) {
+                prefetchQuadsShaded[i] = tapShaded(vec2((quad + ivec2(i % 3 - 1, i / 3 - 1))*2 + 1) + 0.5f, camIndex);
+            }
+            if (rendered) {//rendered pixel 
+                filled = reshadeRenderedChecker(pixel, invWandH, prefetch, prefetchQuadsShaded);
+            } else {//black pixel 
+                filled = fillCheckerHole(pixel, invWandH, prefetch, prefetchQuadsShaded);
+            }
+        }
+
+        if (!filled && !rendered) {//quarter and eighth density holes, or checker holes next to a sparser ring
+            //the sparser ring's fill: the patterns are nested, its lattice quads are shaded in both rings
+            bool latticeFilled = false;
+            for (int shift = max(densityShift, 2); shift < 3 && !latticeFilled; ++shift) {
+                latticeFilled = fillLatticeHole(pixel, shift, invWandH, camIndex);
+            }
+            if (!latticeFilled) {//the eighth lattice's quads are shaded in every ring
+                fillLatticeHole(pixel, 3, invWandH, camIndex);
+            }
+        } else if (!filled) {//full res region, a rendered lattice quad, or a rendered checker pixel whose taps reach a sparser ring
+            outColor = texture(texSampler, fragTexCoord);
+        }
+    } else {//outside lens range
+        //in place it already is and the holes' taps read it, so it's left alone
+        if (0 != ((PushConstant.toggleFlags >> holesOnlyBit) & 1)) { discard; }
+        outColor = vec4(0.f,0.f,0.f,1.f); //no need to fetch, it's black
+    }
+}
+
+//PreMadeStencil's ring test for the quad at its lower right pixel: the density shift of the first ring it's inside of,
+//-1 if it's in none of them (never shaded, the lens edge is the last ring's limit)
+int getDensityShift(const ivec2 quad, const int camIndex) {
+    const int width = PushConstant.virtualWidth;
+    const int height = PushConstant.virtualHeight;
 
     //UV for the 2x2 pixel quad in which it resides
-    const vec2 groupUV = vec2(groupPixel.x*invWidth, groupPixel.y*invHeight);
+    const vec2 groupUV = vec2(quad*2 + 1) / vec2(width, height);
     vec2 equivNDC = vec2((groupUV.x - 0.5*camIndex)*4.f - 1.f, groupUV.y*2.f - 1.f);//convert to eye ndc
 
     //normalize y ndc against half width (eye viewport size) so we get circles and not tall/short vertical ellipses
     //if Y is greater/less than vr eye viewport x (rendertarget width/2)
     equivNDC *= vec2(1.f , height/(width*0.5f)); 
-    const float radius = length(equivNDC - ndcCenter[camIndex]);
+    const vec2 ndcCenter = vec2(camIndex == 0 ? NDCcenterOffset : -NDCcenterOffset, 0.f);
+    const float radius = length(equivNDC - ndcCenter);
 
-
-    if (radius < (1.f + extraRadius)) {
-        if (radius > middleRegionRadius) {//middle region checkerboard 2x2
-            if ( (((groupPixel.x - 1) & 0x3) == 0) && (((groupPixel.y - 1) & 0x3) == 0) //both divis by 4
-              || (((groupPixel.x - 3) & 0x3) == 0) && (((groupPixel.y - 3) & 0x3) == 0)  //shift above pattern to get checker
-            ) {//rendered pixel 
-                reshadeRenderedChecker(pixel, invWandH, prefetch);
-//                outColor = vec4(1.f,0.f,0.f,1.f); 
-//                outColor = texture(texSampler, fragTexCoord);
-            } else {//black pixel 
-                fillCheckerHole(pixel, invWandH, prefetch);
-//                outColor = vec4(0.f,1.f,0.f,1.f); 
-//                outColor = texture(texSampler, fragTexCoord);
-            }
-        } else {//inner region
-            outColor = texture(texSampler, fragTexCoord);
+    for (int ring = 0; ring < 4; ++ring) {
+        if (radius <= PushConstant.stencilRingRadii[ring]) {
+            return (PushConstant.stencilRingShifts >> (4*ring)) & 0xF;
         }
-    } else {//outside lens range
-        outColor = vec4(0.f,0.f,0.f,1.f); //no need to fetch, it's black
     }
+    return -1;
+}
+
+//did the forward pass render the pixel a tap lands on, past the last ring it reads black like the output there
+bool tapShaded(const vec2 pixelCenter, const int camIndex) {
+    const ivec2 quad = ivec2(floor(pixelCenter)) >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+    return densityShift < 0 || quadShaded(densityShift, quad);
+}
+
+//prefetch entries are -2..1 pixels from the quad's lower right pixel, that's quads -1..1 of the 3x3
+bool prefetchShaded(const int index, const bool prefetchQuadsShaded[9]) {
+    const ivec2 offset = ivec2(index & 3, index >> 2) - 2;
+    const ivec2 quadOffset = ((offset + 1) >> 1) + 1;
+    return prefetchQuadsShaded[quadOffset.y*3 + quadOffset.x];
 }
 
 int determinePixelID2x2(const ivec2 pixel) {
@@ -114,7 +164,8 @@ vec2 pixelCenterToUV(const vec2 pixelCenter, const vec2 invWandH) {
 	return pixelCenter * invWandH;
 }
 
-void fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16]) {
+//false (nothing written) if one of the taps wasn't rendered
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16], const bool prefetchQuadsShaded[9]) {
 	const int pixelID = determinePixelID2x2(pixel);//numbered like reading a book(0 is upper left, 3 is lower right)
 	const vec2 pixelC = vec2(pixel.x + 0.5f, pixel.y + 0.5f);
 	const float w1 = 0.375f;
@@ -153,14 +204,20 @@ void fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch
 		offset3 = pixelIndex-2 + ( 0*prefetchWidth);//skip left
 		offset4 = pixelIndex+0 + (-2*prefetchWidth);//skip up
 	}
+    if (!prefetchShaded(offset1, prefetchQuadsShaded) || !prefetchShaded(offset2, prefetchQuadsShaded) ||
+        !prefetchShaded(offset3, prefetchQuadsShaded) || !prefetchShaded(offset4, prefetchQuadsShaded)) {
+        return false;
+    }
     const vec3 sample1 =  w1 * prefetch[offset1];
     const vec3 sample2 =  w2 * prefetch[offset2];
     const vec3 sample3 =  w3 * prefetch[offset3];
     const vec3 sample4 =  w4 * prefetch[offset4];
     outColor = vec4(sample1 + sample2 + sample3 + sample4, 1.f);
+    return true;
 }
 
-void reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16]) {
+//false (nothing written) if one of the taps wasn't rendered
+bool reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const vec3 prefetch[16], const bool prefetchQuadsShaded[9]) {
 	const int pixelID = determinePixelID2x2(pixel);//numbered like reading a book(0 is upper left, 3 is lower right)
 	const vec2 pixelC = vec2(pixel.x + 0.5f, pixel.y + 0.5f);
 	const float w1 = 0.50000f;
@@ -204,10 +261,51 @@ void reshadeRenderedChecker(const ivec2 pixel, const vec2 invWandH, const vec3 p
 		offset4 = pixelIndex+1 + (-2*prefetchWidth);//1Right 2Up
 		offset5 = pixelIndex-2 + (-2*prefetchWidth);//2Left 2Up
 	}
+    if (!prefetchShaded(offset2, prefetchQuadsShaded) || !prefetchShaded(offset3, prefetchQuadsShaded) ||
+        !prefetchShaded(offset4, prefetchQuadsShaded) || !prefetchShaded(offset5, prefetchQuadsShaded)) {
+        return false;
+    }
     const vec3 sample1 =  w1 * prefetch[offset1];
     const vec3 sample2 =  w2 * prefetch[offset2];
     const vec3 sample3 =  w3 * prefetch[offset3];
     const vec3 sample4 =  w4 * prefetch[offset4];
     const vec3 sample5 =  w5 * prefetch[offset5];
     outColor = vec4(sample1 + sample2 + sample3 + sample4 + sample5, 1.f);
+    return true;
+}
+
+//PreMadeStencil::quadShaded, the density patterns are nested so a quad shaded at one shift is shaded at every lower one
+bool quadShaded(const int densityShift, const ivec2 quad) {
+    if (densityShift == 0) { return true; }
+    if (densityShift == 1) { return ((quad.x ^ quad.y) & 1) == 0; }
+    const bool evenQuad = ((quad.x | quad.y) & 1) == 0;
+    return densityShift == 2 ? evenQuad : evenQuad && (((quad.x ^ quad.y) >> 1) & 1) == 0;
+}
+
+//same as ppStencilHoleFill.frag, the lattice quads are too far apart to share a prefetch
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex) {
+    //lattice point i is quad 2i, its center is pixel corner 4i+1
+    const vec2 p = (vec2(pixel) + 0.5f - 1.f) * 0.25f;
+    //eighth density: shaded points have an even x+y, in (x+y)/2, (x-y)/2 those are every integer point
+    const vec2 a = densityShift == 2 ? p : vec2(p.x + p.y, p.x - p.y) * 0.5f;
+    const vec2 base = floor(a);
+    const vec2 f = a - base;
+
+    vec2 latticePixels[4];
+    for (int i = 0; i < 4; ++i) {
+        const vec2 c = base + vec2(i & 1, i >> 1);
+        const vec2 latticePoint = densityShift == 2 ? c : vec2(c.x + c.y, c.x - c.y);
+        //sample the middle of the quad, any of its 4 pixels were shaded
+        latticePixels[i] = latticePoint*4.f + 1.f;
+        if (!tapShaded(latticePixels[i] + 0.5f, camIndex)) {
+            return false;
+        }
+    }
+
+    vec3 corners[4];
+    for (int i = 0; i < 4; ++i) {
+        corners[i] = vec3( texture(texSampler, pixelCenterToUV(latticePixels[i], invWandH)) );
+    }
+    outColor = vec4(mix(mix(corners[0], corners[1], f.x), mix(corners[2], corners[3], f.x), f.y), 1.f);
+    return true;
 }
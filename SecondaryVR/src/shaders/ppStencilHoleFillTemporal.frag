@@ -0,0 +1,286 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+//ppStencilHoleFill.frag for temporalCheckerStencil (see GlobalSettings.h): the checker rings shade the other half of their quads
+//every other frame, so a checker hole is filled from this stage's previous output reprojected with last frame's view projection.
+//if the history doesn't fit the hole's neighbours (disocclusion, history isn't last frame's) it falls back to the spatial fill
+
+layout(binding = 0) uniform sampler2D texSampler;
+layout(binding = 1) uniform sampler2D historySampler;//this stage's output for the previous swap image
+layout(binding = 2) uniform sampler2D depthSampler;//this frame's forward depth
+
+layout(binding = 3) uniform TemporalHoleFillUBO {
+    mat4 reprojection[2];//per eye, this frame's ndc to last frame's clip space
+    int stencilPhase;//the checker half that was shaded this frame, Camera::stencilPhase
+    int historyValid;
+} ubo;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    int toggleFlags;
+    int virtualWidth;
+    int virtualHeight;
+    int gridQuadsPerDim;
+    vec4 stencilRingRadii;//PreMadeStencil::getRingRadii, innermost first, unused rings are -1
+    int stencilRingShifts;//4 bits per ring, the ring shades 1 in 2^shift quads
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragNor;
+layout(location = 3) in vec3 fragTan;
+layout(location = 4) in vec3 fragBiTan;
+
+layout(location = 0) out vec4 outColor;
+
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+layout(constant_id = 14) const float NDCcenterOffset = 0.1425;//0.15 ndc centeer UV center offset 0.0375
+
+void fillTemporalHole(const ivec2 pixel, const int camIndex, const vec2 invWandH);
+vec2 pixelCenterToUV(const vec2 pixelCenter, const vec2 invWandH);
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const int camIndex);
+bool quadShaded(const int densityShift, const ivec2 quad);
+int getDensityShift(const ivec2 quad, const int camIndex);
+bool tapShaded(const vec2 pixelCenter, const int camIndex);
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex);
+void fillHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex);
+
+void main() {
+    const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    //if vrMode, shrink UV.x by half and shift to sample one eye
+    vec2 fragTexCoord = fragUV;
+    fragTexCoord.x = (fragTexCoord.x * (1.f - 0.5*vrMode)) + 0.5f*camIndex;
+
+    //just sample normally if not vrMode
+    if(0 == vrMode) { outColor = texture(texSampler, fragTexCoord); return;}
+
+    //else fill holes
+    const int width = PushConstant.virtualWidth;
+    const int height = PushConstant.virtualHeight;
+
+    const float invWidth = 1.f / width;
+    const float invHeight = 1.f / height;
+    const vec2 invWandH = vec2(invWidth, invHeight);
+
+
+    const ivec2 pixel = ivec2(gl_FragCoord.x, gl_FragCoord.y);
+    const ivec2 quad = pixel >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+
+    if (densityShift >= 0) {
+        if (densityShift == 1) {//checkerboard 2x2, the odd phase shades the quads one to the right (PreMadeStencil::quadShadedAlternate)
+            if (quadShaded(1, quad + ivec2(ubo.stencilPhase, 0))) {//rendered this frame, full res once the holes are filled
+                outColor = texture(texSampler, fragTexCoord);
+            } else {//rendered last frame
+                fillTemporalHole(pixel, camIndex, invWandH);
+            }
+        } else if (densityShift > 1 && !quadShaded(densityShift, quad)) {//quarter and eighth density holes
+            fillHole(pixel, densityShift, invWandH, camIndex);
+        } else {//full res region or a rendered quad
+            outColor = texture(texSampler, fragTexCoord);
+        }
+    } else {//outside lens range
+        outColor = vec4(0.f,0.f,0.f,1.f); //no need to fetch, it's black
+    }
+}
+
+//ppStencilHoleFill.frag's spatial fill: near a sparser ring the hole takes that ring's lattice fill
+void fillHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex) {
+    if (densityShift == 1 && fillCheckerHole(pixel, invWandH, camIndex)) {
+        return;
+    }
+    for (int shift = max(densityShift, 2); shift < 3; ++shift) {
+        if (fillLatticeHole(pixel, shift, invWandH, camIndex)) {
+            return;
+        }
+    }
+    if (!fillLatticeHole(pixel, 3, invWandH, camIndex)) {//an odd phase corner whose right neighbour is past the checker ring
+        outColor = vec4(0.f,0.f,0.f,1.f);
+    }
+}
+
+//PreMadeStencil's ring test for the quad at its lower right pixel: the density shift of the first ring it's inside of,
+//-1 if it's in none of them (never shaded, the lens edge is the last ring's limit)
+int getDensityShift(const ivec2 quad, const int camIndex) {
+    const int width = PushConstant.virtualWidth;
+    const int height = PushConstant.virtualHeight;
+
+    //UV for the 2x2 pixel quad in which it resides
+    const vec2 groupUV = vec2(quad*2 + 1) / vec2(width, height);
+    vec2 equivNDC = vec2((groupUV.x - 0.5*camIndex)*4.f - 1.f, groupUV.y*2.f - 1.f);//convert to eye ndc
+
+    //normalize y ndc against half width (eye viewport size) so we get circles and not tall/short vertical ellipses
+    equivNDC *= vec2(1.f , height/(width*0.5f)); 
+    const vec2 ndcCenter = vec2(camIndex == 0 ? NDCcenterOffset : -NDCcenterOffset, 0.f);
+    const float radius = length(equivNDC - ndcCenter);
+
+    for (int ring = 0; ring < 4; ++ring) {
+        if (radius <= PushConstant.stencilRingRadii[ring]) {
+            return (PushConstant.stencilRingShifts >> (4*ring)) & 0xF;
+        }
+    }
+    return -1;
+}
+
+//did the forward pass render the pixel a tap lands on this frame, past the last ring it reads black like the output there
+bool tapShaded(const vec2 pixelCenter, const int camIndex) {
+    const ivec2 quad = ivec2(floor(pixelCenter)) >> 1;
+    const int densityShift = getDensityShift(quad, camIndex);
+    return densityShift < 0 || quadShaded(densityShift, densityShift == 1 ? quad + ivec2(ubo.stencilPhase, 0) : quad);
+}
+
+//the hole's 4 edge neighbour quads were shaded this frame: their colors bound what the history may be,
+//the nearest of their depths stands in for the hole's (its own depth was never written)
+void fillTemporalHole(const ivec2 pixel, const int camIndex, const vec2 invWandH) {
+    if (ubo.historyValid == 0) { fillHole(pixel, 1, invWandH, camIndex); return; }
+
+    const vec2 quadCenter = vec2((pixel >> 1) * 2 + 1);
+    const vec2 neighbourOffsets[4] = vec2[](vec2(-2.f, 0.f), vec2(2.f, 0.f), vec2(0.f, -2.f), vec2(0.f, 2.f));
+    vec3 boxMin = vec3(1e20f);
+    vec3 boxMax = vec3(-1e20f);
+    float depth = 1.f;
+    int numNeighbours = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!tapShaded(quadCenter + neighbourOffsets[i] + 0.5f, camIndex)) {
+            continue;//next to a sparser ring, it has no color or depth
+        }
+        const vec2 uv = pixelCenterToUV(quadCenter + neighbourOffsets[i], invWandH);
+        const vec3 neighbour = vec3( texture(texSampler, uv) );
+        boxMin = min(boxMin, neighbour);
+        boxMax = max(boxMax, neighbour);
+        depth = min(depth, texture(depthSampler, uv).x);
+        ++numNeighbours;
+    }
+    if (numNeighbours == 0) { fillHole(pixel, 1, invWandH, camIndex); return; }
+
+    //this pixel in the eye's ndc, back to last frame's
+    const vec2 uv = pixelCenterToUV(vec2(pixel) + 0.5f, invWandH);
+    const vec4 ndc = vec4((uv.x - 0.5f*camIndex)*4.f - 1.f, uv.y*2.f - 1.f, depth, 1.f);
+    const vec4 prevClip = ubo.reprojection[camIndex] * ndc;
+    const vec2 prevNDC = prevClip.xy / prevClip.w;
+    if (prevClip.w <= 0.f || any(greaterThan(abs(prevNDC), vec2(1.f)))) { fillHole(pixel, 1, invWandH, camIndex); return; }
+
+    vec2 prevUV = prevNDC * 0.5f + 0.5f;
+    prevUV.x = prevUV.x*0.5f + 0.5f*camIndex;
+    const vec3 history = vec3( texture(historySampler, prevUV) );
+
+    //a little slack past the neighbours' range so thin detail and gradients that only the hole has keep their history
+    const vec3 slack = 0.125f*(boxMax - boxMin) + 0.02f;
+    if (any(lessThan(history, boxMin - slack)) || any(greaterThan(history, boxMax + slack))) {
+        fillHole(pixel, 1, invWandH, camIndex);//disoccluded or moved too far
+        return;
+    }
+    outColor = vec4(history, 1.f);
+}
+
+int determinePixelID2x2(const ivec2 pixel) {
+	bool xOdd = (pixel.x & 1) == 1;
+	bool yOdd = (pixel.y & 1) == 1;
+	if(xOdd) {//right in group
+		if(yOdd) {//down in group (vulkan upper left is 0,0)
+			return 3;
+		} else { //up in group
+			return 1;
+		}
+	} else { //left in group
+		if(yOdd) {//down in group (vulkan upper left is 0,0)
+			return 2;
+		} else { //up in group
+			return 0;
+		}
+	}
+}
+
+vec2 pixelCenterToUV(const vec2 pixelCenter, const vec2 invWandH) {
+	return pixelCenter * invWandH;
+}
+
+//false (nothing written) if one of the taps wasn't rendered
+bool fillCheckerHole(const ivec2 pixel, const vec2 invWandH, const int camIndex) {
+	const int pixelID = determinePixelID2x2(pixel);//numbered like reading a book(0 is upper left, 3 is lower right)
+	const vec2 pixelC = vec2(pixel.x + 0.5f, pixel.y + 0.5f);
+	const float w1 = 0.375f;
+	const float w2 = 0.375f;
+	const float w3 = 0.125f;
+	const float w4 = 0.125f;
+    vec2 offset1;
+    vec2 offset2;
+    vec2 offset3;
+    vec2 offset4;
+	if		 (pixelID == 0) {//upper left
+		offset1 = vec2( 0.f, -1.f);//above
+		offset2 = vec2(-1.f,  0.f);//left
+		offset3 = vec2( 2.f,  0.f);//skip right
+		offset4 = vec2( 0.f,  2.f);//skip down
+	} else if(pixelID == 1) {//upper right
+		offset1 = vec2( 0.f, -1.f);//above
+		offset2 = vec2( 1.f,  0.f);//right
+		offset3 = vec2(-2.f,  0.f);//skip left
+		offset4 = vec2( 0.f,  2.f);//skip down
+	} else if(pixelID == 2) {//lower left
+		offset1 = vec2( 0.f,  1.f);//below
+		offset2 = vec2(-1.f,  0.f);//left
+		offset3 = vec2( 2.f,  0.f);//skip right
+		offset4 = vec2( 0.f, -2.f);//skip up
+	} else if(pixelID == 3) {//lower right
+		offset1 = vec2( 0.f,  1.f);//below
+		offset2 = vec2( 1.f,  0.f);//right
+		offset3 = vec2(-2.f,  0.f);//skip left
+		offset4 = vec2( 0.f, -2.f);//skip up
+	}
+    if (!tapShaded(pixelC+offset1, camIndex) || !tapShaded(pixelC+offset2, camIndex) ||
+        !tapShaded(pixelC+offset3, camIndex) || !tapShaded(pixelC+offset4, camIndex)) {
+        return false;
+    }
+    const vec3 sample1 =  w1 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset1, invWandH)) );
+    const vec3 sample2 =  w2 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset2, invWandH)) );
+    const vec3 sample3 =  w3 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset3, invWandH)) );
+    const vec3 sample4 =  w4 * vec3( texture(texSampler, pixelCenterToUV(pixelC+offset4, invWandH)) );
+    outColor = vec4(sample1 + sample2 + sample3 + sample4, 1.f);
+    return true;
+}
+
+//PreMadeStencil::quadShaded, the density patterns are nested so a quad shaded at one shift is shaded at every lower one
+bool quadShaded(const int densityShift, const ivec2 quad) {
+    if (densityShift == 0) { return true; }
+    if (densityShift == 1) { return ((quad.x ^ quad.y) & 1) == 0; }
+    const bool evenQuad = ((quad.x | quad.y) & 1) == 0;
+    return densityShift == 2 ? evenQuad : evenQuad && (((quad.x ^ quad.y) >> 1) & 1) == 0;
+}
+
+//a quarter density ring is shaded on a square lattice of quads (every other quad in x and y),
+//an eighth density ring on every other point of it (a lattice rotated 45 degrees).
+//bilinear between the 4 shaded lattice quads around the pixel, false (nothing written) if one of them wasn't rendered
+bool fillLatticeHole(const ivec2 pixel, const int densityShift, const vec2 invWandH, const int camIndex) {
+    //lattice point i is quad 2i, its center is pixel corner 4i+1
+    const vec2 p = (vec2(pixel) + 0.5f - 1.f) * 0.25f;
+    //eighth density: shaded points have an even x+y, in (x+y)/2, (x-y)/2 those are every integer point
+    const vec2 a = densityShift == 2 ? p : vec2(p.x + p.y, p.x - p.y) * 0.5f;
+    const vec2 base = floor(a);
+    const vec2 f = a - base;
+
+    vec2 latticePixels[4];
+    for (int i = 0; i < 4; ++i) {
+        const vec2 c = base + vec2(i & 1, i >> 1);
+        const vec2 latticePoint = densityShift == 2 ? c : vec2(c.x + c.y, c.x - c.y);
+        //sample the middle of the quad, any of its 4 pixels were shaded
+        latticePixels[i] = latticePoint*4.f + 1.f;
+        if (!tapShaded(latticePixels[i] + 0.5f, camIndex)) {
+            //a lattice quad in a checker ring isn't shaded on the odd phase, the quad to its right is
+            latticePixels[i].x += 2.f;
+            if (!tapShaded(latticePixels[i] + 0.5f, camIndex)) {
+                return false;
+            }
+        }
+    }
+
+    vec3 corners[4];
+    for (int i = 0; i < 4; ++i) {
+        corners[i] = vec3( texture(texSampler, pixelCenterToUV(latticePixels[i], invWandH)) );
+    }
+    outColor = vec4(mix(mix(corners[0], corners[1], f.x), mix(corners[2], corners[3], f.x), f.y), 1.f);
+    return true;
+}
@@ -19,12 +19,9 @@ layout (push_constant) uniform PerDrawCallInfo {
 const int camBit = 1;
 const int vrBit = 0;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inNor;
-layout(location = 4) in vec3 inTan;
-layout(location = 5) in vec3 inBiTan;
+//PostProcessVertex (see Vertex.h): snorm ndc scaled by POSITION_RANGE, uv is derived from it
+layout(location = 0) in vec2 inPosition;
+const float POSITION_RANGE = 4.0;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
@@ -41,13 +38,14 @@ void main() {
     const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
 
     //if vrMode(this shader only enabled in vrMode anyway), shrink UV.x by half and shift to sample one eye
-    vec2 uv = inTexCoord;
+    const vec2 ndcXY = inPosition * POSITION_RANGE;
+    vec2 uv = ndcXY * 0.5 + 0.5;
     uv.x = (uv.x * (1.f - 0.5*vrMode)) + 0.5f*camIndex;
     fragTexCoord    = uv;
 
     //convert inPosition to ndc with depth
     const mat4 vp = ubo.proj * ubo.view[camIndex];
-    const vec3 ndc = vec3(inPosition.x, inPosition.y, texture(DepthSampler, uv).x);
+    const vec3 ndc = vec3(ndcXY, texture(DepthSampler, uv).x);
     const vec4 worldPos = PushConstant.timeWarpInvVP * vec4(ndc,1.f);
     const vec4 updatedCamPos = vp * worldPos;
     gl_Position     = updatedCamPos;
@@ -0,0 +1,100 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+//time warp and ppBarrelAbFragCommonUse.frag in one pass straight into the swapchain image.
+//the barrel/aberration gives the 3 undistorted uv's this pixel sees with the current head rotation, each of them is taken
+//back to where it was in the warped image and sampled there. time warp locks the eye positions and only updates the rotation,
+//so depth barely moves the result: the first guess uses the depth under the current uv, the second the depth it lands on
+
+layout(binding = 1) uniform sampler2D ColorSampler;
+layout(binding = 2) uniform sampler2D DepthSampler;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    mat4 timeWarpInvVP;
+    int toggleFlags;
+    int width;
+    int height;
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 2) in vec3 fragNor;
+layout(location = 3) in vec3 fragTan;
+layout(location = 4) in vec3 fragBiTan;
+layout(location = 5) flat in mat4 currentToWarped;//ppTimeWarpBarrelAb.vert
+
+layout(location = 0) out vec4 outColor;
+
+
+//HmdProfile specialization constants (see HmdSpecializationData), defaults are the dk1
+//lens center, scale and scale in are worked out on the cpu per profile
+layout(constant_id = 0)  const float WARP_K0 = 1.0;
+layout(constant_id = 1)  const float WARP_K1 = 0.22;
+layout(constant_id = 2)  const float WARP_K2 = 0.24;
+layout(constant_id = 3)  const float WARP_K3 = 0.0;
+layout(constant_id = 4)  const float CHROMAB_C0 = 0.996;
+layout(constant_id = 5)  const float CHROMAB_C1 = -0.004;
+layout(constant_id = 6)  const float CHROMAB_C2 = 1.014;
+layout(constant_id = 7)  const float CHROMAB_C3 = 0.0;
+layout(constant_id = 8)  const float LENS_CENTER_SHIFT = 0.0379941;
+layout(constant_id = 9)  const float SCALE_X = 0.145806;
+layout(constant_id = 10) const float SCALE_Y = 0.233290;
+layout(constant_id = 11) const float SCALE_IN_X = 4.0;
+layout(constant_id = 12) const float SCALE_IN_Y = 2.5;
+
+//side by side uv of the current frame -> side by side uv in the warped image, w <= 0 is behind the warped camera
+vec2 reproject(const vec2 tc, const float depth, const int camIndex) {
+    const vec2 ndc = vec2((tc.x - 0.5f*camIndex)*4.f - 1.f, tc.y*2.f - 1.f);
+    const vec4 warped = currentToWarped * vec4(ndc, depth, 1.f);
+    if (warped.w <= 0.f) { return vec2(-1.f); }
+    const vec2 warpedNDC = warped.xy / warped.w;
+    return vec2((warpedNDC.x*0.5f + 0.5f)*0.5f + 0.5f*camIndex, warpedNDC.y*0.5f + 0.5f);
+}
+
+//color channel at a warped side by side uv, black once it leaves the eye's half (nothing was rendered there)
+float sampleWarped(const vec2 uv, const int camIndex, const int channel) {
+    const vec2 eyeUV = vec2((uv.x - 0.5f*camIndex)*2.f, uv.y);
+    if (any(lessThan(eyeUV, vec2(0.f))) || any(greaterThan(eyeUV, vec2(1.f)))) { return 0.f; }
+    return texture(ColorSampler, uv)[channel];
+}
+
+void main() {
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    //time warp only runs in vrMode, shrink UV.x by half and shift to one eye
+    vec2 oTexCoord = fragUV;
+    oTexCoord.x = (oTexCoord.x * 0.5f) + 0.5f*camIndex;
+
+    // Set up values for the shader
+    const bool isRight = oTexCoord.x > 0.5;
+    const vec2 LensCenter = vec2(isRight ? 0.75 - LENS_CENTER_SHIFT : 0.25 + LENS_CENTER_SHIFT, 0.5);
+    const vec2 Scale = vec2(SCALE_X, SCALE_Y);
+    const vec2 ScaleIn = vec2(SCALE_IN_X, SCALE_IN_Y);
+
+    // Compute the warp
+    vec2 theta = (oTexCoord - LensCenter) * ScaleIn; // Scales to [-1, 1]
+    float rSq = theta.x * theta.x + theta.y * theta.y;
+    vec2 theta1 = theta * (WARP_K0 + rSq * (WARP_K1 + rSq * (WARP_K2 + rSq * WARP_K3)));
+
+    // Compute chromatic aberration
+    vec2 thetaRed = theta1 * (CHROMAB_C0 + CHROMAB_C1 * rSq);
+    vec2 thetaBlue = theta1 * (CHROMAB_C2 + CHROMAB_C3 * rSq);
+    vec2 tcRed = LensCenter + Scale * thetaRed;
+    vec2 tcGreen = LensCenter + Scale * theta1;
+    vec2 tcBlue = LensCenter + Scale * thetaBlue;
+
+    vec2 equivNDC = vec2((tcGreen.x - 0.5*camIndex)*4.f-1.f , tcGreen.y*2.f-1.f);
+    if(any(greaterThan(abs(equivNDC), vec2(1.f)))) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    //the channels are a few pixels apart, green's depth does for all 3
+    const vec2 guess = reproject(tcGreen, texture(DepthSampler, tcGreen).x, camIndex);
+    const float depth = texture(DepthSampler, clamp(guess, vec2(0.f), vec2(1.f))).x;
+    outColor = vec4(sampleWarped(reproject(tcRed, depth, camIndex), camIndex, 0),
+                    sampleWarped(reproject(tcGreen, depth, camIndex), camIndex, 1),
+                    sampleWarped(reproject(tcBlue, depth, camIndex), camIndex, 2), 1.f);
+}
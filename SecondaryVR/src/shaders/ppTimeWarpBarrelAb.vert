@@ -0,0 +1,46 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//ppFullscreenTriangle.vert for ppTimeWarpBarrelAb.frag (PP_GEOMETRY_TRIANGLE, see GlobalSettings.h), draw 3 vertices
+//also hands the frag the matrix that takes this frame's ndc back to the ndc of the frame that is being warped,
+//the two inverses are done here once per vertex instead of per pixel
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view[2];
+    mat4 proj;
+    float time;
+} ubo;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    mat4 timeWarpInvVP;
+    int toggleFlags;
+    int renderTargetWidth;
+    int renderTargetHeight;
+    int gridQuadsPerDim;
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNor;
+layout(location = 3) out vec3 fragTan;
+layout(location = 4) out vec3 fragBiTan;
+layout(location = 5) flat out mat4 currentToWarped;//takes locations 5-8
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    const vec2 uv   = vec2(gl_VertexIndex & 2, (gl_VertexIndex << 1) & 2);
+    gl_Position     = vec4(uv * 2.0 - 1.0, 0.5, 1.0);
+    fragTexCoord    = uv;
+
+    //ppTimeWarpGrid.vert goes warped ndc -> world -> current ndc, this is the other way around:
+    //inverse(timeWarpInvVP) is the view proj the warped image was rendered with
+    const mat4 vp = ubo.proj * ubo.view[camIndex];
+    currentToWarped = inverse(PushConstant.timeWarpInvVP) * inverse(vp);
+}
@@ -0,0 +1,60 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//ppTimeWarp.vert without a vertex buffer (PP_GEOMETRY_GRID, see GlobalSettings.h), draw gridQuadsPerDim^2 * 6 vertices
+
+layout(binding = 1) uniform sampler2D ColorSampler;
+layout(binding = 2) uniform sampler2D DepthSampler;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view[2];
+    mat4 proj;
+    float time;
+} ubo;
+
+layout (push_constant) uniform PerDrawCallInfo {
+    mat4 timeWarpInvVP;
+    int toggleFlags;
+    int renderTargetWidth;
+    int renderTargetHeight;
+    int gridQuadsPerDim;
+} PushConstant;
+const int camBit = 1;
+const int vrBit = 0;
+
+//two triangles per quad, same corners and winding as Mesh::genGridMesh
+const ivec2 quadCorners[6] = ivec2[](ivec2(0, 0), ivec2(1, 1), ivec2(1, 0),
+                                     ivec2(0, 1), ivec2(1, 1), ivec2(0, 0));
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNor;
+layout(location = 3) out vec3 fragTan;
+layout(location = 4) out vec3 fragBiTan;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+    const int vrMode = (PushConstant.toggleFlags >> vrBit) & 1;
+    const int camIndex = (PushConstant.toggleFlags >> camBit) & 1;
+
+    //if vrMode(this shader only enabled in vrMode anyway), shrink UV.x by half and shift to sample one eye
+    const int quadsPerDim = PushConstant.gridQuadsPerDim;
+    const int quad = gl_VertexIndex / 6;
+    const ivec2 gridPos = ivec2(quad % quadsPerDim, quad / quadsPerDim) + quadCorners[gl_VertexIndex % 6];
+    const vec2 ndcXY = vec2(gridPos) * (2.0 / float(quadsPerDim)) - 1.0;
+    vec2 uv = ndcXY * 0.5 + 0.5;
+    uv.x = (uv.x * (1.f - 0.5*vrMode)) + 0.5f*camIndex;
+    fragTexCoord    = uv;
+
+    //convert the grid position to ndc with depth
+    const mat4 vp = ubo.proj * ubo.view[camIndex];
+    const vec3 ndc = vec3(ndcXY, texture(DepthSampler, uv).x);
+    const vec4 worldPos = PushConstant.timeWarpInvVP * vec4(ndc,1.f);
+    const vec4 updatedCamPos = vp * worldPos;
+    gl_Position     = updatedCamPos;
+//    fragColor = vec3(texture(ColorSampler, uv));
+//    fragColor = vec3(depth.x, depth.x, depth.x);
+}
@@ -0,0 +1,50 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//PreMadeStencil::createRingStencilMask on the gpu (see StencilGenerator), drawn with ppFullscreenTriangle.vert
+//over the whole stencil with stencil op replace. fragments outside the mask are discarded so they keep the clear value (0)
+
+layout (push_constant) uniform StencilGenInfo {
+    vec4 ndcCenters;//xy left eye lens center, zw right eye
+    float invWidth;
+    float invHeight;
+    float ndcScaleY;
+    float outerRadius;
+    vec4 ringRadii;//innermost first, unused rings are -1
+    int ringShifts;//4 bits per ring, the ring shades 1 in 2^shift quads
+} PushConstant;
+
+//PreMadeStencil::quadShaded
+bool quadShaded(const int densityShift, const ivec2 quad) {
+    if (densityShift == 0) { return true; }
+    if (densityShift == 1) { return ((quad.x ^ quad.y) & 1) == 0; }
+    const bool evenQuad = ((quad.x | quad.y) & 1) == 0;
+    return densityShift == 2 ? evenQuad : evenQuad && (((quad.x ^ quad.y) >> 1) & 1) == 0;
+}
+
+void main() {
+    //all 4 pixels of a quad make the same decision, at the quad's lower right pixel
+    const ivec2 quad = ivec2(gl_FragCoord.xy) >> 1;
+    const vec2 uv = vec2(quad * 2 + 1) * vec2(PushConstant.invWidth, PushConstant.invHeight);
+    const float ndcY = (uv.y*2.0 - 1.0) * PushConstant.ndcScaleY;
+
+    bool eyeCovers[2];
+    for (int camIndex = 0; camIndex <= 1; ++camIndex) {
+        const vec2 center = camIndex == 0 ? PushConstant.ndcCenters.xy : PushConstant.ndcCenters.zw;
+        const vec2 d = vec2((uv.x - 0.5*camIndex)*4.0 - 1.0, ndcY) - center;
+        const float radius = length(d);
+        eyeCovers[camIndex] = false;
+        //first ring the quad is inside of decides
+        for (int ring = 0; ring < 4 && radius < PushConstant.outerRadius; ++ring) {
+            if (radius <= PushConstant.ringRadii[ring]) {
+                eyeCovers[camIndex] = quadShaded((PushConstant.ringShifts >> (4*ring)) & 0xF, quad);
+                break;
+            }
+        }
+    }
+
+    //the eye regions only overlap outside the lens circles, xor like the cpu generator
+    if (eyeCovers[0] == eyeCovers[1]) {
+        discard;
+    }
+}
@@ -0,0 +1,14 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+//SubpassHoleFill, the second subpass of the forward render pass (ppFullscreenTriangle.vert). the stencil test leaves only
+//the rendered pixels, each copies its own forward color into the target the pp chain samples. the holes keep the
+//target's cleared black like the forward image's, filling them needs neighbours that subpassLoad can't read
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput forwardColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = vec4(subpassLoad(forwardColor).rgb, 1.f);
+}